@@ -139,6 +139,9 @@ namespace video
 		//! Support for cube map textures.
 		EVDF_TEXTURE_CUBEMAP,
 
+		//! Support for drawing many instances of a mesh buffer with one call, see IVideoDriver::drawMeshBufferInstances.
+		EVDF_INSTANCED_DRAW,
+
 		//! Only used for counting the elements of this enum
 		EVDF_COUNT
 	};
@@ -39,6 +39,15 @@ namespace scene
 		//! Terrain Scene Node
 		ESNT_TERRAIN        = MAKE_IRR_ID('t','e','r','r'),
 
+		//! Paged Terrain Scene Node
+		ESNT_PAGED_TERRAIN  = MAKE_IRR_ID('p','t','e','r'),
+
+		//! Static Batch Scene Node
+		ESNT_STATIC_BATCH   = MAKE_IRR_ID('s','b','a','t'),
+
+		//! Instanced Mesh Scene Node
+		ESNT_INSTANCED_MESH = MAKE_IRR_ID('i','n','s','t'),
+
 		//! Sky Box Scene Node
 		ESNT_SKY_BOX        = MAKE_IRR_ID('s','k','y','_'),
 
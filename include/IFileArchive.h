@@ -91,6 +91,23 @@ public:
 	*/
 	virtual void addDirectoryToFileList(const io::path &filename) {}
 
+	//! Set the size from which compressed files are decompressed while reading
+	/** Archives with compressed files (currently zip and gzip)
+	decompress smaller files completely into memory when they are opened.
+	Larger files are decompressed in small blocks while reading them
+	instead, which needs less memory and allows reading the begin of a
+	file before the rest is decompressed. Seeking forward in such a file
+	decompresses up to the new position, seeking backward may have to
+	decompress the file from the start again.
+	\param size Uncompressed file size in bytes. Default is 1 MB,
+	0xffffffff decompresses all files completely when they are opened. */
+	virtual void setStreamingThreshold(u32 size) {}
+
+	//! Get the size from which compressed files are decompressed while reading
+	/** \return Uncompressed file size in bytes, 0xffffffff if the
+	archive always decompresses files completely. */
+	virtual u32 getStreamingThreshold() const { return 0xffffffff; }
+
 	//! An optionally used password string
 	/** This variable is publicly accessible from the interface in order to
 	avoid single access patterns to this place, and hence allow some more
@@ -156,6 +156,60 @@ public:
 	\return True if the archive was added successfully, false if not. */
 	virtual bool addFileArchive(IFileArchive* archive) =0;
 
+	//! Adds an archive to the file system, reading its file list on a worker thread.
+	/** Works like addFileArchive, but returns once the archive file is
+	opened and an archive loader is found for it. The file list is read by
+	the worker threads of the device (see
+	SIrrlichtCreationParameters::WorkerThreads), so the file lists of
+	several archives are read in parallel. The archives are added in the
+	order of the calls, after the archives added before. All other
+	functions of the file system wait until the archives are added.
+	Archives which are still read are not searched for the archive file.
+	Folders and archives of external archive loaders are added at once.
+	\param filename: Filename of the archive to add to the file system.
+	\param ignoreCase: If set to true, files in the archive can be accessed without
+	writing all letters in the right case.
+	\param ignorePaths: If set to true, files in the added archive can be accessed
+	without its complete path.
+	\param archiveType: If no specific E_FILE_ARCHIVE_TYPE is selected then
+	the type of archive will depend on the extension of the file name.
+	\param password An optional password, which is used in case of encrypted archives.
+	\return True if the archive is read or was added, false if not. */
+	virtual bool addFileArchiveAsync(const path& filename, bool ignoreCase=true,
+			bool ignorePaths=true,
+			E_FILE_ARCHIVE_TYPE archiveType=EFAT_UNKNOWN,
+			const core::stringc& password="") =0;
+
+	//! Returns true while file lists of archives added with addFileArchiveAsync are read.
+	virtual bool isFileArchiveLoading() const =0;
+
+	//! Sets a directory for caching the file lists of zip archives.
+	/** Reading the file list of a zip archive needs many small reads spread
+	over the archive. With a cache directory the file list is stored there
+	and read in one piece the next time the archive is added, as long as
+	size and modification time of the archive file are the same. Only
+	archives which are files on disk are cached. The directory has to exist.
+	\param directory: Directory for the cache files, an empty path (the
+	default) disables the cache. */
+	virtual void setArchiveCacheDirectory(const path& directory) =0;
+
+	//! Get the directory for caching the file lists of zip archives.
+	/** \return Absolute path of the directory, empty if there is no cache. */
+	virtual const path& getArchiveCacheDirectory() const =0;
+
+	//! Sets if files opened from disk are mapped into memory.
+	/** The contents of mapped files and of the uncompressed files in
+	archives opened from them are available with IReadFile::getData()
+	without copying. Accessing a mapped file which is truncated by another
+	process crashes the application, so only enable it for files which
+	don't change while they are opened. Only has an effect when the engine
+	is compiled with _IRR_COMPILE_WITH_MAPPED_READ_FILE_.
+	\param enable: True to map files, false (the default) to read them. */
+	virtual void setFileMapping(bool enable) =0;
+
+	//! Get if files opened from disk are mapped into memory.
+	virtual bool getFileMapping() const =0;
+
 	//! Get the number of archives currently attached to the file system
 	virtual u32 getFileArchiveCount() const =0;
 
@@ -0,0 +1,84 @@
+// Copyright (C) 2002-2012 Nikolaus Gebhardt
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#ifndef __I_INSTANCED_MESH_SCENE_NODE_H_INCLUDED__
+#define __I_INSTANCED_MESH_SCENE_NODE_H_INCLUDED__
+
+#include "ISceneNode.h"
+
+namespace irr
+{
+namespace scene
+{
+	class IMesh;
+
+	//! Draws many instances of one mesh, each with its own transformation and color.
+	/** Useful for forests, crowds and other scenes with many copies of the
+	same mesh. Compared to one mesh scene node per copy, the instances are
+	culled against the view frustum of the active camera in one loop, and
+	each mesh buffer is drawn with one call of
+	IVideoDriver::drawMeshBufferInstances for all visible instances.
+
+	The transformations of the instances are relative to this node. Drivers
+	supporting EVDF_INSTANCED_DRAW draw all instances at once when the
+	shader of the material reads the attributes "inInstanceMatrix" and
+	"inInstanceColor", see IVideoDriver::drawMeshBufferInstances. Other
+	drivers and materials draw the instances one after another, and the
+	instance colors are not used. */
+	class IInstancedMeshSceneNode : public ISceneNode
+	{
+	public:
+
+		//! Constructor
+		IInstancedMeshSceneNode(ISceneNode* parent, ISceneManager* mgr, s32 id,
+			const core::vector3df& position = core::vector3df(0.0f, 0.0f, 0.0f))
+			: ISceneNode(parent, mgr, id, position) {}
+
+		//! Sets a new mesh to display
+		/** The materials of the mesh buffers are copied. */
+		virtual void setMesh(IMesh* mesh) = 0;
+
+		//! Get the currently defined mesh for display.
+		virtual IMesh* getMesh() = 0;
+
+		//! Adds an instance of the mesh.
+		/** \param transformation Transformation relative to this node.
+		\param color Color of the instance, only used by instancing shaders.
+		\return Index of the new instance. */
+		virtual u32 addInstance(const core::matrix4& transformation,
+			video::SColor color = video::SColor(255,255,255,255)) = 0;
+
+		//! Removes an instance.
+		/** The last instance takes the index of the removed one.
+		\param index Index of the instance, smaller than getInstanceCount(). */
+		virtual void removeInstance(u32 index) = 0;
+
+		//! Removes all instances.
+		virtual void removeAllInstances() = 0;
+
+		//! Get the number of instances.
+		virtual u32 getInstanceCount() const = 0;
+
+		//! Sets the transformation of an instance, relative to this node.
+		virtual void setInstanceTransformation(u32 index, const core::matrix4& transformation) = 0;
+
+		//! Get the transformation of an instance, relative to this node.
+		virtual const core::matrix4& getInstanceTransformation(u32 index) const = 0;
+
+		//! Sets the color of an instance.
+		virtual void setInstanceColor(u32 index, video::SColor color) = 0;
+
+		//! Get the color of an instance.
+		virtual video::SColor getInstanceColor(u32 index) const = 0;
+
+		//! Get the number of instances drawn in the last frame.
+		/** Only the instances inside the view frustum are drawn. */
+		virtual u32 getVisibleInstanceCount() const = 0;
+	};
+
+} // end namespace scene
+} // end namespace irr
+
+#endif
+
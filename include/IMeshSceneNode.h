@@ -69,6 +69,20 @@ public:
 	/** This flag can be set by setReadOnlyMaterials().
 	\return Whether the materials are read-only. */
 	virtual bool isReadOnlyMaterials() const = 0;
+
+	//! Returns true if the scene manager may draw the solid mesh buffers of this node itself.
+	/** With the render queue of the scene manager (see
+	ISceneManager::setRenderQueue()) the solid mesh buffers of such
+	nodes are drawn sorted by their materials, instead of calling
+	render() for the solid pass. The mesh buffers are drawn with the
+	absolute transformation and the materials of getMaterial(), or
+	those of the mesh buffers with read only materials. So nodes have
+	to return false when their render() does anything else, like
+	updating shadows or drawing debug data. */
+	virtual bool canQueueMeshBuffers() const
+	{
+		return false;
+	}
 };
 
 } // end namespace scene
@@ -0,0 +1,88 @@
+// Copyright (C) 2002-2012 Nikolaus Gebhardt
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#ifndef __I_PAGED_TERRAIN_SCENE_NODE_H_INCLUDED__
+#define __I_PAGED_TERRAIN_SCENE_NODE_H_INCLUDED__
+
+#include "ISceneNode.h"
+#include "dimension2d.h"
+
+namespace irr
+{
+namespace scene
+{
+	class ITerrainSceneNode;
+
+	//! A terrain for RAW heightmaps which are too large to be loaded at once.
+	/** The heightmap is split into square tiles which share their border
+	vertices. Only the tiles around the active camera are resident, each of
+	them is an ITerrainSceneNode child of this node, which is rendered with
+	the geo mip map LOD of the terrain scene node. Tiles are read from the
+	heightmap file on the main thread and their vertices and patches are
+	created on the worker threads of the device (see
+	SIrrlichtCreationParameters::WorkerThreads). When more tiles than the
+	budget are needed, the tiles which were not needed for the longest time
+	are removed.
+
+	Like ITerrainSceneNode, the terrain is placed at the absolute position
+	which was used for creating it. The texture coordinates go from 0 to 1
+	on each tile, and the LOD and the normals of neighbouring tiles do not
+	match exactly at their borders.
+
+	The triangle selector of the node, if one was created, contains the
+	triangles of the resident tiles only. */
+	class IPagedTerrainSceneNode : public ISceneNode
+	{
+	public:
+
+		//! Constructor
+		IPagedTerrainSceneNode(ISceneNode* parent, ISceneManager* mgr, s32 id,
+			const core::vector3df& position = core::vector3df(0.0f, 0.0f, 0.0f))
+			: ISceneNode(parent, mgr, id, position) {}
+
+		//! Get the number of tiles in x (Width) and z (Height) direction.
+		virtual core::dimension2du getTileCount() const = 0;
+
+		//! Get the number of tiles which are resident or being loaded.
+		virtual u32 getResidentTileCount() const = 0;
+
+		//! Get a resident tile.
+		/** \param x Tile index in x direction.
+		\param z Tile index in z direction.
+		\return The terrain node of the tile, or 0 if the tile is not
+		loaded at the moment. The tile may be removed in any later frame,
+		so the pointer should only be kept after grabbing it. */
+		virtual ITerrainSceneNode* getTile(u32 x, u32 z) const = 0;
+
+		//! Set how many tiles may be resident at the same time.
+		/** Tiles which are loaded at the moment are counted as well. */
+		virtual void setMaxResidentTiles(u32 count) = 0;
+
+		//! Get how many tiles may be resident at the same time.
+		virtual u32 getMaxResidentTiles() const = 0;
+
+		//! Set the distance from the camera up to which tiles are loaded.
+		/** \param distance Distance in world units, measured in the x-z
+		plane from the camera to the nearest point of a tile. */
+		virtual void setLoadDistance(f32 distance) = 0;
+
+		//! Get the distance from the camera up to which tiles are loaded.
+		virtual f32 getLoadDistance() const = 0;
+
+		//! Get the height of the terrain at a world position.
+		/** \return The height, or -FLT_MAX if the position is outside of
+		the terrain or on a tile which is not resident. */
+		virtual f32 getHeight(f32 x, f32 z) const = 0;
+
+		//! Loads all tiles which the active camera needs and waits for them.
+		/** Useful after the camera jumped to another place, so the
+		following frame does not show missing tiles. */
+		virtual void waitForTiles() = 0;
+	};
+
+} // end namespace scene
+} // end namespace irr
+
+#endif
+
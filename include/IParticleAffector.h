@@ -6,7 +6,7 @@
 #define __I_PARTICLE_AFFECTOR_H_INCLUDED__
 
 #include "IAttributeExchangingObject.h"
-#include "SParticle.h"
+#include "SParticleStreams.h"
 
 namespace irr
 {
@@ -46,11 +46,43 @@ public:
 	IParticleAffector() : Enabled(true) {}
 
 	//! Affects an array of particles.
-	/** \param now Current time. (Same as ITimer::getTime() would return)
+	/** Called by the default affectStreams(), so it can run on a worker
+	thread of the engine as well, see affectStreams().
+	\param now Current time. (Same as ITimer::getTime() would return)
 	\param particlearray Array of particles.
 	\param count Amount of particles in array. */
 	virtual void affect(u32 now, SParticle* particlearray, u32 count) = 0;
 
+	//! Affects particles which are stored in separate arrays.
+	/** This is called by the particle system scene node. The default
+	implementation copies the particles into an array of SParticle, calls
+	affect() and copies them back. The built in affectors work on the
+	arrays directly.
+	When the engine was created with worker threads, this runs on one of
+	them from the start of ISceneNode::OnAnimate() of the particle system
+	until it's rendered. Meanwhile the main thread animates other scene
+	nodes, so affectors must not use the scene manager or other nodes here,
+	and their settings must not be changed from scene node animators. An
+	affector added to several particle systems can be called from several
+	threads at the same time.
+	\param now Current time. (Same as ITimer::getTime() would return)
+	\param particles Arrays of the particles. */
+	virtual void affectStreams(u32 now, SParticleStreams& particles)
+	{
+		const u32 count = particles.size();
+		core::array<SParticle> particlearray(count);
+		particlearray.set_used(count);
+
+		u32 i;
+		for (i=0; i<count; ++i)
+			particles.getParticle(i, particlearray[i]);
+
+		affect(now, particlearray.pointer(), count);
+
+		for (i=0; i<count; ++i)
+			particles.setParticle(i, particlearray[i]);
+	}
+
 	//! Sets whether or not the affector is currently enabled.
 	virtual void setEnabled(bool enabled) { Enabled = enabled; }
 
@@ -47,7 +47,12 @@ class IParticleEmitter : public virtual io::IAttributeExchangingObject
 public:
 
 	//! Prepares an array with new particles to emit into the system
-	/** \param now Current time.
+	/** Called from ISceneNode::OnAnimate() of the particle system on the
+	thread which animates the scene, never while the affectors of the same
+	particle system run. When the engine was created with worker threads,
+	the affectors of other particle systems can run on them meanwhile, so an
+	emitter must not share state with affectors.
+	\param now Current time.
 	\param timeSinceLastCall Time elapsed since last call, in milliseconds.
 	\param outArray Pointer which will point to the array with the new
 	particles to add into the system.
@@ -181,6 +181,12 @@ public:
 	*/
     inline void stop(s32 id);
 
+	//! Add calls to the given id without timing them
+	/** Useful to count events which are too frequent or too short to be timed one by one.
+	NOTE: you have to add the id first with one of the ::add functions
+	*/
+	inline void addCalls(s32 id, u32 calls);
+
 	//! Reset profile data for the given id
     inline void resetDataById(s32 id);
 
@@ -326,6 +332,17 @@ void IProfiler::stop(s32 id)
 	}
 }
 
+void IProfiler::addCalls(s32 id, u32 calls)
+{
+	s32 idx = ProfileDatas.binary_search(SProfileData(id));
+	if ( idx >= 0 )
+	{
+		SProfileData &data = ProfileDatas[idx];
+		data.CountCalls += calls;
+		ProfileGroups[data.GroupIndex].CountCalls += calls;
+	}
+}
+
 s32 IProfiler::add(const core::stringw &name, const core::stringw &groupName)
 {
 	u32 index;
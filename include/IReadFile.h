@@ -42,6 +42,16 @@ namespace io
 		//! Get name of file.
 		/** \return File name as zero terminated character string. */
 		virtual const io::path& getFileName() const = 0;
+
+		//! Get the contents of the file, if they are in memory.
+		/** Files read from memory, memory mapped files and uncompressed
+		files of such files in archives return a pointer to their complete
+		contents, independent from the current position in the file. The
+		pointer stays valid as long as the file exists. Loaders can parse
+		these contents directly instead of reading them into a buffer.
+		\return Pointer to getSize() bytes, or 0 if the contents can
+		only be read with read(). */
+		virtual const void* getData() const { return 0; }
 	};
 
 	//! Internal function, please do not use.
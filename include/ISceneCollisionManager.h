@@ -45,6 +45,37 @@ namespace scene
 		{}
 	};
 
+	//! A moving ellipsoid for ISceneCollisionManager::getCollisionResultPositions
+	struct SEllipsoidSweep
+	{
+		//! Position of the ellipsoid
+		core::vector3df Position;
+
+		//! Radius of the ellipsoid, the ellipsoid is not moved when one component is 0
+		core::vector3df Radius;
+
+		//! Direction and speed of the movement of the ellipsoid
+		core::vector3df DirectionAndSpeed;
+
+		//! New position of the ellipsoid
+		core::vector3df ResultPosition;
+
+		//! Position of the collision
+		core::vector3df HitPosition;
+
+		//! Last triangle causing a collision, only changed when there was a collision
+		core::triangle3df Triangle;
+
+		//! Node with which the ellipsoid collided, only changed when there was a collision
+		ISceneNode* Node;
+
+		//! Is set to true if the ellipsoid is falling down, caused by gravity
+		bool Falling;
+
+		SEllipsoidSweep() : Node(0), Falling(false)
+		{}
+	};
+
 	//! The Scene Collision Manager provides methods for performing collision tests and picking on scene nodes.
 	class ISceneCollisionManager : public virtual IReferenceCounted
 	{
@@ -86,6 +117,27 @@ namespace scene
 			return false;
 		}
 
+		//! Finds the nearest collision points of many lines with the triangles of one selector.
+		/** Gives the same results as calling getCollisionPoint for each
+		ray, but the triangles are only fetched once from the selector
+		for all rays and the rays are tested against four triangles at
+		once. Large batches are spread over the worker threads of the
+		device (see SIrrlichtCreationParameters::WorkerThreads).
+		Hits exactly on the edge of two triangles can report the other
+		triangle than getCollisionPoint. All rays are tested against the
+		triangles in the box around all rays, so batches of rays close to
+		each other are faster than rays spread over the whole world.
+		\param hitResults: Array of count elements. Contains the collision
+		result of each ray which hit a triangle, others are not changed.
+		\param outHits: Array of count elements, set to true for each ray
+		which hit a triangle and to false otherwise.
+		\param rays: Array of count lines with which collisions are tested.
+		\param count: Number of rays.
+		\param selector: TriangleSelector to be used for the collision check.
+		\return Number of rays which hit a triangle. */
+		virtual u32 getCollisionPoints(SCollisionHit* hitResults, bool* outHits,
+				const core::line3d<f32>* rays, u32 count, ITriangleSelector* selector) = 0;
+
 		//! Collides a moving ellipsoid with a 3d world with gravity and returns the resulting new position of the ellipsoid.
 		/** This can be used for moving a character in a 3d world: The
 		character will slide at walls and is able to walk up stairs.
@@ -122,6 +174,28 @@ namespace scene
 			const core::vector3df& gravityDirectionAndSpeed
 			= core::vector3df(0.0f, 0.0f, 0.0f)) = 0;
 
+		//! Collides many moving ellipsoids with a 3d world with gravity.
+		/** Works like calling getCollisionResultPosition for each
+		ellipsoid, but the triangles are fetched only once from the
+		selector for the movement of all ellipsoids and once for the
+		gravity. Large batches are spread over the worker threads of
+		the device. The ellipsoids don't collide with each other. Like
+		for getCollisionPoints, batches of ellipsoids close to each other
+		are faster than ellipsoids spread over the whole world.
+		\param selector: TriangleSelector containing the triangles of
+		the world.
+		\param sweeps: Array of count ellipsoids. Position, Radius and
+		DirectionAndSpeed have to be set, the other members receive the
+		results like the parameters of getCollisionResultPosition.
+		\param count: Number of ellipsoids.
+		\param slidingSpeed: See getCollisionResultPosition.
+		\param gravityDirectionAndSpeed: Direction and force of gravity. */
+		virtual void getCollisionResultPositions(ITriangleSelector* selector,
+			SEllipsoidSweep* sweeps, u32 count,
+			f32 slidingSpeed = 0.0005f,
+			const core::vector3df& gravityDirectionAndSpeed
+			= core::vector3df(0.0f, 0.0f, 0.0f)) = 0;
+
 		//! Returns a 3d ray which would go through the 2d screen coordinates.
 		/** \param pos: Screen coordinates in pixels.
 		\param camera: Camera from which the ray starts. If null, the
@@ -107,11 +107,14 @@ namespace scene
 	class IMeshCache;
 	class IMeshLoader;
 	class IMeshManipulator;
+	class IInstancedMeshSceneNode;
 	class IMeshSceneNode;
 	class IMeshWriter;
 	class IMetaTriangleSelector;
 	class IOctreeSceneNode;
+	class IPagedTerrainSceneNode;
 	class IParticleSystemSceneNode;
+	class IStaticBatchSceneNode;
 	class ISceneCollisionManager;
 	class ISceneLoader;
 	class ISceneNode;
@@ -885,6 +888,65 @@ namespace scene
 			s32 maxLOD=5, E_TERRAIN_PATCH_SIZE patchSize=ETPS_17, s32 smoothFactor=0,
 			bool addAlsoIfHeightmapEmpty = false) = 0;
 
+		//! Adds a terrain scene node for RAW heightmaps which are too large to be loaded at once.
+		/** Only the tiles of the heightmap around the active camera are
+		loaded, see IPagedTerrainSceneNode. The heightmap file stays open
+		while the node exists. The samples are read like with
+		ITerrainSceneNode::loadHeightMapRAW(), row i of the file becomes
+		the vertices with x=i and sample j of a row the vertices with z=j.
+		\param heightMapFileName: The name of the RAW heightmap file.
+		\param heightMapSize: Samples per row (Width) and rows (Height) of
+		the heightmap. Both minus one have to be multiples of the patch
+		size minus one.
+		\param parent: Parent of the scene node. Can be 0 if no parent.
+		\param id: Id of the node. This id can be used to identify the scene node.
+		\param position: The absolute position of this node.
+		\param scale: The scale factor for the terrain, like for
+		addTerrainSceneNode().
+		\param vertexColor: The default color of all the vertices.
+		\param maxLOD: The maximum LOD (level of detail) of the tiles.
+		\param patchSize: patch size of the tiles.
+		\param tileSize: Quads in each direction of a tile. Rounded down
+		to a multiple of the patch size minus one, and further until the
+		tiles cover the heightmap exactly. With more than 255, the tiles
+		need 32 bit indices.
+		\param maxResidentTiles: How many tiles may be in memory at once.
+		\param bitsPerPixel: Size of the samples, 8, 16 or 32 bits.
+		\param signedData: Whether the samples are signed.
+		\param selectorLOD: LOD of the triangle selector of the node,
+		which contains the resident tiles. -1 for no triangle selector.
+		\return Pointer to the created scene node. Can be null if the
+		file could not be opened, is too small or the heightmap size
+		does not fit the patch size. The returned pointer
+		should not be dropped. See IReferenceCounted::drop() for more
+		information. */
+		virtual IPagedTerrainSceneNode* addPagedTerrainSceneNode(
+			const io::path& heightMapFileName,
+			const core::dimension2du& heightMapSize,
+			ISceneNode* parent=0, s32 id=-1,
+			const core::vector3df& position = core::vector3df(0.0f,0.0f,0.0f),
+			const core::vector3df& scale = core::vector3df(1.0f,1.0f,1.0f),
+			video::SColor vertexColor = video::SColor(255,255,255,255),
+			s32 maxLOD=5, E_TERRAIN_PATCH_SIZE patchSize=ETPS_17,
+			u32 tileSize=128, u32 maxResidentTiles=32,
+			s32 bitsPerPixel=16, bool signedData=false, s32 selectorLOD=-1) = 0;
+
+		//! Adds a terrain scene node for RAW heightmaps which are too large to be loaded at once.
+		/** Just like the other addPagedTerrainSceneNode() method, but
+		takes an IReadFile pointer as parameter for the heightmap. The
+		heightmap starts at the current position of the file. For more
+		information take a look at the other function. */
+		virtual IPagedTerrainSceneNode* addPagedTerrainSceneNode(
+			io::IReadFile* heightMapFile,
+			const core::dimension2du& heightMapSize,
+			ISceneNode* parent=0, s32 id=-1,
+			const core::vector3df& position = core::vector3df(0.0f,0.0f,0.0f),
+			const core::vector3df& scale = core::vector3df(1.0f,1.0f,1.0f),
+			video::SColor vertexColor = video::SColor(255,255,255,255),
+			s32 maxLOD=5, E_TERRAIN_PATCH_SIZE patchSize=ETPS_17,
+			u32 tileSize=128, u32 maxResidentTiles=32,
+			s32 bitsPerPixel=16, bool signedData=false, s32 selectorLOD=-1) = 0;
+
 		//! Adds a quake3 scene node to the scene graph.
 		/** A Quake3 Scene renders multiple meshes for a specific HighLanguage Shader (Quake3 Style )
 		\return Pointer to the quake3 scene node if successful, otherwise NULL.
@@ -894,6 +956,29 @@ namespace scene
 												) = 0;
 
 
+		//! Adds a scene node which draws many static mesh scene nodes merged by material.
+		/** Add the mesh scene nodes with
+		IStaticBatchSceneNode::addNode(), see IStaticBatchSceneNode.
+		\param parent: Parent of the scene node. Can be 0 if no parent.
+		\param id: Id of the node. This id can be used to identify the scene node.
+		\param position: Position of the node, the merged meshes are relative to it.
+		\return Pointer to the created scene node.
+		This pointer should not be dropped. See IReferenceCounted::drop() for more information. */
+		virtual IStaticBatchSceneNode* addStaticBatchSceneNode(ISceneNode* parent=0, s32 id=-1,
+			const core::vector3df& position = core::vector3df(0,0,0)) = 0;
+
+		//! Adds a scene node which draws many instances of one mesh.
+		/** Add the instances with IInstancedMeshSceneNode::addInstance(),
+		see IInstancedMeshSceneNode.
+		\param mesh: Mesh of the instances, can be changed later.
+		\param parent: Parent of the scene node. Can be 0 if no parent.
+		\param id: Id of the node. This id can be used to identify the scene node.
+		\param position: Position of the node, the instances are relative to it.
+		\return Pointer to the created scene node.
+		This pointer should not be dropped. See IReferenceCounted::drop() for more information. */
+		virtual IInstancedMeshSceneNode* addInstancedMeshSceneNode(IMesh* mesh, ISceneNode* parent=0, s32 id=-1,
+			const core::vector3df& position = core::vector3df(0,0,0)) = 0;
+
 		//! Adds an empty scene node to the scene graph.
 		/** Can be used for doing advanced transformations
 		or structuring the scene graph.
@@ -1671,6 +1756,50 @@ namespace scene
 		\return True if node is not visible in the current scene, else
 		false. */
 		virtual bool isCulled(const ISceneNode* node) const =0;
+
+		//! Animate the scene nodes on the worker threads of the device in drawAll().
+		/** Independent parts of the scene graph are animated at the same
+		time. Nodes and animators which are not thread safe (see
+		ISceneNode::isAnimationThreadSafe() and
+		ISceneNodeAnimator::isThreadSafe()) are still animated on the main
+		thread, after the others, always in the same order. Has no effect
+		without worker threads, see SIrrlichtCreationParameters::WorkerThreads.
+		Disabled by default. */
+		virtual void setParallelAnimation(bool enable) =0;
+
+		//! Check if the scene nodes are animated on the worker threads.
+		virtual bool getParallelAnimation() const =0;
+
+		//! Keep the transformations of the scene nodes in contiguous arrays.
+		/** When enabled, drawAll() animates the scene with one linear sweep
+		over arrays of the nodes in parent before children order, instead
+		of calling ISceneNode::OnAnimate() recursively. The absolute
+		transformation of a node is only computed again when its relative
+		translation, rotation or scale or the transformation of a parent
+		changed, see ISceneNode::hasDefaultTransformation(). Nodes whose
+		ISceneNode::isAnimationThreadSafe() returns false are animated with
+		their OnAnimate(), together with their children. Changes of the scene graph are found in the next
+		frame, the arrays are built again then. Until that time removed
+		scene nodes are kept alive by the store. Not used when the scene is
+		animated in parallel, see setParallelAnimation(). Disabled by
+		default. */
+		virtual void setTransformStore(bool enable) =0;
+
+		//! Check if the transformations are kept in contiguous arrays.
+		virtual bool getTransformStore() const =0;
+
+		//! Draw the solid mesh buffers of mesh scene nodes sorted by their materials.
+		/** When enabled, drawAll() collects the solid mesh buffers of the
+		mesh scene nodes which allow it (see
+		IMeshSceneNode::canQueueMeshBuffers()) and draws them sorted by
+		material type, textures, other material flags and distance to the
+		camera, before the other solid scene nodes. So the video driver
+		changes the render states less often. Not used while a light
+		manager is set, see setLightManager(). Disabled by default. */
+		virtual void setRenderQueue(bool enable) =0;
+
+		//! Check if the solid mesh buffers are drawn sorted by their materials.
+		virtual bool getRenderQueue() const =0;
 	};
 
 
@@ -39,6 +39,8 @@ namespace scene
 	*/
 	class ISceneNode : virtual public io::IAttributeExchangingObject
 	{
+		friend class CSceneNodeTransformStore;
+
 	public:
 
 		//! Constructor
@@ -49,7 +51,9 @@ namespace scene
 			: RelativeTranslation(position), RelativeRotation(rotation), RelativeScale(scale),
 				Parent(0), SceneManager(mgr), TriangleSelector(0), ID(id),
 				AutomaticCullingState(EAC_BOX), DebugDataVisible(EDS_OFF),
-				IsVisible(true), IsDebugObject(false)
+				IsVisible(true), IsDebugObject(false), ChildrenChanges(0),
+				AbsoluteTransformationChanges(0), ParentTransformationChanges(0),
+				TransformationParent(0), TransformedBoxChanges(0)
 		{
 			if (parent)
 				parent->addChild(this);
@@ -125,8 +129,8 @@ namespace scene
 					}
 				}
 
-				// update absolute position
-				updateAbsolutePosition();
+				// update absolute position, unless nothing changed since the last update
+				updateAbsolutePositionIfChanged();
 
 				// perform the post render process on all children
 
@@ -137,6 +141,42 @@ namespace scene
 		}
 
 
+		//! Returns true if this node may be animated on a worker thread.
+		/** When the scene manager animates the scene nodes in parallel
+		(see ISceneManager::setParallelAnimation()), it does the work of
+		ISceneNode::OnAnimate() itself for nodes which return true and
+		only have thread safe animators (see
+		ISceneNodeAnimator::isThreadSafe()): It runs the animators, calls
+		updateAbsolutePosition() and continues with the children, at the
+		same time as other nodes. OnAnimate() of the node itself is not
+		called then, so only nodes which don't override it, and whose
+		updateAbsolutePosition() doesn't use other nodes than the parent,
+		may return true. Other nodes are animated with OnAnimate() on the
+		main thread, after all nodes which can be animated in parallel,
+		always in the same order. The built in nodes which allow it return
+		true, the default is false. */
+		virtual bool isAnimationThreadSafe() const
+		{
+			return false;
+		}
+
+
+		//! Returns true if the absolute transformation only depends on the parent and the relative translation, rotation and scale.
+		/** The absolute transformation of such nodes is only computed
+		again when their relative transformation or the one of a parent
+		changed, see updateAbsolutePositionIfChanged(). The transform store
+		of the scene manager (see ISceneManager::setTransformStore())
+		computes it itself. Only nodes which override neither
+		updateAbsolutePosition() nor getRelativeTransformation() may return
+		true, updateAbsolutePosition() is called for the others each frame.
+		The built in nodes which allow it return true, the default is
+		false. */
+		virtual bool hasDefaultTransformation() const
+		{
+			return false;
+		}
+
+
 		//! Renders the node.
 		virtual void render() = 0;
 
@@ -178,13 +218,32 @@ namespace scene
 
 		//! Get the axis aligned, transformed and animated absolute bounding box of this node.
 		/** Note: The result is still an axis-aligned bounding box, so it's size
-		changes with rotation.
+		changes with rotation. For nodes whose hasDefaultTransformation()
+		returns true, the box is cached until the bounding box or the
+		absolute transformation change, so this should not be called from
+		several threads at the same time.
 		\return The transformed bounding box. */
 		virtual const core::aabbox3d<f32> getTransformedBoundingBox() const
 		{
-			core::aabbox3d<f32> box = getBoundingBox();
-			AbsoluteTransformation.transformBoxEx(box);
-			return box;
+			const core::aabbox3d<f32>& box = getBoundingBox();
+			if (!hasDefaultTransformation())
+			{
+				// an own updateAbsolutePosition() may not count its changes
+				core::aabbox3d<f32> transformed = box;
+				AbsoluteTransformation.transformBoxEx(transformed);
+				return transformed;
+			}
+
+			if (TransformedBoxChanges != AbsoluteTransformationChanges ||
+				differs(box.MinEdge, TransformedBoxSource.MinEdge) ||
+				differs(box.MaxEdge, TransformedBoxSource.MaxEdge))
+			{
+				TransformedBoxSource = box;
+				TransformedBox = box;
+				AbsoluteTransformation.transformBoxEx(TransformedBox);
+				TransformedBoxChanges = AbsoluteTransformationChanges;
+			}
+			return TransformedBox;
 		}
 
 		//! Get a the 8 corners of the original bounding box transformed and
@@ -304,6 +363,7 @@ namespace scene
 				child->remove(); // remove from old parent
 				Children.push_back(child);
 				child->Parent = this;
+				++ChildrenChanges;
 			}
 		}
 
@@ -323,6 +383,7 @@ namespace scene
 					(*it)->Parent = 0;
 					(*it)->drop();
 					Children.erase(it);
+					++ChildrenChanges;
 					return true;
 				}
 
@@ -344,6 +405,7 @@ namespace scene
 			}
 
 			Children.clear();
+			++ChildrenChanges;
 		}
 
 
@@ -661,7 +723,10 @@ namespace scene
 
 		//! Updates the absolute position based on the relative and the parents position
 		/** Note: This does not recursively update the parents absolute positions, so if you have a deeper
-			hierarchy you might want to update the parents first.*/
+			hierarchy you might want to update the parents first.
+			It remembers which transformations were used, see updateAbsolutePositionIfChanged().
+			Nodes which override this without calling it must not return true from
+			hasDefaultTransformation(). */
 		virtual void updateAbsolutePosition()
 		{
 			if (Parent)
@@ -671,6 +736,34 @@ namespace scene
 			}
 			else
 				AbsoluteTransformation = getRelativeTransformation();
+
+			rememberTransformation();
+		}
+
+
+		//! Updates the absolute position only if it could have changed since the last update.
+		/** That is the case when the relative translation, rotation or
+		scale of this node changed, or the parent or its absolute
+		transformation. Nodes whose hasDefaultTransformation() returns
+		false, and the children of such nodes, are always updated.
+		OnAnimate() uses this, so nodes of static parts of the scene don't
+		compute their absolute transformation each frame.
+		\return True if updateAbsolutePosition() was called, false if
+		the absolute transformation is still valid. */
+		bool updateAbsolutePositionIfChanged()
+		{
+			if (Parent != TransformationParent || !hasDefaultTransformation() ||
+				(Parent && (!Parent->hasDefaultTransformation() ||
+					Parent->AbsoluteTransformationChanges != ParentTransformationChanges)) ||
+				differs(RelativeTranslation, LastRelativeTranslation) ||
+				differs(RelativeRotation, LastRelativeRotation) ||
+				differs(RelativeScale, LastRelativeScale))
+			{
+				updateAbsolutePosition();
+				return true;
+			}
+
+			return false;
 		}
 
 
@@ -774,6 +867,7 @@ namespace scene
 		{
 			Name = toCopyFrom->Name;
 			AbsoluteTransformation = toCopyFrom->AbsoluteTransformation;
+			++AbsoluteTransformationChanges;
 			RelativeTranslation = toCopyFrom->RelativeTranslation;
 			RelativeRotation = toCopyFrom->RelativeRotation;
 			RelativeScale = toCopyFrom->RelativeScale;
@@ -864,6 +958,45 @@ namespace scene
 
 		//! Is debug object?
 		bool IsDebugObject;
+
+	private:
+
+		//! Exact comparison, vector3d::operator!= would hide small movements
+		static bool differs(const core::vector3df& a, const core::vector3df& b)
+		{
+			return a.X != b.X || a.Y != b.Y || a.Z != b.Z;
+		}
+
+		//! Remembers from what the absolute transformation was computed
+		void rememberTransformation()
+		{
+			TransformationParent = Parent;
+			ParentTransformationChanges = Parent ? Parent->AbsoluteTransformationChanges : 0;
+			LastRelativeTranslation = RelativeTranslation;
+			LastRelativeRotation = RelativeRotation;
+			LastRelativeScale = RelativeScale;
+			++AbsoluteTransformationChanges;
+		}
+
+		//! Counts how often children were added or removed
+		u32 ChildrenChanges;
+
+		//! Counts how often the absolute transformation was computed
+		u32 AbsoluteTransformationChanges;
+
+		//! AbsoluteTransformationChanges of the parent at the last update
+		u32 ParentTransformationChanges;
+
+		//! The parent and the relative transformation at the last update
+		ISceneNode* TransformationParent;
+		core::vector3df LastRelativeTranslation;
+		core::vector3df LastRelativeRotation;
+		core::vector3df LastRelativeScale;
+
+		//! Cache of getTransformedBoundingBox()
+		mutable core::aabbox3d<f32> TransformedBox;
+		mutable core::aabbox3d<f32> TransformedBoxSource;
+		mutable u32 TransformedBoxChanges;
 	};
 
 
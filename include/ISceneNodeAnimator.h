@@ -74,6 +74,21 @@ namespace scene
 			return false;
 		}
 
+		//! Returns true if animateNode() may be called on a worker thread.
+		/** Used when the scene manager animates the scene nodes in
+		parallel, see ISceneManager::setParallelAnimation(). A thread safe
+		animator only changes the node it animates and its own members.
+		It does not add or remove scene nodes or animators and does not
+		use other scene nodes, the scene manager, the video driver or the
+		file system. Animators of different nodes run at the same time, so
+		a thread safe animator which changes its own members must not be
+		added to more than one node. Nodes with other animators are
+		animated on the main thread. */
+		virtual bool isThreadSafe() const
+		{
+			return false;
+		}
+
 		//! Reset a time-based movement by changing the starttime.
 		/** By default most animators start on object creation.
 			This value is ignored by animators which don't work with a starttime.
@@ -94,6 +94,7 @@ namespace scene
 		private:
 			//! Internal members used by CSkinnedMesh
 			friend class CSkinnedMesh;
+			//! set by the reference skinning, 0 unless compiled with _IRR_COMPILE_WITH_SKINNING_REFERENCE_
 			bool *Moved;
 			core::vector3df StaticPos;
 			core::vector3df StaticNormal;
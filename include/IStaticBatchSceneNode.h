@@ -0,0 +1,82 @@
+// Copyright (C) 2002-2012 Nikolaus Gebhardt
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#ifndef __I_STATIC_BATCH_SCENE_NODE_H_INCLUDED__
+#define __I_STATIC_BATCH_SCENE_NODE_H_INCLUDED__
+
+#include "ISceneNode.h"
+
+namespace irr
+{
+namespace scene
+{
+	class IMesh;
+	class IMeshSceneNode;
+
+	//! Draws the meshes of many static mesh scene nodes merged by material.
+	/** The mesh buffers of the added mesh scene nodes are copied with
+	their absolute transformation into large mesh buffers, one for each
+	material and vertex type, which use 32 bit indices when they have more
+	than 65535 vertices. So many small nodes with the same material cost
+	one draw call instead of one per node. The added nodes are made
+	invisible, this node draws them instead.
+
+	The bounding box of each added mesh buffer is kept. Mesh buffers which
+	are outside of the view frustum of the active camera are skipped, the
+	visible neighbours in a merged mesh buffer are still drawn with one
+	call.
+
+	The merged mesh buffers are built again before the next frame, when
+	an added node got another mesh, moved or was removed from the scene,
+	and when this node moved. Changes of the materials or the vertices of
+	the added nodes are not found, call setDirty() after them. Only
+	triangle lists can be merged. */
+	class IStaticBatchSceneNode : public ISceneNode
+	{
+	public:
+
+		//! Constructor
+		IStaticBatchSceneNode(ISceneNode* parent, ISceneManager* mgr, s32 id,
+			const core::vector3df& position = core::vector3df(0.0f, 0.0f, 0.0f))
+			: ISceneNode(parent, mgr, id, position) {}
+
+		//! Adds a mesh scene node to the batch.
+		/** The node is grabbed and made invisible.
+		\param node The node to add.
+		\return False if the node was already added or has a mesh
+		buffer which is not a triangle list. */
+		virtual bool addNode(IMeshSceneNode* node) = 0;
+
+		//! Removes a mesh scene node from the batch.
+		/** The node gets back the visibility it had when it was added
+		and is dropped.
+		\return False if the node was not added. */
+		virtual bool removeNode(IMeshSceneNode* node) = 0;
+
+		//! Removes all mesh scene nodes from the batch.
+		virtual void removeAllNodes() = 0;
+
+		//! Get the number of mesh scene nodes in the batch.
+		virtual u32 getNodeCount() const = 0;
+
+		//! Get a mesh scene node of the batch.
+		/** \param index Index of the node, smaller than getNodeCount(). */
+		virtual IMeshSceneNode* getNode(u32 index) const = 0;
+
+		//! Build the merged mesh buffers again before they are used next time.
+		/** Needed after changing the materials or vertices of added
+		nodes. */
+		virtual void setDirty() = 0;
+
+		//! Get the merged mesh.
+		/** It is built first if needed. The vertices are relative to
+		this node. The mesh is replaced when it is built again. */
+		virtual IMesh* getMesh() = 0;
+	};
+
+} // end namespace scene
+} // end namespace irr
+
+#endif
+
@@ -159,7 +159,9 @@ namespace scene
 		//! Initializes the terrain data.  Loads the vertices from the heightMapFile.
 		/** The data is interpreted as (signed) integers of the given bit size or
 		floats (with 32bits, signed). Allowed bitsizes for integers are
-		8, 16, and 32. The heightmap must be square.
+		8, 16, and 32. The heightmap must be square, and its width minus one
+		a multiple of the patch size minus one, as the patches have to cover
+		all of it.
 		\param file The file to read the RAW data from. File is not rewinded.
 		\param bitsPerPixel Size of data if integers used, for floats always use 32.
 		\param signedData Whether we use signed or unsigned ints, ignored for floats.
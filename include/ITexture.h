@@ -268,6 +268,21 @@ protected:
 		return ETCF_OPTIMIZED_FOR_SPEED;
 	}
 
+	//! Helper function, swaps size, format and type with another texture.
+	/** Used by the drivers to swap in textures loaded in the background.
+	The name stays. */
+	void swapProperties(ITexture& other)
+	{
+		core::swap(OriginalSize, other.OriginalSize);
+		core::swap(Size, other.Size);
+		core::swap(OriginalColorFormat, other.OriginalColorFormat);
+		core::swap(ColorFormat, other.ColorFormat);
+		core::swap(Pitch, other.Pitch);
+		core::swap(HasMipMaps, other.HasMipMaps);
+		core::swap(IsRenderTarget, other.IsRenderTarget);
+		core::swap(Type, other.Type);
+	}
+
 	io::SNamedPath NamedPath;
 	core::dimension2d<u32> OriginalSize;
 	core::dimension2d<u32> Size;
@@ -156,6 +156,20 @@ namespace video
 		0
 	};
 
+	//! Interface to get informed when a texture from IVideoDriver::getTextureAsync is loaded.
+	class ITextureLoadCallBack : public virtual IReferenceCounted
+	{
+	public:
+
+		//! Called from IVideoDriver::beginScene after the texture data has been loaded.
+		/** \param placeholder The texture returned by getTextureAsync.
+		\param texture The loaded texture. This is the placeholder itself
+		when the driver could swap in the loaded data. Otherwise it's a
+		new texture, which replaces the placeholder in the texture cache.
+		0 if the file could not be loaded, the placeholder stays then. */
+		virtual void OnTextureLoaded(ITexture* placeholder, ITexture* texture) = 0;
+	};
+
 	//! Interface to driver which is able to perform 2d and 3d graphics functions.
 	/** This interface is one of the most important interfaces of
 	the Irrlicht Engine: All rendering and texture manipulation is done with
@@ -235,6 +249,8 @@ namespace video
 		Version (int) Version of the driver. Should be Major*100+Minor
 		ShaderLanguageVersion (int) Version of the high level shader language. Should be Major*100+Minor.
 		AntiAlias (int) Number of Samples the driver uses for each pixel. 0 and 1 means anti aliasing is off, typical values are 2,4,8,16,32
+		DepthRejectedTriangles (int) Only Burning's Video: Triangles of the last frame which were skipped by the hierarchical depth test.
+		DepthRejectedPixels (int) Only Burning's Video: Approximate number of pixels covered by these triangles.
 		*/
 		virtual const io::IAttributes& getDriverAttributes() const=0;
 
@@ -304,6 +320,37 @@ namespace video
 		IReferenceCounted::drop() for more information. */
 		virtual ITexture* getTexture(io::IReadFile* file) =0;
 
+		//! Get access to a named texture, which is loaded in the background.
+		/** Works like getTexture, but returns at once. The file is read
+		on the calling thread, decoding the image happens on the worker
+		threads of the engine (see SIrrlichtCreationParameters::WorkerThreads).
+		Until the texture is loaded a small white placeholder texture is
+		returned, which is also in the texture cache under the file name.
+		The next beginScene call after loading swaps the loaded data into
+		the placeholder, so materials using it show the texture from then
+		on. Drivers which can't swap texture data (Direct3D 9 and the null
+		driver) replace the placeholder in the texture cache with a new
+		texture instead, which is passed to the callback. So there the
+		pointer of the texture changes: the returned placeholder stays
+		valid and white until the loaded texture is removed, but materials
+		have to be set to the new texture, which getTexture with the same
+		filename returns from then on. Loads still running when all
+		textures are removed are cancelled without calling the callback.
+		\param filename Filename of the texture to be loaded.
+		\param callBack Optional, informed when the texture is loaded. It
+		is called right away when the texture is already loaded.
+		\return Pointer to the placeholder or to the already loaded texture,
+		0 if the file could not be opened. This pointer should not be
+		dropped. See IReferenceCounted::drop() for more information.
+		Passing the placeholder to removeTexture also removes the texture
+		which replaced it. */
+		virtual ITexture* getTextureAsync(const io::path& filename, ITextureLoadCallBack* callBack = 0) = 0;
+
+		//! Check if a texture from getTextureAsync is still loading.
+		/** \param texture Texture returned by getTextureAsync.
+		\return True until the loaded data has been swapped in. */
+		virtual bool isTextureLoading(const ITexture* texture) const = 0;
+
 		//! Returns a texture by index
 		/** \param index: Index of the texture, must be smaller than
 		getTextureCount() Please note that this index might change when
@@ -989,6 +1036,26 @@ namespace video
 		/** \param mb Buffer to draw */
 		virtual void drawMeshBuffer(const scene::IMeshBuffer* mb) =0;
 
+		//! Draws many instances of a mesh buffer
+		/** Each instance is drawn with its own world transformation,
+		which replaces the one set with setTransform(ETS_WORLD).
+		With EVDF_INSTANCED_DRAW, all instances of a triangle list are
+		drawn with one call when the vertex shader of the current
+		material has the attribute "inInstanceMatrix" (mat4). It gets
+		the world transformation of each instance, the world matrix of
+		the driver is the identity matrix then. The optional attribute
+		"inInstanceColor" (vec4) gets the color of each instance, with
+		the components in the same order as the vertex color attribute.
+		Otherwise the instances are drawn one after another and the
+		colors are not used. The world transformation is undefined
+		after this call.
+		\param mb Buffer to draw
+		\param transformations World transformations of the instances
+		\param colors Colors of the instances, can be 0
+		\param instanceCount Number of instances */
+		virtual void drawMeshBufferInstances(const scene::IMeshBuffer* mb,
+			const core::matrix4* transformations, const SColor* colors, u32 instanceCount) =0;
+
 		//! Draws normals of a mesh buffer
 		/** \param mb Buffer to draw the normals of
 		\param length length scale factor of the normals
@@ -166,6 +166,16 @@
 #undef _IRR_COMPILE_WITH_LEAK_HUNTER_
 #endif
 
+//! Define _IRR_COMPILE_WITH_THREADS_ to allow the engine to spread work over worker threads
+/** The number of threads is selected with SIrrlichtCreationParameters::WorkerThreads.
+Without this define all jobs are executed on the calling thread. */
+#if !defined(_IRR_EMSCRIPTEN_PLATFORM_)
+#define _IRR_COMPILE_WITH_THREADS_
+#endif
+#ifdef NO_IRR_COMPILE_WITH_THREADS_
+#undef _IRR_COMPILE_WITH_THREADS_
+#endif
+
 //! Enable profiling information in the engine
 /** NOTE: The profiler itself always exists and can be used by applications.
 This define is about the engine creating profile data
@@ -459,6 +469,14 @@ B3D, MS3D or X meshes */
 #endif
 
 #ifdef _IRR_COMPILE_WITH_SKINNED_MESH_SUPPORT_
+//! Define _IRR_COMPILE_WITH_SKINNING_REFERENCE_ to skin meshes with the plain scalar code
+/** It walks the joints and adds the pull of each weight to its vertex, without
+the influence tables, SSE2 or worker threads. It is slow and only meant to check
+the results of the normal software skinning. */
+//#define _IRR_COMPILE_WITH_SKINNING_REFERENCE_
+#ifdef NO_IRR_COMPILE_WITH_SKINNING_REFERENCE_
+#undef _IRR_COMPILE_WITH_SKINNING_REFERENCE_
+#endif
 //! Define _IRR_COMPILE_WITH_B3D_LOADER_ if you want to use Blitz3D files
 #define _IRR_COMPILE_WITH_B3D_LOADER_
 #ifdef NO_IRR_COMPILE_WITH_B3D_LOADER_
@@ -711,6 +729,19 @@ B3D, MS3D or X meshes */
 #undef _IRR_COMPILE_WITH_TGA_WRITER_
 #endif
 
+//! Define _IRR_COMPILE_WITH_MAPPED_READ_FILE_ if you want to map files from disk into memory
+/** The contents of mapped files and of the uncompressed files in archives
+opened from them are available with IReadFile::getData() without copying.
+Mapping still has to be enabled with IFileSystem::setFileMapping(), as
+truncating a mapped file from another process crashes the application.
+Only supported with the posix API. */
+#if defined(_IRR_POSIX_API_) && !defined(_IRR_WCHAR_FILESYSTEM)
+#define _IRR_COMPILE_WITH_MAPPED_READ_FILE_
+#endif
+#ifdef NO_IRR_COMPILE_WITH_MAPPED_READ_FILE_
+#undef _IRR_COMPILE_WITH_MAPPED_READ_FILE_
+#endif
+
 //! Define __IRR_COMPILE_WITH_ZIP_ARCHIVE_LOADER_ if you want to open ZIP and GZIP archives
 /** ZIP reading has several more options below to configure. */
 #define __IRR_COMPILE_WITH_ZIP_ARCHIVE_LOADER_
@@ -48,6 +48,7 @@ namespace irr
 #endif
 			DisplayAdapter(0),
 			DriverMultithreaded(false),
+			WorkerThreads(0),
 			UsePerformanceTimer(true),
 			SDK_version_do_not_use(IRRLICHT_SDK_VERSION),
 			PrivateData(0),
@@ -85,10 +86,12 @@ namespace irr
 			WindowId = other.WindowId;
 			LoggingLevel = other.LoggingLevel;
 			DriverMultithreaded = other.DriverMultithreaded;
+			WorkerThreads = other.WorkerThreads;
 			DisplayAdapter = other.DisplayAdapter;
 			UsePerformanceTimer = other.UsePerformanceTimer;
 			PrivateData = other.PrivateData;
 			OGLES2ShaderPath = other.OGLES2ShaderPath;
+			MipMapCachePath = other.MipMapCachePath;
 			return *this;
 		}
 
@@ -292,6 +295,14 @@ namespace irr
 			So far only supported on D3D. */
 		bool DriverMultithreaded;
 
+		//! Number of worker threads the engine may use for internal jobs.
+		/** Default is 0, which keeps all work on the thread calling the
+		engine. Currently used by the Burning's Video driver, which renders
+		in screen bands on all threads when this is not 0. The results are
+		the same as with single threaded rendering. Only available when
+		compiled with _IRR_COMPILE_WITH_THREADS_. */
+		u32 WorkerThreads;
+
 		//! Enables use of high performance timers on Windows platform.
 		/** When performance timers are not used, standard GetTickCount()
 		is used instead which usually has worse resolution, but also less
@@ -314,6 +325,15 @@ namespace irr
 		/** This is about the shaders which can be found in media/Shaders by default. It's only necessary
 		to set when using OGL-ES 2.0 */
 		irr::io::path OGLES2ShaderPath;
+
+		//! Directory where generated mipmap levels are cached.
+		/** Default is empty, which disables the cache. Otherwise the
+		mipmap chain of each texture is written to a file in this directory,
+		named after a hash of the texture content, and read back the next
+		time the same texture is created instead of filtering it again.
+		The directory has to exist. So far only used by the Burning's Video
+		driver. */
+		irr::io::path MipMapCachePath;
 	};
 
 
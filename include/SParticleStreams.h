@@ -0,0 +1,174 @@
+// Copyright (C) 2002-2012 Nikolaus Gebhardt
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#ifndef __S_PARTICLE_STREAMS_H_INCLUDED__
+#define __S_PARTICLE_STREAMS_H_INCLUDED__
+
+#include "SParticle.h"
+#include "irrArray.h"
+
+namespace irr
+{
+namespace scene
+{
+	//! Particles stored with one array for each of their values.
+	/** This is the structure of arrays layout of SParticle, which is used
+	by the particle system scene node. Affectors can process several
+	particles at once with SIMD instructions when they work on the arrays
+	directly. All arrays always have the same size. The order of the
+	particles is not stable, removing a particle moves the last one into
+	its place. */
+	struct SParticleStreams
+	{
+		//! Position of the particles
+		core::array<f32> PosX, PosY, PosZ;
+
+		//! Direction and speed of the particles
+		core::array<f32> VectorX, VectorY, VectorZ;
+
+		//! Original direction and speed of the particles
+		core::array<f32> StartVectorX, StartVectorY, StartVectorZ;
+
+		//! Start life time of the particles
+		core::array<u32> StartTime;
+
+		//! End life time of the particles
+		core::array<u32> EndTime;
+
+		//! Current color of the particles
+		core::array<video::SColor> Color;
+
+		//! Original color of the particles
+		core::array<video::SColor> StartColor;
+
+		//! Current scale of the particles
+		core::array<f32> Width, Height;
+
+		//! Original scale of the particles
+		core::array<f32> StartWidth, StartHeight;
+
+		//! Returns the amount of particles
+		u32 size() const
+		{
+			return PosX.size();
+		}
+
+		//! Sets the amount of particles, new particles are not initialized.
+		/** The arrays grow by doubling their size, so adding particles
+		one by one is not slow. */
+		void set_used(u32 count)
+		{
+			grow(PosX, count);
+			grow(PosY, count);
+			grow(PosZ, count);
+			grow(VectorX, count);
+			grow(VectorY, count);
+			grow(VectorZ, count);
+			grow(StartVectorX, count);
+			grow(StartVectorY, count);
+			grow(StartVectorZ, count);
+			grow(StartTime, count);
+			grow(EndTime, count);
+			grow(Color, count);
+			grow(StartColor, count);
+			grow(Width, count);
+			grow(Height, count);
+			grow(StartWidth, count);
+			grow(StartHeight, count);
+		}
+
+		//! Removes all particles, keeps the memory.
+		void clear()
+		{
+			set_used(0);
+		}
+
+		//! Adds a particle at the end.
+		void push_back(const SParticle& particle)
+		{
+			const u32 index = size();
+			set_used(index+1);
+			setParticle(index, particle);
+		}
+
+		//! Copies a particle into a SParticle struct.
+		void getParticle(u32 index, SParticle& particle) const
+		{
+			particle.pos.set(PosX[index], PosY[index], PosZ[index]);
+			particle.vector.set(VectorX[index], VectorY[index], VectorZ[index]);
+			particle.startVector.set(StartVectorX[index], StartVectorY[index], StartVectorZ[index]);
+			particle.startTime = StartTime[index];
+			particle.endTime = EndTime[index];
+			particle.color = Color[index];
+			particle.startColor = StartColor[index];
+			particle.size.set(Width[index], Height[index]);
+			particle.startSize.set(StartWidth[index], StartHeight[index]);
+		}
+
+		//! Sets all values of a particle.
+		void setParticle(u32 index, const SParticle& particle)
+		{
+			PosX[index] = particle.pos.X;
+			PosY[index] = particle.pos.Y;
+			PosZ[index] = particle.pos.Z;
+			VectorX[index] = particle.vector.X;
+			VectorY[index] = particle.vector.Y;
+			VectorZ[index] = particle.vector.Z;
+			StartVectorX[index] = particle.startVector.X;
+			StartVectorY[index] = particle.startVector.Y;
+			StartVectorZ[index] = particle.startVector.Z;
+			StartTime[index] = particle.startTime;
+			EndTime[index] = particle.endTime;
+			Color[index] = particle.color;
+			StartColor[index] = particle.startColor;
+			Width[index] = particle.size.Width;
+			Height[index] = particle.size.Height;
+			StartWidth[index] = particle.startSize.Width;
+			StartHeight[index] = particle.startSize.Height;
+		}
+
+		//! Removes a particle by moving the last particle into its place.
+		void swapRemove(u32 index)
+		{
+			const u32 last = size()-1;
+			if (index != last)
+			{
+				PosX[index] = PosX[last];
+				PosY[index] = PosY[last];
+				PosZ[index] = PosZ[last];
+				VectorX[index] = VectorX[last];
+				VectorY[index] = VectorY[last];
+				VectorZ[index] = VectorZ[last];
+				StartVectorX[index] = StartVectorX[last];
+				StartVectorY[index] = StartVectorY[last];
+				StartVectorZ[index] = StartVectorZ[last];
+				StartTime[index] = StartTime[last];
+				EndTime[index] = EndTime[last];
+				Color[index] = Color[last];
+				StartColor[index] = StartColor[last];
+				Width[index] = Width[last];
+				Height[index] = Height[last];
+				StartWidth[index] = StartWidth[last];
+				StartHeight[index] = StartHeight[last];
+			}
+			set_used(last);
+		}
+
+	private:
+
+		template <class T>
+		static void grow(core::array<T>& values, u32 count)
+		{
+			if (values.allocated_size() < count)
+				values.reallocate(core::max_(count, values.allocated_size()*2));
+			values.set_used(count);
+		}
+	};
+
+
+} // end namespace scene
+} // end namespace irr
+
+#endif
+
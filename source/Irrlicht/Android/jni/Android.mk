@@ -124,6 +124,7 @@ LOCAL_SRC_FILES := \
 					CIrrMeshWriter.cpp \
 					CLightSceneNode.cpp \
 					CLimitReadFile.cpp \
+					CMappedReadFile.cpp \
 					CLMTSMeshFileLoader.cpp \
 					CLogger.cpp \
 					CLWOMeshFileLoader.cpp \
@@ -181,12 +182,17 @@ LOCAL_SRC_FILES := \
 					CPLYMeshFileLoader.cpp \
 					CPLYMeshWriter.cpp \
 					CProfiler.cpp \
+					CJobPool.cpp \
 					CQ3LevelMesh.cpp \
 					CQuake3ShaderSceneNode.cpp \
 					CReadFile.cpp \
 					CSceneCollisionManager.cpp \
 					CSceneLoaderIrr.cpp \
 					CSceneManager.cpp \
+					CSceneNodeTransformStore.cpp \
+					CRenderQueue.cpp \
+					CStaticBatchSceneNode.cpp \
+					CInstancedMeshSceneNode.cpp \
 					CSceneNodeAnimatorCameraFPS.cpp \
 					CSceneNodeAnimatorCameraMaya.cpp \
 					CSceneNodeAnimatorCollisionResponse.cpp \
@@ -210,6 +216,7 @@ LOCAL_SRC_FILES := \
 					CSTLMeshWriter.cpp \
 					CTarReader.cpp \
 					CTerrainSceneNode.cpp \
+					CPagedTerrainSceneNode.cpp \
 					CTerrainTriangleSelector.cpp \
 					CTextSceneNode.cpp \
 					CTRFlat.cpp \
@@ -224,6 +231,7 @@ LOCAL_SRC_FILES := \
 					CTRNormalMap.cpp \
 					CTRStencilShadow.cpp \
 					CTRTextureBlend.cpp \
+					CTROcclusionQuery.cpp \
 					CTRTextureDetailMap2.cpp \
 					CTRTextureFlat.cpp \
 					CTRTextureFlatWire.cpp \
@@ -254,6 +262,7 @@ LOCAL_SRC_FILES := \
 					CXMLWriter.cpp \
 					CZBuffer.cpp \
 					CZipReader.cpp \
+					CZipStreamReadFile.cpp \
 					IBurningShader.cpp \
 					Irrlicht.cpp \
 					irrXML.cpp \
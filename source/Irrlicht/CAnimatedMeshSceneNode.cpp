@@ -10,6 +10,7 @@
 #include "CShadowVolumeSceneNode.h"
 #include "IAnimatedMeshMD3.h"
 #include "CSkinnedMesh.h"
+#include "CNullDriver.h"
 #include "IDummyTransformationSceneNode.h"
 #include "IBoneSceneNode.h"
 #include "IMaterialRenderer.h"
@@ -210,7 +211,8 @@ IMesh * CAnimatedMeshSceneNode::getMeshForCurrentFrame()
 			skinnedMesh->animateMesh(getFrameNr(), 1.0f);
 
 		// Update the skinned mesh for the current joint transforms.
-		skinnedMesh->skinMesh();
+		video::CNullDriver* driver = static_cast<video::CNullDriver*>(SceneManager->getVideoDriver());
+		skinnedMesh->skinMesh(driver ? driver->getJobPool() : 0);
 
 		if (JointMode == EJUOR_READ)//read from mesh
 		{
@@ -39,6 +39,9 @@ namespace scene
 		//! OnAnimate() is called just before rendering the whole scene.
 		virtual void OnAnimate(u32 timeMs) _IRR_OVERRIDE_;
 
+		//! OnAnimate uses the mesh, which may be shared, so it stays on the main thread
+		virtual bool isAnimationThreadSafe() const _IRR_OVERRIDE_ { return false; }
+
 		//! renders the node.
 		virtual void render() _IRR_OVERRIDE_;
 
@@ -141,6 +144,9 @@ namespace scene
 		//! updates the absolute position based on the relative and the parents position
 		virtual void updateAbsolutePosition() _IRR_OVERRIDE_;
 
+		//! updateAbsolutePosition also updates the MD3 tags
+		virtual bool hasDefaultTransformation() const _IRR_OVERRIDE_ { return false; }
+
 
 		//! Set the joint update mode (0-unused, 1-get joints only, 2-set joints only, 3-move and set)
 		virtual void setJointMode(E_JOINT_UPDATE_ON_RENDER mode) _IRR_OVERRIDE_;
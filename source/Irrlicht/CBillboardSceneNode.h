@@ -81,6 +81,12 @@ public:
 	//! Returns type of the scene node
 	virtual ESCENE_NODE_TYPE getType() const _IRR_OVERRIDE_ { return ESNT_BILLBOARD; }
 
+	//! Billboards are turned to the camera when rendered, not in OnAnimate
+	virtual bool isAnimationThreadSafe() const _IRR_OVERRIDE_ { return true; }
+
+	//! Billboards use the default transformation
+	virtual bool hasDefaultTransformation() const _IRR_OVERRIDE_ { return true; }
+
 	//! Creates a clone of this scene node and its children.
 	virtual ISceneNode* clone(ISceneNode* newParent=0, ISceneManager* newManager=0) _IRR_OVERRIDE_;
 
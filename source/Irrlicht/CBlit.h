@@ -7,6 +7,15 @@
 
 #include "SoftwareDriver2_helper.h"
 
+#if defined ( SOFTWARE_DRIVER_2_BLIT_AVX2 )
+	#include <immintrin.h>
+	#if defined ( _MSC_VER )
+		#include <intrin.h>
+	#endif
+#elif defined ( SOFTWARE_DRIVER_2_BLIT_SSE2 )
+	#include <emmintrin.h>
+#endif
+
 namespace irr
 {
 
@@ -1141,6 +1150,509 @@ static void executeBlit_TextureCombineColor_32_to_32( const SBlitJob * job )
 	}
 }
 
+#if defined ( SOFTWARE_DRIVER_2_BLIT_SSE2 )
+
+/*
+	SIMD versions of the 32 bit blitters. They follow the arithmetic of
+	PixelBlend32, PixelMul32_2 and PixelCombine32 exactly, including the carries
+	between the packed channels, so the results are bit identical to the
+	scalar blitters above. The remaining pixels of a row use the scalar code.
+*/
+
+//! low 32 bits of v * f, f holds a factor below 65536 in both 16 bit halves
+static inline __m128i mul32_SSE2 ( const __m128i v, const __m128i f )
+{
+	const __m128i lo = _mm_mullo_epi16 ( v, f );
+	const __m128i hi = _mm_mulhi_epu16 ( v, f );
+	return _mm_add_epi32 ( lo, _mm_slli_epi32 ( hi, 16 ) );
+}
+
+//! extractAlpha, the result is in both 16 bit halves
+static inline __m128i extractAlpha_SSE2 ( const __m128i c )
+{
+	const __m128i a = _mm_add_epi32 ( _mm_srli_epi32 ( c, 24 ), _mm_srli_epi32 ( c, 31 ) );
+	return _mm_or_si128 ( a, _mm_slli_epi32 ( a, 16 ) );
+}
+
+//! PixelBlend32 with given alpha
+static inline __m128i PixelBlend32_SSE2 ( const __m128i c2, const __m128i c1, const __m128i alpha )
+{
+	const __m128i maskRB = _mm_set1_epi32 ( 0x00FF00FF );
+	const __m128i maskXG = _mm_set1_epi32 ( 0x0000FF00 );
+
+	const __m128i dstRB = _mm_and_si128 ( c2, maskRB );
+	const __m128i dstXG = _mm_and_si128 ( c2, maskXG );
+
+	__m128i rb = _mm_sub_epi32 ( _mm_and_si128 ( c1, maskRB ), dstRB );
+	__m128i xg = _mm_sub_epi32 ( _mm_and_si128 ( c1, maskXG ), dstXG );
+
+	rb = _mm_srli_epi32 ( mul32_SSE2 ( rb, alpha ), 8 );
+	xg = _mm_srli_epi32 ( mul32_SSE2 ( xg, alpha ), 8 );
+
+	rb = _mm_and_si128 ( _mm_add_epi32 ( rb, dstRB ), maskRB );
+	xg = _mm_and_si128 ( _mm_add_epi32 ( xg, dstXG ), maskXG );
+
+	return _mm_or_si128 ( rb, xg );
+}
+
+//! PixelBlend32 with source alpha
+static inline __m128i PixelBlend32_SSE2 ( const __m128i c2, const __m128i c1 )
+{
+	const __m128i srcA = _mm_and_si128 ( c1, _mm_set1_epi32 ( 0xFF000000 ) );
+	const __m128i color = _mm_or_si128 ( srcA, PixelBlend32_SSE2 ( c2, c1, extractAlpha_SSE2 ( c1 ) ) );
+
+	// alpha test. an opaque source gives the source already
+	const __m128i keep = _mm_cmpeq_epi32 ( srcA, _mm_setzero_si128 () );
+	return _mm_or_si128 ( _mm_and_si128 ( keep, c2 ), _mm_andnot_si128 ( keep, color ) );
+}
+
+//! PixelCombine32
+static inline __m128i PixelCombine32_SSE2 ( const __m128i c2, const __m128i c1 )
+{
+	const __m128i alpha = extractAlpha_SSE2 ( c1 );
+	const __m128i color = PixelBlend32_SSE2 ( c2, c1, alpha );
+
+	// ( sa * 256 + da * ( 256 - alpha ) ) >> 8, all products fit in 16 bit
+	const __m128i sa = _mm_srli_epi32 ( c1, 24 );
+	const __m128i da = _mm_srli_epi32 ( c2, 24 );
+	const __m128i inv = _mm_sub_epi32 ( _mm_set1_epi32 ( 256 ), _mm_srli_epi32 ( alpha, 16 ) );
+	const __m128i blendAlpha = _mm_srli_epi32 ( _mm_add_epi32 ( _mm_slli_epi32 ( sa, 8 ), _mm_mullo_epi16 ( da, inv ) ), 8 );
+
+	const __m128i keep = _mm_cmpeq_epi32 ( sa, _mm_setzero_si128 () );
+	return _mm_or_si128 ( _mm_and_si128 ( keep, c2 ),
+		_mm_andnot_si128 ( keep, _mm_or_si128 ( _mm_slli_epi32 ( blendAlpha, 24 ), color ) ) );
+}
+
+//! PixelMul32_2, c1 holds the channels of one color as 16 bit values, twice
+static inline __m128i PixelMul32_2_SSE2 ( const __m128i c0, const __m128i c1 )
+{
+	const __m128i zero = _mm_setzero_si128 ();
+	const __m128i lo = _mm_srli_epi16 ( _mm_mullo_epi16 ( _mm_unpacklo_epi8 ( c0, zero ), c1 ), 8 );
+	const __m128i hi = _mm_srli_epi16 ( _mm_mullo_epi16 ( _mm_unpackhi_epi8 ( c0, zero ), c1 ), 8 );
+	return _mm_packus_epi16 ( lo, hi );
+}
+
+/*!
+*/
+static void executeBlit_TextureBlend_32_to_32_SSE2( const SBlitJob * job )
+{
+	if ( job->stretch )
+	{
+		executeBlit_TextureBlend_32_to_32 ( job );
+		return;
+	}
+
+	const u32 w = job->width;
+	const u32 w4 = w & ~3;
+	const u32 *src = (u32*) job->src;
+	u32 *dst = (u32*) job->dst;
+
+	const __m128i maskA = _mm_set1_epi32 ( 0xFF000000 );
+	const __m128i zero = _mm_setzero_si128 ();
+
+	for ( s32 dy = 0; dy != job->height; ++dy )
+	{
+		u32 dx;
+		for ( dx = 0; dx != w4; dx += 4 )
+		{
+			const __m128i s = _mm_loadu_si128 ( (const __m128i*) ( src + dx ) );
+			const __m128i a = _mm_and_si128 ( s, maskA );
+
+			// skip transparent and copy opaque pixels, common in gui images
+			if ( 0xFFFF == _mm_movemask_epi8 ( _mm_cmpeq_epi32 ( a, zero ) ) )
+				continue;
+			if ( 0xFFFF == _mm_movemask_epi8 ( _mm_cmpeq_epi32 ( a, maskA ) ) )
+			{
+				_mm_storeu_si128 ( (__m128i*) ( dst + dx ), s );
+				continue;
+			}
+
+			const __m128i d = _mm_loadu_si128 ( (const __m128i*) ( dst + dx ) );
+			_mm_storeu_si128 ( (__m128i*) ( dst + dx ), PixelBlend32_SSE2 ( d, s ) );
+		}
+		for ( ; dx != w; ++dx )
+		{
+			dst[dx] = PixelBlend32( dst[dx], src[dx] );
+		}
+		src = (u32*) ( (u8*) (src) + job->srcPitch );
+		dst = (u32*) ( (u8*) (dst) + job->dstPitch );
+	}
+}
+
+/*!
+*/
+static void executeBlit_TextureBlendColor_32_to_32_SSE2( const SBlitJob * job )
+{
+	const u32 w = job->width;
+	const u32 w4 = w & ~3;
+	u32 *src = (u32*) job->src;
+	u32 *dst = (u32*) job->dst;
+
+	const __m128i color = _mm_unpacklo_epi8 ( _mm_set1_epi32 ( job->argb ), _mm_setzero_si128 () );
+
+	for ( s32 dy = 0; dy != job->height; ++dy )
+	{
+		u32 dx;
+		for ( dx = 0; dx != w4; dx += 4 )
+		{
+			const __m128i s = _mm_loadu_si128 ( (const __m128i*) ( src + dx ) );
+			const __m128i d = _mm_loadu_si128 ( (const __m128i*) ( dst + dx ) );
+			_mm_storeu_si128 ( (__m128i*) ( dst + dx ), PixelBlend32_SSE2 ( d, PixelMul32_2_SSE2 ( s, color ) ) );
+		}
+		for ( ; dx != w; ++dx )
+		{
+			dst[dx] = PixelBlend32( dst[dx], PixelMul32_2( src[dx], job->argb ) );
+		}
+		src = (u32*) ( (u8*) (src) + job->srcPitch );
+		dst = (u32*) ( (u8*) (dst) + job->dstPitch );
+	}
+}
+
+/*!
+*/
+static void executeBlit_Color_32_to_32_SSE2( const SBlitJob * job )
+{
+	const u32 w = job->width;
+	const u32 w4 = w & ~3;
+	u32 *dst = (u32*) job->dst;
+
+	const __m128i c = _mm_set1_epi32 ( job->argb );
+
+	for ( s32 dy = 0; dy != job->height; ++dy )
+	{
+		u32 dx;
+		for ( dx = 0; dx != w4; dx += 4 )
+		{
+			_mm_storeu_si128 ( (__m128i*) ( dst + dx ), c );
+		}
+		for ( ; dx != w; ++dx )
+		{
+			dst[dx] = job->argb;
+		}
+		dst = (u32*) ( (u8*) (dst) + job->dstPitch );
+	}
+}
+
+/*!
+*/
+static void executeBlit_ColorAlpha_32_to_32_SSE2( const SBlitJob * job )
+{
+	const u32 w = job->width;
+	const u32 w4 = w & ~3;
+	u32 *dst = (u32*) job->dst;
+
+	const u32 alpha = extractAlpha( job->argb );
+	const u32 src = job->argb;
+
+	const __m128i a = _mm_set1_epi32 ( alpha | ( alpha << 16 ) );
+	const __m128i s = _mm_set1_epi32 ( src );
+	const __m128i srcA = _mm_set1_epi32 ( src & 0xFF000000 );
+
+	for ( s32 dy = 0; dy != job->height; ++dy )
+	{
+		u32 dx;
+		for ( dx = 0; dx != w4; dx += 4 )
+		{
+			const __m128i d = _mm_loadu_si128 ( (const __m128i*) ( dst + dx ) );
+			_mm_storeu_si128 ( (__m128i*) ( dst + dx ), _mm_or_si128 ( srcA, PixelBlend32_SSE2 ( d, s, a ) ) );
+		}
+		for ( ; dx != w; ++dx )
+		{
+			dst[dx] = (job->argb & 0xFF000000 ) | PixelBlend32( dst[dx], src, alpha );
+		}
+		dst = (u32*) ( (u8*) (dst) + job->dstPitch );
+	}
+}
+
+/*!
+	Combine alpha channels (increases alpha / reduces transparency)
+*/
+static void executeBlit_TextureCombineColor_32_to_32_SSE2( const SBlitJob * job )
+{
+	const u32 w = job->width;
+	const u32 w4 = w & ~3;
+	u32 *src = (u32*) job->src;
+	u32 *dst = (u32*) job->dst;
+
+	const __m128i color = _mm_unpacklo_epi8 ( _mm_set1_epi32 ( job->argb ), _mm_setzero_si128 () );
+
+	for ( s32 dy = 0; dy != job->height; ++dy )
+	{
+		u32 dx;
+		for ( dx = 0; dx != w4; dx += 4 )
+		{
+			const __m128i s = _mm_loadu_si128 ( (const __m128i*) ( src + dx ) );
+			const __m128i d = _mm_loadu_si128 ( (const __m128i*) ( dst + dx ) );
+			_mm_storeu_si128 ( (__m128i*) ( dst + dx ), PixelCombine32_SSE2 ( d, PixelMul32_2_SSE2 ( s, color ) ) );
+		}
+		for ( ; dx != w; ++dx )
+		{
+			dst[dx] = PixelCombine32( dst[dx], PixelMul32_2( src[dx], job->argb ) );
+		}
+		src = (u32*) ( (u8*) (src) + job->srcPitch );
+		dst = (u32*) ( (u8*) (dst) + job->dstPitch );
+	}
+}
+
+#endif // SOFTWARE_DRIVER_2_BLIT_SSE2
+
+#if defined ( SOFTWARE_DRIVER_2_BLIT_AVX2 )
+
+// the avx2 code is compiled without -mavx2, only called when the cpu has it
+#if defined ( _MSC_VER )
+	#define BLIT_AVX2
+#else
+	#define BLIT_AVX2 __attribute__ ((target ("avx2")))
+#endif
+
+//! returns true if cpu and os support avx2
+static inline bool cpuHasAVX2()
+{
+#if defined ( _MSC_VER )
+	int info[4];
+	__cpuid ( info, 0 );
+	if ( info[0] < 7 )
+		return false;
+
+	// osxsave and avx, the os saves the ymm registers
+	__cpuid ( info, 1 );
+	if ( ( info[2] & 0x18000000 ) != 0x18000000 || ( _xgetbv ( 0 ) & 6 ) != 6 )
+		return false;
+
+	__cpuidex ( info, 7, 0 );
+	return ( info[1] & 0x20 ) != 0;
+#else
+	__builtin_cpu_init ();
+	return __builtin_cpu_supports ( "avx2" ) != 0;
+#endif
+}
+
+//! PixelBlend32 with given alpha, eight pixels
+static inline BLIT_AVX2 __m256i PixelBlend32_AVX2 ( const __m256i c2, const __m256i c1, const __m256i alpha )
+{
+	const __m256i maskRB = _mm256_set1_epi32 ( 0x00FF00FF );
+	const __m256i maskXG = _mm256_set1_epi32 ( 0x0000FF00 );
+
+	const __m256i dstRB = _mm256_and_si256 ( c2, maskRB );
+	const __m256i dstXG = _mm256_and_si256 ( c2, maskXG );
+
+	__m256i rb = _mm256_sub_epi32 ( _mm256_and_si256 ( c1, maskRB ), dstRB );
+	__m256i xg = _mm256_sub_epi32 ( _mm256_and_si256 ( c1, maskXG ), dstXG );
+
+	rb = _mm256_srli_epi32 ( _mm256_mullo_epi32 ( rb, alpha ), 8 );
+	xg = _mm256_srli_epi32 ( _mm256_mullo_epi32 ( xg, alpha ), 8 );
+
+	rb = _mm256_and_si256 ( _mm256_add_epi32 ( rb, dstRB ), maskRB );
+	xg = _mm256_and_si256 ( _mm256_add_epi32 ( xg, dstXG ), maskXG );
+
+	return _mm256_or_si256 ( rb, xg );
+}
+
+//! extractAlpha, eight pixels
+static inline BLIT_AVX2 __m256i extractAlpha_AVX2 ( const __m256i c )
+{
+	return _mm256_add_epi32 ( _mm256_srli_epi32 ( c, 24 ), _mm256_srli_epi32 ( c, 31 ) );
+}
+
+//! PixelBlend32 with source alpha, eight pixels
+static inline BLIT_AVX2 __m256i PixelBlend32_AVX2 ( const __m256i c2, const __m256i c1 )
+{
+	const __m256i srcA = _mm256_and_si256 ( c1, _mm256_set1_epi32 ( 0xFF000000 ) );
+	const __m256i color = _mm256_or_si256 ( srcA, PixelBlend32_AVX2 ( c2, c1, extractAlpha_AVX2 ( c1 ) ) );
+
+	// alpha test. an opaque source gives the source already
+	const __m256i keep = _mm256_cmpeq_epi32 ( srcA, _mm256_setzero_si256 () );
+	return _mm256_blendv_epi8 ( color, c2, keep );
+}
+
+//! PixelCombine32, eight pixels
+static inline BLIT_AVX2 __m256i PixelCombine32_AVX2 ( const __m256i c2, const __m256i c1 )
+{
+	const __m256i alpha = extractAlpha_AVX2 ( c1 );
+	const __m256i color = PixelBlend32_AVX2 ( c2, c1, alpha );
+
+	const __m256i sa = _mm256_srli_epi32 ( c1, 24 );
+	const __m256i da = _mm256_srli_epi32 ( c2, 24 );
+	const __m256i inv = _mm256_sub_epi32 ( _mm256_set1_epi32 ( 256 ), alpha );
+	const __m256i blendAlpha = _mm256_srli_epi32 ( _mm256_add_epi32 ( _mm256_slli_epi32 ( sa, 8 ), _mm256_mullo_epi32 ( da, inv ) ), 8 );
+
+	const __m256i keep = _mm256_cmpeq_epi32 ( sa, _mm256_setzero_si256 () );
+	return _mm256_blendv_epi8 ( _mm256_or_si256 ( _mm256_slli_epi32 ( blendAlpha, 24 ), color ), c2, keep );
+}
+
+//! PixelMul32_2, c1 holds the channels of one color as 16 bit values, four times
+static inline BLIT_AVX2 __m256i PixelMul32_2_AVX2 ( const __m256i c0, const __m256i c1 )
+{
+	const __m256i zero = _mm256_setzero_si256 ();
+	const __m256i lo = _mm256_srli_epi16 ( _mm256_mullo_epi16 ( _mm256_unpacklo_epi8 ( c0, zero ), c1 ), 8 );
+	const __m256i hi = _mm256_srli_epi16 ( _mm256_mullo_epi16 ( _mm256_unpackhi_epi8 ( c0, zero ), c1 ), 8 );
+	return _mm256_packus_epi16 ( lo, hi );
+}
+
+/*!
+*/
+static BLIT_AVX2 void executeBlit_TextureBlend_32_to_32_AVX2( const SBlitJob * job )
+{
+	if ( job->stretch )
+	{
+		executeBlit_TextureBlend_32_to_32 ( job );
+		return;
+	}
+
+	const u32 w = job->width;
+	const u32 w8 = w & ~7;
+	const u32 *src = (u32*) job->src;
+	u32 *dst = (u32*) job->dst;
+
+	const __m256i maskA = _mm256_set1_epi32 ( 0xFF000000 );
+	const __m256i zero = _mm256_setzero_si256 ();
+
+	for ( s32 dy = 0; dy != job->height; ++dy )
+	{
+		u32 dx;
+		for ( dx = 0; dx != w8; dx += 8 )
+		{
+			const __m256i s = _mm256_loadu_si256 ( (const __m256i*) ( src + dx ) );
+			const __m256i a = _mm256_and_si256 ( s, maskA );
+
+			// skip transparent and copy opaque pixels, common in gui images
+			if ( -1 == _mm256_movemask_epi8 ( _mm256_cmpeq_epi32 ( a, zero ) ) )
+				continue;
+			if ( -1 == _mm256_movemask_epi8 ( _mm256_cmpeq_epi32 ( a, maskA ) ) )
+			{
+				_mm256_storeu_si256 ( (__m256i*) ( dst + dx ), s );
+				continue;
+			}
+
+			const __m256i d = _mm256_loadu_si256 ( (const __m256i*) ( dst + dx ) );
+			_mm256_storeu_si256 ( (__m256i*) ( dst + dx ), PixelBlend32_AVX2 ( d, s ) );
+		}
+		for ( ; dx != w; ++dx )
+		{
+			dst[dx] = PixelBlend32( dst[dx], src[dx] );
+		}
+		src = (u32*) ( (u8*) (src) + job->srcPitch );
+		dst = (u32*) ( (u8*) (dst) + job->dstPitch );
+	}
+}
+
+/*!
+*/
+static BLIT_AVX2 void executeBlit_TextureBlendColor_32_to_32_AVX2( const SBlitJob * job )
+{
+	const u32 w = job->width;
+	const u32 w8 = w & ~7;
+	u32 *src = (u32*) job->src;
+	u32 *dst = (u32*) job->dst;
+
+	const __m256i color = _mm256_unpacklo_epi8 ( _mm256_set1_epi32 ( job->argb ), _mm256_setzero_si256 () );
+
+	for ( s32 dy = 0; dy != job->height; ++dy )
+	{
+		u32 dx;
+		for ( dx = 0; dx != w8; dx += 8 )
+		{
+			const __m256i s = _mm256_loadu_si256 ( (const __m256i*) ( src + dx ) );
+			const __m256i d = _mm256_loadu_si256 ( (const __m256i*) ( dst + dx ) );
+			_mm256_storeu_si256 ( (__m256i*) ( dst + dx ), PixelBlend32_AVX2 ( d, PixelMul32_2_AVX2 ( s, color ) ) );
+		}
+		for ( ; dx != w; ++dx )
+		{
+			dst[dx] = PixelBlend32( dst[dx], PixelMul32_2( src[dx], job->argb ) );
+		}
+		src = (u32*) ( (u8*) (src) + job->srcPitch );
+		dst = (u32*) ( (u8*) (dst) + job->dstPitch );
+	}
+}
+
+/*!
+*/
+static BLIT_AVX2 void executeBlit_Color_32_to_32_AVX2( const SBlitJob * job )
+{
+	const u32 w = job->width;
+	const u32 w8 = w & ~7;
+	u32 *dst = (u32*) job->dst;
+
+	const __m256i c = _mm256_set1_epi32 ( job->argb );
+
+	for ( s32 dy = 0; dy != job->height; ++dy )
+	{
+		u32 dx;
+		for ( dx = 0; dx != w8; dx += 8 )
+		{
+			_mm256_storeu_si256 ( (__m256i*) ( dst + dx ), c );
+		}
+		for ( ; dx != w; ++dx )
+		{
+			dst[dx] = job->argb;
+		}
+		dst = (u32*) ( (u8*) (dst) + job->dstPitch );
+	}
+}
+
+/*!
+*/
+static BLIT_AVX2 void executeBlit_ColorAlpha_32_to_32_AVX2( const SBlitJob * job )
+{
+	const u32 w = job->width;
+	const u32 w8 = w & ~7;
+	u32 *dst = (u32*) job->dst;
+
+	const u32 alpha = extractAlpha( job->argb );
+	const u32 src = job->argb;
+
+	const __m256i a = _mm256_set1_epi32 ( alpha );
+	const __m256i s = _mm256_set1_epi32 ( src );
+	const __m256i srcA = _mm256_set1_epi32 ( src & 0xFF000000 );
+
+	for ( s32 dy = 0; dy != job->height; ++dy )
+	{
+		u32 dx;
+		for ( dx = 0; dx != w8; dx += 8 )
+		{
+			const __m256i d = _mm256_loadu_si256 ( (const __m256i*) ( dst + dx ) );
+			_mm256_storeu_si256 ( (__m256i*) ( dst + dx ), _mm256_or_si256 ( srcA, PixelBlend32_AVX2 ( d, s, a ) ) );
+		}
+		for ( ; dx != w; ++dx )
+		{
+			dst[dx] = (job->argb & 0xFF000000 ) | PixelBlend32( dst[dx], src, alpha );
+		}
+		dst = (u32*) ( (u8*) (dst) + job->dstPitch );
+	}
+}
+
+/*!
+	Combine alpha channels (increases alpha / reduces transparency)
+*/
+static BLIT_AVX2 void executeBlit_TextureCombineColor_32_to_32_AVX2( const SBlitJob * job )
+{
+	const u32 w = job->width;
+	const u32 w8 = w & ~7;
+	u32 *src = (u32*) job->src;
+	u32 *dst = (u32*) job->dst;
+
+	const __m256i color = _mm256_unpacklo_epi8 ( _mm256_set1_epi32 ( job->argb ), _mm256_setzero_si256 () );
+
+	for ( s32 dy = 0; dy != job->height; ++dy )
+	{
+		u32 dx;
+		for ( dx = 0; dx != w8; dx += 8 )
+		{
+			const __m256i s = _mm256_loadu_si256 ( (const __m256i*) ( src + dx ) );
+			const __m256i d = _mm256_loadu_si256 ( (const __m256i*) ( dst + dx ) );
+			_mm256_storeu_si256 ( (__m256i*) ( dst + dx ), PixelCombine32_AVX2 ( d, PixelMul32_2_AVX2 ( s, color ) ) );
+		}
+		for ( ; dx != w; ++dx )
+		{
+			dst[dx] = PixelCombine32( dst[dx], PixelMul32_2( src[dx], job->argb ) );
+		}
+		src = (u32*) ( (u8*) (src) + job->srcPitch );
+		dst = (u32*) ( (u8*) (dst) + job->dstPitch );
+	}
+}
+
+#endif // SOFTWARE_DRIVER_2_BLIT_AVX2
+
 // Blitter Operation
 enum eBlitter
 {
@@ -1194,14 +1706,49 @@ static const blitterTable blitTable[] =
 	{ BLITTER_INVALID, -1, -1, 0 }
 };
 
+#if defined ( SOFTWARE_DRIVER_2_BLIT_SSE2 )
+static const blitterTable blitTableSSE2[] =
+{
+	{ BLITTER_TEXTURE_ALPHA_BLEND, video::ECF_A8R8G8B8, video::ECF_A8R8G8B8, executeBlit_TextureBlend_32_to_32_SSE2 },
+	{ BLITTER_TEXTURE_ALPHA_COLOR_BLEND, video::ECF_A8R8G8B8, video::ECF_A8R8G8B8, executeBlit_TextureBlendColor_32_to_32_SSE2 },
+	{ BLITTER_COLOR, video::ECF_A8R8G8B8, -1, executeBlit_Color_32_to_32_SSE2 },
+	{ BLITTER_COLOR_ALPHA, video::ECF_A8R8G8B8, -1, executeBlit_ColorAlpha_32_to_32_SSE2 },
+	{ BLITTER_TEXTURE_COMBINE_ALPHA, video::ECF_A8R8G8B8, video::ECF_A8R8G8B8, executeBlit_TextureCombineColor_32_to_32_SSE2 },
+	{ BLITTER_INVALID, -1, -1, 0 }
+};
+#endif
 
-static inline tExecuteBlit getBlitter2( eBlitter operation,const video::IImage * dest,const video::IImage * source )
+#if defined ( SOFTWARE_DRIVER_2_BLIT_AVX2 )
+static const blitterTable blitTableAVX2[] =
 {
-	video::ECOLOR_FORMAT sourceFormat = (video::ECOLOR_FORMAT) ( source ? source->getColorFormat() : -1 );
-	video::ECOLOR_FORMAT destFormat = (video::ECOLOR_FORMAT) ( dest ? dest->getColorFormat() : -1 );
+	{ BLITTER_TEXTURE_ALPHA_BLEND, video::ECF_A8R8G8B8, video::ECF_A8R8G8B8, executeBlit_TextureBlend_32_to_32_AVX2 },
+	{ BLITTER_TEXTURE_ALPHA_COLOR_BLEND, video::ECF_A8R8G8B8, video::ECF_A8R8G8B8, executeBlit_TextureBlendColor_32_to_32_AVX2 },
+	{ BLITTER_COLOR, video::ECF_A8R8G8B8, -1, executeBlit_Color_32_to_32_AVX2 },
+	{ BLITTER_COLOR_ALPHA, video::ECF_A8R8G8B8, -1, executeBlit_ColorAlpha_32_to_32_AVX2 },
+	{ BLITTER_TEXTURE_COMBINE_ALPHA, video::ECF_A8R8G8B8, video::ECF_A8R8G8B8, executeBlit_TextureCombineColor_32_to_32_AVX2 },
+	{ BLITTER_INVALID, -1, -1, 0 }
+};
+#endif
 
-	const blitterTable * b = blitTable;
+/*!
+	returns the blitters for the best instruction set of the cpu, chosen once.
+	they are searched before blitTable, which holds the reference versions.
+*/
+static inline const blitterTable* getBlitTableSIMD()
+{
+#if defined ( SOFTWARE_DRIVER_2_BLIT_AVX2 )
+	static const blitterTable* table = cpuHasAVX2() ? blitTableAVX2 : blitTableSSE2;
+	return table;
+#elif defined ( SOFTWARE_DRIVER_2_BLIT_SSE2 )
+	return blitTableSSE2;
+#else
+	return 0;
+#endif
+}
 
+static inline tExecuteBlit findBlitter( const blitterTable * b, eBlitter operation,
+					s32 destFormat, s32 sourceFormat )
+{
 	while ( b->operation != BLITTER_INVALID )
 	{
 		if ( b->operation == operation )
@@ -1219,6 +1766,23 @@ static inline tExecuteBlit getBlitter2( eBlitter operation,const video::IImage *
 }
 
 
+static inline tExecuteBlit getBlitter2( eBlitter operation,const video::IImage * dest,const video::IImage * source )
+{
+	video::ECOLOR_FORMAT sourceFormat = (video::ECOLOR_FORMAT) ( source ? source->getColorFormat() : -1 );
+	video::ECOLOR_FORMAT destFormat = (video::ECOLOR_FORMAT) ( dest ? dest->getColorFormat() : -1 );
+
+	const blitterTable * simd = getBlitTableSIMD();
+	if ( simd )
+	{
+		tExecuteBlit func = findBlitter( simd, operation, destFormat, sourceFormat );
+		if ( func )
+			return func;
+	}
+
+	return findBlitter( blitTable, operation, destFormat, sourceFormat );
+}
+
+
 // bounce clipping to texture
 inline void setClip ( AbsRectangle &out, const core::rect<s32> *clip,
 					const video::IImage * tex, s32 passnative )
@@ -41,6 +41,12 @@ namespace scene
 
 		virtual void OnAnimate(u32 timeMs) _IRR_OVERRIDE_;
 
+		//! Bones are animated by their mesh, so OnAnimate stays on the main thread
+		virtual bool isAnimationThreadSafe() const _IRR_OVERRIDE_ { return false; }
+
+		//! The mesh sets the relative transformation, the absolute one is the default
+		virtual bool hasDefaultTransformation() const _IRR_OVERRIDE_ { return true; }
+
 		virtual void updateAbsolutePositionOfAllChildren() _IRR_OVERRIDE_;
 
 		//! Writes attributes of the scene node.
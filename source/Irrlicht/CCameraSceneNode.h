@@ -139,6 +139,12 @@ namespace scene
 		//! Returns type of the scene node
 		virtual ESCENE_NODE_TYPE getType() const _IRR_OVERRIDE_ { return ESNT_CAMERA; }
 
+		//! The view is updated in OnRegisterSceneNode, not while animating
+		virtual bool isAnimationThreadSafe() const _IRR_OVERRIDE_ { return true; }
+
+		//! The target is not part of the absolute transformation
+		virtual bool hasDefaultTransformation() const _IRR_OVERRIDE_ { return true; }
+
 		//! Binds the camera scene node's rotation to its target position and vice versa, or unbinds them.
 		virtual void bindTargetAndRotation(bool bound) _IRR_OVERRIDE_;
 
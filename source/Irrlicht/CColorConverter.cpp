@@ -6,12 +6,249 @@
 #include "SColor.h"
 #include "os.h"
 #include "irrString.h"
+#include "CJobPool.h"
+
+// SSE2 is the baseline of x86-64. The byte shuffles for the 24 bit formats
+// need SSSE3, that code is compiled with a target attribute and only used
+// when the cpu has it.
+#if !defined(NO_IRR_COLOR_CONVERTER_SSE2_) && !defined(__BIG_ENDIAN__) && \
+	(defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+	#define _IRR_COLOR_CONVERTER_SSE2_
+	#include <emmintrin.h>
+	#if defined(__clang__) || (defined(__GNUC__) && (__GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ >= 9))) || \
+		(defined(_MSC_VER) && _MSC_VER >= 1700)
+		#define _IRR_COLOR_CONVERTER_SSSE3_
+		#include <tmmintrin.h>
+		#if defined(_MSC_VER)
+			#include <intrin.h>
+			#define IRR_TARGET_SSSE3
+		#else
+			#define IRR_TARGET_SSSE3 __attribute__ ((target ("ssse3")))
+		#endif
+	#endif
+#endif
 
 namespace irr
 {
 namespace video
 {
 
+#if defined(_IRR_COLOR_CONVERTER_SSE2_)
+
+// The vectorized loops below convert the bulk of a row and return the
+// number of pixels done, the scalar code converts the rest. The results
+// are identical to the scalar code.
+
+//! 8 bit grey to A8R8G8B8, 16 pixels at once
+static s32 convert8BitTo32Bit_SSE2(const u8* in, u32* out, s32 width)
+{
+	const __m128i alpha = _mm_set1_epi8((char)0xFF);
+	s32 x = 0;
+	for (; x + 16 <= width; x += 16)
+	{
+		const __m128i c = _mm_loadu_si128((const __m128i*)(in + x));
+		const __m128i cc0 = _mm_unpacklo_epi8(c, c);
+		const __m128i cc1 = _mm_unpackhi_epi8(c, c);
+		const __m128i ca0 = _mm_unpacklo_epi8(c, alpha);
+		const __m128i ca1 = _mm_unpackhi_epi8(c, alpha);
+		_mm_storeu_si128((__m128i*)(out + x), _mm_unpacklo_epi16(cc0, ca0));
+		_mm_storeu_si128((__m128i*)(out + x + 4), _mm_unpackhi_epi16(cc0, ca0));
+		_mm_storeu_si128((__m128i*)(out + x + 8), _mm_unpacklo_epi16(cc1, ca1));
+		_mm_storeu_si128((__m128i*)(out + x + 12), _mm_unpackhi_epi16(cc1, ca1));
+	}
+	return x;
+}
+
+//! A1R5G5B5toA8R8G8B8 of four pixels in 32 bit lanes
+static inline __m128i A1R5G5B5toA8R8G8B8_SSE2(const __m128i c)
+{
+	const __m128i a = _mm_and_si128(_mm_srai_epi32(_mm_slli_epi32(c, 16), 31), _mm_set1_epi32(0xFF000000));
+	const __m128i r = _mm_or_si128(_mm_slli_epi32(_mm_and_si128(c, _mm_set1_epi32(0x7C00)), 9),
+		_mm_slli_epi32(_mm_and_si128(c, _mm_set1_epi32(0x7000)), 4));
+	const __m128i g = _mm_or_si128(_mm_slli_epi32(_mm_and_si128(c, _mm_set1_epi32(0x03E0)), 6),
+		_mm_slli_epi32(_mm_and_si128(c, _mm_set1_epi32(0x0380)), 1));
+	const __m128i b = _mm_or_si128(_mm_slli_epi32(_mm_and_si128(c, _mm_set1_epi32(0x001F)), 3),
+		_mm_srli_epi32(_mm_and_si128(c, _mm_set1_epi32(0x001C)), 2));
+	return _mm_or_si128(_mm_or_si128(a, r), _mm_or_si128(g, b));
+}
+
+//! R5G6B5toA8R8G8B8 of four pixels in 32 bit lanes
+static inline __m128i R5G6B5toA8R8G8B8_SSE2(const __m128i c)
+{
+	const __m128i r = _mm_slli_epi32(_mm_and_si128(c, _mm_set1_epi32(0xF800)), 8);
+	const __m128i g = _mm_slli_epi32(_mm_and_si128(c, _mm_set1_epi32(0x07E0)), 5);
+	const __m128i b = _mm_slli_epi32(_mm_and_si128(c, _mm_set1_epi32(0x001F)), 3);
+	return _mm_or_si128(_mm_or_si128(_mm_set1_epi32(0xFF000000), r), _mm_or_si128(g, b));
+}
+
+//! 16 bit to A8R8G8B8, 8 pixels at once
+static s32 convert16To32_SSE2(const u16* in, u32* out, s32 count, bool r5g6b5)
+{
+	const __m128i zero = _mm_setzero_si128();
+	s32 x = 0;
+	for (; x + 8 <= count; x += 8)
+	{
+		const __m128i c = _mm_loadu_si128((const __m128i*)(in + x));
+		const __m128i lo = _mm_unpacklo_epi16(c, zero);
+		const __m128i hi = _mm_unpackhi_epi16(c, zero);
+		if (r5g6b5)
+		{
+			_mm_storeu_si128((__m128i*)(out + x), R5G6B5toA8R8G8B8_SSE2(lo));
+			_mm_storeu_si128((__m128i*)(out + x + 4), R5G6B5toA8R8G8B8_SSE2(hi));
+		}
+		else
+		{
+			_mm_storeu_si128((__m128i*)(out + x), A1R5G5B5toA8R8G8B8_SSE2(lo));
+			_mm_storeu_si128((__m128i*)(out + x + 4), A1R5G5B5toA8R8G8B8_SSE2(hi));
+		}
+	}
+	return x;
+}
+
+//! A8R8G8B8 to 16 bit of four pixels in 32 bit lanes
+static inline __m128i A8R8G8B8to16_SSE2(const __m128i c, bool r5g6b5)
+{
+	__m128i v;
+	if (r5g6b5)
+	{
+		v = _mm_or_si128(_mm_or_si128(
+				_mm_srli_epi32(_mm_and_si128(c, _mm_set1_epi32(0x00F80000)), 8),
+				_mm_srli_epi32(_mm_and_si128(c, _mm_set1_epi32(0x0000FC00)), 5)),
+				_mm_srli_epi32(_mm_and_si128(c, _mm_set1_epi32(0x000000F8)), 3));
+	}
+	else
+	{
+		v = _mm_or_si128(_mm_or_si128(
+				_mm_srli_epi32(_mm_and_si128(c, _mm_set1_epi32(0x80000000)), 16),
+				_mm_srli_epi32(_mm_and_si128(c, _mm_set1_epi32(0x00F80000)), 9)),
+				_mm_or_si128(
+				_mm_srli_epi32(_mm_and_si128(c, _mm_set1_epi32(0x0000F800)), 6),
+				_mm_srli_epi32(_mm_and_si128(c, _mm_set1_epi32(0x000000F8)), 3)));
+	}
+	// sign extend, so the signed saturation of the pack keeps all 16 bits
+	return _mm_srai_epi32(_mm_slli_epi32(v, 16), 16);
+}
+
+//! A8R8G8B8 to 16 bit, 8 pixels at once
+static s32 convert32To16_SSE2(const u32* in, u16* out, s32 count, bool r5g6b5)
+{
+	s32 x = 0;
+	for (; x + 8 <= count; x += 8)
+	{
+		const __m128i lo = A8R8G8B8to16_SSE2(_mm_loadu_si128((const __m128i*)(in + x)), r5g6b5);
+		const __m128i hi = A8R8G8B8to16_SSE2(_mm_loadu_si128((const __m128i*)(in + x + 4)), r5g6b5);
+		_mm_storeu_si128((__m128i*)(out + x), _mm_packs_epi32(lo, hi));
+	}
+	return x;
+}
+
+//! swaps red and blue of A8R8G8B8, or rotates alpha to the low byte. 4 pixels at once
+static s32 convert32To32_SSE2(const u32* in, u32* out, s32 count, bool rotate)
+{
+	const __m128i maskAG = _mm_set1_epi32(0xff00ff00);
+	const __m128i maskB = _mm_set1_epi32(0x000000ff);
+	const __m128i maskR = _mm_set1_epi32(0x00ff0000);
+	s32 x = 0;
+	for (; x + 4 <= count; x += 4)
+	{
+		const __m128i c = _mm_loadu_si128((const __m128i*)(in + x));
+		__m128i v;
+		if (rotate)
+			v = _mm_or_si128(_mm_slli_epi32(c, 8), _mm_srli_epi32(c, 24));
+		else
+			v = _mm_or_si128(_mm_and_si128(c, maskAG),
+				_mm_or_si128(_mm_srli_epi32(_mm_and_si128(c, maskR), 16), _mm_slli_epi32(_mm_and_si128(c, maskB), 16)));
+		_mm_storeu_si128((__m128i*)(out + x), v);
+	}
+	return x;
+}
+
+#endif // _IRR_COLOR_CONVERTER_SSE2_
+
+#if defined(_IRR_COLOR_CONVERTER_SSSE3_)
+
+//! true if the cpu supports SSSE3
+static bool cpuHasSSSE3()
+{
+#if defined(_MSC_VER)
+	int info[4];
+	__cpuid(info, 1);
+	return (info[2] & 0x200) != 0;
+#else
+	__builtin_cpu_init();
+	return __builtin_cpu_supports("ssse3") != 0;
+#endif
+}
+
+static bool hasSSSE3()
+{
+	static const bool ssse3 = cpuHasSSSE3();
+	return ssse3;
+}
+
+// byte shuffles, -1 clears the byte
+static const s8 Shuffle_A8R8G8B8toR8G8B8[16] = { 2,1,0, 6,5,4, 10,9,8, 14,13,12, -1,-1,-1,-1 };
+static const s8 Shuffle_A8R8G8B8toB8G8R8[16] = { 0,1,2, 4,5,6, 8,9,10, 12,13,14, -1,-1,-1,-1 };
+static const s8 Shuffle_R8G8B8toA8R8G8B8[16] = { 2,1,0,-1, 5,4,3,-1, 8,7,6,-1, 11,10,9,-1 };
+static const s8 Shuffle_B8G8R8toA8R8G8B8[16] = { 0,1,2,-1, 3,4,5,-1, 6,7,8,-1, 9,10,11,-1 };
+static const s8 Shuffle_R8G8B8toB8G8R8[16] = { 2,1,0, 5,4,3, 8,7,6, 11,10,9, 14,13,12, 15 };
+static const s8 Shuffle_B8G8R8A8toA8R8G8B8[16] = { 3,2,1,0, 7,6,5,4, 11,10,9,8, 15,14,13,12 };
+
+//! 32 bit to 24 bit, 4 pixels at once. Each store writes 4 bytes ahead
+static IRR_TARGET_SSSE3 s32 convert32To24_SSSE3(const u8* in, u8* out, s32 count, const s8* shuffle)
+{
+	const __m128i mask = _mm_loadu_si128((const __m128i*)shuffle);
+	s32 x = 0;
+	for (; x + 6 <= count; x += 4)
+	{
+		const __m128i c = _mm_loadu_si128((const __m128i*)(in + x * 4));
+		_mm_storeu_si128((__m128i*)(out + x * 3), _mm_shuffle_epi8(c, mask));
+	}
+	return x;
+}
+
+//! 24 bit to 32 bit with opaque alpha, 4 pixels at once. Each load reads 4 bytes ahead
+static IRR_TARGET_SSSE3 s32 convert24To32_SSSE3(const u8* in, u8* out, s32 count, const s8* shuffle)
+{
+	const __m128i mask = _mm_loadu_si128((const __m128i*)shuffle);
+	const __m128i alpha = _mm_set1_epi32(0xFF000000);
+	s32 x = 0;
+	for (; x + 6 <= count; x += 4)
+	{
+		const __m128i c = _mm_loadu_si128((const __m128i*)(in + x * 3));
+		_mm_storeu_si128((__m128i*)(out + x * 4), _mm_or_si128(_mm_shuffle_epi8(c, mask), alpha));
+	}
+	return x;
+}
+
+//! 24 bit to 24 bit, 5 pixels at once. Loads and stores reach one byte ahead
+static IRR_TARGET_SSSE3 s32 convert24To24_SSSE3(const u8* in, u8* out, s32 count, const s8* shuffle)
+{
+	const __m128i mask = _mm_loadu_si128((const __m128i*)shuffle);
+	s32 x = 0;
+	for (; x + 6 <= count; x += 5)
+	{
+		const __m128i c = _mm_loadu_si128((const __m128i*)(in + x * 3));
+		_mm_storeu_si128((__m128i*)(out + x * 3), _mm_shuffle_epi8(c, mask));
+	}
+	return x;
+}
+
+//! 32 bit to 32 bit, 4 pixels at once
+static IRR_TARGET_SSSE3 s32 convert32To32_SSSE3(const u8* in, u8* out, s32 count, const s8* shuffle)
+{
+	const __m128i mask = _mm_loadu_si128((const __m128i*)shuffle);
+	s32 x = 0;
+	for (; x + 4 <= count; x += 4)
+	{
+		const __m128i c = _mm_loadu_si128((const __m128i*)(in + x * 4));
+		_mm_storeu_si128((__m128i*)(out + x * 4), _mm_shuffle_epi8(c, mask));
+	}
+	return x;
+}
+
+#endif // _IRR_COLOR_CONVERTER_SSSE3_
+
 //! converts a monochrome bitmap to A1R5G5B5 data
 void CColorConverter::convert1BitTo16Bit(const u8* in, s16* out, s32 width, s32 height, s32 linepad, bool flip)
 {
@@ -181,7 +418,11 @@ void CColorConverter::convert8BitTo32Bit(const u8* in, u8* out, s32 width, s32 h
 		}
 		else
 		{
-			for (x=0; x < (u32) width; x += 1)
+			x = 0;
+#if defined(_IRR_COLOR_CONVERTER_SSE2_)
+			x = convert8BitTo32Bit_SSE2(in, (u32*)out, width);
+#endif
+			for (; x < (u32) width; x += 1)
 			{
 				c = in[x];
 #ifdef __BIG_ENDIAN__
@@ -375,6 +616,13 @@ void CColorConverter::convert_A1R5G5B5toA8R8G8B8(const void* sP, s32 sN, void* d
 	u16* sB = (u16*)sP;
 	u32* dB = (u32*)dP;
 
+#if defined(_IRR_COLOR_CONVERTER_SSE2_)
+	const s32 done = convert16To32_SSE2(sB, dB, sN, false);
+	sB += done;
+	dB += done;
+	sN -= done;
+#endif
+
 	for (s32 x = 0; x < sN; ++x)
 		*dB++ = A1R5G5B5toA8R8G8B8(*sB++);
 }
@@ -398,12 +646,25 @@ void CColorConverter::convert_A8R8G8B8toR8G8B8(const void* sP, s32 sN, void* dP)
 	u8* sB = (u8*)sP;
 	u8* dB = (u8*)dP;
 
+#if defined(_IRR_COLOR_CONVERTER_SSSE3_)
+	if (hasSSSE3())
+	{
+		const s32 done = convert32To24_SSSE3(sB, dB, sN, Shuffle_A8R8G8B8toR8G8B8);
+		sB += done * 4;
+		dB += done * 3;
+		sN -= done;
+	}
+#endif
+
 	for (s32 x = 0; x < sN; ++x)
 	{
-		// sB[3] is alpha
-		dB[0] = sB[2];
-		dB[1] = sB[1];
-		dB[2] = sB[0];
+		// sB[3] is alpha, read first so the conversion also works in place
+		const u8 r = sB[2];
+		const u8 g = sB[1];
+		const u8 bl = sB[0];
+		dB[0] = r;
+		dB[1] = g;
+		dB[2] = bl;
 
 		sB += 4;
 		dB += 3;
@@ -415,6 +676,16 @@ void CColorConverter::convert_A8R8G8B8toB8G8R8(const void* sP, s32 sN, void* dP)
 	u8* sB = (u8*)sP;
 	u8* dB = (u8*)dP;
 
+#if defined(_IRR_COLOR_CONVERTER_SSSE3_)
+	if (hasSSSE3())
+	{
+		const s32 done = convert32To24_SSSE3(sB, dB, sN, Shuffle_A8R8G8B8toB8G8R8);
+		sB += done * 4;
+		dB += done * 3;
+		sN -= done;
+	}
+#endif
+
 	for (s32 x = 0; x < sN; ++x)
 	{
 		// sB[3] is alpha
@@ -437,6 +708,13 @@ void CColorConverter::convert_A8R8G8B8toA1R5G5B5(const void* sP, s32 sN, void* d
 	u32* sB = (u32*)sP;
 	u16* dB = (u16*)dP;
 
+#if defined(_IRR_COLOR_CONVERTER_SSE2_)
+	const s32 done = convert32To16_SSE2(sB, dB, sN, false);
+	sB += done;
+	dB += done;
+	sN -= done;
+#endif
+
 	for (s32 x = 0; x < sN; ++x)
 		*dB++ = A8R8G8B8toA1R5G5B5(*sB++);
 }
@@ -465,6 +743,13 @@ void CColorConverter::convert_A8R8G8B8toR5G6B5(const void* sP, s32 sN, void* dP)
 	u8 * sB = (u8 *)sP;
 	u16* dB = (u16*)dP;
 
+#if defined(_IRR_COLOR_CONVERTER_SSE2_)
+	const s32 done = convert32To16_SSE2((const u32*)sB, dB, sN, true);
+	sB += done * 4;
+	dB += done;
+	sN -= done;
+#endif
+
 	for (s32 x = 0; x < sN; ++x)
 	{
 		s32 r = sB[2] >> 3;
@@ -506,6 +791,16 @@ void CColorConverter::convert_R8G8B8toA8R8G8B8(const void* sP, s32 sN, void* dP)
 	u8*  sB = (u8* )sP;
 	u32* dB = (u32*)dP;
 
+#if defined(_IRR_COLOR_CONVERTER_SSSE3_)
+	if (hasSSSE3())
+	{
+		const s32 done = convert24To32_SSSE3(sB, (u8*)dB, sN, Shuffle_R8G8B8toA8R8G8B8);
+		sB += done * 3;
+		dB += done;
+		sN -= done;
+	}
+#endif
+
 	for (s32 x = 0; x < sN; ++x)
 	{
 		*dB = 0xff000000 | (sB[0]<<16) | (sB[1]<<8) | sB[2];
@@ -538,6 +833,16 @@ void CColorConverter::convert_B8G8R8toA8R8G8B8(const void* sP, s32 sN, void* dP)
 	u8*  sB = (u8* )sP;
 	u32* dB = (u32*)dP;
 
+#if defined(_IRR_COLOR_CONVERTER_SSSE3_)
+	if (hasSSSE3())
+	{
+		const s32 done = convert24To32_SSSE3(sB, (u8*)dB, sN, Shuffle_B8G8R8toA8R8G8B8);
+		sB += done * 3;
+		dB += done;
+		sN -= done;
+	}
+#endif
+
 	for (s32 x = 0; x < sN; ++x)
 	{
 		*dB = 0xff000000 | (sB[2]<<16) | (sB[1]<<8) | sB[0];
@@ -552,6 +857,13 @@ void CColorConverter::convert_A8R8G8B8toR8G8B8A8(const void* sP, s32 sN, void* d
 	const u32* sB = (const u32*)sP;
 	u32* dB = (u32*)dP;
 
+#if defined(_IRR_COLOR_CONVERTER_SSE2_)
+	const s32 done = convert32To32_SSE2(sB, dB, sN, true);
+	sB += done;
+	dB += done;
+	sN -= done;
+#endif
+
 	for (s32 x = 0; x < sN; ++x)
 	{
 		*dB++ = (*sB<<8) | (*sB>>24);
@@ -564,6 +876,13 @@ void CColorConverter::convert_A8R8G8B8toA8B8G8R8(const void* sP, s32 sN, void* d
 	const u32* sB = (const u32*)sP;
 	u32* dB = (u32*)dP;
 
+#if defined(_IRR_COLOR_CONVERTER_SSE2_)
+	const s32 done = convert32To32_SSE2(sB, dB, sN, false);
+	sB += done;
+	dB += done;
+	sN -= done;
+#endif
+
 	for (s32 x = 0; x < sN; ++x)
 	{
 		*dB++ = (*sB&0xff00ff00)|((*sB&0x00ff0000)>>16)|((*sB&0x000000ff)<<16);
@@ -576,6 +895,16 @@ void CColorConverter::convert_B8G8R8A8toA8R8G8B8(const void* sP, s32 sN, void* d
 	u8* sB = (u8*)sP;
 	u8* dB = (u8*)dP;
 
+#if defined(_IRR_COLOR_CONVERTER_SSSE3_)
+	if (hasSSSE3())
+	{
+		const s32 done = convert32To32_SSSE3(sB, dB, sN, Shuffle_B8G8R8A8toA8R8G8B8);
+		sB += done * 4;
+		dB += done * 4;
+		sN -= done;
+	}
+#endif
+
 	for (s32 x = 0; x < sN; ++x)
 	{
 		dB[0] = sB[3];
@@ -594,11 +923,22 @@ void CColorConverter::convert_R8G8B8toB8G8R8(const void* sP, s32 sN, void* dP)
 	u8* sB = (u8*)sP;
 	u8* dB = (u8*)dP;
 
+#if defined(_IRR_COLOR_CONVERTER_SSSE3_)
+	if (hasSSSE3())
+	{
+		const s32 done = convert24To24_SSSE3(sB, dB, sN, Shuffle_R8G8B8toB8G8R8);
+		sB += done * 3;
+		dB += done * 3;
+		sN -= done;
+	}
+#endif
+
 	for (s32 x = 0; x < sN; ++x)
 	{
-		dB[2] = sB[0];
+		const u8 r = sB[0];
 		dB[1] = sB[1];
 		dB[0] = sB[2];
+		dB[2] = r;
 
 		sB += 3;
 		dB += 3;
@@ -665,6 +1005,13 @@ void CColorConverter::convert_R5G6B5toA8R8G8B8(const void* sP, s32 sN, void* dP)
 	u16* sB = (u16*)sP;
 	u32* dB = (u32*)dP;
 
+#if defined(_IRR_COLOR_CONVERTER_SSE2_)
+	const s32 done = convert16To32_SSE2(sB, dB, sN, true);
+	sB += done;
+	dB += done;
+	sN -= done;
+#endif
+
 	for (s32 x = 0; x < sN; ++x)
 		*dB++ = R5G6B5toA8R8G8B8(*sB++);
 }
@@ -766,5 +1113,70 @@ void CColorConverter::convert_viaFormat(const void* sP, ECOLOR_FORMAT sF, s32 sN
 }
 
 
+//! rows of an image conversion, split in bands for the job pool
+struct SConvertBands
+{
+	const u8* Source;
+	ECOLOR_FORMAT SourceFormat;
+	u32 SourcePitch;
+	u8* Dest;
+	ECOLOR_FORMAT DestFormat;
+	u32 DestPitch;
+	u32 Width;
+	u32 Height;
+	u32 BandHeight;
+};
+
+static void convertBand(void* userData, u32 index)
+{
+	const SConvertBands* bands = (const SConvertBands*) userData;
+
+	const u32 start = index * bands->BandHeight;
+	const u32 end = core::min_(start + bands->BandHeight, bands->Height);
+	for (u32 y=start; y<end; ++y)
+	{
+		CColorConverter::convert_viaFormat(bands->Source + y * bands->SourcePitch, bands->SourceFormat,
+			bands->Width, bands->Dest + y * bands->DestPitch, bands->DestFormat);
+	}
+}
+
+void CColorConverter::convert_viaFormat(const void* sP, ECOLOR_FORMAT sF, u32 sPitch,
+				void* dP, ECOLOR_FORMAT dF, u32 dPitch,
+				u32 width, u32 height, CJobPool* pool)
+{
+	if (!width || !height)
+		return;
+
+	// rows without padding are converted in one go
+	if (sPitch == width * IImage::getBitsPerPixelFromFormat(sF) / 8 &&
+		dPitch == width * IImage::getBitsPerPixelFromFormat(dF) / 8 &&
+		(!pool || !pool->getThreadCount()))
+	{
+		convert_viaFormat(sP, sF, width * height, dP, dF);
+		return;
+	}
+
+	SConvertBands bands;
+	bands.Source = (const u8*) sP;
+	bands.SourceFormat = sF;
+	bands.SourcePitch = sPitch;
+	bands.Dest = (u8*) dP;
+	bands.DestFormat = dF;
+	bands.DestPitch = dPitch;
+	bands.Width = width;
+	bands.Height = height;
+
+	// about 16k pixels per job, small images stay on this thread
+	bands.BandHeight = core::max_(16384u / width, 1u);
+	const u32 count = (height + bands.BandHeight - 1) / bands.BandHeight;
+
+	if (pool && count > 1)
+		pool->parallelFor(convertBand, &bands, count);
+	else
+		for (u32 i=0; i<count; ++i)
+			convertBand(&bands, i);
+}
+
+
 } // end namespace video
 } // end namespace irr
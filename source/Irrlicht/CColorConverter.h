@@ -10,6 +10,8 @@
 
 namespace irr
 {
+class CJobPool;
+
 namespace video
 {
 
@@ -89,6 +91,16 @@ public:
 	static void convert_R5G6B5toA1R5G5B5(const void* sP, s32 sN, void* dP);
 	static void convert_viaFormat(const void* sP, ECOLOR_FORMAT sF, s32 sN,
 				void* dP, ECOLOR_FORMAT dF);
+
+	//! Converts width x height pixels from one image to another.
+	/** Large images are split into bands of rows which are converted on
+	the worker threads of the pool.
+	\param sPitch Bytes from one source row to the next.
+	\param dPitch Bytes from one destination row to the next.
+	\param pool Worker threads, may be 0. */
+	static void convert_viaFormat(const void* sP, ECOLOR_FORMAT sF, u32 sPitch,
+				void* dP, ECOLOR_FORMAT dF, u32 dPitch,
+				u32 width, u32 height, CJobPool* pool);
 };
 
 
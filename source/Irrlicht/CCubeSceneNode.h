@@ -45,6 +45,12 @@ namespace scene
 		//! Returns type of the scene node
 		virtual ESCENE_NODE_TYPE getType() const _IRR_OVERRIDE_ { return ESNT_CUBE; }
 
+		//! Cubes have the default OnAnimate
+		virtual bool isAnimationThreadSafe() const _IRR_OVERRIDE_ { return true; }
+
+		//! Cubes use the default transformation
+		virtual bool hasDefaultTransformation() const _IRR_OVERRIDE_ { return true; }
+
 		//! Creates shadow volume scene node as child of this node
 		//! and returns a pointer to it.
 		virtual IShadowVolumeSceneNode* addShadowVolumeSceneNode(const IMesh* shadowMesh,
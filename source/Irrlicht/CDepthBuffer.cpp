@@ -16,7 +16,7 @@ namespace video
 
 //! constructor
 CDepthBuffer::CDepthBuffer(const core::dimension2d<u32>& size)
-: Buffer(0), Size(0,0)
+: Buffer(0), Size(0,0), BlockPitch(0)
 {
 	#ifdef _DEBUG
 	setDebugName("CDepthBuffer");
@@ -49,6 +49,14 @@ void CDepthBuffer::clear()
 	zMaxValue = IR(zMax);
 
 	memset32 ( Buffer, zMaxValue, TotalSize );
+
+	for ( u32 i = 0; i != Blocks.size(); ++i )
+	{
+		Blocks[i].Min = zMax;
+		Blocks[i].Max = zMax;
+		Blocks[i].Marked = false;
+	}
+	MarkedBlocks.set_used ( 0 );
 }
 
 
@@ -66,6 +74,9 @@ void CDepthBuffer::setSize(const core::dimension2d<u32>& size)
 	Pitch = size.Width * sizeof ( fp24 );
 	TotalSize = Pitch * size.Height;
 	Buffer = new u8[TotalSize];
+
+	BlockPitch = ( size.Width + SOFTWARE_DRIVER_2_DEPTH_BLOCK - 1 ) >> SOFTWARE_DRIVER_2_DEPTH_BLOCK_LOG2;
+	Blocks.set_used ( BlockPitch * ( ( size.Height + SOFTWARE_DRIVER_2_DEPTH_BLOCK - 1 ) >> SOFTWARE_DRIVER_2_DEPTH_BLOCK_LOG2 ) );
 	clear ();
 }
 
@@ -77,6 +88,100 @@ const core::dimension2d<u32>& CDepthBuffer::getSize() const
 	return Size;
 }
 
+
+//! clips area to the buffer and converts it to block coordinates
+bool CDepthBuffer::getBlockRect(const core::rect<s32>& area, core::rect<s32>& blocks) const
+{
+	const s32 x0 = core::s32_max ( area.UpperLeftCorner.X, 0 );
+	const s32 y0 = core::s32_max ( area.UpperLeftCorner.Y, 0 );
+	const s32 x1 = core::s32_min ( area.LowerRightCorner.X, (s32) Size.Width );
+	const s32 y1 = core::s32_min ( area.LowerRightCorner.Y, (s32) Size.Height );
+
+	if ( x0 >= x1 || y0 >= y1 )
+		return false;
+
+	// inclusive block coordinates
+	blocks.UpperLeftCorner.X = x0 >> SOFTWARE_DRIVER_2_DEPTH_BLOCK_LOG2;
+	blocks.UpperLeftCorner.Y = y0 >> SOFTWARE_DRIVER_2_DEPTH_BLOCK_LOG2;
+	blocks.LowerRightCorner.X = ( x1 - 1 ) >> SOFTWARE_DRIVER_2_DEPTH_BLOCK_LOG2;
+	blocks.LowerRightCorner.Y = ( y1 - 1 ) >> SOFTWARE_DRIVER_2_DEPTH_BLOCK_LOG2;
+	return true;
+}
+
+
+//! remembers the blocks touched by area for the next updateBlocks
+void CDepthBuffer::markBlocks(const core::rect<s32>& area)
+{
+	core::rect<s32> b;
+	if ( !getBlockRect ( area, b ) )
+		return;
+
+	for ( s32 y = b.UpperLeftCorner.Y; y <= b.LowerRightCorner.Y; ++y )
+	{
+		for ( s32 x = b.UpperLeftCorner.X; x <= b.LowerRightCorner.X; ++x )
+		{
+			const u32 i = y * BlockPitch + x;
+			if ( Blocks[i].Marked )
+				continue;
+
+			Blocks[i].Marked = true;
+			MarkedBlocks.push_back ( i );
+		}
+	}
+}
+
+
+//! recalculates the depth range of all marked blocks
+void CDepthBuffer::updateBlocks()
+{
+	for ( u32 i = 0; i != MarkedBlocks.size(); ++i )
+	{
+		SDepthBlock &block = Blocks[ MarkedBlocks[i] ];
+		const u32 x0 = ( MarkedBlocks[i] % BlockPitch ) << SOFTWARE_DRIVER_2_DEPTH_BLOCK_LOG2;
+		const u32 y0 = ( MarkedBlocks[i] / BlockPitch ) << SOFTWARE_DRIVER_2_DEPTH_BLOCK_LOG2;
+		const u32 x1 = core::min_ ( x0 + SOFTWARE_DRIVER_2_DEPTH_BLOCK, Size.Width );
+		const u32 y1 = core::min_ ( y0 + SOFTWARE_DRIVER_2_DEPTH_BLOCK, Size.Height );
+
+		const fp24 *z = (const fp24*) Buffer + y0 * Size.Width;
+		f32 zMin = z[x0];
+		f32 zMax = z[x0];
+		for ( u32 y = y0; y != y1; ++y )
+		{
+			for ( u32 x = x0; x != x1; ++x )
+			{
+				zMin = core::min_ ( zMin, (f32) z[x] );
+				zMax = core::max_ ( zMax, (f32) z[x] );
+			}
+			z += Size.Width;
+		}
+
+		block.Min = zMin;
+		block.Max = zMax;
+		block.Marked = false;
+	}
+	MarkedBlocks.set_used ( 0 );
+}
+
+
+//! returns true if all pixels in area hold a w greater than w
+bool CDepthBuffer::isHidden(const core::rect<s32>& area, f32 w) const
+{
+	core::rect<s32> b;
+	if ( !getBlockRect ( area, b ) )
+		return false;
+
+	for ( s32 y = b.UpperLeftCorner.Y; y <= b.LowerRightCorner.Y; ++y )
+	{
+		const SDepthBlock *block = Blocks.const_pointer() + y * BlockPitch;
+		for ( s32 x = b.UpperLeftCorner.X; x <= b.LowerRightCorner.X; ++x )
+		{
+			if ( block[x].Min <= w )
+				return false;
+		}
+	}
+	return true;
+}
+
 // -----------------------------------------------------------------
 
 //! constructor
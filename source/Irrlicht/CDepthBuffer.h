@@ -6,6 +6,8 @@
 #define __C_Z_BUFFER_H_INCLUDED__
 
 #include "IDepthBuffer.h"
+#include "irrArray.h"
+#include "rect.h"
 
 namespace irr
 {
@@ -40,13 +42,46 @@ namespace video
 		//! returns pitch of depthbuffer (in bytes)
 		virtual u32 getPitch() const _IRR_OVERRIDE_ { return Pitch; }
 
+		//! remembers the blocks touched by area for the next updateBlocks
+		void markBlocks(const core::rect<s32>& area);
+
+		//! recalculates the depth range of all marked blocks
+		void updateBlocks();
+
+		//! returns true if all pixels in area hold a w greater than w
+		/** The w-buffer only gets nearer values between clears, so blocks
+		which were not updated yet are still a lower bound and the test
+		stays conservative. */
+		bool isHidden(const core::rect<s32>& area, f32 w) const;
+
+		//! returns the smallest w stored in a block, block coordinates
+		f32 getBlockMin(u32 x, u32 y) const { return Blocks[y * BlockPitch + x].Min; }
+
+		//! returns the largest w stored in a block, block coordinates
+		f32 getBlockMax(u32 x, u32 y) const { return Blocks[y * BlockPitch + x].Max; }
+
 
 	private:
 
+		//! clips area to the buffer and converts it to block coordinates
+		bool getBlockRect(const core::rect<s32>& area, core::rect<s32>& blocks) const;
+
+		//! w range of a block of 8x8 pixels
+		struct SDepthBlock
+		{
+			f32 Min;
+			f32 Max;
+			bool Marked;
+		};
+
 		u8* Buffer;
 		core::dimension2d<u32> Size;
 		u32 TotalSize;
 		u32 Pitch;
+
+		core::array<SDepthBlock> Blocks;
+		core::array<u32> MarkedBlocks;
+		u32 BlockPitch;
 	};
 
 
@@ -30,12 +30,18 @@ namespace scene
 		//! Returns the relative transformation of the scene node.
 		virtual core::matrix4 getRelativeTransformation() const _IRR_OVERRIDE_;
 
+		//! The relative transformation is a matrix which can be changed at any time
+		virtual bool hasDefaultTransformation() const _IRR_OVERRIDE_ { return false; }
+
 		//! does nothing.
 		virtual void render() _IRR_OVERRIDE_ {}
 
 		//! Returns type of the scene node
 		virtual ESCENE_NODE_TYPE getType() const _IRR_OVERRIDE_ { return ESNT_DUMMY_TRANSFORMATION; }
 
+		//! The matrix is only changed by the user, not while animating
+		virtual bool isAnimationThreadSafe() const _IRR_OVERRIDE_ { return true; }
+
 		//! Creates a clone of this scene node and its children.
 		virtual ISceneNode* clone(ISceneNode* newParent=0, ISceneManager* newManager=0) _IRR_OVERRIDE_;
 
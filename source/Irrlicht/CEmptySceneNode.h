@@ -31,6 +31,12 @@ namespace scene
 		//! Returns type of the scene node
 		virtual ESCENE_NODE_TYPE getType() const _IRR_OVERRIDE_ { return ESNT_EMPTY; }
 
+		//! Empty scene nodes have the default OnAnimate
+		virtual bool isAnimationThreadSafe() const _IRR_OVERRIDE_ { return true; }
+
+		//! Empty scene nodes use the default transformation
+		virtual bool hasDefaultTransformation() const _IRR_OVERRIDE_ { return true; }
+
 		//! Creates a clone of this scene node and its children.
 		virtual ISceneNode* clone(ISceneNode* newParent=0, ISceneManager* newManager=0) _IRR_OVERRIDE_;
 
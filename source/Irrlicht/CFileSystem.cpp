@@ -20,6 +20,7 @@
 #include "os.h"
 #include "CAttributes.h"
 #include "CReadFile.h"
+#include "CMappedReadFile.h"
 #include "CMemoryFile.h"
 #include "CLimitReadFile.h"
 #include "CWriteFile.h"
@@ -56,8 +57,14 @@ namespace irr
 namespace io
 {
 
+// how the file list of an archive is indexed
+static const u8 PATH_INDEX_IGNORE_CASE = 1;
+static const u8 PATH_INDEX_IGNORE_PATHS = 2;
+static const u8 PATH_INDEX_NONE = 0xff;
+
 //! constructor
 CFileSystem::CFileSystem()
+	: PathIndexDirty(false), JobPool(0), FileMapping(false)
 {
 	#ifdef _DEBUG
 	setDebugName("CFileSystem");
@@ -91,6 +98,7 @@ CFileSystem::CFileSystem()
 	ArchiveLoader.push_back(new CArchiveLoaderZIP(this));
 #endif
 
+	BuiltinLoaderCount = ArchiveLoader.size();
 }
 
 
@@ -99,6 +107,8 @@ CFileSystem::~CFileSystem()
 {
 	u32 i;
 
+	finishArchiveMounts();
+
 	for ( i=0; i < FileArchives.size(); ++i)
 	{
 		FileArchives[i]->drop();
@@ -108,11 +118,22 @@ CFileSystem::~CFileSystem()
 	{
 		ArchiveLoader[i]->drop();
 	}
+
+	if (JobPool)
+		JobPool->drop();
 }
 
 
 //! opens a file for read access
 IReadFile* CFileSystem::createAndOpenFile(const io::path& filename)
+{
+	finishArchiveMounts();
+	return openFile(filename);
+}
+
+
+//! opens a file without waiting for archives which are read
+IReadFile* CFileSystem::openFile(const io::path& filename)
 {
 	if ( filename.empty() )
 		return 0;
@@ -120,15 +141,33 @@ IReadFile* CFileSystem::createAndOpenFile(const io::path& filename)
 	IReadFile* file = 0;
 	u32 i;
 
+	// archives before the first indexed archive containing the file
+	// only have to be searched when they are not indexed
+	u32 fileIndex = 0;
+	const u32 indexed = findInPathIndex(filename, fileIndex);
+
 	for (i=0; i< FileArchives.size(); ++i)
 	{
-		file = FileArchives[i]->createAndOpenFile(filename);
+		if (i == indexed)
+			file = FileArchives[i]->createAndOpenFile(fileIndex);
+		else if (i > indexed || ArchiveIndexFlags[i] == PATH_INDEX_NONE)
+			file = FileArchives[i]->createAndOpenFile(filename);
+		else
+			continue;
 		if (file)
 			return file;
 	}
 
 	// Create the file using an absolute path so that it matches
 	// the scheme used by CNullDriver::getTexture().
+#ifdef _IRR_COMPILE_WITH_MAPPED_READ_FILE_
+	if (FileMapping)
+	{
+		file = CMappedReadFile::createMappedReadFile(getAbsolutePath(filename));
+		if (file)
+			return file;
+	}
+#endif
 	return CReadFile::createReadFile(getAbsolutePath(filename));
 }
 
@@ -201,6 +240,8 @@ IArchiveLoader* CFileSystem::getArchiveLoader(u32 index) const
 //! move the hirarchy of the filesystem. moves sourceIndex relative up or down
 bool CFileSystem::moveFileArchive(u32 sourceIndex, s32 relative)
 {
+	finishArchiveMounts();
+
 	bool r = false;
 	const s32 dest = (s32) sourceIndex + relative;
 	const s32 dir = relative < 0 ? -1 : 1;
@@ -215,8 +256,11 @@ bool CFileSystem::moveFileArchive(u32 sourceIndex, s32 relative)
 		t = FileArchives[s + dir];
 		FileArchives[s + dir] = FileArchives[s];
 		FileArchives[s] = t;
+		core::swap(ArchiveIndexFlags[s + dir], ArchiveIndexFlags[s]);
 		r = true;
 	}
+	if (r)
+		PathIndexDirty = true;
 	return r;
 }
 
@@ -230,6 +274,8 @@ bool CFileSystem::addFileArchive(const io::path& filename, bool ignoreCase,
 	IFileArchive* archive = 0;
 	bool ret = false;
 
+	finishArchiveMounts();
+
 	// see if archive is already added
 	if (changeArchivePassword(filename, password, retArchive))
 		return true;
@@ -313,7 +359,8 @@ bool CFileSystem::addFileArchive(const io::path& filename, bool ignoreCase,
 
 	if (archive)
 	{
-		FileArchives.push_back(archive);
+		appendFileArchive(archive, i < (s32)BuiltinLoaderCount ?
+			(ignoreCase ? PATH_INDEX_IGNORE_CASE : 0) | (ignorePaths ? PATH_INDEX_IGNORE_PATHS : 0) : PATH_INDEX_NONE);
 		if (password.size())
 			archive->Password=password;
 		if (retArchive)
@@ -352,6 +399,104 @@ bool CFileSystem::changeArchivePassword(const path& filename,
 	return false;
 }
 
+//! appends an archive, flags tell how its file list is indexed
+void CFileSystem::appendFileArchive(IFileArchive* archive, u8 indexFlags)
+{
+	FileArchives.push_back(archive);
+	ArchiveIndexFlags.push_back(indexFlags);
+
+	// a new archive has the lowest priority and can be merged into the index
+	if (!PathIndexDirty)
+		addToPathIndex(FileArchives.size()-1);
+}
+
+
+//! rebuilds the path index after archives were removed or moved
+void CFileSystem::updatePathIndex() const
+{
+	if (!PathIndexDirty)
+		return;
+
+	for (u32 i=0; i<4; ++i)
+		PathIndex[i].clear();
+	for (u32 i=0; i<FileArchives.size(); ++i)
+		addToPathIndex(i);
+
+	PathIndexDirty = false;
+}
+
+
+//! adds the files of an archive to the path index
+void CFileSystem::addToPathIndex(u32 archive) const
+{
+	const u8 flags = ArchiveIndexFlags[archive];
+	if (flags == PATH_INDEX_NONE)
+		return;
+
+	// the names in the file list are already normalized for the flags. the
+	// keys are lower case for all flags, CFileList::findFile ignores the case.
+	const IFileList* list = FileArchives[archive]->getFileList();
+	CPathHashMap<SArchiveFile>& index = PathIndex[flags];
+	for (u32 i=0; i<list->getFileCount(); ++i)
+	{
+		io::path key = list->getFullFileName(i);
+		key.make_lower();
+		if (list->isDirectory(i))
+			key.append('/');
+
+		// archives added before have priority
+		if (!index.find(key))
+		{
+			SArchiveFile file;
+			file.Archive = archive;
+			file.File = i;
+			index.insert(key, file);
+		}
+	}
+}
+
+
+//! returns the first indexed archive containing the file, or the archive count
+u32 CFileSystem::findInPathIndex(const io::path& filename, u32& fileIndex) const
+{
+	updatePathIndex();
+
+	// normalize like CFileList::findFile, directories keep a trailing slash
+	io::path name(filename);
+	name.replace('\\', '/');
+	bool isDirectory = false;
+	if (name.lastChar() == '/')
+	{
+		isDirectory = true;
+		name[name.size()-1] = 0;
+		name.validate();
+	}
+
+	u32 found = FileArchives.size();
+	for (u8 flags=0; flags<4; ++flags)
+	{
+		if (!PathIndex[flags].size())
+			continue;
+
+		io::path key(name);
+		key.make_lower();
+		if (flags & PATH_INDEX_IGNORE_PATHS)
+			core::deletePathFromFilename(key);
+		if (isDirectory)
+			key.append('/');
+
+		const SArchiveFile* file = PathIndex[flags].find(key);
+		if (file && file->Archive < found)
+		{
+			found = file->Archive;
+			fileIndex = file->File;
+		}
+	}
+
+	return found;
+}
+
+
 bool CFileSystem::addFileArchive(IReadFile* file, bool ignoreCase,
 		bool ignorePaths, E_FILE_ARCHIVE_TYPE archiveType,
 		const core::stringc& password, IFileArchive** retArchive)
@@ -359,6 +504,8 @@ bool CFileSystem::addFileArchive(IReadFile* file, bool ignoreCase,
 	if (!file || archiveType == EFAT_FOLDER)
 		return false;
 
+	finishArchiveMounts();
+
 	if (file)
 	{
 		if (changeArchivePassword(file->getFileName(), password, retArchive))
@@ -418,7 +565,8 @@ bool CFileSystem::addFileArchive(IReadFile* file, bool ignoreCase,
 
 		if (archive)
 		{
-			FileArchives.push_back(archive);
+			appendFileArchive(archive, i < (s32)BuiltinLoaderCount ?
+				(ignoreCase ? PATH_INDEX_IGNORE_CASE : 0) | (ignorePaths ? PATH_INDEX_IGNORE_PATHS : 0) : PATH_INDEX_NONE);
 			if (password.size())
 				archive->Password=password;
 			if (retArchive)
@@ -438,6 +586,8 @@ bool CFileSystem::addFileArchive(IReadFile* file, bool ignoreCase,
 //! Adds an archive to the file system.
 bool CFileSystem::addFileArchive(IFileArchive* archive)
 {
+	finishArchiveMounts();
+
 	if ( archive )
 	{
 		for (u32 i=0; i < FileArchives.size(); ++i)
@@ -447,7 +597,8 @@ bool CFileSystem::addFileArchive(IFileArchive* archive)
 				return false;
 			}
 		}
-		FileArchives.push_back(archive);
+		// the file list of external archives might not match their lookup
+		appendFileArchive(archive, PATH_INDEX_NONE);
 		archive->grab();
 
 		return true;
@@ -457,14 +608,169 @@ bool CFileSystem::addFileArchive(IFileArchive* archive)
 }
 
 
+//! Adds an archive to the file system, reading its file list on a worker thread.
+bool CFileSystem::addFileArchiveAsync(const io::path& filename, bool ignoreCase,
+		bool ignorePaths, E_FILE_ARCHIVE_TYPE archiveType,
+		const core::stringc& password)
+{
+	// see if archive is already added or read
+	const io::path absPath = getAbsolutePath(filename);
+	for (u32 i=0; i < ArchiveMounts.size(); ++i)
+	{
+		if (ArchiveMounts[i]->File->getFileName() == absPath)
+		{
+			if (password.size())
+				ArchiveMounts[i]->Password = password;
+			return true;
+		}
+	}
+	if (changeArchivePassword(filename, password))
+		return true;
+
+	// loader for the file name or type which accepts the content, else any loader accepting the content
+	// mount points need the file list of the working directory and are left to addFileArchive
+	s32 i = -1;
+	IReadFile* file = archiveType == EFAT_FOLDER ? 0 : openFile(filename);
+	if (file)
+	{
+		for (i = ArchiveLoader.size()-1; i >= 0; --i)
+		{
+			const bool loadable = archiveType == EFAT_UNKNOWN ?
+				!ArchiveLoader[i]->isALoadableFileFormat(EFAT_FOLDER) && ArchiveLoader[i]->isALoadableFileFormat(filename) :
+				ArchiveLoader[i]->isALoadableFileFormat(archiveType);
+			file->seek(0);
+			if (loadable && ArchiveLoader[i]->isALoadableFileFormat(file))
+				break;
+		}
+
+		if (i < 0 && archiveType == EFAT_UNKNOWN)
+		{
+			for (i = ArchiveLoader.size()-1; i >= 0; --i)
+			{
+				file->seek(0);
+				if (ArchiveLoader[i]->isALoadableFileFormat(file))
+					break;
+			}
+		}
+	}
+
+	// external archive loaders might not be thread safe
+	if (i < 0 || i >= (s32)BuiltinLoaderCount)
+	{
+		if (file)
+			file->drop();
+		return addFileArchive(filename, ignoreCase, ignorePaths, archiveType, password);
+	}
+
+	SArchiveMount* mount = new SArchiveMount;
+	mount->Loader = ArchiveLoader[i];
+	mount->File = file;
+	mount->Archive = 0;
+	mount->Password = password;
+	mount->IgnoreCase = ignoreCase;
+	mount->IgnorePaths = ignorePaths;
+	mount->IndexFlags = (ignoreCase ? PATH_INDEX_IGNORE_CASE : 0) | (ignorePaths ? PATH_INDEX_IGNORE_PATHS : 0);
+	mount->Job = 0;
+	if (JobPool)
+		mount->Job = JobPool->startJob(mountArchiveJob, mount);
+	else
+		mountArchiveJob(mount, 0);
+	ArchiveMounts.push_back(mount);
+
+	return true;
+}
+
+
+//! reads the file list of an archive added by addFileArchiveAsync
+void CFileSystem::mountArchiveJob(void* userData, u32 index)
+{
+	SArchiveMount* mount = (SArchiveMount*)userData;
+	mount->File->seek(0);
+	mount->Archive = mount->Loader->createArchive(mount->File, mount->IgnoreCase, mount->IgnorePaths);
+}
+
+
+//! adds the archives read by addFileArchiveAsync
+void CFileSystem::finishArchiveMounts()
+{
+	for (u32 i=0; i < ArchiveMounts.size(); ++i)
+	{
+		SArchiveMount* mount = ArchiveMounts[i];
+		if (mount->Job)
+			JobPool->finishJob(mount->Job);
+
+		if (mount->Archive)
+		{
+			appendFileArchive(mount->Archive, mount->IndexFlags);
+			if (mount->Password.size())
+				mount->Archive->Password = mount->Password;
+		}
+		else
+			os::Printer::log("Could not create archive for", mount->File->getFileName(), ELL_ERROR);
+
+		mount->File->drop();
+		delete mount;
+	}
+	ArchiveMounts.clear();
+}
+
+
+//! Returns true while file lists of archives added with addFileArchiveAsync are read.
+bool CFileSystem::isFileArchiveLoading() const
+{
+	for (u32 i=0; i < ArchiveMounts.size(); ++i)
+	{
+		if (ArchiveMounts[i]->Job && !JobPool->isJobDone(ArchiveMounts[i]->Job))
+			return true;
+	}
+	return false;
+}
+
+
+//! Sets a directory for caching the file lists of zip archives.
+void CFileSystem::setArchiveCacheDirectory(const io::path& directory)
+{
+	// archives which are read use the directory
+	finishArchiveMounts();
+
+	if (directory.empty())
+		ArchiveCacheDirectory = "";
+	else
+	{
+		ArchiveCacheDirectory = getAbsolutePath(directory);
+		if (ArchiveCacheDirectory.lastChar() != '/')
+			ArchiveCacheDirectory.append('/');
+	}
+}
+
+
+//! Sets the worker threads which read archives added with addFileArchiveAsync
+void CFileSystem::setJobPool(CJobPool* pool)
+{
+	finishArchiveMounts();
+
+	if (pool)
+		pool->grab();
+
+	if (JobPool)
+		JobPool->drop();
+
+	JobPool = pool;
+}
+
+
 //! removes an archive from the file system.
 bool CFileSystem::removeFileArchive(u32 index)
 {
+	finishArchiveMounts();
+
 	bool ret = false;
 	if (index < FileArchives.size())
 	{
 		FileArchives[index]->drop();
 		FileArchives.erase(index);
+		ArchiveIndexFlags.erase(index);
+		PathIndexDirty = true;
 		ret = true;
 	}
 	return ret;
@@ -474,6 +780,8 @@ bool CFileSystem::removeFileArchive(u32 index)
 //! removes an archive from the file system.
 bool CFileSystem::removeFileArchive(const io::path& filename)
 {
+	finishArchiveMounts();
+
 	const path absPath = getAbsolutePath(filename);
 	for (u32 i=0; i < FileArchives.size(); ++i)
 	{
@@ -487,6 +795,8 @@ bool CFileSystem::removeFileArchive(const io::path& filename)
 //! Removes an archive from the file system.
 bool CFileSystem::removeFileArchive(const IFileArchive* archive)
 {
+	finishArchiveMounts();
+
 	for (u32 i=0; i < FileArchives.size(); ++i)
 	{
 		if (archive == FileArchives[i])
@@ -501,6 +811,7 @@ bool CFileSystem::removeFileArchive(const IFileArchive* archive)
 //! gets an archive
 u32 CFileSystem::getFileArchiveCount() const
 {
+	const_cast<CFileSystem*>(this)->finishArchiveMounts();
 	return FileArchives.size();
 }
 
@@ -831,6 +1142,8 @@ EFileSystemType CFileSystem::setFileListSystem(EFileSystemType listType)
 //! Creates a list of files and directories in the current working directory
 IFileList* CFileSystem::createFileList()
 {
+	finishArchiveMounts();
+
 	CFileList* r = 0;
 	io::path Path = getWorkingDirectory();
 	Path.replace('\\', '/');
@@ -962,8 +1275,15 @@ IFileList* CFileSystem::createEmptyFileList(const io::path& path, bool ignoreCas
 //! determines if a file exists and would be able to be opened.
 bool CFileSystem::existFile(const io::path& filename) const
 {
+	const_cast<CFileSystem*>(this)->finishArchiveMounts();
+
+	u32 fileIndex;
+	if (findInPathIndex(filename, fileIndex) < FileArchives.size())
+		return true;
+
 	for (u32 i=0; i < FileArchives.size(); ++i)
-		if (FileArchives[i]->getFileList()->findFile(filename)!=-1)
+		if (ArchiveIndexFlags[i] == PATH_INDEX_NONE &&
+			FileArchives[i]->getFileList()->findFile(filename)!=-1)
 			return true;
 
 #if defined(_MSC_VER) && defined(_IRR_WINDOWS_API_)
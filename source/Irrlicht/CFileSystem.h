@@ -7,6 +7,8 @@
 
 #include "IFileSystem.h"
 #include "irrArray.h"
+#include "CPathHashMap.h"
+#include "CJobPool.h"
 
 namespace irr
 {
@@ -62,6 +64,27 @@ public:
 	//! Adds an archive to the file system.
 	virtual bool addFileArchive(IFileArchive* archive) _IRR_OVERRIDE_;
 
+	//! Adds an archive to the file system, reading its file list on a worker thread.
+	virtual bool addFileArchiveAsync(const io::path& filename, bool ignoreCase=true,
+			bool ignorePaths=true,
+			E_FILE_ARCHIVE_TYPE archiveType=EFAT_UNKNOWN,
+			const core::stringc& password="") _IRR_OVERRIDE_;
+
+	//! Returns true while file lists of archives added with addFileArchiveAsync are read.
+	virtual bool isFileArchiveLoading() const _IRR_OVERRIDE_;
+
+	//! Sets a directory for caching the file lists of zip archives.
+	virtual void setArchiveCacheDirectory(const io::path& directory) _IRR_OVERRIDE_;
+
+	//! Get the directory for caching the file lists of zip archives.
+	virtual const io::path& getArchiveCacheDirectory() const _IRR_OVERRIDE_ { return ArchiveCacheDirectory; }
+
+	//! Sets if files opened from disk are mapped into memory.
+	virtual void setFileMapping(bool enable) _IRR_OVERRIDE_ { FileMapping = enable; }
+
+	//! Get if files opened from disk are mapped into memory.
+	virtual bool getFileMapping() const _IRR_OVERRIDE_ { return FileMapping; }
+
 	//! move the hirarchy of the filesystem. moves sourceIndex relative up or down
 	virtual bool moveFileArchive(u32 sourceIndex, s32 relative) _IRR_OVERRIDE_;
 
@@ -148,6 +171,9 @@ public:
 	//! Creates a new empty collection of attributes, usable for serialization and more.
 	virtual IAttributes* createEmptyAttributes(video::IVideoDriver* driver) _IRR_OVERRIDE_;
 
+	//! Sets the worker threads which read archives added with addFileArchiveAsync
+	void setJobPool(CJobPool* pool);
+
 private:
 
 	// don't expose, needs refactoring
@@ -155,6 +181,46 @@ private:
 			const core::stringc& password,
 			IFileArchive** archive = 0);
 
+	//! opens a file without waiting for archives which are read
+	IReadFile* openFile(const io::path& filename);
+
+	//! adds the archives read by addFileArchiveAsync
+	void finishArchiveMounts();
+
+	//! archive added by addFileArchiveAsync
+	struct SArchiveMount
+	{
+		IArchiveLoader* Loader;
+		IReadFile* File;
+		IFileArchive* Archive;
+		core::stringc Password;
+		bool IgnoreCase;
+		bool IgnorePaths;
+		u8 IndexFlags;
+		CJobPool::SBatch* Job;
+	};
+
+	static void mountArchiveJob(void* userData, u32 index);
+
+	//! appends an archive, flags tell how its file list is indexed
+	void appendFileArchive(IFileArchive* archive, u8 indexFlags);
+
+	//! rebuilds the path index after archives were removed or moved
+	void updatePathIndex() const;
+
+	//! adds the files of an archive to the path index
+	void addToPathIndex(u32 archive) const;
+
+	//! returns the first indexed archive containing the file, or the archive count
+	u32 findInPathIndex(const io::path& filename, u32& fileIndex) const;
+
+	//! file of an archive in the path index
+	struct SArchiveFile
+	{
+		u32 Archive;
+		u32 File;
+	};
+
 	//! Currently used FileSystemType
 	EFileSystemType FileSystemType;
 	//! WorkingDirectory for Native and Virtual filesystems
@@ -163,6 +229,18 @@ private:
 	core::array<IArchiveLoader*> ArchiveLoader;
 	//! currently attached Archives
 	core::array<IFileArchive*> FileArchives;
+	//! how the file list of each archive is indexed
+	core::array<u8> ArchiveIndexFlags;
+	//! merged file lists of the archives, one per combination of ignoreCase and ignorePaths
+	mutable CPathHashMap<SArchiveFile> PathIndex[4];
+	mutable bool PathIndexDirty;
+	//! archives of the loaders created by the file system are indexed
+	u32 BuiltinLoaderCount;
+	//! archives added by addFileArchiveAsync, in the order of the calls
+	core::array<SArchiveMount*> ArchiveMounts;
+	CJobPool* JobPool;
+	io::path ArchiveCacheDirectory;
+	bool FileMapping;
 };
 
 
@@ -16,11 +16,6 @@ namespace irr
 namespace video
 {
 
-#ifdef _IRR_COMPILE_WITH_LIBJPEG_
-// Static members
-io::path CImageLoaderJPG::Filename;
-#endif
-
 //! constructor
 CImageLoaderJPG::CImageLoaderJPG()
 {
@@ -113,7 +108,8 @@ void CImageLoaderJPG::output_message(j_common_ptr cinfo)
 	c8 temp1[JMSG_LENGTH_MAX];
 	(*cinfo->err->format_message)(cinfo, temp1);
 	core::stringc errMsg("JPEG FATAL ERROR in ");
-	errMsg += core::stringc(Filename);
+	// client_data holds the file name, set by loadImage
+	errMsg += core::stringc(*(const io::path*)cinfo->client_data);
 	os::Printer::log(errMsg.c_str(),temp1, ELL_ERROR);
 }
 #endif // _IRR_COMPILE_WITH_LIBJPEG_
@@ -144,8 +140,6 @@ IImage* CImageLoaderJPG::loadImage(io::IReadFile* file) const
 	if (!file)
 		return 0;
 
-	Filename = file->getFileName();
-
 	u8 **rowPtr=0;
 	u8* input = new u8[file->getSize()];
 	file->read(input, file->getSize());
@@ -154,6 +148,9 @@ IImage* CImageLoaderJPG::loadImage(io::IReadFile* file) const
 	struct jpeg_decompress_struct cinfo;
 	struct irr_jpeg_error_mgr jerr;
 
+	// for error messages, kept per call as images are loaded on several threads
+	cinfo.client_data = (void*)&file->getFileName();
+
 	//We have to set up the error handler first, in case the initialization
 	//step fails.  (Unlikely, but it could happen if you are out of memory.)
 	//This routine fills in the contents of struct jerr, and returns jerr's
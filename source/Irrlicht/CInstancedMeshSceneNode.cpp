@@ -0,0 +1,299 @@
+// Copyright (C) 2002-2012 Nikolaus Gebhardt
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#include "CInstancedMeshSceneNode.h"
+#include "ISceneManager.h"
+#include "ICameraSceneNode.h"
+#include "IVideoDriver.h"
+#include "IMaterialRenderer.h"
+#include "SViewFrustum.h"
+
+namespace irr
+{
+namespace scene
+{
+
+//! constructor
+CInstancedMeshSceneNode::CInstancedMeshSceneNode(IMesh* mesh, ISceneNode* parent, ISceneManager* mgr, s32 id,
+		const core::vector3df& position)
+	: IInstancedMeshSceneNode(parent, mgr, id, position), Mesh(0), BoxDirty(true), PassCount(0)
+{
+	#ifdef _DEBUG
+	setDebugName("CInstancedMeshSceneNode");
+	#endif
+
+	setMesh(mesh);
+}
+
+
+//! destructor
+CInstancedMeshSceneNode::~CInstancedMeshSceneNode()
+{
+	if (Mesh)
+		Mesh->drop();
+}
+
+
+//! Sets a new mesh to display
+void CInstancedMeshSceneNode::setMesh(IMesh* mesh)
+{
+	if (mesh)
+		mesh->grab();
+	if (Mesh)
+		Mesh->drop();
+	Mesh = mesh;
+
+	Materials.clear();
+	for (u32 i=0; Mesh && i<Mesh->getMeshBufferCount(); ++i)
+	{
+		IMeshBuffer* mb = Mesh->getMeshBuffer(i);
+		Materials.push_back(mb ? mb->getMaterial() : video::SMaterial());
+	}
+
+	for (u32 i=0; i<Transformations.size(); ++i)
+		updateInstanceBox(i);
+	BoxDirty = true;
+}
+
+
+//! Adds an instance of the mesh.
+u32 CInstancedMeshSceneNode::addInstance(const core::matrix4& transformation, video::SColor color)
+{
+	Transformations.push_back(transformation);
+	Colors.push_back(color);
+	Centers.push_back(core::vector3df());
+	HalfExtents.push_back(core::vector3df());
+
+	const u32 index = Transformations.size() - 1;
+	updateInstanceBox(index);
+	BoxDirty = true;
+	return index;
+}
+
+
+//! Removes an instance.
+void CInstancedMeshSceneNode::removeInstance(u32 index)
+{
+	if (index >= Transformations.size())
+		return;
+
+	const u32 last = Transformations.size() - 1;
+	Transformations[index] = Transformations[last];
+	Colors[index] = Colors[last];
+	Centers[index] = Centers[last];
+	HalfExtents[index] = HalfExtents[last];
+
+	Transformations.erase(last);
+	Colors.erase(last);
+	Centers.erase(last);
+	HalfExtents.erase(last);
+	BoxDirty = true;
+}
+
+
+//! Removes all instances.
+void CInstancedMeshSceneNode::removeAllInstances()
+{
+	Transformations.clear();
+	Colors.clear();
+	Centers.clear();
+	HalfExtents.clear();
+	VisibleTransformations.clear();
+	VisibleColors.clear();
+	BoxDirty = true;
+}
+
+
+//! Sets the transformation of an instance, relative to this node.
+void CInstancedMeshSceneNode::setInstanceTransformation(u32 index, const core::matrix4& transformation)
+{
+	if (index >= Transformations.size())
+		return;
+
+	Transformations[index] = transformation;
+	updateInstanceBox(index);
+	BoxDirty = true;
+}
+
+
+//! Sets the box of an instance used for culling
+void CInstancedMeshSceneNode::updateInstanceBox(u32 index)
+{
+	core::aabbox3df box(core::vector3df(0.f, 0.f, 0.f));
+	if (Mesh)
+		box = Mesh->getBoundingBox();
+	Transformations[index].transformBoxEx(box);
+
+	Centers[index] = box.getCenter();
+	HalfExtents[index] = box.getExtent() * 0.5f;
+}
+
+
+//! returns the axis aligned bounding box of all instances
+const core::aabbox3d<f32>& CInstancedMeshSceneNode::getBoundingBox() const
+{
+	if (BoxDirty)
+	{
+		Box.reset(0.f, 0.f, 0.f);
+		for (u32 i=0; i<Centers.size(); ++i)
+		{
+			const core::aabbox3df box(Centers[i] - HalfExtents[i], Centers[i] + HalfExtents[i]);
+			if (i == 0)
+				Box = box;
+			else
+				Box.addInternalBox(box);
+		}
+		BoxDirty = false;
+	}
+
+	return Box;
+}
+
+
+//! returns the material based on the zero based index i.
+video::SMaterial& CInstancedMeshSceneNode::getMaterial(u32 i)
+{
+	if (i >= Materials.size())
+		return ISceneNode::getMaterial(i);
+
+	return Materials[i];
+}
+
+
+//! Collects the absolute transformations and colors of the instances inside the view frustum
+void CInstancedMeshSceneNode::cullInstances()
+{
+	VisibleTransformations.set_used(0);
+	VisibleColors.set_used(0);
+
+	// the view frustum relative to this node
+	const ICameraSceneNode* camera = SceneManager->getActiveCamera();
+	const bool cull = camera && AutomaticCullingState != EAC_OFF;
+	SViewFrustum frustum;
+	if (cull)
+	{
+		frustum = *camera->getViewFrustum();
+		frustum.transform(core::matrix4(AbsoluteTransformation, core::matrix4::EM4CONST_INVERSE));
+	}
+
+	const bool identity = AbsoluteTransformation.isIdentity();
+	for (u32 i=0; i<Transformations.size(); ++i)
+	{
+		if (cull)
+		{
+			// outside when the box is completely in front of one plane
+			const core::vector3df& center = Centers[i];
+			const core::vector3df& halfExtent = HalfExtents[i];
+			u32 p = 0;
+			for (; p<SViewFrustum::VF_PLANE_COUNT; ++p)
+			{
+				const core::plane3df& plane = frustum.planes[p];
+				const f32 distance = plane.Normal.dotProduct(center) + plane.D;
+				const f32 radius = core::abs_(plane.Normal.X) * halfExtent.X +
+					core::abs_(plane.Normal.Y) * halfExtent.Y + core::abs_(plane.Normal.Z) * halfExtent.Z;
+				if (distance > radius)
+					break;
+			}
+			if (p < SViewFrustum::VF_PLANE_COUNT)
+				continue;
+		}
+
+		if (identity)
+			VisibleTransformations.push_back(Transformations[i]);
+		else
+			VisibleTransformations.push_back(AbsoluteTransformation * Transformations[i]);
+		VisibleColors.push_back(Colors[i]);
+	}
+}
+
+
+//! frame
+void CInstancedMeshSceneNode::OnRegisterSceneNode()
+{
+	if (IsVisible && Mesh && Transformations.size())
+	{
+		video::IVideoDriver* driver = SceneManager->getVideoDriver();
+
+		PassCount = 0;
+		bool solid = false;
+		bool transparent = false;
+		for (u32 i=0; i<Materials.size(); ++i)
+		{
+			video::IMaterialRenderer* rnd = driver->getMaterialRenderer(Materials[i].MaterialType);
+			if ((rnd && rnd->isTransparent()) || Materials[i].isTransparent())
+				transparent = true;
+			else
+				solid = true;
+		}
+
+		if (solid)
+			SceneManager->registerNodeForRendering(this, ESNRP_SOLID);
+		if (transparent)
+			SceneManager->registerNodeForRendering(this, ESNRP_TRANSPARENT);
+	}
+
+	ISceneNode::OnRegisterSceneNode();
+}
+
+
+//! renders the node.
+void CInstancedMeshSceneNode::render()
+{
+	video::IVideoDriver* driver = SceneManager->getVideoDriver();
+	if (!Mesh || !driver)
+		return;
+
+	const bool isTransparentPass =
+		SceneManager->getSceneNodeRenderPass() == ESNRP_TRANSPARENT;
+
+	// the instances are culled once per frame
+	++PassCount;
+	if (PassCount == 1)
+		cullInstances();
+
+	if (VisibleTransformations.size())
+	{
+		for (u32 i=0; i<Mesh->getMeshBufferCount(); ++i)
+		{
+			IMeshBuffer* mb = Mesh->getMeshBuffer(i);
+			if (!mb)
+				continue;
+
+			video::IMaterialRenderer* rnd = driver->getMaterialRenderer(Materials[i].MaterialType);
+			const bool transparent = (rnd && rnd->isTransparent()) || Materials[i].isTransparent();
+			if (transparent != isTransparentPass)
+				continue;
+
+			driver->setMaterial(Materials[i]);
+			driver->drawMeshBufferInstances(mb, VisibleTransformations.const_pointer(),
+				VisibleColors.const_pointer(), VisibleTransformations.size());
+		}
+	}
+
+	// for debug purposes only:
+	if (DebugDataVisible && PassCount==1)
+	{
+		driver->setTransform(video::ETS_WORLD, AbsoluteTransformation);
+
+		video::SMaterial m;
+		m.Lighting = false;
+		driver->setMaterial(m);
+
+		if (DebugDataVisible & EDS_BBOX)
+			driver->draw3DBox(getBoundingBox(), video::SColor(255,255,255,255));
+
+		if (DebugDataVisible & EDS_BBOX_BUFFERS)
+		{
+			for (u32 i=0; i<Centers.size(); ++i)
+			{
+				driver->draw3DBox(core::aabbox3df(Centers[i] - HalfExtents[i], Centers[i] + HalfExtents[i]),
+					video::SColor(255,190,128,128));
+			}
+		}
+	}
+}
+
+} // end namespace scene
+} // end namespace irr
+
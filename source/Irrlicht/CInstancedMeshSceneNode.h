@@ -0,0 +1,117 @@
+// Copyright (C) 2002-2012 Nikolaus Gebhardt
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#ifndef __C_INSTANCED_MESH_SCENE_NODE_H_INCLUDED__
+#define __C_INSTANCED_MESH_SCENE_NODE_H_INCLUDED__
+
+#include "IInstancedMeshSceneNode.h"
+#include "IMesh.h"
+#include "irrArray.h"
+
+namespace irr
+{
+namespace scene
+{
+
+	class CInstancedMeshSceneNode : public IInstancedMeshSceneNode
+	{
+	public:
+
+		//! constructor
+		CInstancedMeshSceneNode(IMesh* mesh, ISceneNode* parent, ISceneManager* mgr, s32 id,
+			const core::vector3df& position = core::vector3df(0,0,0));
+
+		//! destructor
+		virtual ~CInstancedMeshSceneNode();
+
+		//! frame
+		virtual void OnRegisterSceneNode() _IRR_OVERRIDE_;
+
+		//! renders the node.
+		virtual void render() _IRR_OVERRIDE_;
+
+		//! returns the axis aligned bounding box of all instances
+		virtual const core::aabbox3d<f32>& getBoundingBox() const _IRR_OVERRIDE_;
+
+		//! returns the material based on the zero based index i.
+		virtual video::SMaterial& getMaterial(u32 i) _IRR_OVERRIDE_;
+
+		//! returns amount of materials used by this scene node.
+		virtual u32 getMaterialCount() const _IRR_OVERRIDE_ { return Materials.size(); }
+
+		//! Returns type of the scene node
+		virtual ESCENE_NODE_TYPE getType() const _IRR_OVERRIDE_ { return ESNT_INSTANCED_MESH; }
+
+		//! The instances are only used when the node is registered and rendered
+		virtual bool isAnimationThreadSafe() const _IRR_OVERRIDE_ { return true; }
+
+		//! The instance matrices are relative to the default transformation
+		virtual bool hasDefaultTransformation() const _IRR_OVERRIDE_ { return true; }
+
+		//! Sets a new mesh to display
+		virtual void setMesh(IMesh* mesh) _IRR_OVERRIDE_;
+
+		//! Get the currently defined mesh for display.
+		virtual IMesh* getMesh() _IRR_OVERRIDE_ { return Mesh; }
+
+		//! Adds an instance of the mesh.
+		virtual u32 addInstance(const core::matrix4& transformation, video::SColor color) _IRR_OVERRIDE_;
+
+		//! Removes an instance.
+		virtual void removeInstance(u32 index) _IRR_OVERRIDE_;
+
+		//! Removes all instances.
+		virtual void removeAllInstances() _IRR_OVERRIDE_;
+
+		//! Get the number of instances.
+		virtual u32 getInstanceCount() const _IRR_OVERRIDE_ { return Transformations.size(); }
+
+		//! Sets the transformation of an instance, relative to this node.
+		virtual void setInstanceTransformation(u32 index, const core::matrix4& transformation) _IRR_OVERRIDE_;
+
+		//! Get the transformation of an instance, relative to this node.
+		virtual const core::matrix4& getInstanceTransformation(u32 index) const _IRR_OVERRIDE_ { return Transformations[index]; }
+
+		//! Sets the color of an instance.
+		virtual void setInstanceColor(u32 index, video::SColor color) _IRR_OVERRIDE_ { if (index < Colors.size()) Colors[index] = color; }
+
+		//! Get the color of an instance.
+		virtual video::SColor getInstanceColor(u32 index) const _IRR_OVERRIDE_ { return Colors[index]; }
+
+		//! Get the number of instances drawn in the last frame.
+		virtual u32 getVisibleInstanceCount() const _IRR_OVERRIDE_ { return VisibleTransformations.size(); }
+
+	private:
+
+		//! Sets the box of an instance used for culling
+		void updateInstanceBox(u32 index);
+
+		//! Collects the absolute transformations and colors of the instances inside the view frustum
+		void cullInstances();
+
+		IMesh* Mesh;
+		core::array<video::SMaterial> Materials;
+
+		// instances, relative to this node
+		core::array<core::matrix4> Transformations;
+		core::array<video::SColor> Colors;
+
+		// boxes of the instances as center and half extent, relative to this node
+		core::array<core::vector3df> Centers;
+		core::array<core::vector3df> HalfExtents;
+
+		// instances drawn in this frame
+		core::array<core::matrix4> VisibleTransformations;
+		core::array<video::SColor> VisibleColors;
+
+		mutable core::aabbox3df Box;
+		mutable bool BoxDirty;
+		s32 PassCount;
+	};
+
+} // end namespace scene
+} // end namespace irr
+
+#endif
+
@@ -453,12 +453,8 @@ bool CIrrDeviceFB::present(video::IImage* image, void* windowId, core::rect<s32>
 	srcwidth = core::min_(srcwidth, CreationParams.WindowSize.Width);
 
 	u8* srcdata = (u8*)image->lock();
-	for (u32 y=0; y<srcheight; ++y)
-	{
-		video::CColorConverter::convert_viaFormat(srcdata, image->getColorFormat(), srcwidth, destData, FBColorFormat);
-		srcdata+=image->getPitch();
-		destData+=Pitch;
-	}
+	video::CColorConverter::convert_viaFormat(srcdata, image->getColorFormat(), image->getPitch(),
+		destData, FBColorFormat, Pitch, srcwidth, srcheight, JobPool);
 	image->unlock();
 	msync(SoftwareImage,CreationParams.WindowSize.Width*CreationParams.WindowSize.Height,MS_ASYNC);
 	return true;
@@ -1204,13 +1204,8 @@ bool CIrrDeviceLinux::present(video::IImage* image, void* windowId, core::rect<s
 
 	const u32 destheight = SoftwareImage->height;
 	const u32 srcheight = core::min_(image->getDimension().Height, destheight);
-	const u32 srcPitch = image->getPitch();
-	for (u32 y=0; y!=srcheight; ++y)
-	{
-		video::CColorConverter::convert_viaFormat(srcdata,image->getColorFormat(), minWidth, destData, destColor);
-		srcdata+=srcPitch;
-		destData+=destPitch;
-	}
+	video::CColorConverter::convert_viaFormat(srcdata, image->getColorFormat(), image->getPitch(),
+		destData, destColor, destPitch, minWidth, srcheight, JobPool);
 
 	GC gc = DefaultGC(XDisplay, DefaultScreen(XDisplay));
 	Window myWindow=XWindow;
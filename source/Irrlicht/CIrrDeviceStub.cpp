@@ -13,6 +13,10 @@
 #include "CLogger.h"
 #include "irrString.h"
 #include "IRandomizer.h"
+#include "CJobPool.h"
+#include "CNullDriver.h"
+#include "CFileSystem.h"
+#include "CSceneCollisionManager.h"
 
 namespace irr
 {
@@ -22,7 +26,7 @@ CIrrDeviceStub::CIrrDeviceStub(const SIrrlichtCreationParameters& params)
 	Timer(0), CursorControl(0), UserReceiver(params.EventReceiver),
 	Logger(0), Operator(0), Randomizer(0), FileSystem(0),
 	InputReceivingSceneManager(0), VideoModeList(0), ContextManager(0),
-	CreationParams(params), Close(false)
+	JobPool(0), CreationParams(params), Close(false)
 {
 	Timer = new CTimer(params.UsePerformanceTimer);
 	if (os::Printer::Logger)
@@ -43,6 +47,9 @@ CIrrDeviceStub::CIrrDeviceStub(const SIrrlichtCreationParameters& params)
 
 	FileSystem = io::createFileSystem();
 	VideoModeList = new video::CVideoModeList();
+	JobPool = new CJobPool(params.WorkerThreads);
+	// the file system is always a CFileSystem
+	static_cast<io::CFileSystem*>(FileSystem)->setJobPool(JobPool);
 
 	core::stringc s = "Irrlicht Engine version ";
 	s.append(getVersion());
@@ -83,6 +90,9 @@ CIrrDeviceStub::~CIrrDeviceStub()
 	if (Randomizer)
 		Randomizer->drop();
 
+	if (JobPool)
+		JobPool->drop();
+
 	CursorControl = 0;
 
 	if (Timer)
@@ -95,6 +105,10 @@ CIrrDeviceStub::~CIrrDeviceStub()
 
 void CIrrDeviceStub::createGUIAndScene()
 {
+	// all drivers are derived from the null driver
+	if (VideoDriver)
+		static_cast<video::CNullDriver*>(VideoDriver)->setJobPool(JobPool);
+
 	#ifdef _IRR_COMPILE_WITH_GUI_
 	// create gui environment
 	GUIEnvironment = gui::createGUIEnvironment(FileSystem, VideoDriver, Operator);
@@ -102,6 +116,8 @@ void CIrrDeviceStub::createGUIAndScene()
 
 	// create Scene manager
 	SceneManager = scene::createSceneManager(VideoDriver, FileSystem, CursorControl, GUIEnvironment);
+	// the scene manager always creates a CSceneCollisionManager
+	static_cast<scene::CSceneCollisionManager*>(SceneManager->getSceneCollisionManager())->setJobPool(JobPool);
 
 	setEventReceiver(UserReceiver);
 }
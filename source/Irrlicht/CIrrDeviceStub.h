@@ -17,6 +17,7 @@ namespace irr
 	class ILogger;
 	class CLogger;
 	class IRandomizer;
+	class CJobPool;
 
 	namespace gui
 	{
@@ -221,6 +222,7 @@ namespace irr
 		SMouseMultiClicks MouseMultiClicks;
 		video::CVideoModeList* VideoModeList;
 		video::IContextManager* ContextManager;
+		CJobPool* JobPool;
 		SIrrlichtCreationParameters CreationParams;
 		bool Close;
 	};
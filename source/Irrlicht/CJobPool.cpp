@@ -0,0 +1,327 @@
+// Copyright (C) 2002-2012 Nikolaus Gebhardt
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#include "CJobPool.h"
+#include "os.h"
+
+#if defined(_IRR_COMPILE_WITH_THREADS_)
+	#if defined(_IRR_WINDOWS_API_)
+		#define WIN32_LEAN_AND_MEAN
+		#include <windows.h>
+	#else
+		#include <pthread.h>
+	#endif
+#endif
+
+namespace irr
+{
+
+#if defined(_IRR_COMPILE_WITH_THREADS_) && defined(_IRR_WINDOWS_API_)
+
+struct SJobPoolPlatform
+{
+	SJobPoolPlatform()
+	{
+		InitializeCriticalSection(&Mutex);
+		InitializeConditionVariable(&WorkAvailable);
+		InitializeConditionVariable(&BatchDone);
+	}
+
+	~SJobPoolPlatform()
+	{
+		DeleteCriticalSection(&Mutex);
+	}
+
+	void lock() { EnterCriticalSection(&Mutex); }
+	void unlock() { LeaveCriticalSection(&Mutex); }
+	void waitForWork() { SleepConditionVariableCS(&WorkAvailable, &Mutex, INFINITE); }
+	void waitForBatch() { SleepConditionVariableCS(&BatchDone, &Mutex, INFINITE); }
+	void signalWork() { WakeAllConditionVariable(&WorkAvailable); }
+	void signalBatch() { WakeAllConditionVariable(&BatchDone); }
+
+	static DWORD WINAPI threadMain(LPVOID pool);
+
+	CRITICAL_SECTION Mutex;
+	CONDITION_VARIABLE WorkAvailable;
+	CONDITION_VARIABLE BatchDone;
+	core::array<HANDLE> Threads;
+};
+
+#elif defined(_IRR_COMPILE_WITH_THREADS_)
+
+struct SJobPoolPlatform
+{
+	SJobPoolPlatform()
+	{
+		pthread_mutex_init(&Mutex, 0);
+		pthread_cond_init(&WorkAvailable, 0);
+		pthread_cond_init(&BatchDone, 0);
+	}
+
+	~SJobPoolPlatform()
+	{
+		pthread_cond_destroy(&BatchDone);
+		pthread_cond_destroy(&WorkAvailable);
+		pthread_mutex_destroy(&Mutex);
+	}
+
+	void lock() { pthread_mutex_lock(&Mutex); }
+	void unlock() { pthread_mutex_unlock(&Mutex); }
+	void waitForWork() { pthread_cond_wait(&WorkAvailable, &Mutex); }
+	void waitForBatch() { pthread_cond_wait(&BatchDone, &Mutex); }
+	void signalWork() { pthread_cond_broadcast(&WorkAvailable); }
+	void signalBatch() { pthread_cond_broadcast(&BatchDone); }
+
+	static void* threadMain(void* pool);
+
+	pthread_mutex_t Mutex;
+	pthread_cond_t WorkAvailable;
+	pthread_cond_t BatchDone;
+	core::array<pthread_t> Threads;
+};
+
+#else
+
+// without thread support everything runs on the calling thread
+struct SJobPoolPlatform
+{
+	void lock() {}
+	void unlock() {}
+	void waitForWork() {}
+	void waitForBatch() {}
+	void signalWork() {}
+	void signalBatch() {}
+};
+
+#endif
+
+
+//! constructor
+CJobPool::CJobPool(u32 threadCount)
+: Platform(0), ThreadCount(0), Quit(false)
+{
+	#ifdef _DEBUG
+	setDebugName("CJobPool");
+	#endif
+
+	Platform = new SJobPoolPlatform();
+
+#if defined(_IRR_COMPILE_WITH_THREADS_)
+	for (u32 i=0; i<threadCount; ++i)
+	{
+	#if defined(_IRR_WINDOWS_API_)
+		HANDLE thread = CreateThread(0, 0, SJobPoolPlatform::threadMain, this, 0, 0);
+		if (!thread)
+			break;
+	#else
+		pthread_t thread;
+		if (pthread_create(&thread, 0, SJobPoolPlatform::threadMain, this))
+			break;
+	#endif
+		Platform->Threads.push_back(thread);
+	}
+	ThreadCount = Platform->Threads.size();
+
+	if (ThreadCount < threadCount)
+		os::Printer::log("Could not create all worker threads.", ELL_WARNING);
+#else
+	if (threadCount)
+		os::Printer::log("Worker threads not available, compiled without _IRR_COMPILE_WITH_THREADS_.", ELL_WARNING);
+#endif
+}
+
+
+//! destructor
+CJobPool::~CJobPool()
+{
+	Platform->lock();
+	Quit = true;
+	Platform->signalWork();
+	Platform->unlock();
+
+#if defined(_IRR_COMPILE_WITH_THREADS_)
+	for (u32 i=0; i<Platform->Threads.size(); ++i)
+	{
+	#if defined(_IRR_WINDOWS_API_)
+		WaitForSingleObject(Platform->Threads[i], INFINITE);
+		CloseHandle(Platform->Threads[i]);
+	#else
+		pthread_join(Platform->Threads[i], 0);
+	#endif
+	}
+#endif
+
+	delete Platform;
+}
+
+
+//! Returns the number of worker threads, not counting the calling thread.
+u32 CJobPool::getThreadCount() const
+{
+	return ThreadCount;
+}
+
+
+//! takes the next job index of the first pending batch, needs the lock
+bool CJobPool::takeJob(SBatch*& batch, u32& index)
+{
+	if (Pending.empty())
+		return false;
+
+	batch = Pending[0];
+	index = batch->Next++;
+
+	// all jobs handed out, the batch leaves the queue
+	if (batch->Next == batch->Count)
+		Pending.erase(0);
+
+	return true;
+}
+
+
+//! executes one job and marks it as done, needs the lock
+void CJobPool::runJob(SBatch* batch, u32 index)
+{
+	Platform->unlock();
+	batch->Function(batch->UserData, index);
+	Platform->lock();
+
+	batch->Done += 1;
+	if (batch->Done == batch->Count)
+		Platform->signalBatch();
+}
+
+
+//! Runs function(userData, i) for all i in [0, count).
+void CJobPool::parallelFor(JobFunction function, void* userData, u32 count)
+{
+	if (0 == count)
+		return;
+
+	if (0 == ThreadCount || 1 == count)
+	{
+		for (u32 i=0; i<count; ++i)
+			function(userData, i);
+		return;
+	}
+
+	SBatch batch;
+	batch.Function = function;
+	batch.UserData = userData;
+	batch.Count = count;
+	batch.Next = 0;
+	batch.Done = 0;
+
+	Platform->lock();
+	Pending.push_back(&batch);
+	Platform->signalWork();
+
+	// help with our own batch
+	while (batch.Next < batch.Count)
+	{
+		const u32 index = batch.Next++;
+		if (batch.Next == batch.Count)
+		{
+			for (u32 i=0; i<Pending.size(); ++i)
+			{
+				if (Pending[i] == &batch)
+				{
+					Pending.erase(i);
+					break;
+				}
+			}
+		}
+		runJob(&batch, index);
+	}
+
+	while (batch.Done < batch.Count)
+		Platform->waitForBatch();
+
+	Platform->unlock();
+}
+
+
+//! Starts function(userData, 0) on a worker thread and returns at once.
+CJobPool::SBatch* CJobPool::startJob(JobFunction function, void* userData)
+{
+	SBatch* job = new SBatch();
+	job->Function = function;
+	job->UserData = userData;
+	job->Count = 1;
+	job->Next = 0;
+	job->Done = 0;
+
+	if (0 == ThreadCount)
+	{
+		job->Next = 1;
+		function(userData, 0);
+		job->Done = 1;
+		return job;
+	}
+
+	Platform->lock();
+	Pending.push_back(job);
+	Platform->signalWork();
+	Platform->unlock();
+
+	return job;
+}
+
+
+//! Returns true when a job started with startJob is done.
+bool CJobPool::isJobDone(const SBatch* job) const
+{
+	Platform->lock();
+	const bool done = job->Done == job->Count;
+	Platform->unlock();
+
+	return done;
+}
+
+
+//! Waits until a job started with startJob is done and releases the handle.
+void CJobPool::finishJob(SBatch* job)
+{
+	Platform->lock();
+	while (job->Done < job->Count)
+		Platform->waitForBatch();
+	Platform->unlock();
+
+	delete job;
+}
+
+
+void CJobPool::workerMain(CJobPool* pool)
+{
+	SBatch* batch;
+	u32 index;
+
+	pool->Platform->lock();
+	while (!pool->Quit)
+	{
+		if (pool->takeJob(batch, index))
+			pool->runJob(batch, index);
+		else
+			pool->Platform->waitForWork();
+	}
+	pool->Platform->unlock();
+}
+
+
+#if defined(_IRR_COMPILE_WITH_THREADS_) && defined(_IRR_WINDOWS_API_)
+DWORD WINAPI SJobPoolPlatform::threadMain(LPVOID pool)
+{
+	CJobPool::workerMain((CJobPool*)pool);
+	return 0;
+}
+#elif defined(_IRR_COMPILE_WITH_THREADS_)
+void* SJobPoolPlatform::threadMain(void* pool)
+{
+	CJobPool::workerMain((CJobPool*)pool);
+	return 0;
+}
+#endif
+
+} // end namespace irr
+
@@ -0,0 +1,90 @@
+// Copyright (C) 2002-2012 Nikolaus Gebhardt
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#ifndef __C_JOB_POOL_H_INCLUDED__
+#define __C_JOB_POOL_H_INCLUDED__
+
+#include "IrrCompileConfig.h"
+#include "IReferenceCounted.h"
+#include "irrArray.h"
+
+namespace irr
+{
+	//! Function executed by the job pool.
+	/** \param userData Pointer passed when the jobs were submitted.
+	\param index Index of the job inside its batch, 0 to count-1. */
+	typedef void (*JobFunction)(void* userData, u32 index);
+
+	struct SJobPoolPlatform;
+
+	//! Fixed set of worker threads which execute batches of jobs.
+	/** The pool is created by the device with
+	SIrrlichtCreationParameters::WorkerThreads threads. With zero worker
+	threads (or when the engine is compiled without _IRR_COMPILE_WITH_THREADS_)
+	all jobs are executed on the calling thread, in index order. */
+	class CJobPool : public virtual IReferenceCounted
+	{
+	public:
+
+		//! constructor
+		CJobPool(u32 threadCount);
+
+		//! destructor, waits for the worker threads to finish
+		virtual ~CJobPool();
+
+		//! Returns the number of worker threads, not counting the calling thread.
+		u32 getThreadCount() const;
+
+		//! Runs function(userData, i) for all i in [0, count).
+		/** The calling thread works on the batch as well and the call
+		returns only when all jobs of the batch are done. Jobs of one
+		batch may run concurrently and in any order, so they must not
+		write to shared data without their own synchronization. */
+		void parallelFor(JobFunction function, void* userData, u32 count);
+
+		//! Jobs of one parallelFor call, also the handle of a job started with startJob
+		struct SBatch
+		{
+			JobFunction Function;
+			void* UserData;
+			u32 Count;
+			u32 Next;
+			u32 Done;
+		};
+
+		//! Starts function(userData, 0) on a worker thread and returns at once.
+		/** Without worker threads the job runs right away on the calling
+		thread. The returned handle has to be passed to finishJob exactly
+		once, before the pool is destroyed. */
+		SBatch* startJob(JobFunction function, void* userData);
+
+		//! Returns true when a job started with startJob is done.
+		/** Everything the job wrote is visible to the caller afterwards. */
+		bool isJobDone(const SBatch* job) const;
+
+		//! Waits until a job started with startJob is done and releases the handle.
+		void finishJob(SBatch* job);
+
+	private:
+
+		friend struct SJobPoolPlatform;
+
+		//! takes the next job index of the first pending batch, needs the lock
+		bool takeJob(SBatch*& batch, u32& index);
+
+		//! executes one job and marks it as done, needs the lock
+		void runJob(SBatch* batch, u32 index);
+
+		static void workerMain(CJobPool* pool);
+
+		core::array<SBatch*> Pending;
+		SJobPoolPlatform* Platform;
+		u32 ThreadCount;
+		bool Quit;
+	};
+
+} // end namespace irr
+
+#endif
+
@@ -49,6 +49,9 @@ public:
 	//! Returns type of the scene node
 	virtual ESCENE_NODE_TYPE getType() const _IRR_OVERRIDE_ { return ESNT_LIGHT; }
 
+	//! updateAbsolutePosition only changes the data of this light
+	virtual bool isAnimationThreadSafe() const _IRR_OVERRIDE_ { return true; }
+
 	//! Writes attributes of the scene node.
 	virtual void serializeAttributes(io::IAttributes* out, io::SAttributeReadWriteOptions* options=0) const _IRR_OVERRIDE_;
 
@@ -92,6 +95,9 @@ public:
 	//! Updates the absolute position based on the relative and the parents position
 	virtual void updateAbsolutePosition() _IRR_OVERRIDE_;
 
+	//! updateAbsolutePosition also updates the light data
+	virtual bool hasDefaultTransformation() const _IRR_OVERRIDE_ { return false; }
+
 private:
 
 	video::SLight LightData;
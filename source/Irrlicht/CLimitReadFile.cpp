@@ -116,6 +116,14 @@ const io::path& CLimitReadFile::getFileName() const
 }
 
 
+//! returns the contents of the area, if the file has its contents in memory
+const void* CLimitReadFile::getData() const
+{
+	const c8* data = File ? (const c8*)File->getData() : 0;
+	return data ? data + AreaStart : 0;
+}
+
+
 IReadFile* createLimitReadFile(const io::path& fileName, IReadFile* alreadyOpenedFile, long pos, long areaSize)
 {
 	return new CLimitReadFile(alreadyOpenedFile, pos, areaSize, fileName);
@@ -46,6 +46,9 @@ namespace io
 		//! returns name of file
 		virtual const io::path& getFileName() const _IRR_OVERRIDE_;
 
+		//! returns the contents of the area, if the file has its contents in memory
+		virtual const void* getData() const _IRR_OVERRIDE_;
+
 	private:
 
 		io::path Filename;
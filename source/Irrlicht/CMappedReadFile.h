@@ -0,0 +1,77 @@
+// Copyright (C) 2002-2012 Nikolaus Gebhardt
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#ifndef __C_MAPPED_READ_FILE_H_INCLUDED__
+#define __C_MAPPED_READ_FILE_H_INCLUDED__
+
+#include "IrrCompileConfig.h"
+
+#ifdef _IRR_COMPILE_WITH_MAPPED_READ_FILE_
+
+#include "IReadFile.h"
+#include "irrString.h"
+
+namespace irr
+{
+
+namespace io
+{
+
+	/*!
+		Class for reading a real file from disk, which is mapped into memory.
+		The contents are available with getData() as long as the file exists.
+	*/
+	class CMappedReadFile : public IReadFile
+	{
+	public:
+
+		CMappedReadFile(const io::path& fileName);
+
+		virtual ~CMappedReadFile();
+
+		//! returns how much was read
+		virtual size_t read(void* buffer, size_t sizeToRead) _IRR_OVERRIDE_;
+
+		//! changes position in file, returns true if successful
+		virtual bool seek(long finalPos, bool relativeMovement = false) _IRR_OVERRIDE_;
+
+		//! returns size of file
+		virtual long getSize() const _IRR_OVERRIDE_;
+
+		//! returns if file is open
+		bool isOpen() const
+		{
+			return Data != 0;
+		}
+
+		//! returns where in the file we are.
+		virtual long getPos() const _IRR_OVERRIDE_;
+
+		//! returns name of file
+		virtual const io::path& getFileName() const _IRR_OVERRIDE_;
+
+		//! returns the mapped contents of the file
+		virtual const void* getData() const _IRR_OVERRIDE_ { return Data; }
+
+		//! create mapped read file on disk.
+		/** Returns 0 if the file can't be mapped, e.g. because it is empty. */
+		static IReadFile* createMappedReadFile(const io::path& fileName);
+
+	private:
+
+		//! maps the file
+		void mapFile();
+
+		const c8* Data;
+		long FileSize;
+		long Pos;
+		io::path Filename;
+	};
+
+} // end namespace io
+} // end namespace irr
+
+#endif // _IRR_COMPILE_WITH_MAPPED_READ_FILE_
+#endif // __C_MAPPED_READ_FILE_H_INCLUDED__
+
@@ -54,6 +54,12 @@ namespace scene
 		//! Returns type of the scene node
 		virtual ESCENE_NODE_TYPE getType() const _IRR_OVERRIDE_ { return ESNT_MESH; }
 
+		//! OnAnimate only runs the animators, so mesh scene nodes may be animated on worker threads
+		virtual bool isAnimationThreadSafe() const _IRR_OVERRIDE_ { return true; }
+
+		//! updateAbsolutePosition is not overridden, so it is skipped while the node doesn't move
+		virtual bool hasDefaultTransformation() const _IRR_OVERRIDE_ { return true; }
+
 		//! Sets a new mesh
 		virtual void setMesh(IMesh* mesh) _IRR_OVERRIDE_;
 
@@ -73,6 +79,9 @@ namespace scene
 		//! Returns if the scene node should not copy the materials of the mesh but use them in a read only style
 		virtual bool isReadOnlyMaterials() const _IRR_OVERRIDE_;
 
+		//! Returns true if the scene manager may draw the solid mesh buffers of this node itself.
+		virtual bool canQueueMeshBuffers() const _IRR_OVERRIDE_ { return !Shadow && !DebugDataVisible; }
+
 		//! Creates a clone of this scene node and its children.
 		virtual ISceneNode* clone(ISceneNode* newParent=0, ISceneManager* newManager=0) _IRR_OVERRIDE_;
 
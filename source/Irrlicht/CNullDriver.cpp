@@ -16,6 +16,7 @@
 #include "CColorConverter.h"
 #include "IAttributeExchangingObject.h"
 #include "IRenderTarget.h"
+#include "CJobPool.h"
 
 
 namespace irr
@@ -87,8 +88,9 @@ IImageWriter* createImageWriterPPM();
 //! constructor
 CNullDriver::CNullDriver(io::IFileSystem* io, const core::dimension2d<u32>& screenSize)
 	: SharedRenderTarget(0), CurrentRenderTarget(0), CurrentRenderTargetSize(0, 0), FileSystem(io), MeshManipulator(0),
-	ViewPort(0, 0, 0, 0), ScreenSize(screenSize), PrimitivesDrawn(0), MinVertexCountForVBO(500),
-	TextureCreationFlags(0), OverrideMaterial2DEnabled(false), AllowZWriteOnTransparent(false)
+	ViewPort(0, 0, 0, 0), ScreenSize(screenSize), PrimitivesDrawn(0), InstanceCount(1), MinVertexCountForVBO(500),
+	TextureCreationFlags(0), OverrideMaterial2DEnabled(false), AllowZWriteOnTransparent(false),
+	JobPool(0)
 {
 	#ifdef _DEBUG
 	setDebugName("CNullDriver");
@@ -236,6 +238,9 @@ CNullDriver::~CNullDriver()
 
 	// delete hardware mesh buffers
 	removeAllHardwareBuffers();
+
+	if (JobPool)
+		JobPool->drop();
 }
 
 
@@ -245,6 +250,9 @@ void CNullDriver::addExternalImageLoader(IImageLoader* loader)
 	if (!loader)
 		return;
 
+	// background loads use the loaders
+	waitForAsyncTextureLoads();
+
 	loader->grab();
 	SurfaceLoader.push_back(loader);
 }
@@ -296,6 +304,8 @@ IImageWriter* CNullDriver::getImageWriter(u32 n)
 //! deletes all textures
 void CNullDriver::deleteAllTextures()
 {
+	cancelAsyncTextureLoads();
+
 	// we need to remove previously set textures which might otherwise be kept in the
 	// last set material member. Could be optimized to reduce state changes.
 	setMaterial(SMaterial());
@@ -310,7 +320,13 @@ void CNullDriver::deleteAllTextures()
 	for (u32 i=0; i<Textures.size(); ++i)
 		Textures[i].Surface->drop();
 
+	for (u32 i=0; i<ReplacedPlaceholders.size(); ++i)
+		ReplacedPlaceholders[i].Placeholder->drop();
+
 	Textures.clear();
+	ReplacedPlaceholders.clear();
+	TextureIndex.clear();
+	AbsolutePaths.clear();
 
 	SharedDepthTextures.clear();
 }
@@ -319,6 +335,7 @@ bool CNullDriver::beginScene(u16 clearFlag, SColor clearColor, f32 clearDepth, u
 {
 	core::clearFPUException();
 	PrimitivesDrawn = 0;
+	updateAsyncTextureLoads();
 	return true;
 }
 
@@ -378,15 +395,24 @@ void CNullDriver::removeTexture(ITexture* texture)
 	if (!texture)
 		return;
 
-	for (u32 i=0; i<Textures.size(); ++i)
+	// a replaced placeholder of getTextureAsync stands for the loaded texture
+	for (u32 j=0; j<ReplacedPlaceholders.size(); ++j)
 	{
-		if (Textures[i].Surface == texture)
+		if (ReplacedPlaceholders[j].Placeholder == texture || ReplacedPlaceholders[j].Texture == texture)
 		{
-			texture->drop();
-			Textures.erase(i);
-			return;
+			texture = ReplacedPlaceholders[j].Texture;
+			ReplacedPlaceholders[j].Placeholder->drop();
+			ReplacedPlaceholders.erase(j);
+			break;
 		}
 	}
+
+	const s32 i = getTexturePosition(texture);
+	if (i >= 0)
+	{
+		eraseTexture(i);
+		texture->drop();
+	}
 }
 
 
@@ -421,12 +447,17 @@ void CNullDriver::renameTexture(ITexture* texture, const io::path& newName)
 {
 	// we can do a const_cast here safely, the name of the ITexture interface
 	// is just readonly to prevent the user changing the texture name without invoking
-	// this method, because the textures will need resorting afterwards
+	// this method, because the name index needs to be updated
+
+	const s32 i = getTexturePosition(texture);
+	if (i >= 0)
+		removeTextureIndex(i);
 
 	io::SNamedPath& name = const_cast<io::SNamedPath&>(texture->getName());
 	name.setPath(newName);
 
-	Textures.sort();
+	if (i >= 0)
+		addTextureIndex(i);
 }
 
 ITexture* CNullDriver::addTexture(const core::dimension2d<u32>& size, const io::path& name, ECOLOR_FORMAT format)
@@ -529,18 +560,10 @@ ITexture* CNullDriver::addTextureCubemap(const io::path& name, IImage* imagePosX
 //! loads a Texture
 ITexture* CNullDriver::getTexture(const io::path& filename)
 {
-	// Identify textures by their absolute filenames if possible.
-	const io::path absolutePath = FileSystem->getAbsolutePath(filename);
-
-	ITexture* texture = findTexture(absolutePath);
-	if (texture)
-	{
-		texture->updateSource(ETS_FROM_CACHE);
-		return texture;
-	}
-
-	// Then try the raw filename, which might be in an Archive
-	texture = findTexture(filename);
+	// Identify textures by their absolute filenames if possible,
+	// then try the raw filename, which might be in an Archive
+	io::path absolutePath;
+	ITexture* texture = findTextureByFilename(filename, absolutePath);
 	if (texture)
 	{
 		texture->updateSource(ETS_FROM_CACHE);
@@ -620,6 +643,281 @@ ITexture* CNullDriver::getTexture(io::IReadFile* file)
 }
 
 
+//! texture loaded in the background by getTextureAsync
+struct CNullDriver::SAsyncTextureLoad
+{
+	CNullDriver* Driver;
+	ITexture* Placeholder;
+	io::IReadFile* File;
+	core::array<IImage*> Images;
+	E_TEXTURE_TYPE Type;
+	core::array<ITextureLoadCallBack*> CallBacks;
+	//! log messages of the loaders, logged on the main thread
+	core::array<os::Printer::SMessage> Messages;
+	CJobPool::SBatch* Job;
+};
+
+
+//! loads a Texture in the background
+ITexture* CNullDriver::getTextureAsync(const io::path& filename, ITextureLoadCallBack* callBack)
+{
+	// same lookup as getTexture
+	io::path absolutePath;
+	ITexture* texture = findTextureByFilename(filename, absolutePath);
+
+	io::IReadFile* file = 0;
+	if (!texture)
+	{
+		file = FileSystem->createAndOpenFile(absolutePath);
+		if (!file)
+			file = FileSystem->createAndOpenFile(filename);
+
+		if (!file)
+		{
+			os::Printer::log("Could not open file of texture", filename, ELL_WARNING);
+			return 0;
+		}
+
+		texture = findTexture(file->getFileName());
+	}
+
+	if (texture)
+	{
+		if (file)
+			file->drop();
+
+		texture->updateSource(ETS_FROM_CACHE);
+
+		if (callBack)
+		{
+			// still loading, inform the callback together with the others
+			for (u32 i=0; i<AsyncTextureLoads.size(); ++i)
+			{
+				if (AsyncTextureLoads[i]->Placeholder == texture)
+				{
+					callBack->grab();
+					AsyncTextureLoads[i]->CallBacks.push_back(callBack);
+					return texture;
+				}
+			}
+
+			callBack->OnTextureLoaded(texture, texture);
+		}
+		return texture;
+	}
+
+	// read the file on this thread, files in archives can't be read from several threads
+	const long size = file->getSize();
+	c8* data = new c8[size > 0 ? size : 1];
+	if (size <= 0 || file->read(data, size) != (size_t)size)
+	{
+		os::Printer::log("Could not read file of texture", filename, ELL_WARNING);
+		delete [] data;
+		file->drop();
+		return 0;
+	}
+
+	io::IReadFile* memoryFile = FileSystem->createMemoryReadFile(data, size, file->getFileName(), true);
+	file->drop();
+
+	// white placeholder until the texture is loaded
+	IImage* image = new CImage(ECF_A8R8G8B8, core::dimension2d<u32>(2, 2));
+	image->fill(SColor(0xFFFFFFFF));
+	texture = createDeviceDependentTexture(memoryFile->getFileName(), image);
+	image->drop();
+
+	if (!texture)
+	{
+		memoryFile->drop();
+		return 0;
+	}
+
+	texture->updateSource(ETS_FROM_FILE);
+	addTexture(texture);
+
+	SAsyncTextureLoad* load = new SAsyncTextureLoad();
+	load->Driver = this;
+	load->Placeholder = texture;
+	load->File = memoryFile;
+	load->Type = ETT_2D;
+	load->Job = 0;
+	if (callBack)
+	{
+		callBack->grab();
+		load->CallBacks.push_back(callBack);
+	}
+	AsyncTextureLoads.push_back(load);
+
+	if (JobPool)
+		load->Job = JobPool->startJob(loadTextureJob, load);
+	else
+		loadTextureJob(load, 0);
+
+	return texture;
+}
+
+
+//! Check if a texture from getTextureAsync is still loading.
+bool CNullDriver::isTextureLoading(const ITexture* texture) const
+{
+	for (u32 i=0; i<AsyncTextureLoads.size(); ++i)
+	{
+		if (AsyncTextureLoads[i]->Placeholder == texture)
+			return true;
+	}
+
+	return false;
+}
+
+
+//! decodes the file of a SAsyncTextureLoad, called from the job pool
+void CNullDriver::loadTextureJob(void* data, u32 index)
+{
+	SAsyncTextureLoad* load = (SAsyncTextureLoad*)data;
+
+	os::Printer::setThreadQueue(&load->Messages);
+	load->Images = load->Driver->createImagesFromFile(load->File, &load->Type);
+	os::Printer::setThreadQueue(0);
+}
+
+
+//! swaps in the textures loaded in the background, called from beginScene
+void CNullDriver::updateAsyncTextureLoads()
+{
+	u32 i = 0;
+	while (i < AsyncTextureLoads.size())
+	{
+		SAsyncTextureLoad* load = AsyncTextureLoads[i];
+
+		if (load->Job)
+		{
+			if (!JobPool->isJobDone(load->Job))
+			{
+				++i;
+				continue;
+			}
+
+			JobPool->finishJob(load->Job);
+		}
+
+		AsyncTextureLoads.erase(i);
+		os::Printer::log(load->Messages);
+
+		const io::path& name = load->Placeholder->getName().getPath();
+		ITexture* texture = 0;
+
+		if (checkImage(load->Images))
+		{
+			if (ETT_2D == load->Type)
+				texture = createDeviceDependentTexture(name, load->Images[0]);
+			else if (ETT_CUBEMAP == load->Type && load->Images.size() >= 6 && load->Images[0] && load->Images[1] &&
+				load->Images[2] && load->Images[3] && load->Images[4] && load->Images[5])
+				texture = createDeviceDependentTextureCubemap(name, load->Images);
+		}
+
+		if (texture)
+		{
+			os::Printer::log("Loaded texture", name, ELL_DEBUG);
+			texture->updateSource(ETS_FROM_FILE);
+
+			if (swapDeviceDependentTexture(load->Placeholder, texture))
+			{
+				// the placeholder has the loaded data now
+				texture->drop();
+				texture = load->Placeholder;
+				texture->grab();
+			}
+			else
+			{
+				// same name, so the name index stays valid. the placeholder
+				// keeps the reference of the cache, it may still be in use.
+				const s32 j = getTexturePosition(load->Placeholder);
+				if (j >= 0)
+				{
+					SReplacedPlaceholder replaced;
+					replaced.Placeholder = load->Placeholder;
+					replaced.Texture = texture;
+					ReplacedPlaceholders.push_back(replaced);
+
+					Textures[j].Surface = texture;
+					texture->grab();
+				}
+			}
+		}
+		else
+			os::Printer::log("Could not load texture", name, ELL_ERROR);
+
+		for (u32 j=0; j<load->CallBacks.size(); ++j)
+		{
+			load->CallBacks[j]->OnTextureLoaded(load->Placeholder, texture);
+			load->CallBacks[j]->drop();
+		}
+
+		if (texture)
+			texture->drop();
+
+		for (u32 j=0; j<load->Images.size(); ++j)
+		{
+			if (load->Images[j])
+				load->Images[j]->drop();
+		}
+
+		load->File->drop();
+		load->Placeholder->drop();
+		delete load;
+	}
+}
+
+
+//! waits until the jobs of all background loads are done
+void CNullDriver::waitForAsyncTextureLoads()
+{
+	for (u32 i=0; i<AsyncTextureLoads.size(); ++i)
+	{
+		if (AsyncTextureLoads[i]->Job)
+		{
+			JobPool->finishJob(AsyncTextureLoads[i]->Job);
+			AsyncTextureLoads[i]->Job = 0;
+		}
+	}
+}
+
+
+//! waits for all background loads and drops them
+void CNullDriver::cancelAsyncTextureLoads()
+{
+	for (u32 i=0; i<AsyncTextureLoads.size(); ++i)
+	{
+		SAsyncTextureLoad* load = AsyncTextureLoads[i];
+
+		if (load->Job)
+			JobPool->finishJob(load->Job);
+
+		for (u32 j=0; j<load->CallBacks.size(); ++j)
+			load->CallBacks[j]->drop();
+
+		for (u32 j=0; j<load->Images.size(); ++j)
+		{
+			if (load->Images[j])
+				load->Images[j]->drop();
+		}
+
+		load->File->drop();
+		load->Placeholder->drop();
+		delete load;
+	}
+
+	AsyncTextureLoads.clear();
+}
+
+
+//! swaps the data of a texture loaded in the background into its placeholder
+bool CNullDriver::swapDeviceDependentTexture(ITexture* placeholder, ITexture* texture)
+{
+	return false;
+}
+
+
 //! opens the file and loads it into the surface
 video::ITexture* CNullDriver::loadTextureFromFile(io::IReadFile* file, const io::path& hashName )
 {
@@ -671,13 +969,7 @@ void CNullDriver::addTexture(video::ITexture* texture)
 		texture->grab();
 
 		Textures.push_back(s);
-
-		// the new texture is now at the end of the texture list. when searching for
-		// the next new texture, the texture array will be sorted and the index of this texture
-		// will be changed. to let the order be more consistent to the user, sort
-		// the textures now already although this isn't necessary:
-
-		Textures.sort();
+		addTextureIndex(Textures.size()-1);
 	}
 }
 
@@ -685,17 +977,138 @@ void CNullDriver::addTexture(video::ITexture* texture)
 //! looks if the image is already loaded
 video::ITexture* CNullDriver::findTexture(const io::path& filename)
 {
-	SSurface s;
-	SDummyTexture dummy(filename, ETT_2D);
-	s.Surface = &dummy;
-
-	s32 index = Textures.binary_search(s);
-	if (index != -1)
-		return Textures[index].Surface;
+	const STextureIndex* index = TextureIndex.find(io::SNamedPath(filename).getInternalName());
+	if (index)
+		return Textures[index->Index].Surface;
 
 	return 0;
 }
 
+
+//! looks for a texture by the filename passed to getTexture
+ITexture* CNullDriver::findTextureByFilename(const io::path& filename, io::path& absolutePath)
+{
+	// the absolute paths depend on the working directory
+	const io::path& workingDirectory = FileSystem->getWorkingDirectory();
+	if (workingDirectory != AbsolutePathsDirectory)
+	{
+		AbsolutePaths.clear();
+		AbsolutePathsDirectory = workingDirectory;
+	}
+
+	// skip the path normalization for filenames found before
+	const io::path* cachedPath = AbsolutePaths.find(filename);
+	if (cachedPath)
+	{
+		ITexture* texture = findTexture(*cachedPath);
+		if (texture)
+			return texture;
+	}
+
+	absolutePath = FileSystem->getAbsolutePath(filename);
+
+	ITexture* texture = findTexture(absolutePath);
+	if (texture)
+	{
+		AbsolutePaths.insert(filename, absolutePath);
+		return texture;
+	}
+
+	return findTexture(filename);
+}
+
+
+//! returns the position of a texture in Textures, -1 if it's not in the cache
+s32 CNullDriver::getTexturePosition(const ITexture* texture) const
+{
+	const STextureIndex* index = TextureIndex.find(texture->getName().getInternalName());
+	if (!index)
+		return -1;
+
+	if (Textures[index->Index].Surface == texture)
+		return index->Index;
+
+	// several textures with the same name
+	if (index->Count > 1)
+	{
+		for (u32 i=0; i<Textures.size(); ++i)
+		{
+			if (Textures[i].Surface == texture)
+				return i;
+		}
+	}
+
+	return -1;
+}
+
+
+//! adds the texture at a position in Textures to the name index
+void CNullDriver::addTextureIndex(u32 position)
+{
+	const io::path& name = Textures[position].Surface->getName().getInternalName();
+
+	STextureIndex* index = TextureIndex.find(name);
+	if (index)
+	{
+		++index->Count;
+	}
+	else
+	{
+		STextureIndex entry;
+		entry.Index = position;
+		entry.Count = 1;
+		TextureIndex.insert(name, entry);
+	}
+}
+
+
+//! removes the texture at a position in Textures from the name index
+void CNullDriver::removeTextureIndex(u32 position)
+{
+	const io::path& name = Textures[position].Surface->getName().getInternalName();
+
+	STextureIndex* index = TextureIndex.find(name);
+	if (!index)
+		return;
+
+	if (--index->Count == 0)
+	{
+		TextureIndex.remove(name);
+	}
+	else if (index->Index == position)
+	{
+		// another texture with the same name is found from now on
+		for (u32 i=0; i<Textures.size(); ++i)
+		{
+			if (i != position && Textures[i].Surface->getName().getInternalName() == name)
+			{
+				index->Index = i;
+				break;
+			}
+		}
+	}
+}
+
+
+//! removes the texture at a position from Textures and from the name index
+void CNullDriver::eraseTexture(u32 position)
+{
+	removeTextureIndex(position);
+
+	// the last texture moves into the gap
+	const u32 last = Textures.size()-1;
+	if (position != last)
+	{
+		Textures[position] = Textures[last];
+
+		STextureIndex* index = TextureIndex.find(Textures[position].Surface->getName().getInternalName());
+		if (index && index->Index == last)
+			index->Index = position;
+	}
+
+	Textures.erase(last);
+}
+
 ITexture* CNullDriver::createDeviceDependentTexture(const io::path& name, IImage* image)
 {
 	return new SDummyTexture(name, ETT_2D);
@@ -767,7 +1180,7 @@ void CNullDriver::drawVertexPrimitiveList(const void* vertices, u32 vertexCount,
 {
 	if ((iType==EIT_16BIT) && (vertexCount>65536))
 		os::Printer::log("Too many vertices for 16bit index type, render artifacts may occur.");
-	PrimitivesDrawn += primitiveCount;
+	PrimitivesDrawn += primitiveCount * InstanceCount;
 }
 
 
@@ -1708,12 +2121,8 @@ IImage* CNullDriver::createImage(ITexture* texture, const core::position2d<s32>&
 		IImage* image = new CImage(texture->getColorFormat(), clamped.getSize());
 		u8* dst = static_cast<u8*>(image->getData());
 		src += clamped.UpperLeftCorner.Y * texture->getPitch() + image->getBytesPerPixel() * clamped.UpperLeftCorner.X;
-		for (u32 i=0; i<clamped.getHeight(); ++i)
-		{
-			video::CColorConverter::convert_viaFormat(src, texture->getColorFormat(), clamped.getWidth(), dst, image->getColorFormat());
-			src += texture->getPitch();
-			dst += image->getPitch();
-		}
+		video::CColorConverter::convert_viaFormat(src, texture->getColorFormat(), texture->getPitch(),
+			dst, image->getColorFormat(), image->getPitch(), clamped.getWidth(), clamped.getHeight(), JobPool);
 		texture->unlock();
 		return image;
 	}
@@ -1762,6 +2171,21 @@ void CNullDriver::drawMeshBuffer(const scene::IMeshBuffer* mb)
 }
 
 
+//! Draws many instances of a mesh buffer, one after another
+void CNullDriver::drawMeshBufferInstances(const scene::IMeshBuffer* mb,
+		const core::matrix4* transformations, const SColor* colors, u32 instanceCount)
+{
+	if (!mb)
+		return;
+
+	for (u32 i=0; i<instanceCount; ++i)
+	{
+		setTransform(ETS_WORLD, transformations[i]);
+		drawMeshBuffer(mb);
+	}
+}
+
+
 //! Draws the normals of a mesh buffer
 void CNullDriver::drawMeshBufferNormals(const scene::IMeshBuffer* mb, f32 length, SColor color)
 {
@@ -2684,6 +3108,19 @@ void CNullDriver::setMinHardwareBufferVertexCount(u32 count)
 }
 
 
+//! Sets the worker threads the driver may use
+void CNullDriver::setJobPool(CJobPool* pool)
+{
+	if (pool)
+		pool->grab();
+
+	if (JobPool)
+		JobPool->drop();
+
+	JobPool = pool;
+}
+
+
 SOverrideMaterial& CNullDriver::getOverrideMaterial()
 {
 	return OverrideMaterial;
@@ -2723,6 +3160,26 @@ determined by the color formats.
 void CNullDriver::convertColor(const void* sP, ECOLOR_FORMAT sF, s32 sN,
 		void* dP, ECOLOR_FORMAT dF) const
 {
+	// long runs are converted as rows of an image, to use the worker threads.
+	// overlapping arrays, like in place conversions to a smaller format, are
+	// converted in order, a row would overwrite pixels of the next one.
+	const u32 rowLength = 4096;
+	const u32 sBytes = IImage::getBitsPerPixelFromFormat(sF) / 8;
+	const u32 dBytes = IImage::getBitsPerPixelFromFormat(dF) / 8;
+	const u8* sBegin = (const u8*) sP;
+	const u8* dBegin = (const u8*) dP;
+	const bool overlap = sN > 0 && sBegin < dBegin + sN * dBytes && dBegin < sBegin + sN * sBytes;
+	const u32 rows = JobPool && JobPool->getThreadCount() && !overlap ? (u32)sN / rowLength : 0;
+	if (rows > 1)
+	{
+		video::CColorConverter::convert_viaFormat(sP, sF, rowLength * sBytes, dP, dF, rowLength * dBytes,
+			rowLength, rows, JobPool);
+
+		sP = (const u8*) sP + rows * rowLength * sBytes;
+		dP = (u8*) dP + rows * rowLength * dBytes;
+		sN -= rows * rowLength;
+	}
+
 	video::CColorConverter::convert_viaFormat(sP, sF, sN, dP, dF);
 }
 
@@ -21,6 +21,7 @@
 #include "SVertexIndex.h"
 #include "SLight.h"
 #include "SExposedVideoData.h"
+#include "CPathHashMap.h"
 
 #ifdef _MSC_VER
 #pragma warning( disable: 4996)
@@ -28,6 +29,8 @@
 
 namespace irr
 {
+	class CJobPool;
+
 namespace io
 {
 	class IWriteFile;
@@ -86,6 +89,12 @@ namespace video
 		//! loads a Texture
 		virtual ITexture* getTexture(io::IReadFile* file) _IRR_OVERRIDE_;
 
+		//! loads a Texture in the background
+		virtual ITexture* getTextureAsync(const io::path& filename, ITextureLoadCallBack* callBack = 0) _IRR_OVERRIDE_;
+
+		//! Check if a texture from getTextureAsync is still loading.
+		virtual bool isTextureLoading(const ITexture* texture) const _IRR_OVERRIDE_;
+
 		//! Returns a texture by index
 		virtual ITexture* getTextureByIndex(u32 index) _IRR_OVERRIDE_;
 
@@ -375,6 +384,10 @@ namespace video
 		//! Draws a mesh buffer
 		virtual void drawMeshBuffer(const scene::IMeshBuffer* mb) _IRR_OVERRIDE_;
 
+		//! Draws many instances of a mesh buffer, one after another
+		virtual void drawMeshBufferInstances(const scene::IMeshBuffer* mb,
+			const core::matrix4* transformations, const SColor* colors, u32 instanceCount) _IRR_OVERRIDE_;
+
 		//! Draws the normals of a mesh buffer
 		virtual void drawMeshBufferNormals(const scene::IMeshBuffer* mb, f32 length=10.f,
 			SColor color=0xffffffff) _IRR_OVERRIDE_;
@@ -679,6 +692,15 @@ namespace video
 				const c8* name=0);
 
 		virtual bool checkDriverReset() _IRR_OVERRIDE_ {return false;}
+
+		//! Only used by the engine internally.
+		/** Sets the worker threads the driver may use, 0 to use none. */
+		virtual void setJobPool(CJobPool* pool);
+
+		//! Only used by the engine internally.
+		/** Worker threads of the device, used by the drivers, textures and skinned meshes. */
+		CJobPool* getJobPool() const { return JobPool; }
+
 	protected:
 
 		//! deletes all textures
@@ -694,6 +716,44 @@ namespace video
 
 		virtual ITexture* createDeviceDependentTextureCubemap(const io::path& name, const core::array<IImage*>& image);
 
+		//! looks for a texture by the filename passed to getTexture
+		/** Checks the absolute path first, then the filename itself.
+		\param absolutePath Set to the absolute path of the filename.
+		It is only computed when the filename hasn't been found before. */
+		ITexture* findTextureByFilename(const io::path& filename, io::path& absolutePath);
+
+		//! returns the position of a texture in Textures, -1 if it's not in the cache
+		s32 getTexturePosition(const ITexture* texture) const;
+
+		//! adds the texture at a position in Textures to the name index
+		void addTextureIndex(u32 position);
+
+		//! removes the texture at a position in Textures from the name index
+		void removeTextureIndex(u32 position);
+
+		//! removes the texture at a position from Textures and from the name index
+		void eraseTexture(u32 position);
+
+		//! swaps the data of a texture loaded in the background into its placeholder
+		/** Both textures are created by createDeviceDependentTexture(Cubemap).
+		\return False if the driver doesn't support it. */
+		virtual bool swapDeviceDependentTexture(ITexture* placeholder, ITexture* texture);
+
+		//! texture loaded in the background by getTextureAsync
+		struct SAsyncTextureLoad;
+
+		//! decodes the file of a SAsyncTextureLoad, called from the job pool
+		static void loadTextureJob(void* load, u32 index);
+
+		//! swaps in the textures loaded in the background, called from beginScene
+		void updateAsyncTextureLoads();
+
+		//! waits until the jobs of all background loads are done
+		void waitForAsyncTextureLoads();
+
+		//! waits for all background loads and drops them
+		void cancelAsyncTextureLoads();
+
 		//! checks triangle count and print warning if wrong
 		bool checkPrimitiveCount(u32 prmcnt) const;
 
@@ -760,11 +820,15 @@ namespace video
 		struct SSurface
 		{
 			video::ITexture* Surface;
+		};
 
-			bool operator < (const SSurface& other) const
-			{
-				return Surface->getName() < other.Surface->getName();
-			}
+		//! position of the first texture with a name in Textures and the number of textures with it
+		struct STextureIndex
+		{
+			STextureIndex() : Index(0), Count(0) {}
+
+			u32 Index;
+			u32 Count;
 		};
 
 		struct SMaterialRenderer
@@ -782,10 +846,25 @@ namespace video
 			virtual void regenerateMipMapLevels(void* data = 0, u32 layer = 0) _IRR_OVERRIDE_ {}
 		};
 		core::array<SSurface> Textures;
+		//! Textures by internal name
+		io::CPathHashMap<STextureIndex> TextureIndex;
+		//! absolute path of filenames passed to getTexture, valid for AbsolutePathsDirectory
+		io::CPathHashMap<io::path> AbsolutePaths;
+		io::path AbsolutePathsDirectory;
+		core::array<SAsyncTextureLoad*> AsyncTextureLoads;
+
+		//! placeholder of getTextureAsync replaced in Textures by the loaded texture
+		struct SReplacedPlaceholder
+		{
+			ITexture* Placeholder;
+			ITexture* Texture;
+		};
+		//! kept until the loaded texture is removed, users may still hold the placeholder
+		core::array<SReplacedPlaceholder> ReplacedPlaceholders;
 
 		struct SOccQuery
 		{
-			SOccQuery(scene::ISceneNode* node, const scene::IMesh* mesh=0) : Node(node), Mesh(mesh), PID(0), Result(0xffffffff), Run(0xffffffff)
+			SOccQuery(scene::ISceneNode* node, const scene::IMesh* mesh=0) : Node(node), Mesh(mesh), PID(0), Result(0xffffffff), PendingResult(0), Run(0xffffffff)
 			{
 				if (Node)
 					Node->grab();
@@ -793,7 +872,7 @@ namespace video
 					Mesh->grab();
 			}
 
-			SOccQuery(const SOccQuery& other) : Node(other.Node), Mesh(other.Mesh), PID(other.PID), Result(other.Result), Run(other.Run)
+			SOccQuery(const SOccQuery& other) : Node(other.Node), Mesh(other.Mesh), PID(other.PID), Result(other.Result), PendingResult(other.PendingResult), Run(other.Run)
 			{
 				if (Node)
 					Node->grab();
@@ -815,6 +894,7 @@ namespace video
 				Mesh=other.Mesh;
 				PID=other.PID;
 				Result=other.Result;
+				PendingResult=other.PendingResult;
 				Run=other.Run;
 				if (Node)
 					Node->grab();
@@ -836,6 +916,8 @@ namespace video
 				unsigned int UID;
 			};
 			u32 Result;
+			//! result of drivers which count without a hardware query, until the update
+			u32 PendingResult;
 			u32 Run;
 		};
 		core::array<SOccQuery> OcclusionQueries;
@@ -869,6 +951,8 @@ namespace video
 		CFPSCounter FPSCounter;
 
 		u32 PrimitivesDrawn;
+		//! Instances drawn by the next draw call of an instanced driver
+		u32 InstanceCount;
 		u32 MinVertexCountForVBO;
 
 		u32 TextureCreationFlags;
@@ -894,6 +978,8 @@ namespace video
 		bool FeatureEnabled[video::EVDF_COUNT];
 
 		SColorf AmbientLight;
+
+		CJobPool* JobPool;
 	};
 
 } // end namespace video
@@ -89,13 +89,20 @@ IAnimatedMesh* COBJMeshFileLoader::createMesh(io::IReadFile* file)
 	const io::path fullName = file->getFileName();
 	const io::path relPath = FileSystem->getFileDir(fullName)+"/";
 
-	c8* buf = new c8[filesize];
-	memset(buf, 0, filesize);
-	file->read((void*)buf, filesize);
-	const c8* const bufEnd = buf+filesize;
+	// parse the contents in place if the file has them in memory
+	const c8* data = (const c8*)file->getData();
+	c8* buf = 0;
+	if (!data)
+	{
+		buf = new c8[filesize];
+		memset(buf, 0, filesize);
+		file->read((void*)buf, filesize);
+		data = buf;
+	}
+	const c8* const bufEnd = data+filesize;
 
 	// Process obj information
-	const c8* bufPtr = buf;
+	const c8* bufPtr = data;
 	core::stringc grpName, mtlName;
 	bool mtlChanged=false;
 	bool useGroups = !SceneManager->getParameters()->getAttributeAsBool(OBJ_LOADER_IGNORE_GROUPS);
@@ -529,13 +536,19 @@ void COBJMeshFileLoader::readMTL(const c8* fileName, const io::path& relPath)
 		return;
 	}
 
-	c8* buf = new c8[filesize];
-	mtlReader->read((void*)buf, filesize);
-	const c8* bufEnd = buf+filesize;
+	const c8* data = (const c8*)mtlReader->getData();
+	c8* buf = 0;
+	if (!data)
+	{
+		buf = new c8[filesize];
+		mtlReader->read((void*)buf, filesize);
+		data = buf;
+	}
+	const c8* bufEnd = data+filesize;
 
 	SObjMtl* currMaterial = 0;
 
-	const c8* bufPtr = buf;
+	const c8* bufPtr = data;
 	while(bufPtr != bufEnd)
 	{
 		switch(*bufPtr)
@@ -709,6 +709,69 @@ COGLES2Driver::~COGLES2Driver()
 	}
 
 
+	//! Draws many instances of a mesh buffer
+	void COGLES2Driver::drawMeshBufferInstances(const scene::IMeshBuffer* mb,
+			const core::matrix4* transformations, const SColor* colors, u32 instanceCount)
+	{
+		if (!mb || !instanceCount)
+			return;
+
+		if (instanceCount == 1 || mb->getPrimitiveType() != scene::EPT_TRIANGLES || !queryFeature(EVDF_INSTANCED_DRAW))
+		{
+			CNullDriver::drawMeshBufferInstances(mb, transformations, colors, instanceCount);
+			return;
+		}
+
+		// the shader of the material has to be bound to find its attributes
+		setTransform(ETS_WORLD, core::IdentityMatrix);
+		setRenderStates3DMode();
+
+		GLint program = 0;
+		glGetIntegerv(GL_CURRENT_PROGRAM, &program);
+		const GLint matrixAttribute = program ? glGetAttribLocation(program, "inInstanceMatrix") : -1;
+		if (matrixAttribute < 0)
+		{
+			CNullDriver::drawMeshBufferInstances(mb, transformations, colors, instanceCount);
+			return;
+		}
+		const GLint colorAttribute = colors ? glGetAttribLocation(program, "inInstanceColor") : -1;
+
+		// the instance data stays in client memory
+		glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+		// one attribute per matrix column
+		for (u32 i = 0; i < 4; ++i)
+		{
+			glEnableVertexAttribArray(matrixAttribute + i);
+			glVertexAttribPointer(matrixAttribute + i, 4, GL_FLOAT, false, sizeof(core::matrix4), transformations[0].pointer() + i * 4);
+			irrGlVertexAttribDivisor(matrixAttribute + i, 1);
+		}
+
+		if (colorAttribute >= 0)
+		{
+			glEnableVertexAttribArray(colorAttribute);
+			glVertexAttribPointer(colorAttribute, 4, GL_UNSIGNED_BYTE, true, sizeof(SColor), colors);
+			irrGlVertexAttribDivisor(colorAttribute, 1);
+		}
+
+		InstanceCount = instanceCount;
+		drawMeshBuffer(mb);
+		InstanceCount = 1;
+
+		for (u32 i = 0; i < 4; ++i)
+		{
+			irrGlVertexAttribDivisor(matrixAttribute + i, 0);
+			glDisableVertexAttribArray(matrixAttribute + i);
+		}
+
+		if (colorAttribute >= 0)
+		{
+			irrGlVertexAttribDivisor(colorAttribute, 0);
+			glDisableVertexAttribArray(colorAttribute);
+		}
+	}
+
+
 	IRenderTarget* COGLES2Driver::addRenderTarget()
 	{
 		COGLES2RenderTarget* renderTarget = new COGLES2RenderTarget(this);
@@ -857,7 +920,10 @@ COGLES2Driver::~COGLES2Driver()
 				glDrawElements(GL_TRIANGLE_FAN, primitiveCount + 2, indexSize, indexList);
 				break;
 			case scene::EPT_TRIANGLES:
-				glDrawElements((LastMaterial.Wireframe) ? GL_LINES : (LastMaterial.PointCloud) ? GL_POINTS : GL_TRIANGLES, primitiveCount*3, indexSize, indexList);
+				if (InstanceCount > 1)
+					irrGlDrawElementsInstanced((LastMaterial.Wireframe) ? GL_LINES : (LastMaterial.PointCloud) ? GL_POINTS : GL_TRIANGLES, primitiveCount*3, indexSize, indexList, InstanceCount);
+				else
+					glDrawElements((LastMaterial.Wireframe) ? GL_LINES : (LastMaterial.PointCloud) ? GL_POINTS : GL_TRIANGLES, primitiveCount*3, indexSize, indexList);
 				break;
 			default:
 				break;
@@ -1574,6 +1640,16 @@ COGLES2Driver::~COGLES2Driver()
 		return texture;
 	}
 
+	bool COGLES2Driver::swapDeviceDependentTexture(ITexture* placeholder, ITexture* texture)
+	{
+		static_cast<COGLES2Texture*>(placeholder)->swap(static_cast<COGLES2Texture*>(texture));
+
+		// the texture units have to be bound again
+		ResetRenderStates = true;
+
+		return true;
+	}
+
 	//! Sets a material.
 	void COGLES2Driver::setMaterial(const SMaterial& material)
 	{
@@ -94,6 +94,10 @@ namespace video
 		//! Draw hardware buffer
 		virtual void drawHardwareBuffer(SHWBufferLink *HWBuffer) _IRR_OVERRIDE_;
 
+		//! Draws many instances of a mesh buffer
+		virtual void drawMeshBufferInstances(const scene::IMeshBuffer* mb,
+			const core::matrix4* transformations, const SColor* colors, u32 instanceCount) _IRR_OVERRIDE_;
+
 		virtual IRenderTarget* addRenderTarget() _IRR_OVERRIDE_;
 
 		//! draws a vertex primitive list
@@ -334,6 +338,8 @@ namespace video
 
 		virtual ITexture* createDeviceDependentTextureCubemap(const io::path& name, const core::array<IImage*>& image) _IRR_OVERRIDE_;
 
+		virtual bool swapDeviceDependentTexture(ITexture* placeholder, ITexture* texture) _IRR_OVERRIDE_;
+
 		//! Map Irrlicht wrap mode to OpenGL enum
 		GLint getTextureWrapMode(u8 clamp) const;
 
@@ -12,6 +12,10 @@
 #include "SMaterial.h"
 #include "fast_atof.h"
 
+#ifdef _IRR_COMPILE_WITH_EGL_MANAGER_
+#include <EGL/egl.h>
+#endif
+
 namespace irr
 {
 namespace video
@@ -48,6 +52,28 @@ namespace video
 
 		Feature.TextureUnit = core::min_(Feature.TextureUnit, static_cast<u8>(MATERIAL_MAX_TEXTURES));
 		Feature.ColorAttachment = 1;
+
+	#ifdef _IRR_COMPILE_WITH_EGL_MANAGER_
+		const char* suffix = 0;
+		if (Version >= 300)
+			suffix = "";
+		else if (FeatureAvailable[IRR_GL_EXT_instanced_arrays])
+			suffix = "EXT";
+		else if (FeatureAvailable[IRR_GL_ANGLE_instanced_arrays])
+			suffix = "ANGLE";
+		else if (FeatureAvailable[IRR_GL_NV_draw_instanced] && FeatureAvailable[IRR_GL_NV_instanced_arrays])
+			suffix = "NV";
+
+		if (suffix)
+		{
+			core::stringc name("glDrawElementsInstanced");
+			name += suffix;
+			pGlDrawElementsInstanced = (PFNIRRGLDRAWELEMENTSINSTANCEDPROC)eglGetProcAddress(name.c_str());
+			name = "glVertexAttribDivisor";
+			name += suffix;
+			pGlVertexAttribDivisor = (PFNIRRGLVERTEXATTRIBDIVISORPROC)eglGetProcAddress(name.c_str());
+		}
+	#endif
 	}
 
 } // end namespace video
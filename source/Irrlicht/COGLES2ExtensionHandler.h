@@ -26,7 +26,8 @@ namespace video
 	class COGLES2ExtensionHandler : public COGLESCoreExtensionHandler
 	{
 	public:
-		COGLES2ExtensionHandler() : COGLESCoreExtensionHandler() {}
+		COGLES2ExtensionHandler() : COGLESCoreExtensionHandler(),
+			pGlDrawElementsInstanced(0), pGlVertexAttribDivisor(0) {}
 
 		void initExtensions();
 
@@ -79,6 +80,8 @@ namespace video
 				return false;
 			case EVDF_STENCIL_BUFFER:
 				return StencilBuffer;
+			case EVDF_INSTANCED_DRAW:
+				return pGlDrawElementsInstanced && pGlVertexAttribDivisor;
 			default:
 				return false;
 			};
@@ -185,6 +188,26 @@ namespace video
 		inline void irrGlBlendEquationSeparateIndexed(GLuint buf, GLenum modeRGB, GLenum modeAlpha)
 		{
 		}
+
+		inline void irrGlDrawElementsInstanced(GLenum mode, GLsizei count, GLenum type, const void* indices, GLsizei primcount)
+		{
+			if (pGlDrawElementsInstanced)
+				pGlDrawElementsInstanced(mode, count, type, indices, primcount);
+		}
+
+		inline void irrGlVertexAttribDivisor(GLuint index, GLuint divisor)
+		{
+			if (pGlVertexAttribDivisor)
+				pGlVertexAttribDivisor(index, divisor);
+		}
+
+	protected:
+		// OpenGL ES 3.0 or one of the instancing extensions
+		typedef void (GL_APIENTRYP PFNIRRGLDRAWELEMENTSINSTANCEDPROC) (GLenum mode, GLsizei count, GLenum type, const void* indices, GLsizei primcount);
+		typedef void (GL_APIENTRYP PFNIRRGLVERTEXATTRIBDIVISORPROC) (GLuint index, GLuint divisor);
+
+		PFNIRRGLDRAWELEMENTSINSTANCEDPROC pGlDrawElementsInstanced;
+		PFNIRRGLVERTEXATTRIBDIVISORPROC pGlVertexAttribDivisor;
 	};
 
 }
@@ -1425,6 +1425,16 @@ ITexture* COGLES1Driver::createDeviceDependentTextureCubemap(const io::path& nam
 	return texture;
 }
 
+bool COGLES1Driver::swapDeviceDependentTexture(ITexture* placeholder, ITexture* texture)
+{
+	static_cast<COGLES1Texture*>(placeholder)->swap(static_cast<COGLES1Texture*>(texture));
+
+	// the texture units have to be bound again
+	ResetRenderStates = true;
+
+	return true;
+}
+
 //! Sets a material. All 3d drawing functions draw geometry now using this material.
 void COGLES1Driver::setMaterial(const SMaterial& material)
 {
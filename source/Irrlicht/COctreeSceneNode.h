@@ -56,6 +56,12 @@ namespace scene
 		//! Returns type of the scene node
 		virtual ESCENE_NODE_TYPE getType() const _IRR_OVERRIDE_ { return ESNT_OCTREE; }
 
+		//! The octree is culled in OnRegisterSceneNode, OnAnimate is the default one
+		virtual bool isAnimationThreadSafe() const _IRR_OVERRIDE_ { return true; }
+
+		//! Octree scene nodes use the default transformation
+		virtual bool hasDefaultTransformation() const _IRR_OVERRIDE_ { return true; }
+
 		//! Sets a new mesh to display
 		virtual void setMesh(IMesh* mesh) _IRR_OVERRIDE_;
 
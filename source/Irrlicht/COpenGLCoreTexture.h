@@ -411,6 +411,27 @@ public:
 		return StatesCache;
 	}
 
+	//! swaps the GL texture and its properties with another texture, keeps the name
+	/** Used to swap in textures loaded in the background. */
+	void swap(COpenGLCoreTexture* other)
+	{
+		Driver->getCacheHandler()->getTextureCache().remove(this);
+		Driver->getCacheHandler()->getTextureCache().remove(other);
+
+		swapProperties(*other);
+
+		core::swap(TextureType, other->TextureType);
+		core::swap(TextureName, other->TextureName);
+		core::swap(InternalFormat, other->InternalFormat);
+		core::swap(PixelFormat, other->PixelFormat);
+		core::swap(PixelType, other->PixelType);
+		core::swap(Converter, other->Converter);
+		core::swap(KeepImage, other->KeepImage);
+		Image.swap(other->Image);
+		core::swap(AutoGenerateMipMaps, other->AutoGenerateMipMaps);
+		core::swap(StatesCache, other->StatesCache);
+	}
+
 protected:
 	ECOLOR_FORMAT getBestColorFormat(ECOLOR_FORMAT format)
 	{
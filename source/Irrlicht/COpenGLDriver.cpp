@@ -680,6 +680,84 @@ void COpenGLDriver::drawHardwareBuffer(SHWBufferLink *_HWBuffer)
 }
 
 
+//! Draws many instances of a mesh buffer
+void COpenGLDriver::drawMeshBufferInstances(const scene::IMeshBuffer* mb,
+		const core::matrix4* transformations, const SColor* colors, u32 instanceCount)
+{
+	if (!mb || !instanceCount)
+		return;
+
+	if (instanceCount == 1 || mb->getPrimitiveType() != scene::EPT_TRIANGLES || !queryFeature(EVDF_INSTANCED_DRAW))
+	{
+		CNullDriver::drawMeshBufferInstances(mb, transformations, colors, instanceCount);
+		return;
+	}
+
+	// the shader of the material has to be bound to find its attributes
+	setTransform(ETS_WORLD, core::IdentityMatrix);
+	setRenderStates3DMode();
+
+	GLint program = 0;
+	glGetIntegerv(GL_CURRENT_PROGRAM, &program);
+	const GLint matrixAttribute = program ? extGlGetAttribLocation(program, "inInstanceMatrix") : -1;
+	if (matrixAttribute < 0)
+	{
+		CNullDriver::drawMeshBufferInstances(mb, transformations, colors, instanceCount);
+		return;
+	}
+	const GLint colorAttribute = colors ? extGlGetAttribLocation(program, "inInstanceColor") : -1;
+
+	// the instance data stays in client memory
+	extGlBindBuffer(GL_ARRAY_BUFFER, 0);
+
+	// one attribute per matrix column
+	for (u32 i=0; i<4; ++i)
+	{
+		extGlEnableVertexAttribArray(matrixAttribute + i);
+		extGlVertexAttribPointer(matrixAttribute + i, 4, GL_FLOAT, GL_FALSE, sizeof(core::matrix4), transformations[0].pointer() + i * 4);
+		extGlVertexAttribDivisor(matrixAttribute + i, 1);
+	}
+
+	if (colorAttribute >= 0)
+	{
+		// same conversion as for the vertex colors
+		const u8* colorData = reinterpret_cast<const u8*>(colors);
+		GLint colorSize = 4;
+#ifdef GL_BGRA
+		if (FeatureAvailable[IRR_ARB_vertex_array_bgra] || FeatureAvailable[IRR_EXT_vertex_array_bgra])
+			colorSize = GL_BGRA;
+		else
+#endif
+		{
+			InstanceColorBuffer.set_used(instanceCount * 4);
+			for (u32 i=0; i<instanceCount; ++i)
+				colors[i].toOpenGLColor(&InstanceColorBuffer[i * 4]);
+			colorData = InstanceColorBuffer.const_pointer();
+		}
+
+		extGlEnableVertexAttribArray(colorAttribute);
+		extGlVertexAttribPointer(colorAttribute, colorSize, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(SColor), colorData);
+		extGlVertexAttribDivisor(colorAttribute, 1);
+	}
+
+	InstanceCount = instanceCount;
+	drawMeshBuffer(mb);
+	InstanceCount = 1;
+
+	for (u32 i=0; i<4; ++i)
+	{
+		extGlVertexAttribDivisor(matrixAttribute + i, 0);
+		extGlDisableVertexAttribArray(matrixAttribute + i);
+	}
+
+	if (colorAttribute >= 0)
+	{
+		extGlVertexAttribDivisor(colorAttribute, 0);
+		extGlDisableVertexAttribArray(colorAttribute);
+	}
+}
+
+
 //! Create occlusion query.
 /** Use node for identification and mesh for occlusion test. */
 void COpenGLDriver::addOcclusionQuery(scene::ISceneNode* node,
@@ -1116,7 +1194,10 @@ void COpenGLDriver::renderArray(const void* indexList, u32 primitiveCount,
 			glDrawElements(GL_TRIANGLE_FAN, primitiveCount+2, indexSize, indexList);
 			break;
 		case scene::EPT_TRIANGLES:
-			glDrawElements(GL_TRIANGLES, primitiveCount*3, indexSize, indexList);
+			if (InstanceCount > 1)
+				extGlDrawElementsInstanced(GL_TRIANGLES, primitiveCount*3, indexSize, indexList, InstanceCount);
+			else
+				glDrawElements(GL_TRIANGLES, primitiveCount*3, indexSize, indexList);
 			break;
 		case scene::EPT_QUAD_STRIP:
 			glDrawElements(GL_QUAD_STRIP, primitiveCount*2+2, indexSize, indexList);
@@ -2024,6 +2105,16 @@ ITexture* COpenGLDriver::createDeviceDependentTextureCubemap(const io::path& nam
 	return texture;
 }
 
+bool COpenGLDriver::swapDeviceDependentTexture(ITexture* placeholder, ITexture* texture)
+{
+	static_cast<COpenGLTexture*>(placeholder)->swap(static_cast<COpenGLTexture*>(texture));
+
+	// the texture units have to be bound again
+	ResetRenderStates = true;
+
+	return true;
+}
+
 //! Sets a material. All 3d drawing functions draw geometry now using this material.
 void COpenGLDriver::setMaterial(const SMaterial& material)
 {
@@ -89,6 +89,10 @@ namespace video
 		//! Draw hardware buffer
 		virtual void drawHardwareBuffer(SHWBufferLink *HWBuffer) _IRR_OVERRIDE_;
 
+		//! Draws many instances of a mesh buffer
+		virtual void drawMeshBufferInstances(const scene::IMeshBuffer* mb,
+			const core::matrix4* transformations, const SColor* colors, u32 instanceCount) _IRR_OVERRIDE_;
+
 		//! Create occlusion query.
 		/** Use node for identification and mesh for occlusion test. */
 		virtual void addOcclusionQuery(scene::ISceneNode* node,
@@ -413,6 +417,8 @@ namespace video
 		virtual ITexture* createDeviceDependentTexture(const io::path& name, IImage* image) _IRR_OVERRIDE_;
 
 		virtual ITexture* createDeviceDependentTextureCubemap(const io::path& name, const core::array<IImage*>& image) _IRR_OVERRIDE_;
+
+		virtual bool swapDeviceDependentTexture(ITexture* placeholder, ITexture* texture) _IRR_OVERRIDE_;
 		
 		//! creates a transposed matrix in supplied GLfloat array to pass to OpenGL
 		inline void getGLMatrix(GLfloat gl_matrix[16], const core::matrix4& m);
@@ -446,6 +452,7 @@ namespace video
 		core::stringw Name;
 		core::matrix4 Matrices[ETS_COUNT];
 		core::array<u8> ColorBuffer;
+		core::array<u8> InstanceColorBuffer;
 
 		//! enumeration for rendering modes such as 2d and 3d for minizing the switching of renderStates.
 		enum E_RENDER_MODE
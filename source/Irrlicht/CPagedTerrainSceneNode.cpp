@@ -0,0 +1,404 @@
+// Copyright (C) 2002-2012 Nikolaus Gebhardt
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#include "CPagedTerrainSceneNode.h"
+#include "CTerrainSceneNode.h"
+#include "CTerrainTriangleSelector.h"
+#include "CNullDriver.h"
+#include "ISceneManager.h"
+#include "ICameraSceneNode.h"
+#include "IMetaTriangleSelector.h"
+#include "IFileSystem.h"
+#include "IReadFile.h"
+#include "IMesh.h"
+#include "os.h"
+
+namespace irr
+{
+namespace scene
+{
+
+//! constructor
+CPagedTerrainSceneNode::CPagedTerrainSceneNode(ISceneNode* parent, ISceneManager* mgr,
+		io::IFileSystem* fs, io::IReadFile* file, const core::dimension2du& size, s32 id,
+		const core::vector3df& position, const core::vector3df& scale,
+		video::SColor vertexColor, s32 maxLOD, E_TERRAIN_PATCH_SIZE patchSize,
+		u32 tileSize, u32 maxResidentTiles, s32 bitsPerPixel, bool signedData,
+		s32 selectorLOD)
+	: IPagedTerrainSceneNode(parent, mgr, id, position),
+	FileSystem(fs), File(file), JobPool(0), Selector(0),
+	DataStart(file ? file->getPos() : 0), Size(size), TerrainPosition(position),
+	TerrainScale(scale), VertexColor(vertexColor), MaxLOD(maxLOD), PatchSize(patchSize),
+	TileSize(0), TilesX(0), TilesZ(0), MaxResidentTiles(maxResidentTiles),
+	LoadDistance(0.f), Frame(0), BitsPerPixel(bitsPerPixel), SelectorLOD(selectorLOD),
+	SignedData(signedData)
+{
+	#ifdef _DEBUG
+	setDebugName("CPagedTerrainSceneNode");
+	#endif
+
+	if (FileSystem)
+		FileSystem->grab();
+	if (File)
+		File->grab();
+
+	// the patches have to fit into the tiles and the tiles have to cover
+	// the heightmap, which consists of whole patches
+	const u32 patchQuads = (u32)PatchSize - 1;
+	TileSize = core::max_(tileSize / patchQuads, 1u) * patchQuads;
+	while (TileSize > patchQuads && ((Size.Width - 1) % TileSize || (Size.Height - 1) % TileSize))
+		TileSize -= patchQuads;
+	if (Size.Height > TileSize)
+		TilesX = (Size.Height - 1) / TileSize;
+	if (Size.Width > TileSize)
+		TilesZ = (Size.Width - 1) / TileSize;
+
+	Tiles.reallocate(TilesX * TilesZ);
+	for (u32 i=0; i<TilesX*TilesZ; ++i)
+	{
+		Tiles.push_back(STile());
+		Tiles.getLast().Owner = this;
+	}
+
+	LoadDistance = 2.f * TileSize * core::max_(TerrainScale.X, TerrainScale.Z);
+	Box.reset(0.f, 0.f, 0.f);
+	Box.addInternalPoint(TilesX * TileSize * TerrainScale.X, 0.f, TilesZ * TileSize * TerrainScale.Z);
+
+	video::CNullDriver* driver = static_cast<video::CNullDriver*>(SceneManager->getVideoDriver());
+	JobPool = driver ? driver->getJobPool() : 0;
+	if (JobPool)
+		JobPool->grab();
+
+	if (SelectorLOD >= 0)
+	{
+		Selector = SceneManager->createMetaTriangleSelector();
+		setTriangleSelector(Selector);
+	}
+
+	setAutomaticCulling(EAC_OFF);
+}
+
+
+//! destructor
+CPagedTerrainSceneNode::~CPagedTerrainSceneNode()
+{
+	finishLoads(true);
+	while (ResidentTiles.size())
+		removeTile(ResidentTiles.size()-1);
+
+	if (Selector)
+		Selector->drop();
+	if (JobPool)
+		JobPool->drop();
+	if (File)
+		File->drop();
+	if (FileSystem)
+		FileSystem->drop();
+}
+
+
+//! Loads and removes tiles and registers the resident tiles
+void CPagedTerrainSceneNode::OnRegisterSceneNode()
+{
+	if (!IsVisible)
+		return;
+
+	finishLoads(false);
+	requestTiles();
+
+	// the tiles use the material of this node
+	for (u32 i=0; i<ResidentTiles.size(); ++i)
+		Tiles[ResidentTiles[i]].Node->getMaterial(0) = Material;
+
+	ISceneNode::OnRegisterSceneNode();
+}
+
+
+//! returns the axis aligned bounding box of this node
+const core::aabbox3d<f32>& CPagedTerrainSceneNode::getBoundingBox() const
+{
+	return Box;
+}
+
+
+//! Returns the material which is used for all tiles
+video::SMaterial& CPagedTerrainSceneNode::getMaterial(u32 i)
+{
+	return Material;
+}
+
+
+//! Get the number of tiles in x (Width) and z (Height) direction.
+core::dimension2du CPagedTerrainSceneNode::getTileCount() const
+{
+	return core::dimension2du(TilesX, TilesZ);
+}
+
+
+//! Get a resident tile.
+ITerrainSceneNode* CPagedTerrainSceneNode::getTile(u32 x, u32 z) const
+{
+	if (x >= TilesX || z >= TilesZ)
+		return 0;
+
+	const STile& tile = Tiles[x * TilesZ + z];
+	return tile.State == EPTS_RESIDENT ? tile.Node : 0;
+}
+
+
+//! Set how many tiles may be resident at the same time.
+void CPagedTerrainSceneNode::setMaxResidentTiles(u32 count)
+{
+	// tiles over the budget are removed in the next frame
+	MaxResidentTiles = count;
+}
+
+
+//! Get the height of the terrain at a world position.
+f32 CPagedTerrainSceneNode::getHeight(f32 x, f32 z) const
+{
+	const f32 tileX = (x - TerrainPosition.X) / (TileSize * TerrainScale.X);
+	const f32 tileZ = (z - TerrainPosition.Z) / (TileSize * TerrainScale.Z);
+	if (tileX < 0.f || tileZ < 0.f || tileX >= TilesX || tileZ >= TilesZ)
+		return -FLT_MAX;
+
+	const ITerrainSceneNode* tile = getTile((u32)tileX, (u32)tileZ);
+	return tile ? tile->getHeight(x, z) : -FLT_MAX;
+}
+
+
+//! Loads all tiles which the active camera needs and waits for them.
+void CPagedTerrainSceneNode::waitForTiles()
+{
+	finishLoads(true);
+	while (requestTiles())
+		finishLoads(true);
+}
+
+
+//! Attaches the tiles which are built, waits for all of them if wait is true
+void CPagedTerrainSceneNode::finishLoads(bool wait)
+{
+	for (u32 i=0; i<LoadingTiles.size();)
+	{
+		STile& tile = Tiles[LoadingTiles[i]];
+		if (tile.Job)
+		{
+			if (!wait && !JobPool->isJobDone(tile.Job))
+			{
+				++i;
+				continue;
+			}
+
+			JobPool->finishJob(tile.Job);
+			tile.Job = 0;
+		}
+
+		tile.Data->drop();
+		tile.Data = 0;
+
+		if (tile.Node->getMesh()->getMeshBufferCount())
+		{
+			tile.State = EPTS_RESIDENT;
+			addChild(tile.Node);
+			if (Selector && tile.Selector)
+				Selector->addTriangleSelector(tile.Selector);
+			ResidentTiles.push_back(LoadingTiles[i]);
+
+			const core::aabbox3df& box = tile.Node->getBoundingBox();
+			Box.MinEdge.Y = core::min_(Box.MinEdge.Y, box.MinEdge.Y - TerrainPosition.Y);
+			Box.MaxEdge.Y = core::max_(Box.MaxEdge.Y, box.MaxEdge.Y - TerrainPosition.Y);
+		}
+		else
+		{
+			// not tried again
+			tile.State = EPTS_FAILED;
+			tile.Node->drop();
+			tile.Node = 0;
+			if (tile.Selector)
+			{
+				tile.Selector->drop();
+				tile.Selector = 0;
+			}
+		}
+
+		LoadingTiles.erase(i);
+	}
+}
+
+
+//! Starts loading the tiles which the camera needs and removes others to stay in the budget.
+bool CPagedTerrainSceneNode::requestTiles()
+{
+	++Frame;
+
+	const ICameraSceneNode* camera = SceneManager->getActiveCamera();
+	if (!camera || Tiles.empty())
+		return false;
+
+	const core::vector3df cameraPosition = camera->getAbsolutePosition() - TerrainPosition;
+	const f32 tileSizeX = TileSize * TerrainScale.X;
+	const f32 tileSizeZ = TileSize * TerrainScale.Z;
+
+	// only the tiles in the square around the camera can be in the load distance
+	const s32 firstX = core::s32_clamp(core::floor32((cameraPosition.X - LoadDistance) / tileSizeX), 0, (s32)TilesX-1);
+	const s32 lastX = core::s32_clamp(core::floor32((cameraPosition.X + LoadDistance) / tileSizeX), 0, (s32)TilesX-1);
+	const s32 firstZ = core::s32_clamp(core::floor32((cameraPosition.Z - LoadDistance) / tileSizeZ), 0, (s32)TilesZ-1);
+	const s32 lastZ = core::s32_clamp(core::floor32((cameraPosition.Z + LoadDistance) / tileSizeZ), 0, (s32)TilesZ-1);
+
+	NeededTiles.set_used(0);
+	for (s32 x=firstX; x<=lastX; ++x)
+	{
+		const f32 dx = core::max_(0.f, x * tileSizeX - cameraPosition.X, cameraPosition.X - (x+1) * tileSizeX);
+		for (s32 z=firstZ; z<=lastZ; ++z)
+		{
+			const f32 dz = core::max_(0.f, z * tileSizeZ - cameraPosition.Z, cameraPosition.Z - (z+1) * tileSizeZ);
+			const f32 distance = sqrtf(dx*dx + dz*dz);
+			if (distance <= LoadDistance)
+			{
+				STileDistance needed;
+				needed.Distance = distance;
+				needed.Tile = x * TilesZ + z;
+				NeededTiles.push_back(needed);
+			}
+		}
+	}
+
+	// the nearest tiles are needed when there are more than the budget
+	NeededTiles.sort();
+	if (NeededTiles.size() > MaxResidentTiles)
+		NeededTiles.set_used(MaxResidentTiles);
+
+	for (u32 i=0; i<NeededTiles.size(); ++i)
+		Tiles[NeededTiles[i].Tile].LastUsed = Frame;
+
+	// one tile per worker thread is built at a time, to keep frames short
+	const u32 maxLoads = JobPool ? core::max_(JobPool->getThreadCount(), 1u) : 1;
+
+	bool missing = false;
+	for (u32 i=0; i<NeededTiles.size(); ++i)
+	{
+		const STile& tile = Tiles[NeededTiles[i].Tile];
+		if (tile.State == EPTS_RESIDENT || tile.State == EPTS_FAILED)
+			continue;
+
+		missing = true;
+		if (tile.State == EPTS_LOADING || LoadingTiles.size() >= maxLoads)
+			continue;
+
+		if (getResidentTileCount() >= MaxResidentTiles && !evictTile())
+			continue;
+
+		loadTile(NeededTiles[i].Tile);
+	}
+
+	// the budget may have been lowered
+	while (getResidentTileCount() > MaxResidentTiles && evictTile())
+		;
+
+	return missing;
+}
+
+
+//! Reads the heightmap of a tile and starts building it
+bool CPagedTerrainSceneNode::loadTile(u32 index)
+{
+	STile& tile = Tiles[index];
+	const u32 x = index / TilesZ;
+	const u32 z = index % TilesZ;
+
+	// the tiles share their border vertices
+	const u32 samples = TileSize + 1;
+	const size_t rowBytes = samples * (BitsPerPixel / 8);
+	c8* data = new c8[rowBytes * samples];
+
+	// file access is not thread safe, so only building the tile is done by the jobs
+	for (u32 row=0; row<samples; ++row)
+	{
+		const long rowStart = DataStart + (long)(((x * TileSize + row) * (size_t)Size.Width + z * TileSize) * (BitsPerPixel / 8));
+		if (!File->seek(rowStart) || File->read(data + row * rowBytes, rowBytes) != rowBytes)
+		{
+			os::Printer::log("Could not read heightmap tile", File->getFileName(), ELL_ERROR);
+			delete [] data;
+			tile.State = EPTS_FAILED;
+			return false;
+		}
+	}
+
+	tile.Data = FileSystem->createMemoryReadFile(data, (s32)(rowBytes * samples), File->getFileName(), true);
+
+	const core::vector3df tilePosition(TerrainPosition.X + x * TileSize * TerrainScale.X,
+		TerrainPosition.Y, TerrainPosition.Z + z * TileSize * TerrainScale.Z);
+	tile.Node = new CTerrainSceneNode(0, SceneManager, FileSystem, -1, MaxLOD, PatchSize,
+		tilePosition, core::vector3df(0.f, 0.f, 0.f), TerrainScale);
+	tile.State = EPTS_LOADING;
+	LoadingTiles.push_back(index);
+
+	if (JobPool)
+		tile.Job = JobPool->startJob(buildTileJob, &tile);
+	else
+		buildTileJob(&tile, 0);
+
+	return true;
+}
+
+
+//! Removes the resident tile which was not needed for the longest time
+bool CPagedTerrainSceneNode::evictTile()
+{
+	s32 oldest = -1;
+	for (u32 i=0; i<ResidentTiles.size(); ++i)
+	{
+		const STile& tile = Tiles[ResidentTiles[i]];
+		if (tile.LastUsed != Frame &&
+			(oldest < 0 || tile.LastUsed < Tiles[ResidentTiles[oldest]].LastUsed))
+			oldest = i;
+	}
+
+	if (oldest < 0)
+		return false;
+
+	removeTile(oldest);
+	return true;
+}
+
+
+//! Removes a tile from the resident tiles
+void CPagedTerrainSceneNode::removeTile(u32 resident)
+{
+	STile& tile = Tiles[ResidentTiles[resident]];
+
+	if (tile.Selector)
+	{
+		if (Selector)
+			Selector->removeTriangleSelector(tile.Selector);
+		tile.Selector->drop();
+		tile.Selector = 0;
+	}
+
+	removeChild(tile.Node);
+	tile.Node->drop();
+	tile.Node = 0;
+	tile.State = EPTS_EMPTY;
+
+	ResidentTiles.erase(resident);
+}
+
+
+//! Creates the terrain of a tile from its heightmap
+void CPagedTerrainSceneNode::buildTileJob(void* userData, u32 index)
+{
+	STile* tile = static_cast<STile*>(userData);
+	const CPagedTerrainSceneNode* owner = tile->Owner;
+
+	// the tile is not in the scene yet, so nothing else uses it
+	if (tile->Node->createTerrainFromRAW(tile->Data, owner->BitsPerPixel, owner->SignedData,
+			false, owner->TileSize + 1, owner->VertexColor, 0) && owner->SelectorLOD >= 0)
+		tile->Selector = new CTerrainTriangleSelector(tile->Node, owner->SelectorLOD);
+}
+
+
+} // end namespace scene
+} // end namespace irr
+
@@ -0,0 +1,180 @@
+// Copyright (C) 2002-2012 Nikolaus Gebhardt
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#ifndef __C_PAGED_TERRAIN_SCENE_NODE_H_INCLUDED__
+#define __C_PAGED_TERRAIN_SCENE_NODE_H_INCLUDED__
+
+#include "IPagedTerrainSceneNode.h"
+#include "ETerrainElements.h"
+#include "CJobPool.h"
+
+namespace irr
+{
+namespace io
+{
+	class IFileSystem;
+	class IReadFile;
+}
+namespace scene
+{
+	class CTerrainSceneNode;
+	class IMetaTriangleSelector;
+
+	//! Terrain which keeps only the tiles of a large RAW heightmap around the camera in memory
+	class CPagedTerrainSceneNode : public IPagedTerrainSceneNode
+	{
+	public:
+
+		//! constructor
+		/** \param file Heightmap, starting at its current position.
+		\param size Samples per row (Width) and rows (Height) of the heightmap.
+		\param selectorLOD LOD of the triangle selectors of the tiles, or -1 for no selectors. */
+		CPagedTerrainSceneNode(ISceneNode* parent, ISceneManager* mgr, io::IFileSystem* fs,
+			io::IReadFile* file, const core::dimension2du& size, s32 id,
+			const core::vector3df& position, const core::vector3df& scale,
+			video::SColor vertexColor, s32 maxLOD, E_TERRAIN_PATCH_SIZE patchSize,
+			u32 tileSize, u32 maxResidentTiles, s32 bitsPerPixel, bool signedData,
+			s32 selectorLOD);
+
+		//! destructor
+		virtual ~CPagedTerrainSceneNode();
+
+		//! Loads and removes tiles and registers the resident tiles
+		virtual void OnRegisterSceneNode() _IRR_OVERRIDE_;
+
+		//! The tiles render themselves
+		virtual void render() _IRR_OVERRIDE_ {}
+
+		//! returns the axis aligned bounding box of this node
+		virtual const core::aabbox3d<f32>& getBoundingBox() const _IRR_OVERRIDE_;
+
+		//! Returns the material which is used for all tiles
+		virtual video::SMaterial& getMaterial(u32 i) _IRR_OVERRIDE_;
+
+		//! returns amount of materials used by this scene node.
+		virtual u32 getMaterialCount() const _IRR_OVERRIDE_ { return 1; }
+
+		//! Returns type of the scene node
+		virtual ESCENE_NODE_TYPE getType() const _IRR_OVERRIDE_ { return ESNT_PAGED_TERRAIN; }
+
+		//! Pages are loaded in OnRegisterSceneNode, OnAnimate is the default one
+		virtual bool isAnimationThreadSafe() const _IRR_OVERRIDE_ { return true; }
+
+		//! The pages are children with their own transformation
+		virtual bool hasDefaultTransformation() const _IRR_OVERRIDE_ { return true; }
+
+		//! Get the number of tiles in x (Width) and z (Height) direction.
+		virtual core::dimension2du getTileCount() const _IRR_OVERRIDE_;
+
+		//! Get the number of tiles which are resident or being loaded.
+		virtual u32 getResidentTileCount() const _IRR_OVERRIDE_ { return ResidentTiles.size() + LoadingTiles.size(); }
+
+		//! Get a resident tile.
+		virtual ITerrainSceneNode* getTile(u32 x, u32 z) const _IRR_OVERRIDE_;
+
+		//! Set how many tiles may be resident at the same time.
+		virtual void setMaxResidentTiles(u32 count) _IRR_OVERRIDE_;
+
+		//! Get how many tiles may be resident at the same time.
+		virtual u32 getMaxResidentTiles() const _IRR_OVERRIDE_ { return MaxResidentTiles; }
+
+		//! Set the distance from the camera up to which tiles are loaded.
+		virtual void setLoadDistance(f32 distance) _IRR_OVERRIDE_ { LoadDistance = distance; }
+
+		//! Get the distance from the camera up to which tiles are loaded.
+		virtual f32 getLoadDistance() const _IRR_OVERRIDE_ { return LoadDistance; }
+
+		//! Get the height of the terrain at a world position.
+		virtual f32 getHeight(f32 x, f32 z) const _IRR_OVERRIDE_;
+
+		//! Loads all tiles which the active camera needs and waits for them.
+		virtual void waitForTiles() _IRR_OVERRIDE_;
+
+	private:
+
+		enum E_PAGED_TILE_STATE
+		{
+			EPTS_EMPTY,
+			EPTS_LOADING,
+			EPTS_RESIDENT,
+			EPTS_FAILED
+		};
+
+		struct STile
+		{
+			STile() : Owner(0), Node(0), Selector(0), Data(0), Job(0), LastUsed(0), State(EPTS_EMPTY) {}
+
+			CPagedTerrainSceneNode* Owner;
+			CTerrainSceneNode* Node;
+			ITriangleSelector* Selector;
+			io::IReadFile* Data;
+			CJobPool::SBatch* Job;
+			u32 LastUsed;
+			E_PAGED_TILE_STATE State;
+		};
+
+		//! Tile index and its distance to the camera, for sorting
+		struct STileDistance
+		{
+			bool operator<(const STileDistance& other) const { return Distance < other.Distance; }
+
+			f32 Distance;
+			u32 Tile;
+		};
+
+		//! Attaches the tiles which are built, waits for all of them if wait is true
+		void finishLoads(bool wait);
+
+		//! Starts loading the tiles which the camera needs and removes others to stay in the budget.
+		/** Returns true if some of the needed tiles are not resident yet. */
+		bool requestTiles();
+
+		//! Reads the heightmap of a tile and starts building it
+		bool loadTile(u32 index);
+
+		//! Removes the resident tile which was not needed for the longest time
+		bool evictTile();
+
+		//! Removes a tile from the resident tiles
+		void removeTile(u32 resident);
+
+		//! Creates the terrain of a tile from its heightmap
+		static void buildTileJob(void* userData, u32 index);
+
+		core::array<STile> Tiles;
+		core::array<u32> ResidentTiles;
+		core::array<u32> LoadingTiles;
+		core::array<STileDistance> NeededTiles;
+
+		video::SMaterial Material;
+		core::aabbox3d<f32> Box;
+
+		io::IFileSystem* FileSystem;
+		io::IReadFile* File;
+		CJobPool* JobPool;
+		IMetaTriangleSelector* Selector;
+
+		long DataStart;
+		core::dimension2du Size;
+		core::vector3df TerrainPosition;
+		core::vector3df TerrainScale;
+		video::SColor VertexColor;
+		s32 MaxLOD;
+		E_TERRAIN_PATCH_SIZE PatchSize;
+		u32 TileSize;
+		u32 TilesX;
+		u32 TilesZ;
+		u32 MaxResidentTiles;
+		f32 LoadDistance;
+		u32 Frame;
+		s32 BitsPerPixel;
+		s32 SelectorLOD;
+		bool SignedData;
+	};
+
+} // end namespace scene
+} // end namespace irr
+
+#endif
+
@@ -7,6 +7,7 @@
 #ifdef _IRR_COMPILE_WITH_PARTICLES_
 
 #include "IAttributes.h"
+#include "ParticleSIMD.h"
 
 namespace irr
 {
@@ -60,6 +61,75 @@ void CParticleAttractionAffector::affect(u32 now, SParticle* particlearray, u32
 	}
 }
 
+//! Affects particles which are stored in separate arrays.
+void CParticleAttractionAffector::affectStreams(u32 now, SParticleStreams& particles)
+{
+	if( LastTime == 0 )
+	{
+		LastTime = now;
+		return;
+	}
+
+	f32 timeDelta = ( now - LastTime ) / 1000.0f;
+	LastTime = now;
+
+	if( !Enabled )
+		return;
+
+	// distance moved in this call, negative when pushing the particles away
+	const f32 step = Attract ? Speed * timeDelta : Speed * timeDelta * -1.0f;
+
+	const u32 count = particles.size();
+	f32* posX = particles.PosX.pointer();
+	f32* posY = particles.PosY.pointer();
+	f32* posZ = particles.PosZ.pointer();
+	u32 i = 0;
+
+#if defined(_IRR_PARTICLES_SSE2_)
+	const __m128 zero = _mm_setzero_ps();
+	const __m128 one = _mm_set1_ps(1.f);
+	const __m128 pointX = _mm_set1_ps(Point.X);
+	const __m128 pointY = _mm_set1_ps(Point.Y);
+	const __m128 pointZ = _mm_set1_ps(Point.Z);
+	const __m128 stepX = _mm_set1_ps(AffectX ? step : 0.f);
+	const __m128 stepY = _mm_set1_ps(AffectY ? step : 0.f);
+	const __m128 stepZ = _mm_set1_ps(AffectZ ? step : 0.f);
+
+	for (; i+4 <= count; i+=4)
+	{
+		const __m128 x = loadParticles(posX+i);
+		const __m128 y = loadParticles(posY+i);
+		const __m128 z = loadParticles(posZ+i);
+		const __m128 dx = _mm_sub_ps(pointX, x);
+		const __m128 dy = _mm_sub_ps(pointY, y);
+		const __m128 dz = _mm_sub_ps(pointZ, z);
+
+		// particles at the point itself don't move, like vector3d::normalize
+		const __m128 length = _mm_add_ps(_mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy)), _mm_mul_ps(dz, dz));
+		const __m128 scale = _mm_and_ps(_mm_cmpgt_ps(length, zero), _mm_div_ps(one, _mm_sqrt_ps(length)));
+
+		storeParticles(posX+i, _mm_add_ps(x, _mm_mul_ps(_mm_mul_ps(dx, scale), stepX)));
+		storeParticles(posY+i, _mm_add_ps(y, _mm_mul_ps(_mm_mul_ps(dy, scale), stepY)));
+		storeParticles(posZ+i, _mm_add_ps(z, _mm_mul_ps(_mm_mul_ps(dz, scale), stepZ)));
+	}
+#endif
+
+	for (; i<count; ++i)
+	{
+		core::vector3df direction = (Point - core::vector3df(posX[i], posY[i], posZ[i])).normalize();
+		direction *= step;
+
+		if( AffectX )
+			posX[i] += direction.X;
+
+		if( AffectY )
+			posY[i] += direction.Y;
+
+		if( AffectZ )
+			posZ[i] += direction.Z;
+	}
+}
+
 //! Writes attributes of the object.
 void CParticleAttractionAffector::serializeAttributes(io::IAttributes* out, io::SAttributeReadWriteOptions* options) const
 {
@@ -28,6 +28,9 @@ public:
 	//! Affects a particle.
 	virtual void affect(u32 now, SParticle* particlearray, u32 count) _IRR_OVERRIDE_;
 
+	//! Affects particles which are stored in separate arrays.
+	virtual void affectStreams(u32 now, SParticleStreams& particles) _IRR_OVERRIDE_;
+
 	//! Set the point that particles will attract to
 	virtual void setPoint( const core::vector3df& point ) _IRR_OVERRIDE_ { Point = point; }
 
@@ -7,6 +7,7 @@
 #ifdef _IRR_COMPILE_WITH_PARTICLES_
 
 #include "IAttributes.h"
+#include "ParticleSIMD.h"
 #include "os.h"
 
 namespace irr
@@ -46,6 +47,76 @@ void CParticleFadeOutAffector::affect(u32 now, SParticle* particlearray, u32 cou
 	}
 }
 
+#if defined(_IRR_PARTICLES_SSE2_)
+namespace
+{
+	// interpolates the channel at bit position shift of four colors
+	inline __m128i fadeChannel(__m128i start, __m128i shift, __m128 target, __m128 d, __m128 inv)
+	{
+		const __m128 s = _mm_cvtepi32_ps(_mm_and_si128(_mm_srl_epi32(start, shift), _mm_set1_epi32(0xff)));
+
+		// same rounding as core::round32, the values are not negative
+		const __m128 v = _mm_add_ps(_mm_add_ps(_mm_mul_ps(target, inv), _mm_mul_ps(s, d)), _mm_set1_ps(0.5f));
+		return _mm_sll_epi32(_mm_cvttps_epi32(v), shift);
+	}
+}
+#endif
+
+
+//! Affects particles which are stored in separate arrays.
+void CParticleFadeOutAffector::affectStreams(u32 now, SParticleStreams& particles)
+{
+	if (!Enabled)
+		return;
+
+	const u32 count = particles.size();
+	const u32* endTime = particles.EndTime.const_pointer();
+	const video::SColor* startColor = particles.StartColor.const_pointer();
+	video::SColor* color = particles.Color.pointer();
+	u32 i = 0;
+
+#if defined(_IRR_PARTICLES_SSE2_)
+	const __m128i now4 = _mm_set1_epi32((s32)now);
+	const __m128 fadeOutTime = _mm_set1_ps(FadeOutTime);
+	const __m128 one = _mm_set1_ps(1.f);
+	const __m128 targetBlue = _mm_set1_ps((f32)TargetColor.getBlue());
+	const __m128 targetGreen = _mm_set1_ps((f32)TargetColor.getGreen());
+	const __m128 targetRed = _mm_set1_ps((f32)TargetColor.getRed());
+	const __m128 targetAlpha = _mm_set1_ps((f32)TargetColor.getAlpha());
+
+	for (; i+4 <= count; i+=4)
+	{
+		const __m128 left = timeToFloat(_mm_sub_epi32(loadParticles(endTime+i), now4));
+		const __m128 fading = _mm_cmplt_ps(left, fadeOutTime);
+		if (!_mm_movemask_ps(fading))
+			continue;
+
+		const __m128 d = _mm_min_ps(_mm_div_ps(left, fadeOutTime), one);
+		const __m128 inv = _mm_sub_ps(one, d);
+
+		const __m128i start = _mm_loadu_si128((const __m128i*)(startColor+i));
+		__m128i result = fadeChannel(start, _mm_cvtsi32_si128(0), targetBlue, d, inv);
+		result = _mm_or_si128(result, fadeChannel(start, _mm_cvtsi32_si128(8), targetGreen, d, inv));
+		result = _mm_or_si128(result, fadeChannel(start, _mm_cvtsi32_si128(16), targetRed, d, inv));
+		result = _mm_or_si128(result, fadeChannel(start, _mm_cvtsi32_si128(24), targetAlpha, d, inv));
+
+		// particles which don't fade yet keep their color
+		const __m128i mask = _mm_castps_si128(fading);
+		const __m128i old = _mm_loadu_si128((const __m128i*)(color+i));
+		_mm_storeu_si128((__m128i*)(color+i), _mm_or_si128(_mm_and_si128(mask, result), _mm_andnot_si128(mask, old)));
+	}
+#endif
+
+	for (; i<count; ++i)
+	{
+		if (endTime[i] - now < FadeOutTime)
+		{
+			const f32 d = (endTime[i] - now) / FadeOutTime;
+			color[i] = startColor[i].getInterpolated(TargetColor, d);
+		}
+	}
+}
+
 
 //! Writes attributes of the object.
 //! Implement this to expose the attributes of your scene node animator for
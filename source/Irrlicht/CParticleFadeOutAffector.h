@@ -26,6 +26,9 @@ public:
 	//! Affects a particle.
 	virtual void affect(u32 now, SParticle* particlearray, u32 count) _IRR_OVERRIDE_;
 
+	//! Affects particles which are stored in separate arrays.
+	virtual void affectStreams(u32 now, SParticleStreams& particles) _IRR_OVERRIDE_;
+
 	//! Sets the targetColor, i.e. the color the particles will interpolate
 	//! to over time.
 	virtual void setTargetColor( const video::SColor& targetColor ) _IRR_OVERRIDE_ { TargetColor = targetColor; }
@@ -8,6 +8,7 @@
 
 #include "os.h"
 #include "IAttributes.h"
+#include "ParticleSIMD.h"
 
 namespace irr
 {
@@ -45,6 +46,54 @@ void CParticleGravityAffector::affect(u32 now, SParticle* particlearray, u32 cou
 	}
 }
 
+//! Affects particles which are stored in separate arrays.
+void CParticleGravityAffector::affectStreams(u32 now, SParticleStreams& particles)
+{
+	if (!Enabled)
+		return;
+
+	const u32 count = particles.size();
+	const u32* startTime = particles.StartTime.const_pointer();
+	const f32* startX = particles.StartVectorX.const_pointer();
+	const f32* startY = particles.StartVectorY.const_pointer();
+	const f32* startZ = particles.StartVectorZ.const_pointer();
+	f32* vectorX = particles.VectorX.pointer();
+	f32* vectorY = particles.VectorY.pointer();
+	f32* vectorZ = particles.VectorZ.pointer();
+	u32 i = 0;
+
+#if defined(_IRR_PARTICLES_SSE2_)
+	const __m128i now4 = _mm_set1_epi32((s32)now);
+	const __m128 timeForceLost = _mm_set1_ps(TimeForceLost);
+	const __m128 zero = _mm_setzero_ps();
+	const __m128 one = _mm_set1_ps(1.f);
+	const __m128 gravityX = _mm_set1_ps(Gravity.X);
+	const __m128 gravityY = _mm_set1_ps(Gravity.Y);
+	const __m128 gravityZ = _mm_set1_ps(Gravity.Z);
+
+	for (; i+4 <= count; i+=4)
+	{
+		__m128 d = _mm_div_ps(timeToFloat(_mm_sub_epi32(now4, loadParticles(startTime+i))), timeForceLost);
+		d = _mm_sub_ps(one, _mm_max_ps(_mm_min_ps(d, one), zero));
+		const __m128 inv = _mm_sub_ps(one, d);
+
+		storeParticles(vectorX+i, _mm_add_ps(_mm_mul_ps(gravityX, inv), _mm_mul_ps(loadParticles(startX+i), d)));
+		storeParticles(vectorY+i, _mm_add_ps(_mm_mul_ps(gravityY, inv), _mm_mul_ps(loadParticles(startY+i), d)));
+		storeParticles(vectorZ+i, _mm_add_ps(_mm_mul_ps(gravityZ, inv), _mm_mul_ps(loadParticles(startZ+i), d)));
+	}
+#endif
+
+	for (; i<count; ++i)
+	{
+		const f32 d = 1.0f - core::clamp((now - startTime[i]) / TimeForceLost, 0.0f, 1.0f);
+		const f32 inv = 1.0f - d;
+
+		vectorX[i] = Gravity.X*inv + startX[i]*d;
+		vectorY[i] = Gravity.Y*inv + startY[i]*d;
+		vectorZ[i] = Gravity.Z*inv + startZ[i]*d;
+	}
+}
+
 //! Writes attributes of the object.
 void CParticleGravityAffector::serializeAttributes(io::IAttributes* out, io::SAttributeReadWriteOptions* options) const
 {
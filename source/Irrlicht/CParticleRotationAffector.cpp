@@ -8,6 +8,7 @@
 #ifdef _IRR_COMPILE_WITH_PARTICLES_
 
 #include "IAttributes.h"
+#include "ParticleSIMD.h"
 
 namespace irr
 {
@@ -52,6 +53,68 @@ void CParticleRotationAffector::affect(u32 now, SParticle* particlearray, u32 co
 	}
 }
 
+//! Rotates the particles around an axis, a and b are the coordinates in the rotation plane.
+/** Same as the vector3d::rotateYZBy, rotateXZBy and rotateXYBy, but with f32
+precision, so all particles are rotated the same with and without SSE2. */
+static void rotateParticles(f32* a, f32* b, u32 count, f64 degrees, f32 centerA, f32 centerB)
+{
+	degrees *= core::DEGTORAD64;
+	const f32 cs = (f32)cos(degrees);
+	const f32 sn = (f32)sin(degrees);
+	u32 i = 0;
+
+#if defined(_IRR_PARTICLES_SSE2_)
+	const __m128 cs4 = _mm_set1_ps(cs);
+	const __m128 sn4 = _mm_set1_ps(sn);
+	const __m128 centerA4 = _mm_set1_ps(centerA);
+	const __m128 centerB4 = _mm_set1_ps(centerB);
+
+	for (; i+4 <= count; i+=4)
+	{
+		const __m128 x = _mm_sub_ps(loadParticles(a+i), centerA4);
+		const __m128 y = _mm_sub_ps(loadParticles(b+i), centerB4);
+		storeParticles(a+i, _mm_add_ps(_mm_sub_ps(_mm_mul_ps(x, cs4), _mm_mul_ps(y, sn4)), centerA4));
+		storeParticles(b+i, _mm_add_ps(_mm_add_ps(_mm_mul_ps(x, sn4), _mm_mul_ps(y, cs4)), centerB4));
+	}
+#endif
+
+	for (; i<count; ++i)
+	{
+		const f32 x = a[i] - centerA;
+		const f32 y = b[i] - centerB;
+		a[i] = (x*cs - y*sn) + centerA;
+		b[i] = (x*sn + y*cs) + centerB;
+	}
+}
+
+
+//! Affects particles which are stored in separate arrays.
+void CParticleRotationAffector::affectStreams(u32 now, SParticleStreams& particles)
+{
+	if( LastTime == 0 )
+	{
+		LastTime = now;
+		return;
+	}
+
+	f32 timeDelta = ( now - LastTime ) / 1000.0f;
+	LastTime = now;
+
+	if( !Enabled )
+		return;
+
+	const u32 count = particles.size();
+
+	if( Speed.X != 0.0f )
+		rotateParticles(particles.PosY.pointer(), particles.PosZ.pointer(), count, timeDelta * Speed.X, PivotPoint.Y, PivotPoint.Z);
+
+	if( Speed.Y != 0.0f )
+		rotateParticles(particles.PosX.pointer(), particles.PosZ.pointer(), count, timeDelta * Speed.Y, PivotPoint.X, PivotPoint.Z);
+
+	if( Speed.Z != 0.0f )
+		rotateParticles(particles.PosX.pointer(), particles.PosY.pointer(), count, timeDelta * Speed.Z, PivotPoint.X, PivotPoint.Y);
+}
+
 //! Writes attributes of the object.
 void CParticleRotationAffector::serializeAttributes(io::IAttributes* out, io::SAttributeReadWriteOptions* options) const
 {
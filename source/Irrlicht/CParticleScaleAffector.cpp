@@ -7,6 +7,7 @@
 #ifdef _IRR_COMPILE_WITH_PARTICLES_
 
 #include "IAttributes.h"
+#include "ParticleSIMD.h"
 
 namespace irr
 {
@@ -32,6 +33,45 @@ namespace irr
 			}
 		}
 
+		//! Affects particles which are stored in separate arrays.
+		void CParticleScaleAffector::affectStreams(u32 now, SParticleStreams& particles)
+		{
+			const u32 count = particles.size();
+			const u32* startTime = particles.StartTime.const_pointer();
+			const u32* endTime = particles.EndTime.const_pointer();
+			const f32* startWidth = particles.StartWidth.const_pointer();
+			const f32* startHeight = particles.StartHeight.const_pointer();
+			f32* width = particles.Width.pointer();
+			f32* height = particles.Height.pointer();
+			u32 i = 0;
+
+#if defined(_IRR_PARTICLES_SSE2_)
+			const __m128i now4 = _mm_set1_epi32((s32)now);
+			const __m128 scaleToWidth = _mm_set1_ps(ScaleTo.Width);
+			const __m128 scaleToHeight = _mm_set1_ps(ScaleTo.Height);
+
+			for (; i+4 <= count; i+=4)
+			{
+				const __m128i start = loadParticles(startTime+i);
+				const __m128 maxdiff = timeToFloat(_mm_sub_epi32(loadParticles(endTime+i), start));
+				const __m128 curdiff = timeToFloat(_mm_sub_epi32(now4, start));
+				const __m128 newscale = _mm_div_ps(curdiff, maxdiff);
+
+				storeParticles(width+i, _mm_add_ps(loadParticles(startWidth+i), _mm_mul_ps(scaleToWidth, newscale)));
+				storeParticles(height+i, _mm_add_ps(loadParticles(startHeight+i), _mm_mul_ps(scaleToHeight, newscale)));
+			}
+#endif
+
+			for (; i<count; ++i)
+			{
+				const u32 maxdiff = endTime[i] - startTime[i];
+				const u32 curdiff = now - startTime[i];
+				const f32 newscale = (f32)curdiff/maxdiff;
+				width[i] = startWidth[i] + ScaleTo.Width*newscale;
+				height[i] = startHeight[i] + ScaleTo.Height*newscale;
+			}
+		}
+
 
 		void CParticleScaleAffector::serializeAttributes(io::IAttributes* out, io::SAttributeReadWriteOptions* options) const
 		{
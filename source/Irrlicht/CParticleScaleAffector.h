@@ -21,6 +21,9 @@ namespace irr
 
 			virtual void affect(u32 now, SParticle *particlearray, u32 count) _IRR_OVERRIDE_;
 
+			//! Affects particles which are stored in separate arrays.
+			virtual void affectStreams(u32 now, SParticleStreams& particles) _IRR_OVERRIDE_;
+
 			//! Writes attributes of the object.
 			//! Implement this to expose the attributes of your scene node animator for
 			//! scripting languages, editors, debuggers or xml serialization purposes.
@@ -9,7 +9,7 @@
 #include "os.h"
 #include "ISceneManager.h"
 #include "ICameraSceneNode.h"
-#include "IVideoDriver.h"
+#include "CNullDriver.h"
 
 #include "CParticleAnimatedMeshSceneNodeEmitter.h"
 #include "CParticleBoxEmitter.h"
@@ -24,12 +24,19 @@
 #include "CParticleRotationAffector.h"
 #include "CParticleScaleAffector.h"
 #include "SViewFrustum.h"
+#include "ParticleSIMD.h"
 
 namespace irr
 {
 namespace scene
 {
 
+//! Smallest particle count which is updated on a worker thread.
+static const u32 MIN_PARTICLES_PER_JOB = 512;
+
+//! Number of particles of which each job fills the vertices.
+static const u32 PARTICLES_PER_VERTEX_JOB = 4096;
+
 //! constructor
 CParticleSystemSceneNode::CParticleSystemSceneNode(bool createDefaultEmitter,
 	ISceneNode* parent, ISceneManager* mgr, s32 id,
@@ -37,13 +44,24 @@ CParticleSystemSceneNode::CParticleSystemSceneNode(bool createDefaultEmitter,
 	const core::vector3df& scale)
 	: IParticleSystemSceneNode(parent, mgr, id, position, rotation, scale),
 	Emitter(0), ParticleSize(core::dimension2d<f32>(5.0f, 5.0f)), LastEmitTime(0),
-	Buffer(0), ParticlesAreGlobal(true)
+	Buffer(0), FilledIndexCount(0), DirtyIndexCount(0), JobPool(0), UpdateJob(0),
+	UpdateTime(0), UpdateTimeDiff(0), UpdateAffecting(false), UpdateAnimating(false),
+	UpdateStarted(false), ParticlesAreGlobal(true)
 {
 	#ifdef _DEBUG
 	setDebugName("CParticleSystemSceneNode");
 	#endif
 
-	Buffer = new SMeshBuffer();
+	// the vertices are written each frame, the indices only when more particles are drawn
+	Buffer = new CDynamicMeshBuffer(video::EVT_STANDARD, video::EIT_16BIT);
+	Buffer->setHardwareMappingHint(EHM_STREAM, EBT_VERTEX);
+	Buffer->setHardwareMappingHint(EHM_STATIC, EBT_INDEX);
+
+	video::CNullDriver* driver = static_cast<video::CNullDriver*>(SceneManager->getVideoDriver());
+	JobPool = driver ? driver->getJobPool() : 0;
+	if (JobPool)
+		JobPool->grab();
+
 	if (createDefaultEmitter)
 	{
 		IParticleEmitter* e = createBoxEmitter();
@@ -56,6 +74,9 @@ CParticleSystemSceneNode::CParticleSystemSceneNode(bool createDefaultEmitter,
 //! destructor
 CParticleSystemSceneNode::~CParticleSystemSceneNode()
 {
+	finishUpdate();
+	if (JobPool)
+		JobPool->drop();
 	if (Emitter)
 		Emitter->drop();
 	if (Buffer)
@@ -77,6 +98,7 @@ void CParticleSystemSceneNode::setEmitter(IParticleEmitter* emitter)
 {
 	if (emitter == Emitter)
 		return;
+	finishUpdate();
 	if (Emitter)
 		Emitter->drop();
 
@@ -90,6 +112,7 @@ void CParticleSystemSceneNode::setEmitter(IParticleEmitter* emitter)
 //! Adds new particle effector to the particle system.
 void CParticleSystemSceneNode::addAffector(IParticleAffector* affector)
 {
+	finishUpdate();
 	affector->grab();
 	AffectorList.push_back(affector);
 }
@@ -103,6 +126,7 @@ const core::list<IParticleAffector*>& CParticleSystemSceneNode::getAffectors() c
 //! Removes all particle affectors in the particle system.
 void CParticleSystemSceneNode::removeAllAffectors()
 {
+	finishUpdate();
 	core::list<IParticleAffector*>::Iterator it = AffectorList.begin();
 	while (it != AffectorList.end())
 	{
@@ -293,10 +317,39 @@ IParticleRotationAffector* CParticleSystemSceneNode::createRotationAffector(
 }
 
 
+//! Emits the particles and starts their update
+void CParticleSystemSceneNode::OnAnimate(u32 timeMs)
+{
+	IParticleSystemSceneNode::OnAnimate(timeMs);
+
+	if (!IsVisible)
+		return;
+
+	finishUpdate();
+	UpdateStarted = true;
+
+	// the emitters use the random generator, which is not thread safe
+	if (!emitParticles(timeMs))
+		return;
+
+	if (JobPool && JobPool->getThreadCount() && Particles.size() >= MIN_PARTICLES_PER_JOB)
+		UpdateJob = JobPool->startJob(updateParticlesJob, this);
+	else
+		updateParticles();
+}
+
+
 //! pre render event
 void CParticleSystemSceneNode::OnRegisterSceneNode()
 {
-	doParticleSystem(os::Timer::getTime());
+	// nodes which were not animated this frame are updated here
+	if (UpdateStarted)
+	{
+		finishUpdate();
+		UpdateStarted = false;
+	}
+	else
+		doParticleSystem(os::Timer::getTime());
 
 	if (IsVisible && (Particles.size() != 0))
 	{
@@ -315,6 +368,7 @@ void CParticleSystemSceneNode::render()
 	if (!camera || !driver)
 		return;
 
+	finishUpdate();
 
 #if 0
 	// calculate vectors for letting particles look to camera
@@ -331,52 +385,20 @@ void CParticleSystemSceneNode::render()
 
 #endif
 
+	BillboardHorizontal.set(m[0], m[4], m[8]);
+	BillboardVertical.set(m[1], m[5], m[9]);
+	BillboardView = view;
+
 	// reallocate arrays, if they are too small
 	reallocateBuffers();
 
 	// create particle vertex data
-	s32 idx = 0;
-	for (u32 i=0; i<Particles.size(); ++i)
-	{
-		const SParticle& particle = Particles[i];
-
-		#if 0
-			core::vector3df horizontal = camera->getUpVector().crossProduct(view);
-			horizontal.normalize();
-			horizontal *= 0.5f * particle.size.Width;
-
-			core::vector3df vertical = horizontal.crossProduct(view);
-			vertical.normalize();
-			vertical *= 0.5f * particle.size.Height;
-
-		#else
-			f32 f;
-
-			f = 0.5f * particle.size.Width;
-			const core::vector3df horizontal ( m[0] * f, m[4] * f, m[8] * f );
-
-			f = -0.5f * particle.size.Height;
-			const core::vector3df vertical ( m[1] * f, m[5] * f, m[9] * f );
-		#endif
-
-		Buffer->Vertices[0+idx].Pos = particle.pos + horizontal + vertical;
-		Buffer->Vertices[0+idx].Color = particle.color;
-		Buffer->Vertices[0+idx].Normal = view;
-
-		Buffer->Vertices[1+idx].Pos = particle.pos + horizontal - vertical;
-		Buffer->Vertices[1+idx].Color = particle.color;
-		Buffer->Vertices[1+idx].Normal = view;
-
-		Buffer->Vertices[2+idx].Pos = particle.pos - horizontal - vertical;
-		Buffer->Vertices[2+idx].Color = particle.color;
-		Buffer->Vertices[2+idx].Normal = view;
-
-		Buffer->Vertices[3+idx].Pos = particle.pos - horizontal + vertical;
-		Buffer->Vertices[3+idx].Color = particle.color;
-		Buffer->Vertices[3+idx].Normal = view;
-
-		idx +=4;
-	}
+	const u32 count = Particles.size();
+	if (JobPool && JobPool->getThreadCount() && count >= 2*PARTICLES_PER_VERTEX_JOB)
+		JobPool->parallelFor(buildVerticesJob, this, (count + PARTICLES_PER_VERTEX_JOB - 1) / PARTICLES_PER_VERTEX_JOB);
+	else
+		buildVertices(0, count);
+	Buffer->setDirty(EBT_VERTEX);
 
 	// render all
 	core::matrix4 mat;
@@ -386,8 +408,7 @@ void CParticleSystemSceneNode::render()
 
 	driver->setMaterial(Buffer->Material);
 
-	driver->drawVertexPrimitiveList(Buffer->getVertices(), Particles.size()*4,
-		Buffer->getIndices(), Particles.size()*2, video::EVT_STANDARD, EPT_TRIANGLES,Buffer->getIndexType());
+	driver->drawMeshBuffer(Buffer);
 
 	// for debug purposes only:
 	if ( DebugDataVisible & scene::EDS_BBOX )
@@ -401,6 +422,52 @@ void CParticleSystemSceneNode::render()
 }
 
 
+//! Fills the vertices of the particles first to last-1
+void CParticleSystemSceneNode::buildVertices(u32 first, u32 last)
+{
+	video::S3DVertex* vertices = static_cast<video::S3DVertex*>(Buffer->getVertexBuffer().pointer()) + first*4;
+
+	for (u32 i=first; i<last; ++i)
+	{
+		const core::vector3df pos(Particles.PosX[i], Particles.PosY[i], Particles.PosZ[i]);
+		const video::SColor& color = Particles.Color[i];
+
+		const core::vector3df horizontal(BillboardHorizontal * (0.5f * Particles.Width[i]));
+		const core::vector3df vertical(BillboardVertical * (-0.5f * Particles.Height[i]));
+
+		vertices[0].Pos = pos + horizontal + vertical;
+		vertices[0].Color = color;
+		vertices[0].Normal = BillboardView;
+		vertices[0].TCoords.set(0.0f, 0.0f);
+
+		vertices[1].Pos = pos + horizontal - vertical;
+		vertices[1].Color = color;
+		vertices[1].Normal = BillboardView;
+		vertices[1].TCoords.set(0.0f, 1.0f);
+
+		vertices[2].Pos = pos - horizontal - vertical;
+		vertices[2].Color = color;
+		vertices[2].Normal = BillboardView;
+		vertices[2].TCoords.set(1.0f, 1.0f);
+
+		vertices[3].Pos = pos - horizontal + vertical;
+		vertices[3].Color = color;
+		vertices[3].Normal = BillboardView;
+		vertices[3].TCoords.set(1.0f, 0.0f);
+
+		vertices += 4;
+	}
+}
+
+
+void CParticleSystemSceneNode::buildVerticesJob(void* userData, u32 index)
+{
+	CParticleSystemSceneNode* node = static_cast<CParticleSystemSceneNode*>(userData);
+	const u32 first = index * PARTICLES_PER_VERTEX_JOB;
+	node->buildVertices(first, core::min_(first + PARTICLES_PER_VERTEX_JOB, node->Particles.size()));
+}
+
+
 //! returns the axis aligned bounding box of this node
 const core::aabbox3d<f32>& CParticleSystemSceneNode::getBoundingBox() const
 {
@@ -409,12 +476,25 @@ const core::aabbox3d<f32>& CParticleSystemSceneNode::getBoundingBox() const
 
 
 void CParticleSystemSceneNode::doParticleSystem(u32 time)
+{
+	finishUpdate();
+
+	if (emitParticles(time))
+	{
+		updateParticles();
+		finishUpdate();
+	}
+}
+
+
+//! Emits new particles, returns false if only the time of the first update was stored
+bool CParticleSystemSceneNode::emitParticles(u32 time)
 {
 	if (LastEmitTime==0)
 	{
 		LastEmitTime = time;
 		LastAbsoluteTransformation = AbsoluteTransformation;
-		return;
+		return false;
 	}
 
 	u32 now = time;
@@ -433,114 +513,192 @@ void CParticleSystemSceneNode::doParticleSystem(u32 time)
 
 		if (newParticles && array)
 		{
-			s32 j=Particles.size();
-			if (newParticles > 16250-j)	// avoid having more than 64k vertices in the scenenode
-				newParticles=16250-j;
-			Particles.set_used(j+newParticles);
-			for (s32 i=j; i<j+newParticles; ++i)
+			for (s32 i=0; i<newParticles; ++i)
 			{
-				Particles[i]=array[i-j];
+				SParticle particle = array[i];
 
 				if ( ParticlesAreGlobal && behavior & EPB_EMITTER_FRAME_INTERPOLATION )
 				{
 					// Interpolate between current node transformations and last ones.
 					// (Lazy solution - calculating twice and interpolating results)
 					f32 randInterpolate = (f32)(os::Randomizer::rand() % 101) / 100.f;	// 0 to 1
-					core::vector3df posNow(Particles[i].pos);
-					core::vector3df posLast(Particles[i].pos);
+					core::vector3df posNow(particle.pos);
+					core::vector3df posLast(particle.pos);
 
 					AbsoluteTransformation.transformVect(posNow);
 					LastAbsoluteTransformation.transformVect(posLast);
-					Particles[i].pos = posNow.getInterpolated(posLast, randInterpolate);
+					particle.pos = posNow.getInterpolated(posLast, randInterpolate);
 
 					if ( !(behavior & EPB_EMITTER_VECTOR_IGNORE_ROTATION) )
 					{
-						core::vector3df vecNow(Particles[i].startVector);
-						core::vector3df vecOld(Particles[i].startVector);
+						core::vector3df vecNow(particle.startVector);
+						core::vector3df vecOld(particle.startVector);
 						AbsoluteTransformation.rotateVect(vecNow);
 						LastAbsoluteTransformation.rotateVect(vecOld);
-						Particles[i].startVector = vecNow.getInterpolated(vecOld, randInterpolate);
+						particle.startVector = vecNow.getInterpolated(vecOld, randInterpolate);
 
-						vecNow = Particles[i].vector;
-						vecOld = Particles[i].vector;
+						vecNow = particle.vector;
+						vecOld = particle.vector;
 						AbsoluteTransformation.rotateVect(vecNow);
 						LastAbsoluteTransformation.rotateVect(vecOld);
-						Particles[i].vector = vecNow.getInterpolated(vecOld, randInterpolate);
+						particle.vector = vecNow.getInterpolated(vecOld, randInterpolate);
 					}
 				}
 				else
 				{
 					if (ParticlesAreGlobal)
-						AbsoluteTransformation.transformVect(Particles[i].pos);
+						AbsoluteTransformation.transformVect(particle.pos);
 
 					if ( !(behavior & EPB_EMITTER_VECTOR_IGNORE_ROTATION) )
 					{
 						if (!ParticlesAreGlobal)
-							AbsoluteTransformation.rotateVect(Particles[i].pos);
+							AbsoluteTransformation.rotateVect(particle.pos);
 
-						AbsoluteTransformation.rotateVect(Particles[i].startVector);
-						AbsoluteTransformation.rotateVect(Particles[i].vector);
+						AbsoluteTransformation.rotateVect(particle.startVector);
+						AbsoluteTransformation.rotateVect(particle.vector);
 					}
 				}
+
+				Particles.push_back(particle);
 			}
 		}
 	}
 
+	// the update only works on copies of the node state
+	UpdateTime = now;
+	UpdateTimeDiff = timediff;
+	UpdateAffecting = visible || (behavior & EPB_INVISIBLE_AFFECTING);
+	UpdateAnimating = visible || (behavior & EPB_INVISIBLE_ANIMATING);
+	UpdateTransformation = AbsoluteTransformation;
+
+	LastAbsoluteTransformation = AbsoluteTransformation;
+	return true;
+}
+
+
+//! Runs the affectors, removes dead particles and moves the others
+void CParticleSystemSceneNode::updateParticles()
+{
+	const u32 now = UpdateTime;
+
 	// run affectors
-	if ( visible || behavior & EPB_INVISIBLE_AFFECTING )
+	if (UpdateAffecting)
 	{
 		core::list<IParticleAffector*>::Iterator ait = AffectorList.begin();
 		for (; ait != AffectorList.end(); ++ait)
-			(*ait)->affect(now, Particles.pointer(), Particles.size());
+			(*ait)->affectStreams(now, Particles);
 	}
 
 	if (ParticlesAreGlobal)
-		Buffer->BoundingBox.reset(AbsoluteTransformation.getTranslation());
+		UpdateBox.reset(UpdateTransformation.getTranslation());
 	else
-		Buffer->BoundingBox.reset(core::vector3df(0,0,0));
+		UpdateBox.reset(core::vector3df(0,0,0));
 
 	// animate all particles
-	if ( visible || behavior & EPB_INVISIBLE_ANIMATING )
+	if (UpdateAnimating)
 	{
-		f32 scale = (f32)timediff;
-
+		// Particle order does not matter, so dead particles are removed by
+		// moving the last particle into their place.
 		for (u32 i=0; i<Particles.size();)
 		{
-			// erase is pretty expensive!
-			if (now > Particles[i].endTime)
-			{
-				// Particle order does not seem to matter.
-				// So we can delete by switching with last particle and deleting that one.
-				// This is a lot faster and speed is very important here as the erase otherwise
-				// can cause noticable freezes.
-				Particles[i] = Particles[Particles.size()-1];
-				Particles.erase( Particles.size()-1 );
-			}
+			if (now > Particles.EndTime[i])
+				Particles.swapRemove(i);
 			else
-			{
-				Particles[i].pos += (Particles[i].vector * scale);
-				Buffer->BoundingBox.addInternalPoint(Particles[i].pos);
 				++i;
-			}
 		}
+
+		moveParticles((f32)UpdateTimeDiff);
 	}
 
 	const f32 m = (ParticleSize.Width > ParticleSize.Height ? ParticleSize.Width : ParticleSize.Height) * 0.5f;
-	Buffer->BoundingBox.MaxEdge.X += m;
-	Buffer->BoundingBox.MaxEdge.Y += m;
-	Buffer->BoundingBox.MaxEdge.Z += m;
+	UpdateBox.MaxEdge.X += m;
+	UpdateBox.MaxEdge.Y += m;
+	UpdateBox.MaxEdge.Z += m;
 
-	Buffer->BoundingBox.MinEdge.X -= m;
-	Buffer->BoundingBox.MinEdge.Y -= m;
-	Buffer->BoundingBox.MinEdge.Z -= m;
+	UpdateBox.MinEdge.X -= m;
+	UpdateBox.MinEdge.Y -= m;
+	UpdateBox.MinEdge.Z -= m;
 
 	if (ParticlesAreGlobal)
 	{
-		core::matrix4 absinv( AbsoluteTransformation, core::matrix4::EM4CONST_INVERSE );
-		absinv.transformBoxEx(Buffer->BoundingBox);
+		core::matrix4 absinv( UpdateTransformation, core::matrix4::EM4CONST_INVERSE );
+		absinv.transformBoxEx(UpdateBox);
 	}
+}
 
-	LastAbsoluteTransformation = AbsoluteTransformation;
+
+void CParticleSystemSceneNode::updateParticlesJob(void* userData, u32 index)
+{
+	static_cast<CParticleSystemSceneNode*>(userData)->updateParticles();
+}
+
+
+//! Waits for the update started in OnAnimate and takes over its bounding box
+void CParticleSystemSceneNode::finishUpdate()
+{
+	if (UpdateJob)
+	{
+		JobPool->finishJob(UpdateJob);
+		UpdateJob = 0;
+	}
+
+	Buffer->BoundingBox = UpdateBox;
+}
+
+
+//! Moves the particles along their vectors and adds them to the bounding box.
+void CParticleSystemSceneNode::moveParticles(f32 scale)
+{
+	const u32 count = Particles.size();
+	f32* posX = Particles.PosX.pointer();
+	f32* posY = Particles.PosY.pointer();
+	f32* posZ = Particles.PosZ.pointer();
+	const f32* vectorX = Particles.VectorX.const_pointer();
+	const f32* vectorY = Particles.VectorY.const_pointer();
+	const f32* vectorZ = Particles.VectorZ.const_pointer();
+	core::aabbox3df& box = UpdateBox;
+	u32 i = 0;
+
+#if defined(_IRR_PARTICLES_SSE2_)
+	if (count >= 4)
+	{
+		const __m128 scale4 = _mm_set1_ps(scale);
+		__m128 minX = _mm_set1_ps(box.MinEdge.X);
+		__m128 minY = _mm_set1_ps(box.MinEdge.Y);
+		__m128 minZ = _mm_set1_ps(box.MinEdge.Z);
+		__m128 maxX = _mm_set1_ps(box.MaxEdge.X);
+		__m128 maxY = _mm_set1_ps(box.MaxEdge.Y);
+		__m128 maxZ = _mm_set1_ps(box.MaxEdge.Z);
+
+		for (; i+4 <= count; i+=4)
+		{
+			const __m128 x = _mm_add_ps(loadParticles(posX+i), _mm_mul_ps(loadParticles(vectorX+i), scale4));
+			const __m128 y = _mm_add_ps(loadParticles(posY+i), _mm_mul_ps(loadParticles(vectorY+i), scale4));
+			const __m128 z = _mm_add_ps(loadParticles(posZ+i), _mm_mul_ps(loadParticles(vectorZ+i), scale4));
+			storeParticles(posX+i, x);
+			storeParticles(posY+i, y);
+			storeParticles(posZ+i, z);
+
+			minX = _mm_min_ps(minX, x);
+			minY = _mm_min_ps(minY, y);
+			minZ = _mm_min_ps(minZ, z);
+			maxX = _mm_max_ps(maxX, x);
+			maxY = _mm_max_ps(maxY, y);
+			maxZ = _mm_max_ps(maxZ, z);
+		}
+
+		box.MinEdge.set(minParticles(minX), minParticles(minY), minParticles(minZ));
+		box.MaxEdge.set(maxParticles(maxX), maxParticles(maxY), maxParticles(maxZ));
+	}
+#endif
+
+	for (; i<count; ++i)
+	{
+		posX[i] += vectorX[i] * scale;
+		posY[i] += vectorY[i] * scale;
+		posZ[i] += vectorZ[i] * scale;
+		box.addInternalPoint(posX[i], posY[i], posZ[i]);
+	}
 }
 
 
@@ -549,13 +707,19 @@ void CParticleSystemSceneNode::doParticleSystem(u32 time)
 //! ignore it. Default is true.
 void CParticleSystemSceneNode::setParticlesAreGlobal(bool global)
 {
+	finishUpdate();
 	ParticlesAreGlobal = global;
 }
 
 //! Remove all currently visible particles
 void CParticleSystemSceneNode::clearParticles()
 {
-	Particles.set_used(0);
+	finishUpdate();
+	Particles.clear();
+
+	// without particles the box shrinks to the node
+	UpdateBox.reset(core::vector3df(0,0,0));
+	Buffer->BoundingBox = UpdateBox;
 }
 
 //! Sets if the node should be visible or not.
@@ -573,6 +737,7 @@ void CParticleSystemSceneNode::setVisible(bool isVisible)
 void CParticleSystemSceneNode::setParticleSize(const core::dimension2d<f32> &size)
 {
 	os::Printer::log("setParticleSize is deprecated, use setMinStartSize/setMaxStartSize in emitter.", irr::ELL_WARNING);
+	finishUpdate();
 	//A bit of a hack, but better here than in the particle code
 	if (Emitter)
 	{
@@ -585,38 +750,51 @@ void CParticleSystemSceneNode::setParticleSize(const core::dimension2d<f32> &siz
 
 void CParticleSystemSceneNode::reallocateBuffers()
 {
-	if (Particles.size() * 4 > Buffer->getVertexCount() ||
-			Particles.size() * 6 > Buffer->getIndexCount())
-	{
-		u32 oldSize = Buffer->getVertexCount();
-		Buffer->Vertices.set_used(Particles.size() * 4);
+	const u32 count = Particles.size();
 
-		u32 i;
+	// particle counts often grow a little each frame, so grow by doubling
+	IVertexBuffer& vertices = Buffer->getVertexBuffer();
+	if (vertices.allocated_size() < count * 4)
+		vertices.reallocate(core::max_(count * 4, vertices.allocated_size() * 2));
+	vertices.set_used(count * 4);
 
-		// fill remaining vertices
-		for (i=oldSize; i<Buffer->Vertices.size(); i+=4)
-		{
-			Buffer->Vertices[0+i].TCoords.set(0.0f, 0.0f);
-			Buffer->Vertices[1+i].TCoords.set(0.0f, 1.0f);
-			Buffer->Vertices[2+i].TCoords.set(1.0f, 1.0f);
-			Buffer->Vertices[3+i].TCoords.set(1.0f, 0.0f);
-		}
+	// the indices of all quads are the same each frame, so only new ones are filled
+	IIndexBuffer& indices = Buffer->getIndexBuffer();
+	if (count * 6 > FilledIndexCount)
+	{
+		u32 size = core::max_(count * 6, FilledIndexCount * 2);
+
+		// 16 bit indices address 65536 vertices, use them as long as they are enough
+		if (count * 4 <= 65536)
+			size = core::min_(size, 65536u / 4 * 6);
+		indices.set_used(FilledIndexCount);
+		if (size / 6 * 4 > 65536)
+			indices.setType(video::EIT_32BIT);
 
-		// fill remaining indices
-		u32 oldIdxSize = Buffer->getIndexCount();
-		u32 oldvertices = oldSize;
-		Buffer->Indices.set_used(Particles.size() * 6);
+		if (indices.allocated_size() < size)
+			indices.reallocate(size);
+		indices.set_used(size);
 
-		for (i=oldIdxSize; i<Buffer->Indices.size(); i+=6)
+		u32 vertex = FilledIndexCount / 6 * 4;
+		for (u32 i=FilledIndexCount; i<size; i+=6)
 		{
-			Buffer->Indices[0+i] = (u16)0+oldvertices;
-			Buffer->Indices[1+i] = (u16)2+oldvertices;
-			Buffer->Indices[2+i] = (u16)1+oldvertices;
-			Buffer->Indices[3+i] = (u16)0+oldvertices;
-			Buffer->Indices[4+i] = (u16)3+oldvertices;
-			Buffer->Indices[5+i] = (u16)2+oldvertices;
-			oldvertices += 4;
+			indices.setValue(0+i, 0+vertex);
+			indices.setValue(1+i, 2+vertex);
+			indices.setValue(2+i, 1+vertex);
+			indices.setValue(3+i, 0+vertex);
+			indices.setValue(4+i, 3+vertex);
+			indices.setValue(5+i, 2+vertex);
+			vertex += 4;
 		}
+		FilledIndexCount = size;
+	}
+	indices.set_used(count * 6);
+
+	// the hardware buffer only has the indices which were used when it was updated
+	if (count * 6 > DirtyIndexCount)
+	{
+		Buffer->setDirty(EBT_INDEX);
+		DirtyIndexCount = count * 6;
 	}
 }
 
@@ -667,6 +845,7 @@ void CParticleSystemSceneNode::deserializeAttributes(io::IAttributes* in, io::SA
 {
 	IParticleSystemSceneNode::deserializeAttributes(in, options);
 
+	finishUpdate();
 	ParticlesAreGlobal = in->getAttributeAsBool("GlobalParticles");
 	ParticleSize.Width = in->getAttributeAsFloat("ParticleWidth");
 	ParticleSize.Height = in->getAttributeAsFloat("ParticleHeight");
@@ -11,7 +11,9 @@
 #include "IParticleSystemSceneNode.h"
 #include "irrArray.h"
 #include "irrList.h"
-#include "SMeshBuffer.h"
+#include "CDynamicMeshBuffer.h"
+#include "SParticleStreams.h"
+#include "CJobPool.h"
 
 namespace irr
 {
@@ -21,6 +23,8 @@ namespace scene
 //! A particle system scene node.
 /** A scene node controlling a particle system. The behavior of the particles
 can be controlled by setting the right particle emitters and affectors.
+The particles are emitted in OnAnimate, the affectors and the movement run
+as a job of the job pool of the video driver until OnRegisterSceneNode.
 */
 class CParticleSystemSceneNode : public IParticleSystemSceneNode
 {
@@ -57,6 +61,15 @@ public:
 	//! Returns amount of materials used by this scene node.
 	virtual u32 getMaterialCount() const _IRR_OVERRIDE_;
 
+	//! Emits the particles and starts their update
+	virtual void OnAnimate(u32 timeMs) _IRR_OVERRIDE_;
+
+	//! The emitters use the random generator, so OnAnimate stays on the main thread
+	virtual bool isAnimationThreadSafe() const _IRR_OVERRIDE_ { return false; }
+
+	//! The particles are moved in their own space, the node uses the default transformation
+	virtual bool hasDefaultTransformation() const _IRR_OVERRIDE_ { return true; }
+
 	//! pre render event
 	virtual void OnRegisterSceneNode() _IRR_OVERRIDE_;
 
@@ -216,16 +229,51 @@ public:
 
 private:
 
+	//! Emits new particles, returns false if only the time of the first update was stored
+	bool emitParticles(u32 time);
+
+	//! Runs the affectors, removes dead particles and moves the others
+	void updateParticles();
+
+	//! Waits for the update started in OnAnimate and takes over its bounding box
+	void finishUpdate();
+
+	//! Fills the vertices of the particles first to last-1
+	void buildVertices(u32 first, u32 last);
+
+	static void updateParticlesJob(void* userData, u32 index);
+	static void buildVerticesJob(void* userData, u32 index);
+
 	void reallocateBuffers();
+	void moveParticles(f32 scale);
 
 	core::list<IParticleAffector*> AffectorList;
 	IParticleEmitter* Emitter;
-	core::array<SParticle> Particles;
+	SParticleStreams Particles;
 	core::dimension2d<f32> ParticleSize;
 	u32 LastEmitTime;
 	core::matrix4 LastAbsoluteTransformation;
 
-	SMeshBuffer* Buffer;
+	CDynamicMeshBuffer* Buffer;
+	u32 FilledIndexCount;
+	u32 DirtyIndexCount;
+
+	CJobPool* JobPool;
+	CJobPool::SBatch* UpdateJob;
+
+	// values of the update, which may run on a worker thread
+	core::matrix4 UpdateTransformation;
+	core::aabbox3d<f32> UpdateBox;
+	u32 UpdateTime;
+	u32 UpdateTimeDiff;
+	bool UpdateAffecting;
+	bool UpdateAnimating;
+	bool UpdateStarted;
+
+	// camera axes for the vertices of the billboards
+	core::vector3df BillboardHorizontal;
+	core::vector3df BillboardVertical;
+	core::vector3df BillboardView;
 
 // TODO: That was obviously planned by someone at some point and sounds like a good idea.
 // But seems it was never implemented.
@@ -0,0 +1,195 @@
+// Copyright (C) 2002-2012 Nikolaus Gebhardt
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#ifndef __C_PATH_HASH_MAP_H_INCLUDED__
+#define __C_PATH_HASH_MAP_H_INCLUDED__
+
+#include "irrArray.h"
+#include "path.h"
+
+namespace irr
+{
+namespace io
+{
+
+	//! Hash map from paths to values, with constant time lookup and removal.
+	/** Keys are compared exactly, callers which want case insensitive names
+	pass SNamedPath::getInternalName. The hash of each key is stored with
+	it, so lookups only compare strings when the hashes match. Uses open
+	addressing with linear probing, removal shifts the following entries
+	back instead of leaving tombstones. */
+	template <class T>
+	class CPathHashMap
+	{
+	public:
+
+		//! constructor
+		CPathHashMap() : Used(0) {}
+
+		//! Returns the hash of a path, FNV-1a over the characters.
+		static u32 getHash(const path& key)
+		{
+			u32 hash = 2166136261u;
+			for (u32 i=0; i<key.size(); ++i)
+			{
+				hash ^= (u32)key[i];
+				hash *= 16777619u;
+			}
+			return hash;
+		}
+
+		//! Returns the value of a key, 0 if the key is not in the map.
+		T* find(const path& key)
+		{
+			const s32 slot = findSlot(key, getHash(key));
+			return slot >= 0 ? &Entries[slot].Value : 0;
+		}
+
+		//! Returns the value of a key, 0 if the key is not in the map.
+		const T* find(const path& key) const
+		{
+			const s32 slot = findSlot(key, getHash(key));
+			return slot >= 0 ? &Entries[slot].Value : 0;
+		}
+
+		//! Sets the value of a key, adds the key when it is not in the map.
+		void insert(const path& key, const T& value)
+		{
+			const u32 hash = getHash(key);
+			const s32 slot = findSlot(key, hash);
+			if (slot >= 0)
+			{
+				Entries[slot].Value = value;
+				return;
+			}
+
+			// keep the load factor below 3/4
+			if ((Used+1)*4 > Entries.size()*3)
+				rehash(Entries.size() ? Entries.size()*2 : 16);
+
+			const u32 mask = Entries.size()-1;
+			u32 i = hash & mask;
+			while (Entries[i].Used)
+				i = (i+1) & mask;
+
+			Entries[i].Key = key;
+			Entries[i].Hash = hash;
+			Entries[i].Value = value;
+			Entries[i].Used = true;
+			++Used;
+		}
+
+		//! Removes a key, returns false if the key is not in the map.
+		bool remove(const path& key)
+		{
+			const s32 slot = findSlot(key, getHash(key));
+			if (slot < 0)
+				return false;
+
+			// move following entries of the probe sequence into the hole
+			const u32 mask = Entries.size()-1;
+			u32 hole = (u32)slot;
+			u32 i = hole;
+			for (;;)
+			{
+				i = (i+1) & mask;
+				if (!Entries[i].Used)
+					break;
+
+				// entries which can't be found from the hole stay
+				const u32 home = Entries[i].Hash & mask;
+				if (((i - home) & mask) < ((i - hole) & mask))
+					continue;
+
+				Entries[hole].Key = Entries[i].Key;
+				Entries[hole].Hash = Entries[i].Hash;
+				Entries[hole].Value = Entries[i].Value;
+				hole = i;
+			}
+
+			Entries[hole].Key = path();
+			Entries[hole].Value = T();
+			Entries[hole].Used = false;
+			--Used;
+			return true;
+		}
+
+		//! Removes all keys.
+		void clear()
+		{
+			Entries.clear();
+			Used = 0;
+		}
+
+		//! Returns the number of keys in the map.
+		u32 size() const
+		{
+			return Used;
+		}
+
+	private:
+
+		struct SEntry
+		{
+			SEntry() : Hash(0), Value(), Used(false) {}
+
+			path Key;
+			u32 Hash;
+			T Value;
+			bool Used;
+		};
+
+		//! returns the slot of a key, -1 if it is not in the map
+		s32 findSlot(const path& key, u32 hash) const
+		{
+			if (Entries.empty())
+				return -1;
+
+			const u32 mask = Entries.size()-1;
+			u32 i = hash & mask;
+			while (Entries[i].Used)
+			{
+				if (Entries[i].Hash == hash && Entries[i].Key == key)
+					return (s32)i;
+				i = (i+1) & mask;
+			}
+			return -1;
+		}
+
+		//! moves all entries into a new table with a power of two size
+		void rehash(u32 size)
+		{
+			core::array<SEntry> old;
+			old.swap(Entries);
+
+			// set_used doesn't construct the entries
+			Entries.reallocate(size);
+			for (u32 k=0; k<size; ++k)
+				Entries.push_back(SEntry());
+			Used = 0;
+
+			const u32 mask = size-1;
+			for (u32 k=0; k<old.size(); ++k)
+			{
+				if (!old[k].Used)
+					continue;
+
+				u32 i = old[k].Hash & mask;
+				while (Entries[i].Used)
+					i = (i+1) & mask;
+
+				Entries[i] = old[k];
+				++Used;
+			}
+		}
+
+		core::array<SEntry> Entries;
+		u32 Used;
+	};
+
+} // end namespace io
+} // end namespace irr
+
+#endif
+
@@ -354,6 +354,14 @@ void CQ3LevelMesh::loadVisData(tBSPLump* l, io::IReadFile* file)
 */
 void CQ3LevelMesh::loadEntities(tBSPLump* l, io::IReadFile* file)
 {
+	// parse the lump in place if the file has its contents in memory
+	const c8* data = (const c8*)file->getData();
+	if (data && l->offset >= 0 && l->length >= 0 && l->offset + l->length <= file->getSize())
+	{
+		parser_parse( data + l->offset, l->length, &CQ3LevelMesh::scriptcallback_entity );
+		return;
+	}
+
 	core::array<u8> entity;
 	entity.set_used( l->length + 2 );
 	entity[l->length + 1 ] = 0;
@@ -1601,9 +1609,17 @@ void CQ3LevelMesh::getShader( io::IReadFile* file )
 	if ( 0 == file )
 		return;
 
+	const long len = file->getSize();
+
+	// parse the script in place if the file has its contents in memory
+	if (file->getData())
+	{
+		parser_parse( file->getData(), len, &CQ3LevelMesh::scriptcallback_shader );
+		return;
+	}
+
 	// load script
 	core::array<u8> script;
-	const long len = file->getSize();
 
 	script.set_used( len + 2 );
 
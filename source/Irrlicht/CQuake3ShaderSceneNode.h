@@ -34,6 +34,8 @@ public:
 	virtual void OnRegisterSceneNode() _IRR_OVERRIDE_;
 	virtual void render() _IRR_OVERRIDE_;
 	virtual void OnAnimate(u32 timeMs) _IRR_OVERRIDE_;
+	virtual bool isAnimationThreadSafe() const _IRR_OVERRIDE_ { return false; }
+	virtual bool hasDefaultTransformation() const _IRR_OVERRIDE_ { return true; }
 	virtual const core::aabbox3d<f32>& getBoundingBox() const _IRR_OVERRIDE_;
 
 	virtual u32 getMaterialCount() const _IRR_OVERRIDE_;
@@ -0,0 +1,197 @@
+// Copyright (C) 2002-2012 Nikolaus Gebhardt
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#include "CRenderQueue.h"
+#include "IMaterialRenderer.h"
+#include "IMesh.h"
+#include "IMeshBuffer.h"
+
+namespace irr
+{
+namespace scene
+{
+
+//! constructor
+CRenderQueue::CRenderQueue()
+	: MaterialChanges(0), TextureChanges(0)
+{
+	memset(TextureSlots, 0, sizeof(TextureSlots));
+}
+
+
+//! Adds the solid mesh buffers of a node
+void CRenderQueue::addNode(IMeshSceneNode* node, video::IVideoDriver* driver, f32 distance)
+{
+	IMesh* mesh = node->getMesh();
+	if (!mesh)
+		return;
+
+	const bool readOnlyMaterials = node->isReadOnlyMaterials();
+	for (u32 i=0; i<mesh->getMeshBufferCount(); ++i)
+	{
+		IMeshBuffer* mb = mesh->getMeshBuffer(i);
+		if (!mb)
+			continue;
+
+		// same choice of materials as CMeshSceneNode::render()
+		const video::SMaterial& material = readOnlyMaterials ? mb->getMaterial() : node->getMaterial(i);
+		video::IMaterialRenderer* rnd = driver->getMaterialRenderer(material.MaterialType);
+		if (rnd && rnd->isTransparent())
+			continue;
+
+		SSortEntry entry;
+		entry.Key = getKey(material, distance);
+		entry.Item = Items.size();
+		Entries.push_back(entry);
+
+		SDrawItem item;
+		item.Node = node;
+		item.MeshBuffer = mb;
+		item.Material = &material;
+		Items.push_back(item);
+	}
+}
+
+
+//! Builds the sort key of a material
+u64 CRenderQueue::getKey(const video::SMaterial& material, f32 distance)
+{
+	const u64 type = core::min_((u32)material.MaterialType, (u32)0xff);
+	const u64 texture0 = getTextureId(material.getTexture(0)) & 0xffff;
+	const u64 texture1 = getTextureId(material.getTexture(1)) & 0xfff;
+	const u64 flags = (material.Lighting ? 1 : 0) | (material.ZWriteEnable ? 2 : 0) |
+		(material.BackfaceCulling ? 4 : 0) | (material.FrontfaceCulling ? 8 : 0) |
+		(material.FogEnable ? 16 : 0) | (material.GouraudShading ? 32 : 0) |
+		(material.Wireframe ? 64 : 0) | (material.NormalizeNormals ? 128 : 0) |
+		((u64)(material.ZBuffer & 0xf) << 8);
+	const u64 depth = (u64)(core::clamp(distance, 0.f, 1.f) * 65535.f);
+
+	return (type << 56) | (texture0 << 40) | (texture1 << 28) | (flags << 16) | depth;
+}
+
+
+//! Get a small id for a texture, which is the same in each frame
+u32 CRenderQueue::getTextureId(video::ITexture* texture)
+{
+	if (!texture)
+		return 0;
+
+	// most mesh buffers use one of a few textures
+	STextureSlot& slot = TextureSlots[((size_t)texture >> 4) & 0xff];
+	if (slot.Texture == texture)
+		return slot.Id;
+
+	core::map<video::ITexture*, u32>::Node* n = TextureIds.find(texture);
+	if (!n)
+	{
+		// start again when the ids don't fit into the keys anymore
+		if (TextureIds.size() >= 0xffff)
+		{
+			TextureIds.clear();
+			memset(TextureSlots, 0, sizeof(TextureSlots));
+		}
+
+		TextureIds.insert(texture, TextureIds.size() + 1);
+		n = TextureIds.find(texture);
+	}
+
+	slot.Texture = texture;
+	slot.Id = n->getValue();
+	return slot.Id;
+}
+
+
+//! Sorts the entries by their keys, the order of equal keys is kept
+void CRenderQueue::sort()
+{
+	const u32 count = Entries.size();
+	SortBuffer.set_used(count);
+
+	u64 differentBits = 0;
+	for (u32 i=1; i<count; ++i)
+		differentBits |= Entries[i].Key ^ Entries[0].Key;
+
+	// least significant digit first, one byte per pass
+	for (u32 shift=0; shift<64; shift+=8)
+	{
+		// all keys have the same byte
+		if (!((differentBits >> shift) & 0xff))
+			continue;
+
+		u32 offsets[256] = {0};
+		for (u32 i=0; i<count; ++i)
+			++offsets[(Entries[i].Key >> shift) & 0xff];
+
+		u32 sum = 0;
+		for (u32 b=0; b<256; ++b)
+		{
+			const u32 c = offsets[b];
+			offsets[b] = sum;
+			sum += c;
+		}
+
+		for (u32 i=0; i<count; ++i)
+			SortBuffer[offsets[(Entries[i].Key >> shift) & 0xff]++] = Entries[i];
+
+		Entries.swap(SortBuffer);
+	}
+}
+
+
+//! Draws all items in sorted order and removes them
+void CRenderQueue::render(video::IVideoDriver* driver)
+{
+	sort();
+
+	MaterialChanges = 0;
+	TextureChanges = 0;
+
+	const IMeshSceneNode* lastNode = 0;
+	const video::SMaterial* lastMaterial = 0;
+	u64 lastStates = 0;
+	for (u32 i=0; i<Entries.size(); ++i)
+	{
+		const SDrawItem& item = Items[Entries[i].Item];
+		// materials with other keys are different, without the distance bits
+		const u64 states = Entries[i].Key >> 16;
+
+		if (item.Node != lastNode)
+		{
+			driver->setTransform(video::ETS_WORLD, item.Node->getAbsoluteTransformation());
+			lastNode = item.Node;
+		}
+
+		if (!lastMaterial || states != lastStates ||
+			(item.Material != lastMaterial && *item.Material != *lastMaterial))
+		{
+			if (!lastMaterial || item.Material->getTexture(0) != lastMaterial->getTexture(0))
+				++TextureChanges;
+
+			driver->setMaterial(*item.Material);
+			++MaterialChanges;
+		}
+		lastMaterial = item.Material;
+		lastStates = states;
+
+		driver->drawMeshBuffer(item.MeshBuffer);
+	}
+
+	Items.set_used(0);
+	Entries.set_used(0);
+}
+
+
+//! Removes all items and forgets the textures
+void CRenderQueue::clear()
+{
+	Items.clear();
+	Entries.clear();
+	SortBuffer.clear();
+	TextureIds.clear();
+	memset(TextureSlots, 0, sizeof(TextureSlots));
+}
+
+} // end namespace scene
+} // end namespace irr
+
@@ -0,0 +1,98 @@
+// Copyright (C) 2002-2012 Nikolaus Gebhardt
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#ifndef __C_RENDER_QUEUE_H_INCLUDED__
+#define __C_RENDER_QUEUE_H_INCLUDED__
+
+#include "IMeshSceneNode.h"
+#include "IVideoDriver.h"
+#include "irrArray.h"
+#include "irrMap.h"
+
+namespace irr
+{
+namespace scene
+{
+	//! Draws the solid mesh buffers of many mesh scene nodes sorted by their render states
+	/** Each mesh buffer is one draw item with a 64 bit sort key. From the
+	highest to the lowest bits the key holds the material type, the
+	textures of the first two layers, the other material flags and the
+	distance to the camera. The items are radix sorted, so mesh buffers
+	with the same material are drawn one after the other and the driver
+	only has to change the render states between different materials.
+	Mesh buffers with equal states are drawn front to back. */
+	class CRenderQueue
+	{
+	public:
+
+		//! constructor
+		CRenderQueue();
+
+		//! Adds the solid mesh buffers of a node
+		/** \param node Node which returned true for IMeshSceneNode::canQueueMeshBuffers().
+		\param driver Driver to find the transparent materials.
+		\param distance Distance of the node to the camera, between 0 and 1. */
+		void addNode(IMeshSceneNode* node, video::IVideoDriver* driver, f32 distance);
+
+		//! Draws all items in sorted order and removes them
+		void render(video::IVideoDriver* driver);
+
+		//! Get the number of items added since the last render()
+		u32 getItemCount() const { return Items.size(); }
+
+		//! Get the number of material changes of the last render()
+		u32 getMaterialChanges() const { return MaterialChanges; }
+
+		//! Get the number of texture changes of the last render()
+		u32 getTextureChanges() const { return TextureChanges; }
+
+		//! Removes all items and forgets the textures
+		void clear();
+
+	private:
+
+		struct SDrawItem
+		{
+			IMeshSceneNode* Node;
+			IMeshBuffer* MeshBuffer;
+			const video::SMaterial* Material;
+		};
+
+		struct STextureSlot
+		{
+			video::ITexture* Texture;
+			u32 Id;
+		};
+
+		struct SSortEntry
+		{
+			u64 Key;
+			u32 Item;
+		};
+
+		//! Builds the sort key of a material
+		u64 getKey(const video::SMaterial& material, f32 distance);
+
+		//! Get a small id for a texture, which is the same in each frame
+		u32 getTextureId(video::ITexture* texture);
+
+		//! Sorts the entries by their keys, the order of equal keys is kept
+		void sort();
+
+		core::array<SDrawItem> Items;
+		core::array<SSortEntry> Entries;
+		core::array<SSortEntry> SortBuffer;
+
+		core::map<video::ITexture*, u32> TextureIds;
+		//! Recently used entries of TextureIds
+		STextureSlot TextureSlots[256];
+		u32 MaterialChanges;
+		u32 TextureChanges;
+	};
+
+} // end namespace scene
+} // end namespace irr
+
+#endif
+
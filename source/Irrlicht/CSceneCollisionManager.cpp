@@ -11,14 +11,36 @@
 #include "os.h"
 #include "irrMath.h"
 
+// The ray batches test four triangles at once with SSE2. Define
+// NO_IRR_COLLISION_SSE2_ to use the plain C++ loop.
+#if !defined(NO_IRR_COLLISION_SSE2_) && \
+	(defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+	#define _IRR_COLLISION_SSE2_
+	#include <emmintrin.h>
+#endif
+
 namespace irr
 {
 namespace scene
 {
 
+//! Smallest number of rays tested by one job of a batch.
+static const u32 MIN_RAYS_PER_JOB = 64;
+
+//! Smallest number of ellipsoids moved by one job of a batch.
+static const u32 MIN_SWEEPS_PER_JOB = 16;
+
+#if defined(_IRR_COLLISION_SSE2_)
+//! dot products of four pairs of vectors
+static inline __m128 dotProduct4(__m128 ax, __m128 ay, __m128 az, __m128 bx, __m128 by, __m128 bz)
+{
+	return _mm_add_ps(_mm_add_ps(_mm_mul_ps(ax, bx), _mm_mul_ps(ay, by)), _mm_mul_ps(az, bz));
+}
+#endif
+
 //! constructor
 CSceneCollisionManager::CSceneCollisionManager(ISceneManager* smanager, video::IVideoDriver* driver)
-: SceneManager(smanager), Driver(driver)
+: SceneManager(smanager), Driver(driver), JobPool(0)
 {
 	#ifdef _DEBUG
 	setDebugName("CSceneCollisionManager");
@@ -34,6 +56,22 @@ CSceneCollisionManager::~CSceneCollisionManager()
 {
 	if (Driver)
 		Driver->drop();
+
+	if (JobPool)
+		JobPool->drop();
+}
+
+
+//! Sets the worker threads which run large ray and ellipsoid batches
+void CSceneCollisionManager::setJobPool(CJobPool* pool)
+{
+	if (pool)
+		pool->grab();
+
+	if (JobPool)
+		JobPool->drop();
+
+	JobPool = pool;
 }
 
 
@@ -351,8 +389,8 @@ bool CSceneCollisionManager::getCollisionPoint(SCollisionHit& hitResult, const c
 	Triangles.set_used(totalcnt);
 
 	s32 cnt = 0;
-	irr::core::array<SCollisionTriangleRange> outTriangleInfo;
-	selector->getTriangles(Triangles.pointer(), totalcnt, cnt, ray, 0, true, &outTriangleInfo);
+	TriangleInfo.set_used(0);
+	selector->getTriangles(Triangles.pointer(), totalcnt, cnt, ray, 0, true, &TriangleInfo);
 
 	const core::vector3df linevect = ray.getVector().normalize();
 	core::vector3df intersection;
@@ -402,17 +440,13 @@ bool CSceneCollisionManager::getCollisionPoint(SCollisionHit& hitResult, const c
 
 	if ( foundIndex >= 0 )
 	{
-		for ( irr::u32 t=0; t<outTriangleInfo.size(); ++t )
+		const SCollisionTriangleRange* range = getTriangleRange(foundIndex);
+		if ( range )
 		{
-			if ( outTriangleInfo[t].isIndexInRange(foundIndex) )
-			{
-				hitResult.Node = outTriangleInfo[t].SceneNode;
-				hitResult.MeshBuffer = outTriangleInfo[t].MeshBuffer;
-				hitResult.MaterialIndex = outTriangleInfo[t].MaterialIndex;
-				hitResult.TriangleSelector = outTriangleInfo[t].Selector;
-
-				break;
-			}
+			hitResult.Node = range->SceneNode;
+			hitResult.MeshBuffer = range->MeshBuffer;
+			hitResult.MaterialIndex = range->MaterialIndex;
+			hitResult.TriangleSelector = range->Selector;
 		}
 
 		return true;
@@ -421,6 +455,324 @@ bool CSceneCollisionManager::getCollisionPoint(SCollisionHit& hitResult, const c
 	return false;
 }
 
+
+//! Finds the nearest collision points of many lines with the triangles of one selector.
+u32 CSceneCollisionManager::getCollisionPoints(SCollisionHit* hitResults, bool* outHits,
+		const core::line3d<f32>* rays, u32 count, ITriangleSelector* selector)
+{
+	for (u32 i=0; i<count; ++i)
+		outHits[i] = false;
+
+	if (!selector || !count)
+		return 0;
+
+	// the triangles are fetched once for the box around all rays
+	core::aabbox3df box(rays[0].start);
+	for (u32 i=0; i<count; ++i)
+	{
+		box.addInternalPoint(rays[i].start);
+		box.addInternalPoint(rays[i].end);
+	}
+
+	const s32 triangleCount = getBatchTriangles(selector, box);
+	if (triangleCount <= 0)
+		return 0;
+
+	// Blocks of four triangles. The unused ones in the last block have
+	// no area and an empty box, so they are never hit.
+	RayBlocks.set_used((triangleCount + 3) / 4);
+	for (s32 i=0; i<(s32)RayBlocks.size()*4; ++i)
+	{
+		STriangleBlock& block = RayBlocks[i/4];
+		const u32 k = i & 3;
+
+		if (i < triangleCount)
+		{
+			const core::triangle3df& triangle = Triangles[i];
+			block.AX[k] = triangle.pointA.X;
+			block.AY[k] = triangle.pointA.Y;
+			block.AZ[k] = triangle.pointA.Z;
+			block.E1X[k] = triangle.pointB.X - triangle.pointA.X;
+			block.E1Y[k] = triangle.pointB.Y - triangle.pointA.Y;
+			block.E1Z[k] = triangle.pointB.Z - triangle.pointA.Z;
+			block.E2X[k] = triangle.pointC.X - triangle.pointA.X;
+			block.E2Y[k] = triangle.pointC.Y - triangle.pointA.Y;
+			block.E2Z[k] = triangle.pointC.Z - triangle.pointA.Z;
+			block.MinX[k] = core::min_(triangle.pointA.X, triangle.pointB.X, triangle.pointC.X);
+			block.MinY[k] = core::min_(triangle.pointA.Y, triangle.pointB.Y, triangle.pointC.Y);
+			block.MinZ[k] = core::min_(triangle.pointA.Z, triangle.pointB.Z, triangle.pointC.Z);
+			block.MaxX[k] = core::max_(triangle.pointA.X, triangle.pointB.X, triangle.pointC.X);
+			block.MaxY[k] = core::max_(triangle.pointA.Y, triangle.pointB.Y, triangle.pointC.Y);
+			block.MaxZ[k] = core::max_(triangle.pointA.Z, triangle.pointB.Z, triangle.pointC.Z);
+		}
+		else
+		{
+			block.AX[k] = block.AY[k] = block.AZ[k] = 0.f;
+			block.E1X[k] = block.E1Y[k] = block.E1Z[k] = 0.f;
+			block.E2X[k] = block.E2Y[k] = block.E2Z[k] = 0.f;
+			block.MinX[k] = block.MinY[k] = block.MinZ[k] = FLT_MAX;
+			block.MaxX[k] = block.MaxY[k] = block.MaxZ[k] = -FLT_MAX;
+		}
+	}
+
+	SBatchJobs jobs;
+	jobs.Manager = this;
+	jobs.Count = count;
+	jobs.JobCount = getBatchJobCount(count, MIN_RAYS_PER_JOB);
+	jobs.HitResults = hitResults;
+	jobs.Hits = outHits;
+	jobs.Rays = rays;
+	jobs.Sweeps = 0;
+	runBatchJobs(collideRaysJob, jobs);
+
+	u32 hitCount = 0;
+	for (u32 i=0; i<count; ++i)
+	{
+		if (outHits[i])
+			++hitCount;
+	}
+	return hitCount;
+}
+
+
+//! Tests the rays first to last-1 of a batch
+void CSceneCollisionManager::collideRays(const SBatchJobs& jobs, u32 first, u32 last) const
+{
+	for (u32 i=first; i<last; ++i)
+	{
+		const core::line3df& ray = jobs.Rays[i];
+
+		f32 t;
+		const s32 index = getNearestRayTriangle(ray, t);
+		if (index < 0)
+			continue;
+
+		SCollisionHit& hitResult = jobs.HitResults[i];
+		hitResult.Intersection = ray.start + ray.getVector() * t;
+		hitResult.Triangle = Triangles[index];
+
+		const SCollisionTriangleRange* range = getTriangleRange(index);
+		if (range)
+		{
+			hitResult.Node = range->SceneNode;
+			hitResult.MeshBuffer = range->MeshBuffer;
+			hitResult.MaterialIndex = range->MaterialIndex;
+			hitResult.TriangleSelector = range->Selector;
+		}
+
+		jobs.Hits[i] = true;
+	}
+}
+
+
+void CSceneCollisionManager::collideRaysJob(void* userData, u32 index)
+{
+	const SBatchJobs& jobs = *static_cast<SBatchJobs*>(userData);
+	const u32 countPerJob = (jobs.Count + jobs.JobCount - 1) / jobs.JobCount;
+	const u32 first = index * countPerJob;
+	jobs.Manager->collideRays(jobs, first, core::min_(first + countPerJob, jobs.Count));
+}
+
+
+//! Finds the nearest triangle in RayBlocks hit by a ray, returns -1 if there is none
+/** Moeller-Trumbore test of the points start+t*(end-start) with 0 < t < 1,
+like the test of getCollisionPoint which excludes the end points. */
+s32 CSceneCollisionManager::getNearestRayTriangle(const core::line3df& ray, f32& outT) const
+{
+	const core::vector3df dir = ray.getVector();
+	const core::vector3df rayMin(core::min_(ray.start.X, ray.end.X),
+		core::min_(ray.start.Y, ray.end.Y), core::min_(ray.start.Z, ray.end.Z));
+	const core::vector3df rayMax(core::max_(ray.start.X, ray.end.X),
+		core::max_(ray.start.Y, ray.end.Y), core::max_(ray.start.Z, ray.end.Z));
+	const u32 blockCount = RayBlocks.size();
+
+	s32 found = -1;
+	f32 nearest = 1.f;
+
+#if defined(_IRR_COLLISION_SSE2_)
+	const __m128 startX = _mm_set1_ps(ray.start.X);
+	const __m128 startY = _mm_set1_ps(ray.start.Y);
+	const __m128 startZ = _mm_set1_ps(ray.start.Z);
+	const __m128 dirX = _mm_set1_ps(dir.X);
+	const __m128 dirY = _mm_set1_ps(dir.Y);
+	const __m128 dirZ = _mm_set1_ps(dir.Z);
+	const __m128 minX = _mm_set1_ps(rayMin.X);
+	const __m128 minY = _mm_set1_ps(rayMin.Y);
+	const __m128 minZ = _mm_set1_ps(rayMin.Z);
+	const __m128 maxX = _mm_set1_ps(rayMax.X);
+	const __m128 maxY = _mm_set1_ps(rayMax.Y);
+	const __m128 maxZ = _mm_set1_ps(rayMax.Z);
+	const __m128 zero = _mm_setzero_ps();
+	const __m128 one = _mm_set1_ps(1.f);
+	const __m128i four = _mm_set1_epi32(4);
+
+	// nearest hit of each of the four lanes
+	__m128 bestT = one;
+	__m128i bestIndex = _mm_set1_epi32(-1);
+	__m128i index = _mm_set_epi32(3, 2, 1, 0);
+
+	for (u32 b=0; b<blockCount; ++b, index = _mm_add_epi32(index, four))
+	{
+		const STriangleBlock& block = RayBlocks[b];
+
+		// boxes of the ray and the triangles have to overlap
+		__m128 mask = _mm_and_ps(_mm_cmple_ps(_mm_loadu_ps(block.MinX), maxX),
+			_mm_cmpge_ps(_mm_loadu_ps(block.MaxX), minX));
+		mask = _mm_and_ps(mask, _mm_and_ps(_mm_cmple_ps(_mm_loadu_ps(block.MinY), maxY),
+			_mm_cmpge_ps(_mm_loadu_ps(block.MaxY), minY)));
+		mask = _mm_and_ps(mask, _mm_and_ps(_mm_cmple_ps(_mm_loadu_ps(block.MinZ), maxZ),
+			_mm_cmpge_ps(_mm_loadu_ps(block.MaxZ), minZ)));
+		if (!_mm_movemask_ps(mask))
+			continue;
+
+		const __m128 e1x = _mm_loadu_ps(block.E1X);
+		const __m128 e1y = _mm_loadu_ps(block.E1Y);
+		const __m128 e1z = _mm_loadu_ps(block.E1Z);
+		const __m128 e2x = _mm_loadu_ps(block.E2X);
+		const __m128 e2y = _mm_loadu_ps(block.E2Y);
+		const __m128 e2z = _mm_loadu_ps(block.E2Z);
+
+		// p = dir x e2
+		const __m128 px = _mm_sub_ps(_mm_mul_ps(dirY, e2z), _mm_mul_ps(dirZ, e2y));
+		const __m128 py = _mm_sub_ps(_mm_mul_ps(dirZ, e2x), _mm_mul_ps(dirX, e2z));
+		const __m128 pz = _mm_sub_ps(_mm_mul_ps(dirX, e2y), _mm_mul_ps(dirY, e2x));
+
+		// no hit when the ray is parallel to the triangle
+		const __m128 det = dotProduct4(e1x, e1y, e1z, px, py, pz);
+		mask = _mm_and_ps(mask, _mm_cmpneq_ps(det, zero));
+		const __m128 invDet = _mm_div_ps(one, det);
+
+		// s = start - pointA
+		const __m128 sx = _mm_sub_ps(startX, _mm_loadu_ps(block.AX));
+		const __m128 sy = _mm_sub_ps(startY, _mm_loadu_ps(block.AY));
+		const __m128 sz = _mm_sub_ps(startZ, _mm_loadu_ps(block.AZ));
+		const __m128 u = _mm_mul_ps(dotProduct4(sx, sy, sz, px, py, pz), invDet);
+
+		// q = s x e1
+		const __m128 qx = _mm_sub_ps(_mm_mul_ps(sy, e1z), _mm_mul_ps(sz, e1y));
+		const __m128 qy = _mm_sub_ps(_mm_mul_ps(sz, e1x), _mm_mul_ps(sx, e1z));
+		const __m128 qz = _mm_sub_ps(_mm_mul_ps(sx, e1y), _mm_mul_ps(sy, e1x));
+		const __m128 v = _mm_mul_ps(dotProduct4(dirX, dirY, dirZ, qx, qy, qz), invDet);
+		const __m128 t = _mm_mul_ps(dotProduct4(e2x, e2y, e2z, qx, qy, qz), invDet);
+
+		mask = _mm_and_ps(mask, _mm_and_ps(_mm_cmpge_ps(u, zero), _mm_cmpge_ps(v, zero)));
+		mask = _mm_and_ps(mask, _mm_cmple_ps(_mm_add_ps(u, v), one));
+		mask = _mm_and_ps(mask, _mm_and_ps(_mm_cmpgt_ps(t, zero), _mm_cmplt_ps(t, bestT)));
+
+		bestT = _mm_or_ps(_mm_and_ps(mask, t), _mm_andnot_ps(mask, bestT));
+		const __m128i indexMask = _mm_castps_si128(mask);
+		bestIndex = _mm_or_si128(_mm_and_si128(indexMask, index), _mm_andnot_si128(indexMask, bestIndex));
+	}
+
+	// nearest of the lanes, the first triangle on a tie like the scalar loop
+	f32 laneT[4];
+	s32 laneIndex[4];
+	_mm_storeu_ps(laneT, bestT);
+	_mm_storeu_si128((__m128i*)laneIndex, bestIndex);
+	for (u32 k=0; k<4; ++k)
+	{
+		if (laneIndex[k] >= 0 && (found < 0 || laneT[k] < nearest ||
+			(laneT[k] == nearest && laneIndex[k] < found)))
+		{
+			nearest = laneT[k];
+			found = laneIndex[k];
+		}
+	}
+#else
+	for (u32 b=0; b<blockCount; ++b)
+	{
+		const STriangleBlock& block = RayBlocks[b];
+
+		for (u32 k=0; k<4; ++k)
+		{
+			// boxes of the ray and the triangle have to overlap
+			if (block.MinX[k] > rayMax.X || block.MaxX[k] < rayMin.X ||
+				block.MinY[k] > rayMax.Y || block.MaxY[k] < rayMin.Y ||
+				block.MinZ[k] > rayMax.Z || block.MaxZ[k] < rayMin.Z)
+				continue;
+
+			const core::vector3df e1(block.E1X[k], block.E1Y[k], block.E1Z[k]);
+			const core::vector3df e2(block.E2X[k], block.E2Y[k], block.E2Z[k]);
+			const core::vector3df p = dir.crossProduct(e2);
+
+			// no hit when the ray is parallel to the triangle
+			const f32 det = e1.dotProduct(p);
+			if (det == 0.f)
+				continue;
+			const f32 invDet = 1.f / det;
+
+			const core::vector3df s = ray.start - core::vector3df(block.AX[k], block.AY[k], block.AZ[k]);
+			const f32 u = s.dotProduct(p) * invDet;
+			if (u < 0.f)
+				continue;
+
+			const core::vector3df q = s.crossProduct(e1);
+			const f32 v = dir.dotProduct(q) * invDet;
+			if (v < 0.f || u + v > 1.f)
+				continue;
+
+			const f32 t = e2.dotProduct(q) * invDet;
+			if (t > 0.f && t < nearest)
+			{
+				nearest = t;
+				found = b*4 + k;
+			}
+		}
+	}
+#endif
+
+	outT = nearest;
+	return found;
+}
+
+
+//! Fills Triangles and TriangleInfo with the triangles of the selector inside the box
+s32 CSceneCollisionManager::getBatchTriangles(ITriangleSelector* selector, const core::aabbox3df& box)
+{
+	const s32 totalcnt = selector->getTriangleCount();
+	s32 cnt = 0;
+	TriangleInfo.set_used(0);
+	if (totalcnt > 0)
+	{
+		Triangles.set_used(totalcnt);
+		selector->getTriangles(Triangles.pointer(), totalcnt, cnt, box, 0, true, &TriangleInfo);
+	}
+	Triangles.set_used(cnt);
+	return cnt;
+}
+
+
+//! Returns the range in TriangleInfo containing a triangle
+const SCollisionTriangleRange* CSceneCollisionManager::getTriangleRange(u32 triangleIndex) const
+{
+	for ( irr::u32 t=0; t<TriangleInfo.size(); ++t )
+	{
+		if ( TriangleInfo[t].isIndexInRange(triangleIndex) )
+			return &TriangleInfo[t];
+	}
+	return 0;
+}
+
+
+//! Returns the number of jobs for a batch, 1 without worker threads
+u32 CSceneCollisionManager::getBatchJobCount(u32 count, u32 minCountPerJob) const
+{
+	if (!JobPool)
+		return 1;
+
+	return core::clamp(count / minCountPerJob, 1u, JobPool->getThreadCount() + 1);
+}
+
+
+//! Runs the jobs of a batch, on the worker threads when there is more than one
+void CSceneCollisionManager::runBatchJobs(JobFunction function, SBatchJobs& jobs)
+{
+	if (jobs.JobCount > 1)
+		JobPool->parallelFor(function, &jobs, jobs.JobCount);
+	else
+		function(&jobs, 0);
+}
+
 //! Collides a moving ellipsoid with a 3d world with gravity and returns
 //! the resulting new position of the ellipsoid.
 core::vector3df CSceneCollisionManager::getCollisionResultPosition(
@@ -439,6 +791,164 @@ core::vector3df CSceneCollisionManager::getCollisionResultPosition(
 }
 
 
+//! Collides many moving ellipsoids with a 3d world with gravity.
+void CSceneCollisionManager::getCollisionResultPositions(ITriangleSelector* selector,
+	SEllipsoidSweep* sweeps, u32 count, f32 slidingSpeed,
+	const core::vector3df& gravity)
+{
+	// Works like collideEllipsoidWithWorld, but first all ellipsoids are
+	// moved and then gravity is added to all of them. The triangles are
+	// fetched once for the box around all ellipsoids of each step.
+	SweepData.set_used(count);
+
+	core::aabbox3df box;
+	bool boxEmpty = true;
+	for (u32 i=0; i<count; ++i)
+	{
+		SEllipsoidSweep& sweep = sweeps[i];
+		SCollisionData& colData = SweepData[i];
+
+		sweep.ResultPosition = sweep.Position;
+		colData.selector = 0;
+		if (!selector || sweep.Radius.X == 0.0f || sweep.Radius.Y == 0.0f || sweep.Radius.Z == 0.0f)
+			continue;
+
+		colData.R3Position = sweep.Position;
+		colData.R3Velocity = sweep.DirectionAndSpeed;
+		colData.eRadius = sweep.Radius;
+		colData.nearestDistance = FLT_MAX;
+		colData.intersectionPoint.set(0.f, 0.f, 0.f);
+		colData.selector = selector;
+		colData.slidingSpeed = slidingSpeed;
+		colData.triangleHits = 0;
+		colData.node = 0;
+
+		// in ellipsoid space until all steps are done
+		sweep.ResultPosition = colData.R3Position / colData.eRadius;
+
+		if (boxEmpty)
+			box = getEllipsoidBox(colData);
+		else
+			box.addInternalBox(getEllipsoidBox(colData));
+		boxEmpty = false;
+	}
+
+	if (boxEmpty)
+		return;
+
+	SBatchJobs jobs;
+	jobs.Manager = this;
+	jobs.Count = count;
+	jobs.JobCount = getBatchJobCount(count, MIN_SWEEPS_PER_JOB);
+	jobs.HitResults = 0;
+	jobs.Hits = 0;
+	jobs.Rays = 0;
+	jobs.Sweeps = sweeps;
+	while (SweepScratch.size() < jobs.JobCount)
+		SweepScratch.push_back(SSweepScratch());
+
+	getBatchTriangles(selector, box);
+	runBatchJobs(collideSweepsJob, jobs);
+
+	// add gravity
+	const bool hasGravity = gravity != core::vector3df(0,0,0);
+	if (hasGravity)
+	{
+		boxEmpty = true;
+		for (u32 i=0; i<count; ++i)
+		{
+			SCollisionData& colData = SweepData[i];
+			if (!colData.selector)
+				continue;
+
+			colData.R3Position = sweeps[i].ResultPosition * colData.eRadius;
+			colData.R3Velocity = gravity;
+			colData.triangleHits = 0;
+
+			if (boxEmpty)
+				box = getEllipsoidBox(colData);
+			else
+				box.addInternalBox(getEllipsoidBox(colData));
+			boxEmpty = false;
+		}
+
+		getBatchTriangles(selector, box);
+		runBatchJobs(collideSweepsJob, jobs);
+	}
+
+	for (u32 i=0; i<count; ++i)
+	{
+		SEllipsoidSweep& sweep = sweeps[i];
+		const SCollisionData& colData = SweepData[i];
+		if (!colData.selector)
+			continue;
+
+		sweep.Falling = hasGravity && colData.triangleHits == 0;
+		if (colData.triangleHits)
+		{
+			sweep.Triangle = colData.intersectionTriangle;
+			sweep.Triangle.pointA *= colData.eRadius;
+			sweep.Triangle.pointB *= colData.eRadius;
+			sweep.Triangle.pointC *= colData.eRadius;
+			sweep.Node = colData.node;
+		}
+
+		sweep.ResultPosition *= colData.eRadius;
+		sweep.HitPosition = colData.intersectionPoint * colData.eRadius;
+	}
+}
+
+
+//! Moves the ellipsoids first to last-1 of a batch once
+void CSceneCollisionManager::collideSweeps(const SBatchJobs& jobs, u32 first, u32 last, SSweepScratch& scratch)
+{
+	const s32 triangleCount = (s32)Triangles.size();
+
+	for (u32 i=first; i<last; ++i)
+	{
+		SCollisionData& colData = SweepData[i];
+		if (!colData.selector)
+			continue;
+
+		// the triangles of the batch with which this ellipsoid might collide, in ellipsoid space
+		const core::aabbox3df box = getEllipsoidBox(colData);
+		const core::vector3df scale(1.0f / colData.eRadius.X,
+			1.0f / colData.eRadius.Y, 1.0f / colData.eRadius.Z);
+
+		scratch.Triangles.set_used(0);
+		scratch.Indices.set_used(0);
+		for (s32 t=0; t<triangleCount; ++t)
+		{
+			const core::triangle3df& triangle = Triangles[t];
+			if (triangle.isTotalOutsideBox(box))
+				continue;
+
+			scratch.Triangles.push_back(core::triangle3df(triangle.pointA * scale,
+				triangle.pointB * scale, triangle.pointC * scale));
+			scratch.Indices.push_back(t);
+		}
+
+		colData.triangles = scratch.Triangles.const_pointer();
+		colData.triangleCount = scratch.Triangles.size();
+		colData.triangleIndices = scratch.Indices.const_pointer();
+
+		SEllipsoidSweep& sweep = jobs.Sweeps[i];
+		sweep.ResultPosition = collideWithWorld(0, colData,
+			sweep.ResultPosition, colData.R3Velocity / colData.eRadius);
+	}
+}
+
+
+void CSceneCollisionManager::collideSweepsJob(void* userData, u32 index)
+{
+	const SBatchJobs& jobs = *static_cast<SBatchJobs*>(userData);
+	const u32 countPerJob = (jobs.Count + jobs.JobCount - 1) / jobs.JobCount;
+	const u32 first = index * countPerJob;
+	jobs.Manager->collideSweeps(jobs, first, core::min_(first + countPerJob, jobs.Count),
+		jobs.Manager->SweepScratch[index]);
+}
+
+
 bool CSceneCollisionManager::testTriangleIntersection(SCollisionData* colData,
 			const core::triangle3df& triangle)
 {
@@ -722,6 +1232,7 @@ core::vector3df CSceneCollisionManager::collideEllipsoidWithWorld(
 
 	// iterate until we have our final position
 
+	getEllipsoidTriangles(colData);
 	core::vector3df finalPos = collideWithWorld(
 		0, colData, eSpacePosition, eSpaceVelocity);
 
@@ -737,6 +1248,7 @@ core::vector3df CSceneCollisionManager::collideEllipsoidWithWorld(
 
 		eSpaceVelocity = gravity/colData.eRadius;
 
+		getEllipsoidTriangles(colData);
 		finalPos = collideWithWorld(0, colData,
 			finalPos, eSpaceVelocity);
 
@@ -775,44 +1287,22 @@ core::vector3df CSceneCollisionManager::collideWithWorld(s32 recursionDepth,
 
 	//------------------ collide with world
 
-	// get all triangles with which we might collide
-	core::aabbox3d<f32> box(colData.R3Position);
-	box.addInternalPoint(colData.R3Position + colData.R3Velocity);
-	box.MinEdge -= colData.eRadius;
-	box.MaxEdge += colData.eRadius;
-
-	s32 totalTriangleCnt = colData.selector->getTriangleCount();
-	Triangles.set_used(totalTriangleCnt);
-
-	core::matrix4 scaleMatrix;
-	scaleMatrix.setScale(
-			core::vector3df(1.0f / colData.eRadius.X,
-					1.0f / colData.eRadius.Y,
-					1.0f / colData.eRadius.Z));
-
-	irr::core::array<SCollisionTriangleRange> outTriangleInfo;
-	s32 triangleCnt = 0;
-	colData.selector->getTriangles(Triangles.pointer(), totalTriangleCnt, triangleCnt, box, &scaleMatrix, true, &outTriangleInfo);
-
 	// Find closest intersection
 	irr::s32 nearestTriangleIndex = -1;
-	for (s32 i=0; i<triangleCnt; ++i)
+	for (s32 i=0; i<colData.triangleCount; ++i)
 	{
-		if(testTriangleIntersection(&colData, Triangles[i]))
+		if(testTriangleIntersection(&colData, colData.triangles[i]))
 		{
 			nearestTriangleIndex = i;
 		}
 	}
 	if ( nearestTriangleIndex >= 0 )
 	{
-		for ( irr::u32 t=0; t<outTriangleInfo.size(); ++t )
-		{
-			if ( outTriangleInfo[t].isIndexInRange(nearestTriangleIndex) )
-			{
-				colData.node = outTriangleInfo[t].SceneNode;
-				break;
-			}
-		}
+		const u32 index = colData.triangleIndices ?
+			colData.triangleIndices[nearestTriangleIndex] : (u32)nearestTriangleIndex;
+		const SCollisionTriangleRange* range = getTriangleRange(index);
+		if ( range )
+			colData.node = range->SceneNode;
 	}
 
 	//---------------- end collide with world
@@ -860,6 +1350,42 @@ core::vector3df CSceneCollisionManager::collideWithWorld(s32 recursionDepth,
 }
 
 
+//! Box around the movement of the ellipsoid, in world space
+core::aabbox3df CSceneCollisionManager::getEllipsoidBox(const SCollisionData& colData) const
+{
+	core::aabbox3d<f32> box(colData.R3Position);
+	box.addInternalPoint(colData.R3Position + colData.R3Velocity);
+	box.MinEdge -= colData.eRadius;
+	box.MaxEdge += colData.eRadius;
+	return box;
+}
+
+
+//! Gets the triangles in ellipsoid space for one movement of the ellipsoid
+/** The box doesn't change while collideWithWorld slides the ellipsoid, so
+all recursions use the same triangles. */
+void CSceneCollisionManager::getEllipsoidTriangles(SCollisionData& colData)
+{
+	// get all triangles with which we might collide
+	const core::aabbox3d<f32> box = getEllipsoidBox(colData);
+
+	s32 totalTriangleCnt = colData.selector->getTriangleCount();
+	Triangles.set_used(totalTriangleCnt);
+
+	core::matrix4 scaleMatrix;
+	scaleMatrix.setScale(
+			core::vector3df(1.0f / colData.eRadius.X,
+					1.0f / colData.eRadius.Y,
+					1.0f / colData.eRadius.Z));
+
+	TriangleInfo.set_used(0);
+	colData.triangleCount = 0;
+	colData.selector->getTriangles(Triangles.pointer(), totalTriangleCnt, colData.triangleCount, box, &scaleMatrix, true, &TriangleInfo);
+	colData.triangles = Triangles.const_pointer();
+	colData.triangleIndices = 0;
+}
+
+
 //! Returns a 3d ray which would go through the 2d screen coordinates.
 core::line3d<f32> CSceneCollisionManager::getRayFromScreenCoordinates(
 	const core::position2d<s32> & pos, const ICameraSceneNode* camera)
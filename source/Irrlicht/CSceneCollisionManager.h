@@ -8,6 +8,8 @@
 #include "ISceneCollisionManager.h"
 #include "ISceneManager.h"
 #include "IVideoDriver.h"
+#include "ITriangleSelector.h"
+#include "CJobPool.h"
 
 namespace irr
 {
@@ -45,6 +47,10 @@ namespace scene
 		virtual bool getCollisionPoint(SCollisionHit& hitResult, const core::line3d<f32>& ray,
 				ITriangleSelector* selector)  _IRR_OVERRIDE_;
 
+		//! Finds the nearest collision points of many lines with the triangles of one selector.
+		virtual u32 getCollisionPoints(SCollisionHit* hitResults, bool* outHits,
+				const core::line3d<f32>* rays, u32 count, ITriangleSelector* selector) _IRR_OVERRIDE_;
+
 		//! Collides a moving ellipsoid with a 3d world with gravity and returns
 		//! the resulting new position of the ellipsoid.
 		virtual core::vector3df getCollisionResultPosition(
@@ -59,6 +65,12 @@ namespace scene
 			f32 slidingSpeed,
 			const core::vector3df& gravityDirectionAndSpeed) _IRR_OVERRIDE_;
 
+		//! Collides many moving ellipsoids with a 3d world with gravity.
+		virtual void getCollisionResultPositions(ITriangleSelector* selector,
+			SEllipsoidSweep* sweeps, u32 count,
+			f32 slidingSpeed,
+			const core::vector3df& gravityDirectionAndSpeed) _IRR_OVERRIDE_;
+
 		//! Returns a 3d ray which would go through the 2d screen coordinates.
 		virtual core::line3d<f32> getRayFromScreenCoordinates(
 			const core::position2d<s32> & pos, const ICameraSceneNode* camera = 0) _IRR_OVERRIDE_;
@@ -76,6 +88,12 @@ namespace scene
 								ISceneNode * collisionRootNode = 0,
 								bool noDebugObjects = false)  _IRR_OVERRIDE_;
 
+		//! Sets the worker threads which run large ray and ellipsoid batches
+		void setJobPool(CJobPool* pool);
+
+		//! Get the worker threads which run large ray and ellipsoid batches
+		CJobPool* getJobPool() const { return JobPool; }
+
 	private:
 
 		//! recursive method for going through all scene nodes
@@ -115,6 +133,45 @@ namespace scene
 			f32 slidingSpeed;
 
 			ITriangleSelector* selector;
+
+			// triangles in ellipsoid space with which the ellipsoid might collide
+			const core::triangle3df* triangles;
+			s32 triangleCount;
+
+			// index of each triangle in TriangleInfo, 0 when it's the same index
+			const u32* triangleIndices;
+		};
+
+		//! Four triangles for the ray batches, tested at once
+		struct STriangleBlock
+		{
+			// first corner
+			f32 AX[4], AY[4], AZ[4];
+			// edges from the first to the second and third corner
+			f32 E1X[4], E1Y[4], E1Z[4];
+			f32 E2X[4], E2Y[4], E2Z[4];
+			// bounding boxes
+			f32 MinX[4], MinY[4], MinZ[4];
+			f32 MaxX[4], MaxY[4], MaxZ[4];
+		};
+
+		//! Triangles of one job of an ellipsoid batch, kept to avoid allocations
+		struct SSweepScratch
+		{
+			core::array<core::triangle3df> Triangles;
+			core::array<u32> Indices;
+		};
+
+		//! Parameters of the jobs of a ray or ellipsoid batch
+		struct SBatchJobs
+		{
+			CSceneCollisionManager* Manager;
+			u32 Count;
+			u32 JobCount;
+			SCollisionHit* HitResults;
+			bool* Hits;
+			const core::line3df* Rays;
+			SEllipsoidSweep* Sweeps;
 		};
 
 		//! Tests the current collision data against an individual triangle.
@@ -138,11 +195,48 @@ namespace scene
 		core::vector3df collideWithWorld(s32 recursionDepth, SCollisionData &colData,
 			const core::vector3df& pos, const core::vector3df& vel);
 
+		//! Box around the movement of the ellipsoid, in world space
+		core::aabbox3df getEllipsoidBox(const SCollisionData& colData) const;
+
+		//! Gets the triangles in ellipsoid space for one movement of the ellipsoid
+		void getEllipsoidTriangles(SCollisionData& colData);
+
+		//! Fills Triangles and TriangleInfo with the triangles of the selector inside the box
+		s32 getBatchTriangles(ITriangleSelector* selector, const core::aabbox3df& box);
+
+		//! Returns the range in TriangleInfo containing a triangle
+		const SCollisionTriangleRange* getTriangleRange(u32 triangleIndex) const;
+
+		//! Returns the number of jobs for a batch, 1 without worker threads
+		u32 getBatchJobCount(u32 count, u32 minCountPerJob) const;
+
+		//! Runs the jobs of a batch, on the worker threads when there is more than one
+		void runBatchJobs(JobFunction function, SBatchJobs& jobs);
+
+		//! Finds the nearest triangle in RayBlocks hit by a ray, returns -1 if there is none
+		s32 getNearestRayTriangle(const core::line3df& ray, f32& outT) const;
+
+		//! Tests the rays first to last-1 of a batch
+		void collideRays(const SBatchJobs& jobs, u32 first, u32 last) const;
+
+		//! Moves the ellipsoids first to last-1 of a batch once
+		void collideSweeps(const SBatchJobs& jobs, u32 first, u32 last, SSweepScratch& scratch);
+
+		static void collideRaysJob(void* userData, u32 index);
+		static void collideSweepsJob(void* userData, u32 index);
+
 		inline bool getLowestRoot(f32 a, f32 b, f32 c, f32 maxR, f32* root) const;
 
 		ISceneManager* SceneManager;
 		video::IVideoDriver* Driver;
+		CJobPool* JobPool;
 		core::array<core::triangle3df> Triangles; // triangle buffer
+		core::array<SCollisionTriangleRange> TriangleInfo; // ranges of the triangles in the buffer
+
+		// scratch of the batches, kept to avoid allocations
+		core::array<STriangleBlock> RayBlocks;
+		core::array<SCollisionData> SweepData;
+		core::array<SSweepScratch> SweepScratch;
 	};
 
 
@@ -4,6 +4,10 @@
 
 #include "IrrCompileConfig.h"
 #include "CSceneManager.h"
+#include "CNullDriver.h"
+#include "CJobPool.h"
+#include "CSceneNodeTransformStore.h"
+#include "CRenderQueue.h"
 #include "IVideoDriver.h"
 #include "IFileSystem.h"
 #include "SAnimatedMesh.h"
@@ -156,6 +160,9 @@
 #include "CDummyTransformationSceneNode.h"
 #include "CWaterSurfaceSceneNode.h"
 #include "CTerrainSceneNode.h"
+#include "CPagedTerrainSceneNode.h"
+#include "CStaticBatchSceneNode.h"
+#include "CInstancedMeshSceneNode.h"
 #include "CEmptySceneNode.h"
 #include "CTextSceneNode.h"
 #include "CQuake3ShaderSceneNode.h"
@@ -198,7 +205,9 @@ CSceneManager::CSceneManager(video::IVideoDriver* driver, io::IFileSystem* fs,
 	CursorControl(cursorControl), CollisionManager(0),
 	ActiveCamera(0), ShadowColor(150,0,0,0), AmbientLight(0,0,0,0), Parameters(0),
 	MeshCache(cache), CurrentRenderPass(ESNRP_NONE), LightManager(0),
-	IRR_XML_FORMAT_SCENE(L"irr_scene"), IRR_XML_FORMAT_NODE(L"node"), IRR_XML_FORMAT_NODE_ATTR_TYPE(L"type")
+	IRR_XML_FORMAT_SCENE(L"irr_scene"), IRR_XML_FORMAT_NODE(L"node"), IRR_XML_FORMAT_NODE_ATTR_TYPE(L"type"),
+	AnimationJobs(0), AnimationTime(0), ParallelAnimation(false), TransformStore(0),
+	RenderQueue(0)
 {
 	#ifdef _DEBUG
 	ISceneManager::setDebugName("CSceneManager ISceneManager");
@@ -336,6 +345,10 @@ CSceneManager::CSceneManager(video::IVideoDriver* driver, io::IFileSystem* fs,
 			getProfiler().add(EPID_SM_RENDER_TRANSPARENT, L"transp.nodes", L"Irrlicht scene");
 			getProfiler().add(EPID_SM_RENDER_EFFECT, L"effectnodes", L"Irrlicht scene");
 			getProfiler().add(EPID_SM_REGISTER, L"reg.render.node", L"Irrlicht scene");
+			getProfiler().add(EPID_RQ_SORT_AND_DRAW, L"sort+draw", L"Irrlicht render queue");
+			getProfiler().add(EPID_RQ_ITEMS, L"mesh buffers", L"Irrlicht render queue");
+			getProfiler().add(EPID_RQ_MATERIAL_CHANGES, L"mat.changes", L"Irrlicht render queue");
+			getProfiler().add(EPID_RQ_TEXTURE_CHANGES, L"tex.changes", L"Irrlicht render queue");
 		}
  	)
 }
@@ -346,6 +359,10 @@ CSceneManager::~CSceneManager()
 {
 	clearDeletionList();
 
+	// drops the nodes which it keeps alive
+	delete TransformStore;
+	delete RenderQueue;
+
 	//! force to remove hardwareTextures from the driver
 	//! because Scenes may hold internally data bounded to sceneNodes
 	//! which may be destroyed twice
@@ -936,6 +953,120 @@ ITerrainSceneNode* CSceneManager::addTerrainSceneNode(
 }
 
 
+//! Adds a terrain scene node for RAW heightmaps which are too large to be loaded at once.
+IPagedTerrainSceneNode* CSceneManager::addPagedTerrainSceneNode(
+	const io::path& heightMapFileName,
+	const core::dimension2du& heightMapSize,
+	ISceneNode* parent, s32 id,
+	const core::vector3df& position,
+	const core::vector3df& scale,
+	video::SColor vertexColor,
+	s32 maxLOD, E_TERRAIN_PATCH_SIZE patchSize,
+	u32 tileSize, u32 maxResidentTiles,
+	s32 bitsPerPixel, bool signedData, s32 selectorLOD)
+{
+	io::IReadFile* file = FileSystem->createAndOpenFile(heightMapFileName);
+
+	if (!file)
+	{
+		os::Printer::log("Could not load terrain, because file could not be opened.",
+		heightMapFileName, ELL_ERROR);
+		return 0;
+	}
+
+	IPagedTerrainSceneNode* terrain = addPagedTerrainSceneNode(file, heightMapSize,
+		parent, id, position, scale, vertexColor, maxLOD, patchSize,
+		tileSize, maxResidentTiles, bitsPerPixel, signedData, selectorLOD);
+
+	file->drop();
+
+	return terrain;
+}
+
+
+//! Adds a terrain scene node for RAW heightmaps which are too large to be loaded at once.
+IPagedTerrainSceneNode* CSceneManager::addPagedTerrainSceneNode(
+	io::IReadFile* heightMapFile,
+	const core::dimension2du& heightMapSize,
+	ISceneNode* parent, s32 id,
+	const core::vector3df& position,
+	const core::vector3df& scale,
+	video::SColor vertexColor,
+	s32 maxLOD, E_TERRAIN_PATCH_SIZE patchSize,
+	u32 tileSize, u32 maxResidentTiles,
+	s32 bitsPerPixel, bool signedData, s32 selectorLOD)
+{
+	if (!parent)
+		parent = this;
+
+	if (!heightMapFile)
+	{
+		os::Printer::log("Could not load terrain, because file could not be opened.", ELL_ERROR);
+		return 0;
+	}
+
+	if (bitsPerPixel != 8 && bitsPerPixel != 16 && bitsPerPixel != 32)
+	{
+		os::Printer::log("Could not load terrain, unsupported bits per pixel.", ELL_ERROR);
+		return 0;
+	}
+
+	// the tiles consist of whole patches, the rest of the heightmap would be lost
+	const u32 patchQuads = (u32)patchSize - 1;
+	if (heightMapSize.Width < (u32)patchSize || heightMapSize.Height < (u32)patchSize ||
+		(heightMapSize.Width - 1) % patchQuads || (heightMapSize.Height - 1) % patchQuads)
+	{
+		os::Printer::log("Could not load terrain, heightmap size minus one is not a multiple of the patch size minus one.",
+			heightMapFile->getFileName(), ELL_ERROR);
+		return 0;
+	}
+
+	// the tiles are read on demand, so the size is checked up front
+	const f64 needed = (f64)heightMapSize.Width * heightMapSize.Height * (bitsPerPixel / 8);
+	if (heightMapFile->getSize() - heightMapFile->getPos() < needed)
+	{
+		os::Printer::log("Could not load terrain, heightmap file is too small.",
+			heightMapFile->getFileName(), ELL_ERROR);
+		return 0;
+	}
+
+	CPagedTerrainSceneNode* node = new CPagedTerrainSceneNode(parent, this, FileSystem,
+		heightMapFile, heightMapSize, id, position, scale, vertexColor, maxLOD, patchSize,
+		tileSize, maxResidentTiles, bitsPerPixel, signedData, selectorLOD);
+
+	node->drop();
+	return node;
+}
+
+
+//! Adds a scene node which draws many static mesh scene nodes merged by material.
+IStaticBatchSceneNode* CSceneManager::addStaticBatchSceneNode(ISceneNode* parent, s32 id,
+	const core::vector3df& position)
+{
+	if (!parent)
+		parent = this;
+
+	IStaticBatchSceneNode* node = new CStaticBatchSceneNode(parent, this, id, position);
+	node->drop();
+
+	return node;
+}
+
+
+//! Adds a scene node which draws many instances of one mesh.
+IInstancedMeshSceneNode* CSceneManager::addInstancedMeshSceneNode(IMesh* mesh, ISceneNode* parent, s32 id,
+	const core::vector3df& position)
+{
+	if (!parent)
+		parent = this;
+
+	IInstancedMeshSceneNode* node = new CInstancedMeshSceneNode(mesh, parent, this, id, position);
+	node->drop();
+
+	return node;
+}
+
+
 //! Adds an empty scene node.
 ISceneNode* CSceneManager::addEmptySceneNode(ISceneNode* parent, s32 id)
 {
@@ -1301,7 +1432,19 @@ u32 CSceneManager::registerNodeForRendering(ISceneNode* node, E_SCENE_NODE_RENDE
 	case ESNRP_SOLID:
 		if (!isCulled(node))
 		{
-			SolidNodeList.push_back(node);
+			if (RenderQueue && !LightManager && node->getType() == ESNT_MESH &&
+				static_cast<IMeshSceneNode*>(node)->canQueueMeshBuffers())
+			{
+				f32 distance = 0.f;
+				if (ActiveCamera)
+				{
+					distance = node->getAbsolutePosition().getDistanceFrom(camWorldPos) /
+						ActiveCamera->getFarValue();
+				}
+				RenderQueue->addNode(static_cast<IMeshSceneNode*>(node), Driver, distance);
+			}
+			else
+				SolidNodeList.push_back(node);
 			taken = 1;
 		}
 		break;
@@ -1382,6 +1525,9 @@ void CSceneManager::clearAllRegisteredNodesForRendering()
 	TransparentNodeList.clear();
 	TransparentEffectNodeList.clear();
 	ShadowNodeList.clear();
+
+	if (RenderQueue)
+		RenderQueue->clear();
 }
 
 //! This method is called just before the rendering process of the whole scene.
@@ -1416,7 +1562,7 @@ void CSceneManager::drawAll()
 
 	// do animations and other stuff.
 	IRR_PROFILE(getProfiler().start(EPID_SM_ANIMATE));
-	OnAnimate(os::Timer::getTime());
+	animateScene(os::Timer::getTime());
 	IRR_PROFILE(getProfiler().stop(EPID_SM_ANIMATE));
 
 	/*!
@@ -1537,6 +1683,17 @@ void CSceneManager::drawAll()
 		CurrentRenderPass = ESNRP_SOLID;
 		Driver->getOverrideMaterial().Enabled = ((Driver->getOverrideMaterial().EnablePasses & CurrentRenderPass) != 0);
 
+		if (RenderQueue && RenderQueue->getItemCount())
+		{
+			IRR_PROFILE(CProfileScope psQueue(EPID_RQ_SORT_AND_DRAW);)
+			IRR_PROFILE(getProfiler().addCalls(EPID_RQ_ITEMS, RenderQueue->getItemCount());)
+
+			RenderQueue->render(Driver);
+
+			IRR_PROFILE(getProfiler().addCalls(EPID_RQ_MATERIAL_CHANGES, RenderQueue->getMaterialChanges());)
+			IRR_PROFILE(getProfiler().addCalls(EPID_RQ_TEXTURE_CHANGES, RenderQueue->getTextureChanges());)
+		}
+
 		SolidNodeList.sort(); // sort by textures
 
 		if (LightManager)
@@ -1672,6 +1829,187 @@ void CSceneManager::drawAll()
 	CurrentRenderPass = ESNRP_NONE;
 }
 
+
+//! Animates the scene, on the worker threads if enabled
+void CSceneManager::animateScene(u32 timeMs)
+{
+	CJobPool* jobPool = static_cast<video::CNullDriver*>(Driver)->getJobPool();
+	if (!ParallelAnimation || !jobPool || !jobPool->getThreadCount() || !IsVisible)
+	{
+		if (TransformStore && IsVisible)
+			TransformStore->animate(this, timeMs);
+		else
+			OnAnimate(timeMs);
+		return;
+	}
+
+	// the store would keep removed nodes alive
+	if (TransformStore)
+		TransformStore->clear();
+
+	// Enough subtrees for the worker threads, independent of their count
+	// so the nodes which stay on the main thread are always found in the same order.
+	const u32 minSubtrees = 256;
+	const u32 maxJobs = 64;
+
+	if (MainThreadAnimationNodes.empty())
+		MainThreadAnimationNodes.push_back(core::array<ISceneNode*>());
+	MainThreadAnimationNodes[0].set_used(0);
+
+	// The top of the scene graph is animated on this thread, one level
+	// after another, until there are enough subtrees.
+	animateNodeOnly(this, timeMs);
+	AnimationNodes.set_used(0);
+	ISceneNodeList::ConstIterator it = Children.begin();
+	for (; it != Children.end(); ++it)
+		AnimationNodes.push_back(*it);
+
+	while (AnimationNodes.size() && AnimationNodes.size() < minSubtrees)
+	{
+		NextAnimationNodes.set_used(0);
+		for (u32 i=0; i<AnimationNodes.size(); ++i)
+		{
+			ISceneNode* node = AnimationNodes[i];
+			if (!node->isVisible())
+				continue;
+
+			if (!canAnimateInParallel(node))
+			{
+				MainThreadAnimationNodes[0].push_back(node);
+				continue;
+			}
+
+			animateNodeOnly(node, timeMs);
+			for (it = node->getChildren().begin(); it != node->getChildren().end(); ++it)
+				NextAnimationNodes.push_back(*it);
+		}
+		AnimationNodes.swap(NextAnimationNodes);
+	}
+
+	AnimationJobs = core::min_(AnimationNodes.size(), maxJobs);
+	if (AnimationJobs)
+	{
+		while (MainThreadAnimationNodes.size() <= AnimationJobs)
+			MainThreadAnimationNodes.push_back(core::array<ISceneNode*>());
+		for (u32 i=1; i<=AnimationJobs; ++i)
+			MainThreadAnimationNodes[i].set_used(0);
+
+		AnimationTime = timeMs;
+		jobPool->parallelFor(animateSubtreesJob, this, AnimationJobs);
+	}
+
+	// the nodes which are not thread safe, after their parents and the other nodes
+	for (u32 i=0; i<=AnimationJobs; ++i)
+	{
+		const core::array<ISceneNode*>& nodes = MainThreadAnimationNodes[i];
+		for (u32 n=0; n<nodes.size(); ++n)
+			nodes[n]->OnAnimate(timeMs);
+	}
+}
+
+
+//! Keep the transformations of the scene nodes in contiguous arrays.
+void CSceneManager::setTransformStore(bool enable)
+{
+	if (enable && !TransformStore)
+	{
+		TransformStore = new CSceneNodeTransformStore();
+	}
+	else if (!enable && TransformStore)
+	{
+		delete TransformStore;
+		TransformStore = 0;
+	}
+}
+
+
+//! Draw the solid mesh buffers of mesh scene nodes sorted by their materials.
+void CSceneManager::setRenderQueue(bool enable)
+{
+	if (enable && !RenderQueue)
+	{
+		RenderQueue = new CRenderQueue();
+	}
+	else if (!enable && RenderQueue)
+	{
+		delete RenderQueue;
+		RenderQueue = 0;
+	}
+}
+
+
+//! Runs the animators of a node and updates its absolute position, without the children
+void CSceneManager::animateNodeOnly(ISceneNode* node, u32 timeMs)
+{
+	const ISceneNodeAnimatorList& animators = node->getAnimators();
+	ISceneNodeAnimatorList::ConstIterator ait = animators.begin();
+	while (ait != animators.end())
+	{
+		// continue to the next node before calling animateNode()
+		// so that the animator may remove itself from the scene
+		// node without the iterator becoming invalid
+		ISceneNodeAnimator* anim = *ait;
+		++ait;
+		if (anim->isEnabled())
+			anim->animateNode(node, timeMs);
+	}
+
+	node->updateAbsolutePositionIfChanged();
+}
+
+
+//! Returns true if a node and its animators may be animated on a worker thread
+bool CSceneManager::canAnimateInParallel(const ISceneNode* node)
+{
+	if (!node->isAnimationThreadSafe())
+		return false;
+
+	const ISceneNodeAnimatorList& animators = node->getAnimators();
+	ISceneNodeAnimatorList::ConstIterator ait = animators.begin();
+	for (; ait != animators.end(); ++ait)
+	{
+		if (!(*ait)->isThreadSafe())
+			return false;
+	}
+
+	return true;
+}
+
+
+//! Animates a node and its children on a worker thread, collects the nodes which can't be
+void CSceneManager::animateSubtree(ISceneNode* node, core::array<ISceneNode*>& mainThreadNodes) const
+{
+	if (!node->isVisible())
+		return;
+
+	if (!canAnimateInParallel(node))
+	{
+		mainThreadNodes.push_back(node);
+		return;
+	}
+
+	animateNodeOnly(node, AnimationTime);
+
+	ISceneNodeList::ConstIterator it = node->getChildren().begin();
+	for (; it != node->getChildren().end(); ++it)
+		animateSubtree(*it, mainThreadNodes);
+}
+
+
+//! Animates a part of the subtrees in AnimationNodes
+void CSceneManager::animateSubtreesJob(void* userData, u32 index)
+{
+	CSceneManager* smgr = static_cast<CSceneManager*>(userData);
+	const u32 count = smgr->AnimationNodes.size();
+	const u32 first = count * index / smgr->AnimationJobs;
+	const u32 last = count * (index+1) / smgr->AnimationJobs;
+
+	core::array<ISceneNode*>& mainThreadNodes = smgr->MainThreadAnimationNodes[index+1];
+	for (u32 i=first; i<last; ++i)
+		smgr->animateSubtree(smgr->AnimationNodes[i], mainThreadNodes);
+}
+
+
 void CSceneManager::setLightManager(ILightManager* lightManager)
 {
 	if (lightManager)
@@ -2071,6 +2409,12 @@ void CSceneManager::removeAll()
 void CSceneManager::clear()
 {
 	removeAll();
+
+	if (TransformStore)
+		TransformStore->clear();
+
+	if (RenderQueue)
+		RenderQueue->clear();
 }
 
 
@@ -2100,6 +2444,10 @@ ISceneManager* CSceneManager::createNewSceneManager(bool cloneContent)
 {
 	CSceneManager* manager = new CSceneManager(Driver, FileSystem, CursorControl, MeshCache, GUIEnvironment);
 
+	// the collision managers are always created by the scene managers
+	static_cast<CSceneCollisionManager*>(manager->CollisionManager)->setJobPool(
+		static_cast<CSceneCollisionManager*>(CollisionManager)->getJobPool());
+
 	if (cloneContent)
 		manager->cloneMembers(this, manager);
 
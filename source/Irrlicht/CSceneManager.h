@@ -25,6 +25,8 @@ namespace scene
 {
 	class IMeshCache;
 	class IGeometryCreator;
+	class CSceneNodeTransformStore;
+	class CRenderQueue;
 
 	/*!
 		The Scene Manager manages scene nodes, mesh resources, cameras and all the other stuff.
@@ -270,10 +272,42 @@ namespace scene
 			s32 maxLOD=4, E_TERRAIN_PATCH_SIZE patchSize=ETPS_17,s32 smoothFactor=0,
 			bool addAlsoIfHeightmapEmpty=false) _IRR_OVERRIDE_;
 
+		//! Adds a terrain scene node for RAW heightmaps which are too large to be loaded at once.
+		virtual IPagedTerrainSceneNode* addPagedTerrainSceneNode(
+			const io::path& heightMapFileName,
+			const core::dimension2du& heightMapSize,
+			ISceneNode* parent=0, s32 id=-1,
+			const core::vector3df& position = core::vector3df(0.0f,0.0f,0.0f),
+			const core::vector3df& scale = core::vector3df(1.0f,1.0f,1.0f),
+			video::SColor vertexColor = video::SColor(255,255,255,255),
+			s32 maxLOD=5, E_TERRAIN_PATCH_SIZE patchSize=ETPS_17,
+			u32 tileSize=128, u32 maxResidentTiles=32,
+			s32 bitsPerPixel=16, bool signedData=false, s32 selectorLOD=-1) _IRR_OVERRIDE_;
+
+		//! Adds a terrain scene node for RAW heightmaps which are too large to be loaded at once.
+		virtual IPagedTerrainSceneNode* addPagedTerrainSceneNode(
+			io::IReadFile* heightMapFile,
+			const core::dimension2du& heightMapSize,
+			ISceneNode* parent=0, s32 id=-1,
+			const core::vector3df& position = core::vector3df(0.0f,0.0f,0.0f),
+			const core::vector3df& scale = core::vector3df(1.0f,1.0f,1.0f),
+			video::SColor vertexColor = video::SColor(255,255,255,255),
+			s32 maxLOD=5, E_TERRAIN_PATCH_SIZE patchSize=ETPS_17,
+			u32 tileSize=128, u32 maxResidentTiles=32,
+			s32 bitsPerPixel=16, bool signedData=false, s32 selectorLOD=-1) _IRR_OVERRIDE_;
+
 		//! Adds a dummy transformation scene node to the scene graph.
 		virtual IDummyTransformationSceneNode* addDummyTransformationSceneNode(
 			ISceneNode* parent=0, s32 id=-1) _IRR_OVERRIDE_;
 
+		//! Adds a scene node which draws many static mesh scene nodes merged by material.
+		virtual IStaticBatchSceneNode* addStaticBatchSceneNode(ISceneNode* parent=0, s32 id=-1,
+			const core::vector3df& position = core::vector3df(0,0,0)) _IRR_OVERRIDE_;
+
+		//! Adds a scene node which draws many instances of one mesh.
+		virtual IInstancedMeshSceneNode* addInstancedMeshSceneNode(IMesh* mesh, ISceneNode* parent=0, s32 id=-1,
+			const core::vector3df& position = core::vector3df(0,0,0)) _IRR_OVERRIDE_;
+
 		//! Adds an empty scene node.
 		virtual ISceneNode* addEmptySceneNode(ISceneNode* parent, s32 id=-1) _IRR_OVERRIDE_;
 
@@ -446,6 +480,12 @@ namespace scene
 		//! Returns type of the scene node
 		virtual ESCENE_NODE_TYPE getType() const _IRR_OVERRIDE_ { return ESNT_SCENE_MANAGER; }
 
+		//! The root node has the default OnAnimate
+		virtual bool isAnimationThreadSafe() const _IRR_OVERRIDE_ { return true; }
+
+		//! The root node has the default transformation
+		virtual bool hasDefaultTransformation() const _IRR_OVERRIDE_ { return true; }
+
 		//! Returns the default scene node factory which can create all built in scene nodes
 		virtual ISceneNodeFactory* getDefaultSceneNodeFactory() _IRR_OVERRIDE_;
 
@@ -532,8 +572,41 @@ namespace scene
 		//! returns if node is culled
 		virtual bool isCulled(const ISceneNode* node) const _IRR_OVERRIDE_;
 
+		//! Animate the scene nodes on the worker threads of the device in drawAll().
+		virtual void setParallelAnimation(bool enable) _IRR_OVERRIDE_ { ParallelAnimation = enable; }
+
+		//! Check if the scene nodes are animated on the worker threads.
+		virtual bool getParallelAnimation() const _IRR_OVERRIDE_ { return ParallelAnimation; }
+
+		//! Keep the transformations of the scene nodes in contiguous arrays.
+		virtual void setTransformStore(bool enable) _IRR_OVERRIDE_;
+
+		//! Check if the transformations are kept in contiguous arrays.
+		virtual bool getTransformStore() const _IRR_OVERRIDE_ { return TransformStore != 0; }
+
+		//! Draw the solid mesh buffers of mesh scene nodes sorted by their materials.
+		virtual void setRenderQueue(bool enable) _IRR_OVERRIDE_;
+
+		//! Check if the solid mesh buffers are drawn sorted by their materials.
+		virtual bool getRenderQueue() const _IRR_OVERRIDE_ { return RenderQueue != 0; }
+
 	private:
 
+		//! Animates the scene, on the worker threads if enabled
+		void animateScene(u32 timeMs);
+
+		//! Runs the animators of a node and updates its absolute position, without the children
+		static void animateNodeOnly(ISceneNode* node, u32 timeMs);
+
+		//! Returns true if a node and its animators may be animated on a worker thread
+		static bool canAnimateInParallel(const ISceneNode* node);
+
+		//! Animates a node and its children on a worker thread, collects the nodes which can't be
+		void animateSubtree(ISceneNode* node, core::array<ISceneNode*>& mainThreadNodes) const;
+
+		//! Animates a part of the subtrees in AnimationNodes
+		static void animateSubtreesJob(void* userData, u32 index);
+
 		// load and create a mesh which we know already isn't in the cache and put it in there
 		IAnimatedMesh* getUncachedMesh(io::IReadFile* file, const io::path& filename, const io::path& cachename);
 
@@ -664,6 +737,22 @@ namespace scene
 		const core::stringw IRR_XML_FORMAT_NODE_ATTR_TYPE;
 
 		IGeometryCreator* GeometryCreator;
+
+		//! Roots of the subtrees which are animated on the worker threads
+		core::array<ISceneNode*> AnimationNodes;
+		core::array<ISceneNode*> NextAnimationNodes;
+
+		//! Nodes which have to be animated on the main thread, first the ones found
+		//! while splitting the scene graph, then the ones found by each job
+		core::array<core::array<ISceneNode*> > MainThreadAnimationNodes;
+		u32 AnimationJobs;
+		u32 AnimationTime;
+		bool ParallelAnimation;
+
+		CSceneNodeTransformStore* TransformStore;
+
+		//! Solid mesh buffers sorted by their materials, when enabled
+		CRenderQueue* RenderQueue;
 	};
 
 } // end namespace video
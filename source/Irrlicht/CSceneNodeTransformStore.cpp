@@ -0,0 +1,229 @@
+// Copyright (C) 2002-2012 Nikolaus Gebhardt
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#include "CSceneNodeTransformStore.h"
+#include "IProfiler.h"
+
+namespace irr
+{
+namespace scene
+{
+
+namespace
+{
+	// vector3d::operator!= has a tolerance, which would hide small movements
+	inline bool differs(const core::vector3df& a, const core::vector3df& b)
+	{
+		return a.X != b.X || a.Y != b.Y || a.Z != b.Z;
+	}
+}
+
+
+//! constructor
+CSceneNodeTransformStore::CSceneNodeTransformStore()
+	: NeedsBuild(true)
+{
+}
+
+
+//! destructor
+CSceneNodeTransformStore::~CSceneNodeTransformStore()
+{
+	clear();
+}
+
+
+//! Drops all nodes, the store is built again on the next animate()
+void CSceneNodeTransformStore::clear()
+{
+	// the root is not grabbed, it owns the store
+	for (u32 i=1; i<Nodes.size(); ++i)
+		Nodes[i]->drop();
+
+	Nodes.clear();
+	Parents.clear();
+	SubtreeEnds.clear();
+	ChildrenChanges.clear();
+	LocalMatrices.clear();
+	WorldMatrices.clear();
+	Translations.clear();
+	Rotations.clear();
+	Scales.clear();
+	Flags.clear();
+	NeedsBuild = true;
+}
+
+
+//! Adds a node and its children in depth first order
+void CSceneNodeTransformStore::add(ISceneNode* node, s32 parent)
+{
+	const u32 index = Nodes.size();
+	Nodes.push_back(node);
+	Parents.push_back(parent);
+	SubtreeEnds.push_back(index+1);
+	ChildrenChanges.push_back(node->ChildrenChanges);
+	Translations.push_back(node->RelativeTranslation);
+	Rotations.push_back(node->RelativeRotation);
+	Scales.push_back(node->RelativeScale);
+	LocalMatrices.push_back(node->hasDefaultTransformation() ?
+		node->getRelativeTransformation() : core::IdentityMatrix);
+	WorldMatrices.push_back(node->AbsoluteTransformation);
+	Flags.push_back(ETF_STALE);
+
+	if (index)
+		node->grab();
+
+	// nodes which might override OnAnimate() animate their children themselves
+	if (!node->isAnimationThreadSafe())
+		return;
+
+	ISceneNodeList::ConstIterator it = node->getChildren().begin();
+	for (; it != node->getChildren().end(); ++it)
+		add(*it, (s32)index);
+
+	SubtreeEnds[index] = Nodes.size();
+}
+
+
+//! Builds the arrays from the scene graph
+void CSceneNodeTransformStore::build(ISceneNode* root)
+{
+	// keep the old nodes until the new ones are grabbed
+	core::array<ISceneNode*> oldNodes;
+	oldNodes.swap(Nodes);
+	clear();
+
+	add(root, -1);
+
+	for (u32 i=1; i<oldNodes.size(); ++i)
+		oldNodes[i]->drop();
+
+	NeedsBuild = false;
+}
+
+
+//! Runs the animators of a node
+void CSceneNodeTransformStore::runAnimators(ISceneNode* node, u32 timeMs)
+{
+	const ISceneNodeAnimatorList& animators = node->getAnimators();
+	ISceneNodeAnimatorList::ConstIterator ait = animators.begin();
+	while (ait != animators.end())
+	{
+		// continue to the next node before calling animateNode()
+		// so that the animator may remove itself from the scene
+		// node without the iterator becoming invalid
+		ISceneNodeAnimator* anim = *ait;
+		++ait;
+		if (anim->isEnabled())
+			anim->animateNode(node, timeMs);
+	}
+}
+
+
+//! Updates the absolute transformation of the node at index i if needed
+bool CSceneNodeTransformStore::updateTransformation(u32 i)
+{
+	ISceneNode* node = Nodes[i];
+	const s32 parent = Parents[i];
+	bool changed = (Flags[i] & ETF_STALE) || (parent >= 0 && (Flags[parent] & ETF_CHANGED));
+
+	if (!node->hasDefaultTransformation())
+	{
+		node->updateAbsolutePosition();
+		WorldMatrices[i] = node->AbsoluteTransformation;
+		changed = true;
+	}
+	else
+	{
+		if (differs(node->RelativeTranslation, Translations[i]) ||
+			differs(node->RelativeRotation, Rotations[i]) ||
+			differs(node->RelativeScale, Scales[i]))
+		{
+			Translations[i] = node->RelativeTranslation;
+			Rotations[i] = node->RelativeRotation;
+			Scales[i] = node->RelativeScale;
+			LocalMatrices[i] = node->getRelativeTransformation();
+			changed = true;
+		}
+
+		if (changed)
+		{
+			if (parent >= 0)
+				WorldMatrices[i] = WorldMatrices[parent] * LocalMatrices[i];
+			else
+				WorldMatrices[i] = LocalMatrices[i];
+			node->AbsoluteTransformation = WorldMatrices[i];
+			node->rememberTransformation();
+		}
+	}
+
+	Flags[i] = changed ? ETF_CHANGED : 0;
+	return changed;
+}
+
+
+//! Does the work of root->OnAnimate(timeMs) for the whole scene
+void CSceneNodeTransformStore::animate(ISceneNode* root, u32 timeMs)
+{
+	if (NeedsBuild || Nodes.empty() || Nodes[0] != root)
+		build(root);
+
+	u32 skipped = 0;
+	u32 i = 0;
+	while (i < Nodes.size())
+	{
+		ISceneNode* node = Nodes[i];
+		const s32 parent = Parents[i];
+
+		// removed or moved to another parent in this frame
+		if (parent >= 0 && node->Parent != Nodes[parent])
+		{
+			NeedsBuild = true;
+			i = SubtreeEnds[i];
+			continue;
+		}
+
+		if (!node->IsVisible)
+		{
+			// the parents may move until the node is visible again
+			Flags[i] = ETF_STALE;
+			i = SubtreeEnds[i];
+			continue;
+		}
+
+		if (!node->isAnimationThreadSafe())
+		{
+			node->OnAnimate(timeMs);
+			i = SubtreeEnds[i];
+			continue;
+		}
+
+		runAnimators(node, timeMs);
+		if (!updateTransformation(i))
+			++skipped;
+
+		if (node->ChildrenChanges != ChildrenChanges[i])
+		{
+			// children were added or removed, animate them as usual in this frame
+			ISceneNodeList::ConstIterator it = node->getChildren().begin();
+			for (; it != node->getChildren().end(); ++it)
+				(*it)->OnAnimate(timeMs);
+
+			NeedsBuild = true;
+			i = SubtreeEnds[i];
+			continue;
+		}
+
+		++i;
+	}
+
+	IRR_PROFILE(
+		static const s32 skippedId = getProfiler().add(L"skip.transform", L"Irrlicht scene");
+		getProfiler().addCalls(skippedId, skipped);
+	)
+}
+
+} // end namespace scene
+} // end namespace irr
+
@@ -0,0 +1,87 @@
+// Copyright (C) 2002-2012 Nikolaus Gebhardt
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#ifndef __C_SCENE_NODE_TRANSFORM_STORE_H_INCLUDED__
+#define __C_SCENE_NODE_TRANSFORM_STORE_H_INCLUDED__
+
+#include "ISceneNode.h"
+#include "irrArray.h"
+
+namespace irr
+{
+namespace scene
+{
+	//! Transformations of a scene graph in contiguous arrays, in parent before children order
+	/** Replaces the recursive ISceneNode::OnAnimate() of the whole scene by
+	one linear sweep over the arrays. The absolute transformation of a node
+	is only computed again when its relative translation, rotation or scale
+	or the absolute transformation of its parent changed. Nodes which might
+	override OnAnimate() (see ISceneNode::isAnimationThreadSafe()) are
+	animated with it, together with their children.
+	The store grabs all nodes, a node which was removed from the scene
+	graph is dropped in the next frame, when the store is built again. */
+	class CSceneNodeTransformStore
+	{
+	public:
+
+		//! constructor
+		CSceneNodeTransformStore();
+
+		//! destructor
+		~CSceneNodeTransformStore();
+
+		//! Does the work of root->OnAnimate(timeMs) for the whole scene
+		void animate(ISceneNode* root, u32 timeMs);
+
+		//! Drops all nodes, the store is built again on the next animate()
+		void clear();
+
+		//! Get the number of nodes in the store
+		u32 getNodeCount() const { return Nodes.size(); }
+
+	private:
+
+		enum E_TRANSFORM_FLAGS
+		{
+			//! The absolute transformation was computed again in this frame
+			ETF_CHANGED = 1,
+			//! The cached transformation may be outdated, compute it on the next visit
+			ETF_STALE = 2
+		};
+
+		//! Adds a node and its children in depth first order
+		void add(ISceneNode* node, s32 parent);
+
+		//! Builds the arrays from the scene graph
+		void build(ISceneNode* root);
+
+		//! Runs the animators of a node
+		static void runAnimators(ISceneNode* node, u32 timeMs);
+
+		//! Updates the absolute transformation of the node at index i if needed
+		/** \return False if the transformation was unchanged. */
+		bool updateTransformation(u32 i);
+
+		core::array<ISceneNode*> Nodes;
+		core::array<s32> Parents;
+		//! Index after the last node in the subtree of each node
+		core::array<u32> SubtreeEnds;
+		//! ISceneNode::ChildrenChanges when the store was built
+		core::array<u32> ChildrenChanges;
+
+		core::array<core::matrix4> LocalMatrices;
+		core::array<core::matrix4> WorldMatrices;
+		core::array<core::vector3df> Translations;
+		core::array<core::vector3df> Rotations;
+		core::array<core::vector3df> Scales;
+		core::array<u8> Flags;
+
+		bool NeedsBuild;
+	};
+
+} // end namespace scene
+} // end namespace irr
+
+#endif
+
@@ -8,8 +8,17 @@
 #include "CSkinnedMesh.h"
 #include "CBoneSceneNode.h"
 #include "IAnimatedMeshSceneNode.h"
+#include "CJobPool.h"
 #include "os.h"
 
+// SSE2 is the baseline of x86-64, the skinning kernel gives the same
+// results as the scalar code.
+#if !defined(NO_IRR_SKINNED_MESH_SSE2_) && \
+	(defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+	#define _IRR_SKINNED_MESH_SSE2_
+	#include <emmintrin.h>
+#endif
+
 namespace
 {
 	// Frames must always be increasing, so we remove objects where this isn't the case
@@ -82,6 +91,31 @@ namespace
 	{
 		return a.rotation == b.rotation;
 	}
+
+	// number of skinned vertices per job, small meshes are skinned faster without waking the worker threads
+	const irr::u32 SKIN_JOB_VERTICES = 2048;
+
+#if defined(_IRR_SKINNED_MESH_SSE2_)
+	// same operation order as matrix4::rotateVect
+	inline __m128 rotateSkinned(const irr::f32* m, __m128 x, __m128 y, __m128 z)
+	{
+		return _mm_add_ps(_mm_add_ps(_mm_mul_ps(x, _mm_loadu_ps(m)), _mm_mul_ps(y, _mm_loadu_ps(m+4))),
+			_mm_mul_ps(z, _mm_loadu_ps(m+8)));
+	}
+
+	// same operation order as matrix4::transformVect
+	inline __m128 transformSkinned(const irr::f32* m, __m128 x, __m128 y, __m128 z)
+	{
+		return _mm_add_ps(rotateSkinned(m, x, y, z), _mm_loadu_ps(m+12));
+	}
+
+	inline void storeSkinned(irr::core::vector3df& out, __m128 v)
+	{
+		irr::f32 tmp[4];
+		_mm_storeu_ps(tmp, v);
+		out.set(tmp[0], tmp[1], tmp[2]);
+	}
+#endif
 };
 
 namespace irr
@@ -92,7 +126,7 @@ namespace scene
 
 //! constructor
 CSkinnedMesh::CSkinnedMesh()
-: SkinningBuffers(0), EndFrame(0.f), FramesPerSecond(25.f),
+: SkinningBuffers(0), SkinnedVertexCount(0), EndFrame(0.f), FramesPerSecond(25.f),
 	LastAnimatedFrame(-1), SkinnedLastFrame(false),
 	InterpolationMode(EIM_LINEAR),
 	HasAnimation(false), PreparedForSkinning(false),
@@ -296,25 +330,30 @@ void CSkinnedMesh::buildAllLocalAnimatedMatrices()
 }
 
 
-void CSkinnedMesh::buildAllGlobalAnimatedMatrices(SJoint *joint, SJoint *parentJoint)
+void CSkinnedMesh::buildAllGlobalAnimatedMatrices()
 {
-	if (!joint)
-	{
-		for (u32 i=0; i<RootJoints.size(); ++i)
-			buildAllGlobalAnimatedMatrices(RootJoints[i], 0);
-		return;
-	}
-	else
+	// parents come before their children
+	for (u32 i=0; i<JointOrder.size(); ++i)
 	{
+		SJoint *joint = JointOrder[i];
+		SJoint *parentJoint = JointParents[i];
+
 		// Find global matrix...
 		if (!parentJoint || joint->GlobalSkinningSpace)
 			joint->GlobalAnimatedMatrix = joint->LocalAnimatedMatrix;
 		else
 			joint->GlobalAnimatedMatrix = parentJoint->GlobalAnimatedMatrix * joint->LocalAnimatedMatrix;
 	}
+}
+
+
+void CSkinnedMesh::buildJointOrder(SJoint *joint, SJoint *parentJoint)
+{
+	JointOrder.push_back(joint);
+	JointParents.push_back(parentJoint);
 
 	for (u32 j=0; j<joint->Children.size(); ++j)
-		buildAllGlobalAnimatedMatrices(joint->Children[j], joint);
+		buildJointOrder(joint->Children[j], joint);
 }
 
 
@@ -520,6 +559,13 @@ void CSkinnedMesh::getFrameData(f32 frame, SJoint *joint,
 
 //! Preforms a software skin on this mesh based of joint positions
 void CSkinnedMesh::skinMesh()
+{
+	skinMesh(0);
+}
+
+
+//! Preforms a software skin, larger meshes are skinned on the worker threads of pool
+void CSkinnedMesh::skinMesh(CJobPool* pool)
 {
 	if (!HasAnimation || SkinnedLastFrame)
 		return;
@@ -545,6 +591,7 @@ void CSkinnedMesh::skinMesh()
 			}
 		}
 
+#if defined(_IRR_COMPILE_WITH_SKINNING_REFERENCE_)
 		//clear skinning helper array
 		for (i=0; i<Vertices_Moved.size(); ++i)
 			for (u32 j=0; j<Vertices_Moved[i].size(); ++j)
@@ -553,14 +600,36 @@ void CSkinnedMesh::skinMesh()
 		//skin starting with the root joints
 		for (i=0; i<RootJoints.size(); ++i)
 			skinJoint(RootJoints[i], 0);
+#else
+		//Find each joints pull on vertices...
+		for (i=0; i<SkinningPalette.size(); ++i)
+		{
+			if (JointOrder[i]->Weights.size())
+				SkinningPalette[i].setbyproduct(JointOrder[i]->GlobalAnimatedMatrix, JointOrder[i]->GlobalInversedMatrix);
+		}
+
+		//jobs write to different vertices
+		if (pool && pool->getThreadCount() && SkinnedVertexCount >= 2*SKIN_JOB_VERTICES)
+			pool->parallelFor(skinVerticesJob, this, SkinJobs.size());
+		else
+		{
+			for (i=0; i<SkinJobs.size(); ++i)
+				skinVertices(i);
+		}
+#endif
 
 		for (i=0; i<SkinningBuffers->size(); ++i)
+		{
+			if (i < SkinnedVertices.size() && SkinnedVertices[i].VertexIds.size())
+				(*SkinningBuffers)[i]->boundingBoxNeedsRecalculated();
 			(*SkinningBuffers)[i]->setDirty(EBT_VERTEX);
+		}
 	}
 	updateBoundingBox();
 }
 
 
+#if defined(_IRR_COMPILE_WITH_SKINNING_REFERENCE_)
 void CSkinnedMesh::skinJoint(SJoint *joint, SJoint *parentJoint)
 {
 	if (joint->Weights.size())
@@ -592,8 +661,6 @@ void CSkinnedMesh::skinJoint(SJoint *joint, SJoint *parentJoint)
 
 				if (AnimateNormals)
 					buffersUsed[weight.buffer_id]->getVertex(weight.vertex_id)->Normal = thisNormalMove * weight.strength;
-
-				//*(weight._Pos) = thisVertexMove * weight.strength;
 			}
 			else
 			{
@@ -601,11 +668,7 @@ void CSkinnedMesh::skinJoint(SJoint *joint, SJoint *parentJoint)
 
 				if (AnimateNormals)
 					buffersUsed[weight.buffer_id]->getVertex(weight.vertex_id)->Normal += thisNormalMove * weight.strength;
-
-				//*(weight._Pos) += thisVertexMove * weight.strength;
 			}
-
-			buffersUsed[weight.buffer_id]->boundingBoxNeedsRecalculated();
 		}
 	}
 
@@ -613,6 +676,185 @@ void CSkinnedMesh::skinJoint(SJoint *joint, SJoint *parentJoint)
 	for (u32 j=0; j<joint->Children.size(); ++j)
 		skinJoint(joint->Children[j], joint);
 }
+#endif
+
+
+void CSkinnedMesh::skinVerticesJob(void* mesh, u32 job)
+{
+	((CSkinnedMesh*)mesh)->skinVertices(job);
+}
+
+
+//! skins the vertices of one SSkinJob
+void CSkinnedMesh::skinVertices(u32 job)
+{
+	const SSkinJob& range = SkinJobs[job];
+	const SSkinnedVertices& skinned = SkinnedVertices[range.Buffer];
+	SSkinMeshBuffer* buffer = (*SkinningBuffers)[range.Buffer];
+
+	// Pos and Normal are at the same place in all vertex types
+	u8* vertices = (u8*)buffer->getVertices();
+	const u32 pitch = video::getVertexPitchFromType(buffer->getVertexType());
+	const core::matrix4* palette = SkinningPalette.const_pointer();
+	const SSkinInfluence* influences = skinned.Influences.const_pointer();
+
+	for (u32 i=range.First; i<range.Last; ++i)
+	{
+		video::S3DVertex* vertex = (video::S3DVertex*)(vertices + skinned.VertexIds[i]*pitch);
+		const SSkinInfluence* influence = influences + skinned.FirstInfluence[i];
+		const SSkinInfluence* end = influences + skinned.FirstInfluence[i+1];
+
+		// the first influence sets the vertex, the others are added in joint order
+#if defined(_IRR_SKINNED_MESH_SSE2_)
+		const core::vector3df& pos = skinned.StaticPos[i];
+		const __m128 px = _mm_set1_ps(pos.X);
+		const __m128 py = _mm_set1_ps(pos.Y);
+		const __m128 pz = _mm_set1_ps(pos.Z);
+
+		__m128 sum = _mm_mul_ps(transformSkinned(palette[influence->Palette].pointer(), px, py, pz),
+			_mm_set1_ps(influence->Strength));
+		for (const SSkinInfluence* it=influence+1; it!=end; ++it)
+			sum = _mm_add_ps(sum, _mm_mul_ps(transformSkinned(palette[it->Palette].pointer(), px, py, pz),
+				_mm_set1_ps(it->Strength)));
+		storeSkinned(vertex->Pos, sum);
+
+		if (AnimateNormals)
+		{
+			const core::vector3df& normal = skinned.StaticNormal[i];
+			const __m128 nx = _mm_set1_ps(normal.X);
+			const __m128 ny = _mm_set1_ps(normal.Y);
+			const __m128 nz = _mm_set1_ps(normal.Z);
+
+			sum = _mm_mul_ps(rotateSkinned(palette[influence->Palette].pointer(), nx, ny, nz),
+				_mm_set1_ps(influence->Strength));
+			for (const SSkinInfluence* it=influence+1; it!=end; ++it)
+				sum = _mm_add_ps(sum, _mm_mul_ps(rotateSkinned(palette[it->Palette].pointer(), nx, ny, nz),
+					_mm_set1_ps(it->Strength)));
+			storeSkinned(vertex->Normal, sum);
+		}
+#else
+		core::vector3df move;
+
+		palette[influence->Palette].transformVect(move, skinned.StaticPos[i]);
+		vertex->Pos = move * influence->Strength;
+		for (const SSkinInfluence* it=influence+1; it!=end; ++it)
+		{
+			palette[it->Palette].transformVect(move, skinned.StaticPos[i]);
+			vertex->Pos += move * it->Strength;
+		}
+
+		if (AnimateNormals)
+		{
+			palette[influence->Palette].rotateVect(move, skinned.StaticNormal[i]);
+			vertex->Normal = move * influence->Strength;
+			for (const SSkinInfluence* it=influence+1; it!=end; ++it)
+			{
+				palette[it->Palette].rotateVect(move, skinned.StaticNormal[i]);
+				vertex->Normal += move * it->Strength;
+			}
+		}
+#endif
+	}
+}
+
+
+//! builds the vertex and influence lists of SkinnedVertices from the weights
+void CSkinnedMesh::buildSkinningTables()
+{
+	u32 i, j;
+
+	SkinnedVertices.clear();
+	SkinJobs.clear();
+	SkinnedVertexCount = 0;
+
+	SkinningPalette.clear();
+	SkinningPalette.reallocate(JointOrder.size());
+	for (i=0; i<JointOrder.size(); ++i)
+		SkinningPalette.push_back(core::IdentityMatrix);
+
+	// index of each vertex in SkinnedVertices, -1 when it has no weights
+	core::array< core::array<s32> > slots;
+	slots.reallocate(LocalBuffers.size());
+	SkinnedVertices.reallocate(LocalBuffers.size());
+	for (i=0; i<LocalBuffers.size(); ++i)
+	{
+		slots.push_back(core::array<s32>());
+		slots[i].set_used(LocalBuffers[i]->getVertexCount());
+		for (j=0; j<slots[i].size(); ++j)
+			slots[i][j] = -1;
+
+		SkinnedVertices.push_back(SSkinnedVertices());
+	}
+
+	// count the influences per vertex, visiting the joints like the skinning
+	for (i=0; i<JointOrder.size(); ++i)
+	{
+		const SJoint *joint = JointOrder[i];
+		for (j=0; j<joint->Weights.size(); ++j)
+		{
+			const SWeight& weight = joint->Weights[j];
+			SSkinnedVertices& skinned = SkinnedVertices[weight.buffer_id];
+			s32& slot = slots[weight.buffer_id][weight.vertex_id];
+			if (slot < 0)
+			{
+				slot = skinned.VertexIds.size();
+				skinned.VertexIds.push_back(weight.vertex_id);
+				skinned.FirstInfluence.push_back(0);
+				skinned.StaticPos.push_back(weight.StaticPos);
+				skinned.StaticNormal.push_back(weight.StaticNormal);
+			}
+			++skinned.FirstInfluence[slot];
+		}
+	}
+
+	// counts to offsets, the influences are written with FirstInfluence[i+1] as cursor
+	for (i=0; i<SkinnedVertices.size(); ++i)
+	{
+		SSkinnedVertices& skinned = SkinnedVertices[i];
+		u32 offset = 0;
+		for (j=0; j<skinned.FirstInfluence.size(); ++j)
+		{
+			const u32 count = skinned.FirstInfluence[j];
+			skinned.FirstInfluence[j] = offset;
+			offset += count;
+		}
+		skinned.FirstInfluence.push_back(offset);
+		skinned.Influences.set_used(offset);
+
+		for (j=skinned.FirstInfluence.size()-1; j>0; --j)
+			skinned.FirstInfluence[j] = skinned.FirstInfluence[j-1];
+	}
+
+	for (i=0; i<JointOrder.size(); ++i)
+	{
+		const SJoint *joint = JointOrder[i];
+		for (j=0; j<joint->Weights.size(); ++j)
+		{
+			const SWeight& weight = joint->Weights[j];
+			SSkinnedVertices& skinned = SkinnedVertices[weight.buffer_id];
+			const s32 slot = slots[weight.buffer_id][weight.vertex_id];
+
+			SSkinInfluence& influence = skinned.Influences[skinned.FirstInfluence[slot+1]++];
+			influence.Palette = i;
+			influence.Strength = weight.strength;
+		}
+	}
+
+	// split the vertices into jobs
+	for (i=0; i<SkinnedVertices.size(); ++i)
+	{
+		const u32 count = SkinnedVertices[i].VertexIds.size();
+		for (j=0; j<count; j+=SKIN_JOB_VERTICES)
+		{
+			SSkinJob job;
+			job.Buffer = i;
+			job.First = j;
+			job.Last = core::min_(j+SKIN_JOB_VERTICES, count);
+			SkinJobs.push_back(job);
+		}
+		SkinnedVertexCount += count;
+	}
+}
 
 
 E_ANIMATED_MESH_TYPE CSkinnedMesh::getMeshType() const
@@ -925,12 +1167,6 @@ void CSkinnedMesh::checkForAnimation()
 			}
 		}
 
-		//An array used in skinning
-
-		for (i=0; i<Vertices_Moved.size(); ++i)
-			for (j=0; j<Vertices_Moved[i].size(); ++j)
-				Vertices_Moved[i][j] = false;
-
 		// For skinning: cache weight values for speed
 
 		for (i=0; i<AllJoints.size(); ++i)
@@ -941,7 +1177,11 @@ void CSkinnedMesh::checkForAnimation()
 				const u16 buffer_id=joint->Weights[j].buffer_id;
 				const u32 vertex_id=joint->Weights[j].vertex_id;
 
+#if defined(_IRR_COMPILE_WITH_SKINNING_REFERENCE_)
 				joint->Weights[j].Moved = &Vertices_Moved[buffer_id] [vertex_id];
+#else
+				joint->Weights[j].Moved = 0;
+#endif
 				joint->Weights[j].StaticPos = LocalBuffers[buffer_id]->getVertex(vertex_id)->Pos;
 				joint->Weights[j].StaticNormal = LocalBuffers[buffer_id]->getVertex(vertex_id)->Normal;
 
@@ -951,6 +1191,8 @@ void CSkinnedMesh::checkForAnimation()
 
 		// normalize weights
 		normalizeWeights();
+
+		buildSkinningTables();
 	}
 	SkinnedLastFrame=false;
 }
@@ -1005,13 +1247,23 @@ void CSkinnedMesh::finalize()
 		AllJoints[i]->UseAnimationFrom=AllJoints[i];
 	}
 
+#if defined(_IRR_COMPILE_WITH_SKINNING_REFERENCE_)
 	//Set array sizes...
 
+	Vertices_Moved.clear();
 	for (i=0; i<LocalBuffers.size(); ++i)
 	{
 		Vertices_Moved.push_back( core::array<bool>() );
 		Vertices_Moved[i].set_used(LocalBuffers[i]->getVertexCount());
 	}
+#endif
+
+	//flatten the hierarchy for animation and skinning...
+
+	JointOrder.clear();
+	JointParents.clear();
+	for (i=0; i<RootJoints.size(); ++i)
+		buildJointOrder(RootJoints[i], 0);
 
 	checkForAnimation();
 
@@ -16,6 +16,8 @@
 
 namespace irr
 {
+	class CJobPool;
+
 namespace scene
 {
 
@@ -54,6 +56,9 @@ namespace scene
 		//! Preforms a software skin on this mesh based of joint positions
 		virtual void skinMesh() _IRR_OVERRIDE_;
 
+		//! Preforms a software skin, larger meshes are skinned on the worker threads of pool
+		void skinMesh(CJobPool* pool);
+
 		//! returns amount of mesh buffers.
 		virtual u32 getMeshBufferCount() const _IRR_OVERRIDE_;
 
@@ -167,7 +172,22 @@ private:
 
 		void buildAllLocalAnimatedMatrices();
 
-		void buildAllGlobalAnimatedMatrices(SJoint *Joint=0, SJoint *ParentJoint=0);
+		void buildAllGlobalAnimatedMatrices();
+
+		//! puts the joints reachable from RootJoints into JointOrder, parents first
+		void buildJointOrder(SJoint *joint, SJoint *parentJoint);
+
+		//! builds the vertex and influence lists of SkinnedVertices from the weights
+		void buildSkinningTables();
+
+		//! skins the vertices of one SSkinJob
+		void skinVertices(u32 job);
+
+		static void skinVerticesJob(void* mesh, u32 job);
+
+#if defined(_IRR_COMPILE_WITH_SKINNING_REFERENCE_)
+		void skinJoint(SJoint *Joint, SJoint *ParentJoint);
+#endif
 
 		void getFrameData(f32 frame, SJoint *Node,
 				core::vector3df &position, s32 &positionHint,
@@ -176,8 +196,6 @@ private:
 
 		void calculateGlobalMatrices(SJoint *Joint,SJoint *ParentJoint);
 
-		void skinJoint(SJoint *Joint, SJoint *ParentJoint);
-
 		void calculateTangents(core::vector3df& normal,
 			core::vector3df& tangent, core::vector3df& binormal,
 			core::vector3df& vt1, core::vector3df& vt2, core::vector3df& vt3,
@@ -190,7 +208,46 @@ private:
 		core::array<SJoint*> AllJoints;
 		core::array<SJoint*> RootJoints;
 
+		//! joints in the order of a depth first traversal from RootJoints
+		core::array<SJoint*> JointOrder;
+		//! parent of the joint at the same position in JointOrder, 0 for root joints
+		core::array<SJoint*> JointParents;
+
+		//! skinning matrix of a joint in JointOrder
+		struct SSkinInfluence
+		{
+			u32 Palette;
+			f32 Strength;
+		};
+
+		//! vertices of a mesh buffer which are moved by joints
+		/** The influences of vertex i are Influences[FirstInfluence[i]] to
+		Influences[FirstInfluence[i+1]-1], in JointOrder. */
+		struct SSkinnedVertices
+		{
+			core::array<u32> VertexIds;
+			core::array<u32> FirstInfluence;
+			core::array<core::vector3df> StaticPos;
+			core::array<core::vector3df> StaticNormal;
+			core::array<SSkinInfluence> Influences;
+		};
+
+		//! range of skinned vertices of one buffer, skinned by one job
+		struct SSkinJob
+		{
+			u32 Buffer;
+			u32 First;
+			u32 Last;
+		};
+
+#if defined(_IRR_COMPILE_WITH_SKINNING_REFERENCE_)
 		core::array< core::array<bool> > Vertices_Moved;
+#endif
+
+		core::array<SSkinnedVertices> SkinnedVertices;
+		core::array<SSkinJob> SkinJobs;
+		core::array<core::matrix4> SkinningPalette;
+		u32 SkinnedVertexCount;
 
 		core::aabbox3d<f32> BoundingBox;
 
@@ -28,6 +28,12 @@ class CSkyDomeSceneNode : public ISceneNode
 		virtual u32 getMaterialCount() const _IRR_OVERRIDE_;
 		virtual ESCENE_NODE_TYPE getType() const _IRR_OVERRIDE_ { return ESNT_SKY_DOME; }
 
+		//! The sky dome follows the camera in render, so it may be animated on worker threads
+		virtual bool isAnimationThreadSafe() const _IRR_OVERRIDE_ { return true; }
+
+		//! The camera position is only added in render
+		virtual bool hasDefaultTransformation() const _IRR_OVERRIDE_ { return true; }
+
 		virtual void serializeAttributes(io::IAttributes* out, io::SAttributeReadWriteOptions* options) const _IRR_OVERRIDE_;
 		virtual void deserializeAttributes(io::IAttributes* in, io::SAttributeReadWriteOptions* options) _IRR_OVERRIDE_;
 		virtual ISceneNode* clone(ISceneNode* newParent=0, ISceneManager* newManager=0) _IRR_OVERRIDE_;
@@ -252,6 +252,12 @@ ITexture* CSoftwareDriver::createDeviceDependentTexture(const io::path& name, II
 	return texture;
 }
 
+bool CSoftwareDriver::swapDeviceDependentTexture(ITexture* placeholder, ITexture* texture)
+{
+	static_cast<CSoftwareTexture*>(placeholder)->swap(static_cast<CSoftwareTexture*>(texture));
+	return true;
+}
+
 bool CSoftwareDriver::setRenderTargetEx(IRenderTarget* target, u16 clearFlag, SColor clearColor, f32 clearDepth, u8 clearStencil)
 {
 	if (target && target->getDriverType() != EDT_SOFTWARE)
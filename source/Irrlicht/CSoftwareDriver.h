@@ -100,6 +100,8 @@ namespace video
 
 		virtual ITexture* createDeviceDependentTexture(const io::path& name, IImage* image) _IRR_OVERRIDE_;
 
+		virtual bool swapDeviceDependentTexture(ITexture* placeholder, ITexture* texture) _IRR_OVERRIDE_;
+
 		//! Creates a render target texture.
 		virtual ITexture* addRenderTargetTexture(const core::dimension2d<u32>& size,
 				const io::path& name, const ECOLOR_FORMAT format = ECF_UNKNOWN) _IRR_OVERRIDE_;
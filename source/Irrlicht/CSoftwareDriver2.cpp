@@ -13,6 +13,11 @@
 #include "S3DVertex.h"
 #include "S4DVertex.h"
 #include "CBlit.h"
+#include "CJobPool.h"
+
+#if defined ( SOFTWARE_DRIVER_2_SSE2 )
+	#include <emmintrin.h>
+#endif
 
 
 #define MAT_TEXTURE(tex) ( (video::CSoftwareTexture2*) Material.org.getTexture ( tex ) )
@@ -28,7 +33,9 @@ CBurningVideoDriver::CBurningVideoDriver(const irr::SIrrlichtCreationParameters&
 : CNullDriver(io, params.WindowSize), BackBuffer(0), Presenter(presenter),
 	WindowId(0), SceneSourceRect(0),
 	RenderTargetTexture(0), RenderTargetSurface(0), CurrentShader(0),
-	 DepthBuffer(0), StencilBuffer ( 0 ),
+	 CurrentShaderType(ETR_INVALID), BandSlots(0), RecordBands(false),
+	 DepthReject(false), DepthRejectedTriangles(0), DepthRejectedPixels(0),
+	 DepthBuffer(0), StencilBuffer ( 0 ), MipMapCachePath ( params.MipMapCachePath ),
 	 CurrentOut ( 16 * 2, 256 ), Temp ( 16 * 2, 256 )
 {
 	#ifdef _DEBUG
@@ -56,40 +63,11 @@ CBurningVideoDriver::CBurningVideoDriver(const irr::SIrrlichtCreationParameters&
 	DriverAttributes->setAttribute("MaxLights", 1024 ); //glsl::gl_MaxLights);
 	DriverAttributes->setAttribute("MaxTextureLODBias", 16.f);
 	DriverAttributes->setAttribute("Version", 49);
+	DriverAttributes->setAttribute("DepthRejectedTriangles", 0);
+	DriverAttributes->setAttribute("DepthRejectedPixels", 0);
 
 	// create triangle renderers
-
-	irr::memset32 ( BurningShader, 0, sizeof ( BurningShader ) );
-	//BurningShader[ETR_FLAT] = createTRFlat2(DepthBuffer);
-	//BurningShader[ETR_FLAT_WIRE] = createTRFlatWire2(DepthBuffer);
-	BurningShader[ETR_GOURAUD] = createTriangleRendererGouraud2(this);
-	BurningShader[ETR_GOURAUD_ALPHA] = createTriangleRendererGouraudAlpha2(this );
-	BurningShader[ETR_GOURAUD_ALPHA_NOZ] = createTRGouraudAlphaNoZ2(this );
-	//BurningShader[ETR_GOURAUD_WIRE] = createTriangleRendererGouraudWire2(DepthBuffer);
-	//BurningShader[ETR_TEXTURE_FLAT] = createTriangleRendererTextureFlat2(DepthBuffer);
-	//BurningShader[ETR_TEXTURE_FLAT_WIRE] = createTriangleRendererTextureFlatWire2(DepthBuffer);
-	BurningShader[ETR_TEXTURE_GOURAUD] = createTriangleRendererTextureGouraud2(this);
-	BurningShader[ETR_TEXTURE_GOURAUD_LIGHTMAP_M1] = createTriangleRendererTextureLightMap2_M1(this);
-	BurningShader[ETR_TEXTURE_GOURAUD_LIGHTMAP_M2] = createTriangleRendererTextureLightMap2_M2(this);
-	BurningShader[ETR_TEXTURE_GOURAUD_LIGHTMAP_M4] = createTriangleRendererGTextureLightMap2_M4(this);
-	BurningShader[ETR_TEXTURE_LIGHTMAP_M4] = createTriangleRendererTextureLightMap2_M4(this);
-	BurningShader[ETR_TEXTURE_GOURAUD_LIGHTMAP_ADD] = createTriangleRendererTextureLightMap2_Add(this);
-	BurningShader[ETR_TEXTURE_GOURAUD_DETAIL_MAP] = createTriangleRendererTextureDetailMap2(this);
-
-	BurningShader[ETR_TEXTURE_GOURAUD_WIRE] = createTriangleRendererTextureGouraudWire2(this);
-	BurningShader[ETR_TEXTURE_GOURAUD_NOZ] = createTRTextureGouraudNoZ2(this);
-	BurningShader[ETR_TEXTURE_GOURAUD_ADD] = createTRTextureGouraudAdd2(this);
-	BurningShader[ETR_TEXTURE_GOURAUD_ADD_NO_Z] = createTRTextureGouraudAddNoZ2(this);
-	BurningShader[ETR_TEXTURE_GOURAUD_VERTEX_ALPHA] = createTriangleRendererTextureVertexAlpha2 ( this );
-
-	BurningShader[ETR_TEXTURE_GOURAUD_ALPHA] = createTRTextureGouraudAlpha(this );
-	BurningShader[ETR_TEXTURE_GOURAUD_ALPHA_NOZ] = createTRTextureGouraudAlphaNoZ( this );
-
-	BurningShader[ETR_NORMAL_MAP_SOLID] = createTRNormalMap ( this );
-	BurningShader[ETR_STENCIL_SHADOW] = createTRStencilShadow ( this );
-	BurningShader[ETR_TEXTURE_BLEND] = createTRTextureBlend( this );
-
-	BurningShader[ETR_REFERENCE] = createTriangleRendererReference ( this );
+	createShaders(BurningShader);
 
 
 	// add the same renderer for all solid types
@@ -153,6 +131,12 @@ CBurningVideoDriver::~CBurningVideoDriver()
 			BurningShader[i]->drop();
 	}
 
+	for (u32 i=0; i<BandShader.size(); ++i)
+	{
+		if (BandShader[i])
+			BandShader[i]->drop();
+	}
+
 	// delete Additional buffer
 	if (StencilBuffer)
 		StencilBuffer->drop();
@@ -168,6 +152,44 @@ CBurningVideoDriver::~CBurningVideoDriver()
 }
 
 
+//! creates the triangle renderers for all EBurningFFShader types
+void CBurningVideoDriver::createShaders(IBurningShader** shader)
+{
+	irr::memset32 ( shader, 0, sizeof ( IBurningShader* ) * ETR2_COUNT );
+	//shader[ETR_FLAT] = createTRFlat2(DepthBuffer);
+	//shader[ETR_FLAT_WIRE] = createTRFlatWire2(DepthBuffer);
+	shader[ETR_GOURAUD] = createTriangleRendererGouraud2(this);
+	shader[ETR_GOURAUD_ALPHA] = createTriangleRendererGouraudAlpha2(this );
+	shader[ETR_GOURAUD_ALPHA_NOZ] = createTRGouraudAlphaNoZ2(this );
+	//shader[ETR_GOURAUD_WIRE] = createTriangleRendererGouraudWire2(DepthBuffer);
+	//shader[ETR_TEXTURE_FLAT] = createTriangleRendererTextureFlat2(DepthBuffer);
+	//shader[ETR_TEXTURE_FLAT_WIRE] = createTriangleRendererTextureFlatWire2(DepthBuffer);
+	shader[ETR_TEXTURE_GOURAUD] = createTriangleRendererTextureGouraud2(this);
+	shader[ETR_TEXTURE_GOURAUD_LIGHTMAP_M1] = createTriangleRendererTextureLightMap2_M1(this);
+	shader[ETR_TEXTURE_GOURAUD_LIGHTMAP_M2] = createTriangleRendererTextureLightMap2_M2(this);
+	shader[ETR_TEXTURE_GOURAUD_LIGHTMAP_M4] = createTriangleRendererGTextureLightMap2_M4(this);
+	shader[ETR_TEXTURE_LIGHTMAP_M4] = createTriangleRendererTextureLightMap2_M4(this);
+	shader[ETR_TEXTURE_GOURAUD_LIGHTMAP_ADD] = createTriangleRendererTextureLightMap2_Add(this);
+	shader[ETR_TEXTURE_GOURAUD_DETAIL_MAP] = createTriangleRendererTextureDetailMap2(this);
+
+	shader[ETR_TEXTURE_GOURAUD_WIRE] = createTriangleRendererTextureGouraudWire2(this);
+	shader[ETR_TEXTURE_GOURAUD_NOZ] = createTRTextureGouraudNoZ2(this);
+	shader[ETR_TEXTURE_GOURAUD_ADD] = createTRTextureGouraudAdd2(this);
+	shader[ETR_TEXTURE_GOURAUD_ADD_NO_Z] = createTRTextureGouraudAddNoZ2(this);
+	shader[ETR_TEXTURE_GOURAUD_VERTEX_ALPHA] = createTriangleRendererTextureVertexAlpha2 ( this );
+
+	shader[ETR_TEXTURE_GOURAUD_ALPHA] = createTRTextureGouraudAlpha(this );
+	shader[ETR_TEXTURE_GOURAUD_ALPHA_NOZ] = createTRTextureGouraudAlphaNoZ( this );
+
+	shader[ETR_NORMAL_MAP_SOLID] = createTRNormalMap ( this );
+	shader[ETR_STENCIL_SHADOW] = createTRStencilShadow ( this );
+	shader[ETR_TEXTURE_BLEND] = createTRTextureBlend( this );
+	shader[ETR_OCCLUSION_QUERY] = createTROcclusionQuery( this );
+
+	shader[ETR_REFERENCE] = createTriangleRendererReference ( this );
+}
+
+
 /*!
 	selects the right triangle renderer based on the render states.
 */
@@ -279,25 +301,171 @@ void CBurningVideoDriver::setCurrentShader()
 	//shader = ETR_REFERENCE;
 
 	// switchToTriangleRenderer
+	CurrentShaderType = shader;
 	CurrentShader = BurningShader[shader];
 	if ( CurrentShader )
+		bindShader ( CurrentShader );
+}
+
+
+//! applies the current render states to a triangle renderer of type CurrentShaderType
+void CBurningVideoDriver::bindShader(IBurningShader* shader)
+{
+	shader->setZCompareFunc ( Material.org.ZBuffer );
+	shader->setRenderTarget(RenderTargetSurface, ViewPort);
+	shader->setMaterial ( Material );
+
+	switch ( CurrentShaderType )
 	{
-		CurrentShader->setZCompareFunc ( Material.org.ZBuffer );
-		CurrentShader->setRenderTarget(RenderTargetSurface, ViewPort);
-		CurrentShader->setMaterial ( Material );
+		case ETR_TEXTURE_GOURAUD_ALPHA:
+		case ETR_TEXTURE_GOURAUD_ALPHA_NOZ:
+		case ETR_TEXTURE_BLEND:
+			shader->setParam ( 0, Material.org.MaterialTypeParam );
+			break;
+		default:
+		break;
+	}
+}
+
 
-		switch ( shader )
+//! Sets the worker threads the driver may use
+void CBurningVideoDriver::setJobPool(CJobPool* pool)
+{
+	CNullDriver::setJobPool(pool);
+
+	u32 i;
+	for (i=0; i<BandShader.size(); ++i)
+	{
+		if (BandShader[i])
+			BandShader[i]->drop();
+	}
+	BandShader.clear();
+	BandSlots = 0;
+
+	if (!JobPool || 0 == JobPool->getThreadCount())
+		return;
+
+	// every thread draws with its own set of renderers
+	BandSlots = JobPool->getThreadCount() + 1;
+	BandShader.set_used(BandSlots * ETR2_COUNT);
+	for (i=0; i<BandSlots; ++i)
+		createShaders(BandShader.pointer() + i * ETR2_COUNT);
+}
+
+
+//! draws a triangle with the current shader or records it for the screen bands
+inline void CBurningVideoDriver::drawTriangle(const s4DVertex* a, const s4DVertex* b, const s4DVertex* c)
+{
+#ifdef SOFTWARE_DRIVER_2_HIERARCHICAL_Z
+	if (DepthReject)
+	{
+		// all pixels the renderers may touch
+		const core::rect<s32> area(
+			core::floor32(core::min_(a->Pos.x, b->Pos.x, c->Pos.x)),
+			core::floor32(core::min_(a->Pos.y, b->Pos.y, c->Pos.y)),
+			core::ceil32(core::max_(a->Pos.x, b->Pos.x, c->Pos.x)) + 1,
+			core::ceil32(core::max_(a->Pos.y, b->Pos.y, c->Pos.y)) + 1);
+
+		// 1/w is linear in screen space, so the nearest point is a vertex.
+		// leave some room for the interpolation of the renderers.
+		const f32 w = core::max_(a->Pos.w, b->Pos.w, c->Pos.w) * (1.f + 1.f / 1024.f);
+
+		CDepthBuffer* depth = (CDepthBuffer*) DepthBuffer;
+		if (depth->isHidden(area, w))
 		{
-			case ETR_TEXTURE_GOURAUD_ALPHA:
-			case ETR_TEXTURE_GOURAUD_ALPHA_NOZ:
-			case ETR_TEXTURE_BLEND:
-				CurrentShader->setParam ( 0, Material.org.MaterialTypeParam );
-				break;
-			default:
-			break;
+			const f32 dc_area = ((b->Pos.x - a->Pos.x) * (c->Pos.y - a->Pos.y)) -
+								((b->Pos.y - a->Pos.y) * (c->Pos.x - a->Pos.x));
+			DepthRejectedTriangles += 1;
+			DepthRejectedPixels += core::round32(core::abs_(dc_area) * 0.5f);
+			return;
 		}
+		depth->markBlocks(area);
 	}
+#endif
 
+	if (!RecordBands)
+	{
+		CurrentShader->drawTriangle(a, b, c);
+		return;
+	}
+
+	SBandTriangle t;
+	t.v[0] = *a;
+	t.v[1] = *b;
+	t.v[2] = *c;
+
+	// the mipmap levels were selected for this triangle already
+	const sInternalTexture* it = CurrentShader->getTextureParam();
+	for (u32 i=0; i<BURNING_MATERIAL_MAX_TEXTURES; ++i)
+		t.IT[i] = it[i];
+
+	// conservative, renderers clip exactly against the band
+	t.yStart = core::floor32(core::min_(a->Pos.y, b->Pos.y, c->Pos.y));
+	t.yEnd = core::ceil32(core::max_(a->Pos.y, b->Pos.y, c->Pos.y));
+
+	const s32 height = RenderTargetSize.Height;
+	if (t.yEnd < 0 || t.yStart >= height)
+		return;
+
+	// bin it, so a band only visits the triangles overlapping it
+	const u32 index = BandTriangles.size();
+	BandTriangles.push_back(t);
+
+	const s32 first = core::max_(t.yStart, 0) / SOFTWARE_DRIVER_2_BAND_HEIGHT;
+	const s32 last = core::min_(t.yEnd, height - 1) / SOFTWARE_DRIVER_2_BAND_HEIGHT;
+	for (s32 band = first; band <= last; ++band)
+		BandBins[band].push_back(index);
+}
+
+
+//! draws the recorded triangles in screen bands on all threads
+void CBurningVideoDriver::flushBands()
+{
+	RecordBands = false;
+	if (BandTriangles.empty())
+		return;
+
+	// resources are bound here, the worker threads must not touch reference counts
+	u32 i;
+	for (i=0; i<BandSlots; ++i)
+		bindShader(BandShader[i * ETR2_COUNT + CurrentShaderType]);
+
+	JobPool->parallelFor(drawBands, this, BandSlots);
+
+	for (i=0; i<BandSlots; ++i)
+		BandShader[i * ETR2_COUNT + CurrentShaderType]->setRenderTarget(0, ViewPort);
+
+	BandTriangles.set_used(0);
+	for (i=0; i<BandBins.size(); ++i)
+		BandBins[i].set_used(0);
+}
+
+
+//! draws every band slot-th screen band, called from the job pool
+void CBurningVideoDriver::drawBands(void* driver, u32 slot)
+{
+	CBurningVideoDriver* self = (CBurningVideoDriver*) driver;
+	IBurningShader* shader = self->BandShader[slot * ETR2_COUNT + self->CurrentShaderType];
+
+	const s32 height = self->RenderTargetSize.Height;
+	const s32 step = SOFTWARE_DRIVER_2_BAND_HEIGHT * self->BandSlots;
+
+	// bands are whole scanlines, so each pixel is written by exactly one
+	// thread and in the same triangle order as without threads
+	for (s32 y = slot * SOFTWARE_DRIVER_2_BAND_HEIGHT; y < height; y += step)
+	{
+		shader->setScanlineClip(y, y + SOFTWARE_DRIVER_2_BAND_HEIGHT);
+
+		const core::array<u32>& bin = self->BandBins[y / SOFTWARE_DRIVER_2_BAND_HEIGHT];
+		for (u32 i=0; i<bin.size(); ++i)
+		{
+			const SBandTriangle& t = self->BandTriangles[bin[i]];
+			shader->copyTextureParam(t.IT);
+			shader->drawTriangle(t.v + 0, t.v + 1, t.v + 2);
+		}
+	}
+
+	shader->setScanlineClip(0, 0x7FFFFFFF);
 }
 
 
@@ -321,6 +489,9 @@ bool CBurningVideoDriver::queryFeature(E_VIDEO_DRIVER_FEATURE feature) const
 	case EVDF_STENCIL_BUFFER:
 		return StencilBuffer != 0;
 
+	case EVDF_OCCLUSION_QUERY:
+		return DepthBuffer != 0;
+
 	case EVDF_RENDER_TO_TARGET:
 	case EVDF_MULTITEXTURE:
 	case EVDF_HARDWARE_TL:
@@ -395,6 +566,8 @@ bool CBurningVideoDriver::beginScene(u16 clearFlag, SColor clearColor, f32 clear
 	CNullDriver::beginScene(clearFlag, clearColor, clearDepth, clearStencil, videoData, sourceRect);
 	WindowId = videoData.D3D9.HWnd;
 	SceneSourceRect = sourceRect;
+	DepthRejectedTriangles = 0;
+	DepthRejectedPixels = 0;
 
 	clearBuffers(clearFlag, clearColor, clearDepth, clearStencil);
 
@@ -406,6 +579,9 @@ bool CBurningVideoDriver::endScene()
 {
 	CNullDriver::endScene();
 
+	DriverAttributes->setAttribute("DepthRejectedTriangles", (s32) DepthRejectedTriangles);
+	DriverAttributes->setAttribute("DepthRejectedPixels", (s32) DepthRejectedPixels);
+
 	return Presenter->present(BackBuffer, WindowId, SceneSourceRect);
 }
 
@@ -871,33 +1047,205 @@ const SVSize CBurningVideoDriver::vSize[] =
 
 
 
+#if defined ( SOFTWARE_DRIVER_2_SSE2 )
+
+//! positions of a vertex block in SoA layout, padded to full SSE registers
+struct SVertexBlock
+{
+	f32 x[VERTEXCACHE_ELEMENT];
+	f32 y[VERTEXCACHE_ELEMENT];
+	f32 z[VERTEXCACHE_ELEMENT];
+	f32 w[VERTEXCACHE_ELEMENT];
+
+	// projected to device coordinates
+	f32 dcx[VERTEXCACHE_ELEMENT];
+	f32 dcy[VERTEXCACHE_ELEMENT];
+	f32 dcz[VERTEXCACHE_ELEMENT];
+	f32 iw[VERTEXCACHE_ELEMENT];
+
+	u32 clip[VERTEXCACHE_ELEMENT];
+};
+
+/*!
+	transform, clip test and project four vertices at once.
+	same operations in the same order as transformVect, clipToFrustumTest and
+	ndc_2_dc_and_project2, so the results are bit identical to the scalar path.
+	x,y,z are the object space positions on input.
+*/
+static void transformBlock_SSE2 ( SVertexBlock &b, const u32 count, const f32 *m, const f32 *clipscale )
+{
+	const __m128 sign = _mm_set1_ps ( -0.f );
+	const __m128 one = _mm_set1_ps ( 1.f );
+
+	for ( u32 i = 0; i < count; i += 4 )
+	{
+		const __m128 ox = _mm_loadu_ps ( b.x + i );
+		const __m128 oy = _mm_loadu_ps ( b.y + i );
+		const __m128 oz = _mm_loadu_ps ( b.z + i );
+
+		// Model * World * Camera * Projection * NDCSpace matrix
+		const __m128 x = _mm_add_ps ( _mm_add_ps ( _mm_add_ps (
+							_mm_mul_ps ( ox, _mm_set1_ps ( m[0] ) ),
+							_mm_mul_ps ( oy, _mm_set1_ps ( m[4] ) ) ),
+							_mm_mul_ps ( oz, _mm_set1_ps ( m[8] ) ) ),
+							_mm_set1_ps ( m[12] ) );
+		const __m128 y = _mm_add_ps ( _mm_add_ps ( _mm_add_ps (
+							_mm_mul_ps ( ox, _mm_set1_ps ( m[1] ) ),
+							_mm_mul_ps ( oy, _mm_set1_ps ( m[5] ) ) ),
+							_mm_mul_ps ( oz, _mm_set1_ps ( m[9] ) ) ),
+							_mm_set1_ps ( m[13] ) );
+		const __m128 z = _mm_add_ps ( _mm_add_ps ( _mm_add_ps (
+							_mm_mul_ps ( ox, _mm_set1_ps ( m[2] ) ),
+							_mm_mul_ps ( oy, _mm_set1_ps ( m[6] ) ) ),
+							_mm_mul_ps ( oz, _mm_set1_ps ( m[10] ) ) ),
+							_mm_set1_ps ( m[14] ) );
+		const __m128 w = _mm_add_ps ( _mm_add_ps ( _mm_add_ps (
+							_mm_mul_ps ( ox, _mm_set1_ps ( m[3] ) ),
+							_mm_mul_ps ( oy, _mm_set1_ps ( m[7] ) ) ),
+							_mm_mul_ps ( oz, _mm_set1_ps ( m[11] ) ) ),
+							_mm_set1_ps ( m[15] ) );
+
+		_mm_storeu_ps ( b.x + i, x );
+		_mm_storeu_ps ( b.y + i, y );
+		_mm_storeu_ps ( b.z + i, z );
+		_mm_storeu_ps ( b.w + i, w );
+
+		// frustum test, one bit per plane and lane
+		const u32 c0 = _mm_movemask_ps ( _mm_cmple_ps ( z, w ) );
+		const u32 c1 = _mm_movemask_ps ( _mm_cmple_ps ( _mm_xor_ps ( z, sign ), w ) );
+		const u32 c2 = _mm_movemask_ps ( _mm_cmple_ps ( x, w ) );
+		const u32 c3 = _mm_movemask_ps ( _mm_cmple_ps ( _mm_xor_ps ( x, sign ), w ) );
+		const u32 c4 = _mm_movemask_ps ( _mm_cmple_ps ( y, w ) );
+		const u32 c5 = _mm_movemask_ps ( _mm_cmple_ps ( _mm_xor_ps ( y, sign ), w ) );
+
+		for ( u32 g = 0; g != 4; ++g )
+		{
+			b.clip[i + g] =	( ( c0 >> g ) & 1 )
+						|	( ( c1 >> g ) & 1 ) << 1
+						|	( ( c2 >> g ) & 1 ) << 2
+						|	( ( c3 >> g ) & 1 ) << 3
+						|	( ( c4 >> g ) & 1 ) << 4
+						|	( ( c5 >> g ) & 1 ) << 5;
+		}
+
+		// project homogenous vertex, to device coordinates
+		const __m128 iw = _mm_div_ps ( one, w );
+		_mm_storeu_ps ( b.iw + i, iw );
+		_mm_storeu_ps ( b.dcx + i, _mm_mul_ps ( iw, _mm_add_ps (
+							_mm_mul_ps ( x, _mm_set1_ps ( clipscale[0] ) ),
+							_mm_mul_ps ( w, _mm_set1_ps ( clipscale[12] ) ) ) ) );
+		_mm_storeu_ps ( b.dcy + i, _mm_mul_ps ( iw, _mm_add_ps (
+							_mm_mul_ps ( y, _mm_set1_ps ( clipscale[5] ) ),
+							_mm_mul_ps ( w, _mm_set1_ps ( clipscale[13] ) ) ) ) );
+		_mm_storeu_ps ( b.dcz + i, _mm_mul_ps ( z, iw ) );
+	}
+}
+
+#endif // SOFTWARE_DRIVER_2_SSE2
+
+
 /*!
-	fill a cache line with transformed, light and clipp test triangles
+	fill cache lines with transformed, light and clipp test triangles
 */
-void CBurningVideoDriver::VertexCache_fill(const u32 sourceIndex, const u32 destIndex)
+void CBurningVideoDriver::VertexCache_fill ( const u32 *sourceIndex, const u32 *destIndex, const u32 count )
 {
-	u8 * source;
-	s4DVertex *dest;
+	const u8 *vertices = (const u8*) VertexCache.vertices;
+	const u32 pitch = vSize[VertexCache.vType].Pitch;
+	u32 i;
+
+#if defined ( SOFTWARE_DRIVER_2_SSE2 )
+	// gather the positions, pad the last register with the first vertex
+	SVertexBlock block;
+	for ( i = 0; i != count; ++i )
+	{
+		const S3DVertex *base = (const S3DVertex*) ( vertices + ( sourceIndex[i] * pitch ) );
+		block.x[i] = base->Pos.X;
+		block.y[i] = base->Pos.Y;
+		block.z[i] = base->Pos.Z;
+	}
+	for ( ; i & 3; ++i )
+	{
+		block.x[i] = block.x[0];
+		block.y[i] = block.y[0];
+		block.z[i] = block.z[0];
+	}
+
+	transformBlock_SSE2 ( block, count, Transformation [ ETS_CURRENT ].pointer(), Transformation [ ETS_CLIPSCALE ].pointer() );
+#endif
+
+	for ( i = 0; i != count; ++i )
+	{
+		const S3DVertex *base = (const S3DVertex*) ( vertices + ( sourceIndex[i] * pitch ) );
+
+		// store info
+		VertexCache.info[ destIndex[i] ].index = sourceIndex[i];
+		VertexCache.info[ destIndex[i] ].hit = 0;
+
+		// destination Vertex
+		s4DVertex *dest = (s4DVertex *) ( (u8*) VertexCache.mem.data + ( destIndex[i] << ( SIZEOF_SVERTEX_LOG2 + 1  ) ) );
+
+#if defined ( SOFTWARE_DRIVER_2_SSE2 )
+		dest->Pos.x = block.x[i];
+		dest->Pos.y = block.y[i];
+		dest->Pos.z = block.z[i];
+		dest->Pos.w = block.w[i];
+#else
+		// transform Model * World * Camera * Projection * NDCSpace matrix
+		Transformation [ ETS_CURRENT].transformVect ( &dest->Pos.x, base->Pos );
+#endif
 
-	source = (u8*) VertexCache.vertices + ( sourceIndex * vSize[VertexCache.vType].Pitch );
+		VertexCache_fillAttributes ( base, dest );
 
-	// it's a look ahead so we never hit it..
-	// but give priority...
-	//VertexCache.info[ destIndex ].hit = hitCount;
+		dest[0].flag = dest[1].flag = vSize[VertexCache.vType].Format;
 
-	// store info
-	VertexCache.info[ destIndex ].index = sourceIndex;
-	VertexCache.info[ destIndex ].hit = 0;
+#if defined ( SOFTWARE_DRIVER_2_SSE2 )
+		dest[0].flag |= block.clip[i];
 
-	// destination Vertex
-	dest = (s4DVertex *) ( (u8*) VertexCache.mem.data + ( destIndex << ( SIZEOF_SVERTEX_LOG2 + 1  ) ) );
+		// to DC Space, already projected in the block
+		if ( (dest[0].flag & VERTEX4D_CLIPMASK ) == VERTEX4D_INSIDE )
+		{
+			const f32 iw = block.iw[i];
 
-	// transform Model * World * Camera * Projection * NDCSpace matrix
-	const S3DVertex *base = ((S3DVertex*) source );
-	Transformation [ ETS_CURRENT].transformVect ( &dest->Pos.x, base->Pos );
+			dest[1].flag = dest[0].flag | VERTEX4D_PROJECTED;
+			dest[1].Pos.x = block.dcx[i];
+			dest[1].Pos.y = block.dcy[i];
+	#ifndef SOFTWARE_DRIVER_2_USE_WBUFFER
+			dest[1].Pos.z = block.dcz[i];
+	#endif
+
+		#ifdef SOFTWARE_DRIVER_2_USE_VERTEX_COLOR
+			#ifdef SOFTWARE_DRIVER_2_PERSPECTIVE_CORRECT
+				dest[1].Color[0] = dest[0].Color[0] * iw;
+			#else
+				dest[1].Color[0] = dest[0].Color[0];
+			#endif
+		#endif
+
+			dest[1].LightTangent[0] = dest[0].LightTangent[0] * iw;
+			dest[1].Pos.w = iw;
+		}
+#else
+		// test vertex
+		dest[0].flag |= clipToFrustumTest ( dest);
+
+		// to DC Space, project homogenous vertex
+		if ( (dest[0].flag & VERTEX4D_CLIPMASK ) == VERTEX4D_INSIDE )
+		{
+			ndc_2_dc_and_project2 ( (const s4DVertex**) &dest, 1 );
+		}
+#endif
+	}
+}
+
+
+/*!
+	light and texture coordinates of a cache line
+*/
+void CBurningVideoDriver::VertexCache_fillAttributes ( const S3DVertex *base, s4DVertex *dest )
+{
+	if ( VertexCache.vType == 4 )
+		return;
 
-	//mhm ;-) maybe no goto
-	if ( VertexCache.vType == 4 ) goto clipandproject;
 
 
 #if defined (SOFTWARE_DRIVER_2_LIGHTING) || defined ( SOFTWARE_DRIVER_2_TEXTURE_TRANSFORM )
@@ -1062,7 +1410,7 @@ void CBurningVideoDriver::VertexCache_fill(const u32 sourceIndex, const u32 dest
 	// tangent space light vector, emboss
 	if ( Lights.size () && ( vSize[VertexCache.vType].Format & VERTEX4D_FORMAT_BUMP_DOT3 ) )
 	{
-		const S3DVertexTangents *tangent = ((S3DVertexTangents*) source );
+		const S3DVertexTangents *tangent = ((const S3DVertexTangents*) base );
 		const SBurningShaderLight &light = LightSpace.Light[0];
 
 		sVec4 vp;
@@ -1092,7 +1440,7 @@ void CBurningVideoDriver::VertexCache_fill(const u32 sourceIndex, const u32 dest
 
 	if ( LightSpace.Light.size () && ( vSize[VertexCache.vType].Format & VERTEX4D_FORMAT_BUMP_DOT3 ) )
 	{
-		const S3DVertexTangents *tangent = ((S3DVertexTangents*) source );
+		const S3DVertexTangents *tangent = ((const S3DVertexTangents*) base );
 
 		sVec4 vp;
 
@@ -1156,20 +1504,6 @@ void CBurningVideoDriver::VertexCache_fill(const u32 sourceIndex, const u32 dest
 
 
 #endif
-
-clipandproject:
-	dest[0].flag = dest[1].flag = vSize[VertexCache.vType].Format;
-
-	// test vertex
-	dest[0].flag |= clipToFrustumTest ( dest);
-
-	// to DC Space, project homogenous vertex
-	if ( (dest[0].flag & VERTEX4D_CLIPMASK ) == VERTEX4D_INSIDE )
-	{
-		ndc_2_dc_and_project2 ( (const s4DVertex**) &dest, 1 );
-	}
-
-	//return dest;
 }
 
 //
@@ -1268,7 +1602,11 @@ REALINLINE void CBurningVideoDriver::VertexCache_get(const s4DVertex ** face)
 			}
 		}
 
-		// fill new
+		// fill new, collect the missing vertices and process them as one block
+		u32 fillSource[VERTEXCACHE_ELEMENT];
+		u32 fillDest[VERTEXCACHE_ELEMENT];
+		u32 fillCount = 0;
+
 		for ( i = 0; i!= fillIndex; ++i )
 		{
 			if ( info[i].hit != VERTEXCACHE_MISS )
@@ -1278,13 +1616,17 @@ REALINLINE void CBurningVideoDriver::VertexCache_get(const s4DVertex ** face)
 			{
 				if ( 0 == VertexCache.info[dIndex].hit )
 				{
-					VertexCache_fill ( info[i].index, dIndex );
+					fillSource[fillCount] = info[i].index;
+					fillDest[fillCount] = dIndex;
+					fillCount += 1;
 					VertexCache.info[dIndex].hit += 1;
 					info[i].hit = dIndex;
 					break;
 				}
 			}
 		}
+
+		VertexCache_fill ( fillSource, fillDest, fillCount );
 	}
 
 	const u32 i0 = core::if_c_a_else_0 ( VertexCache.pType != scene::EPT_TRIANGLE_FAN, VertexCache.indicesRun );
@@ -1327,22 +1669,26 @@ REALINLINE void CBurningVideoDriver::VertexCache_get(const s4DVertex ** face)
 REALINLINE void CBurningVideoDriver::VertexCache_getbypass ( s4DVertex ** face )
 {
 	const u32 i0 = core::if_c_a_else_0 ( VertexCache.pType != scene::EPT_TRIANGLE_FAN, VertexCache.indicesRun );
+	static const u32 destIndex[3] = { 0, 1, 2 };
+	u32 sourceIndex[3];
 
 	if ( VertexCache.iType == 1 )
 	{
 		const u16 *p = (const u16 *) VertexCache.indices;
-		VertexCache_fill ( p[ i0    ], 0 );
-		VertexCache_fill ( p[ VertexCache.indicesRun + 1], 1 );
-		VertexCache_fill ( p[ VertexCache.indicesRun + 2], 2 );
+		sourceIndex[0] = p[ i0    ];
+		sourceIndex[1] = p[ VertexCache.indicesRun + 1];
+		sourceIndex[2] = p[ VertexCache.indicesRun + 2];
 	}
 	else
 	{
 		const u32 *p = (const u32 *) VertexCache.indices;
-		VertexCache_fill ( p[ i0    ], 0 );
-		VertexCache_fill ( p[ VertexCache.indicesRun + 1], 1 );
-		VertexCache_fill ( p[ VertexCache.indicesRun + 2], 2 );
+		sourceIndex[0] = p[ i0    ];
+		sourceIndex[1] = p[ VertexCache.indicesRun + 1];
+		sourceIndex[2] = p[ VertexCache.indicesRun + 2];
 	}
 
+	VertexCache_fill ( sourceIndex, destIndex, 3 );
+
 	VertexCache.indicesRun += VertexCache.primitivePitch;
 
 	face[0] = (s4DVertex *) ( (u8*) VertexCache.mem.data + ( 0 << ( SIZEOF_SVERTEX_LOG2 + 1  ) ) );
@@ -1457,6 +1803,36 @@ void CBurningVideoDriver::drawVertexPrimitiveList(const void* vertices, u32 vert
 
 	VertexCache_reset ( vertices, vertexCount, indexList, primitiveCount, vType, pType, iType );
 
+	// large lists are drawn on all threads after the vertices are processed,
+	// not for renderers bound outside of setCurrentShader (stencil shadows)
+	RecordBands = BandSlots > 1 && primitiveCount >= SOFTWARE_DRIVER_2_BAND_MIN_PRIMITIVES &&
+		CurrentShader == BurningShader[CurrentShaderType];
+	if (RecordBands)
+	{
+		const u32 bands = (RenderTargetSize.Height + SOFTWARE_DRIVER_2_BAND_HEIGHT - 1) / SOFTWARE_DRIVER_2_BAND_HEIGHT;
+		while (BandBins.size() < bands)
+			BandBins.push_back(core::array<u32>());
+	}
+
+#ifdef SOFTWARE_DRIVER_2_HIERARCHICAL_Z
+	// skip triangles behind the w-buffer content, only for renderers which test against it
+	DepthReject = DepthBuffer && CurrentShader == BurningShader[CurrentShaderType];
+	switch ( CurrentShaderType )
+	{
+		case ETR_TEXTURE_GOURAUD_NOZ:
+		case ETR_GOURAUD_ALPHA_NOZ:
+		case ETR_STENCIL_SHADOW:
+		case ETR_REFERENCE:
+			DepthReject = false;
+			break;
+		default:
+			break;
+	}
+
+	if ( DepthReject )
+		((CDepthBuffer*) DepthBuffer)->updateBlocks();
+#endif
+
 	const s4DVertex * face[3];
 
 	f32 dc_area;
@@ -1502,7 +1878,7 @@ void CBurningVideoDriver::drawVertexPrimitiveList(const void* vertices, u32 vert
 			}
 
 			// rasterize
-			CurrentShader->drawTriangle ( face[0] + 1, face[1] + 1, face[2] + 1 );
+			drawTriangle ( face[0] + 1, face[1] + 1, face[2] + 1 );
 			continue;
 		}
 
@@ -1556,13 +1932,16 @@ void CBurningVideoDriver::drawVertexPrimitiveList(const void* vertices, u32 vert
 		for ( g = 0; g <= vOut - 6; g += 2 )
 		{
 			// rasterize
-			CurrentShader->drawTriangle ( CurrentOut.data + 0 + 1,
+			drawTriangle ( CurrentOut.data + 0 + 1,
 							CurrentOut.data + g + 3,
 							CurrentOut.data + g + 5);
 		}
 
 	}
 
+	if ( RecordBands )
+		flushBands ();
+
 	// dump statistics
 /*
 	char buf [64];
@@ -1576,6 +1955,24 @@ void CBurningVideoDriver::drawVertexPrimitiveList(const void* vertices, u32 vert
 }
 
 
+//! Draws many instances of a mesh buffer, one after another
+void CBurningVideoDriver::drawMeshBufferInstances(const scene::IMeshBuffer* mb,
+		const core::matrix4* transformations, const SColor* colors, u32 instanceCount)
+{
+	if (!mb)
+		return;
+
+	// the driver has no hardware buffers, so the calls are bound directly
+	for (u32 i=0; i<instanceCount; ++i)
+	{
+		CBurningVideoDriver::setTransform(ETS_WORLD, transformations[i]);
+		CBurningVideoDriver::drawVertexPrimitiveList(mb->getVertices(), mb->getVertexCount(),
+			mb->getIndices(), mb->getPrimitiveCount(), mb->getVertexType(),
+			mb->getPrimitiveType(), mb->getIndexType());
+	}
+}
+
+
 //! Sets the dynamic ambient light color. The default color is
 //! (0,0,0,0) which means it is dark.
 //! \param color: New color of the ambient light.
@@ -2221,7 +2618,7 @@ ITexture* CBurningVideoDriver::addRenderTargetTexture(const core::dimension2d<u3
 		const io::path& name, const ECOLOR_FORMAT format)
 {
 	IImage* img = createImage(BURNINGSHADER_COLOR_FORMAT, size);
-	ITexture* tex = new CSoftwareTexture2(img, name, CSoftwareTexture2::IS_RENDERTARGET );
+	ITexture* tex = new CSoftwareTexture2(img, name, CSoftwareTexture2::IS_RENDERTARGET, this );
 	img->drop();
 	addTexture(tex);
 	tex->drop();
@@ -2260,12 +2657,19 @@ IImage* CBurningVideoDriver::createScreenShot(video::ECOLOR_FORMAT format, video
 ITexture* CBurningVideoDriver::createDeviceDependentTexture(const io::path& name, IImage* image)
 {
 	CSoftwareTexture2* texture = new CSoftwareTexture2(image, name, (getTextureCreationFlag(ETCF_CREATE_MIP_MAPS) ? CSoftwareTexture2::GEN_MIPMAP : 0) |
-		(getTextureCreationFlag(ETCF_ALLOW_NON_POWER_2) ? 0 : CSoftwareTexture2::NP2_SIZE));
+		(getTextureCreationFlag(ETCF_ALLOW_NON_POWER_2) ? 0 : CSoftwareTexture2::NP2_SIZE), this);
 
 	return texture;
 }
 
 
+bool CBurningVideoDriver::swapDeviceDependentTexture(ITexture* placeholder, ITexture* texture)
+{
+	static_cast<CSoftwareTexture2*>(placeholder)->swap(static_cast<CSoftwareTexture2*>(texture));
+	return true;
+}
+
+
 //! Returns the maximum amount of primitives (mostly vertices) which
 //! the device is able to render with one drawIndexedTriangleList
 //! call.
@@ -2335,6 +2739,130 @@ void CBurningVideoDriver::drawStencilShadowVolume(const core::array<core::vector
 	}
 }
 
+//! returns true if the box is behind the depth buffer content, current transformation
+bool CBurningVideoDriver::isHiddenBox(const core::aabbox3df& box) const
+{
+#ifdef SOFTWARE_DRIVER_2_HIERARCHICAL_Z
+	core::vector3df edges[8];
+	box.getEdges(edges);
+
+	const f32* p = Transformation [ ETS_CLIPSCALE ].pointer();
+	f32 x0 = FLT_MAX, y0 = FLT_MAX, x1 = -FLT_MAX, y1 = -FLT_MAX;
+	f32 w = 0.f;
+
+	for ( u32 i = 0; i != 8; ++i )
+	{
+		sVec4 v;
+		Transformation [ ETS_CURRENT ].transformVect ( &v.x, edges[i] );
+
+		// in front of the near plane, the box may cover everything
+		if ( v.w <= 0.f || -v.z > v.w )
+			return false;
+
+		// to device coordinates
+		const f32 iw = core::reciprocal ( v.w );
+		const f32 x = iw * ( v.x * p[ 0] + v.w * p[12] );
+		const f32 y = iw * ( v.y * p[ 5] + v.w * p[13] );
+
+		x0 = core::min_ ( x0, x );
+		y0 = core::min_ ( y0, y );
+		x1 = core::max_ ( x1, x );
+		y1 = core::max_ ( y1, y );
+		w = core::max_ ( w, iw );
+	}
+
+	// completely outside the screen is left to the clipper
+	const core::rect<s32> area ( core::floor32 ( x0 ), core::floor32 ( y0 ),
+								core::ceil32 ( x1 ) + 1, core::ceil32 ( y1 ) + 1 );
+
+	CDepthBuffer* depth = (CDepthBuffer*) DepthBuffer;
+	depth->updateBlocks();
+	return depth->isHidden ( area, w * ( 1.f + 1.f / 1024.f ) );
+#else
+	return false;
+#endif
+}
+
+
+//! Run occlusion query. Counts the pixels of the mesh stored in query.
+/** Nothing is written to the color or depth buffer. The count is taken
+against the depth buffer before the mesh is drawn, so the mesh does not
+occlude itself and the result may be larger than the visible pixels.
+If the mesh shall be rendered visible, it is drawn afterwards. */
+void CBurningVideoDriver::runOcclusionQuery(scene::ISceneNode* node, bool visible)
+{
+	if (!node || !DepthBuffer)
+		return;
+
+	const s32 index = OcclusionQueries.linear_search(SOccQuery(node));
+	if (index == -1)
+		return;
+
+	OcclusionQueries[index].Run = 0;
+
+	SMaterial mat;
+	mat.Lighting = false;
+	mat.ZWriteEnable = false;
+	setMaterial(mat);
+	setTransform(video::ETS_WORLD, node->getAbsoluteTransformation());
+
+	const scene::IMesh* mesh = OcclusionQueries[index].Mesh;
+	u32 samples = 0;
+
+	// a mesh behind the coarse depth blocks needs no rasterization
+	if (!isHiddenBox(mesh->getBoundingBox()))
+	{
+		IBurningShader* shader = BurningShader[ETR_OCCLUSION_QUERY];
+		shader->setRenderTarget(RenderTargetSurface, ViewPort);
+		shader->setSampleCounter(&samples);
+
+		CurrentShader = shader;
+		for (u32 i=0; i<mesh->getMeshBufferCount(); ++i)
+			drawMeshBuffer(mesh->getMeshBuffer(i));
+
+		// the query shader is not bound again by setRenderTargetImage,
+		// don't keep the render target alive
+		shader->setSampleCounter(0);
+		shader->setRenderTarget(0, ViewPort);
+		setCurrentShader();
+	}
+
+	// there is no hardware query, keep the count until the update
+	OcclusionQueries[index].PendingResult = samples;
+
+	if (visible)
+		CNullDriver::runOcclusionQuery(node, true);
+}
+
+
+//! Update occlusion query. Results are available right after the run.
+void CBurningVideoDriver::updateOcclusionQuery(scene::ISceneNode* node, bool block)
+{
+	const s32 index = OcclusionQueries.linear_search(SOccQuery(node));
+	if (index != -1)
+	{
+		// not yet started
+		if (OcclusionQueries[index].Run==u32(~0))
+			return;
+		OcclusionQueries[index].Result = OcclusionQueries[index].PendingResult;
+	}
+}
+
+
+//! Return query result.
+/** Return value is the number of visible pixels/fragments.
+The value is a safe approximation, i.e. can be larger than the
+actual value of pixels. */
+u32 CBurningVideoDriver::getOcclusionQueryResult(scene::ISceneNode* node) const
+{
+	const s32 index = OcclusionQueries.linear_search(SOccQuery(node));
+	if (index != -1)
+		return OcclusionQueries[index].Result;
+	else
+		return ~0;
+}
+
+
 //! Fills the stencil shadow with color. After the shadow volume has been drawn
 //! into the stencil buffer using IVideoDriver::drawStencilShadowVolume(), use this
 //! to draw the color of the shadow.
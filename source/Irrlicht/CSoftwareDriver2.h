@@ -83,6 +83,10 @@ namespace video
 				const void* indexList, u32 primitiveCount,
 				E_VERTEX_TYPE vType, scene::E_PRIMITIVE_TYPE pType, E_INDEX_TYPE iType) _IRR_OVERRIDE_;
 
+		//! Draws many instances of a mesh buffer, one after another
+		virtual void drawMeshBufferInstances(const scene::IMeshBuffer* mb,
+			const core::matrix4* transformations, const SColor* colors, u32 instanceCount) _IRR_OVERRIDE_;
+
 		//! draws an 2d image, using a color (if color is other then Color(255,255,255,255)) and the alpha channel of the texture if wanted.
 		virtual void draw2DImage(const video::ITexture* texture, const core::position2d<s32>& destPos,
 			const core::rect<s32>& sourceRect, const core::rect<s32>* clipRect = 0,
@@ -155,6 +159,15 @@ namespace video
 			video::SColor leftDownEdge = video::SColor(0,0,0,0),
 			video::SColor rightDownEdge = video::SColor(0,0,0,0)) _IRR_OVERRIDE_;
 
+		//! Run occlusion query. Counts the pixels of the mesh stored in query.
+		virtual void runOcclusionQuery(scene::ISceneNode* node, bool visible=false) _IRR_OVERRIDE_;
+
+		//! Update occlusion query. Results are available right after the run.
+		virtual void updateOcclusionQuery(scene::ISceneNode* node, bool block=true) _IRR_OVERRIDE_;
+
+		//! Return query result.
+		virtual u32 getOcclusionQueryResult(scene::ISceneNode* node) const _IRR_OVERRIDE_;
+
 		//! Returns the graphics card vendor name.
 		virtual core::stringc getVendorInfo() _IRR_OVERRIDE_;
 
@@ -167,6 +180,17 @@ namespace video
 		IDepthBuffer * getDepthBuffer () { return DepthBuffer; }
 		IStencilBuffer * getStencilBuffer () { return StencilBuffer; }
 
+		//! Only used by the engine internally.
+		/** With worker threads large primitive lists are drawn in screen bands on all threads. */
+		virtual void setJobPool(CJobPool* pool) _IRR_OVERRIDE_;
+
+		//! Only used by the engine internally.
+		io::IFileSystem* getFileSystem() const { return FileSystem; }
+
+		//! Only used by the engine internally.
+		/** Directory of the mipmap cache, empty if disabled. */
+		const io::path& getMipMapCachePath() const { return MipMapCachePath; }
+
 	protected:
 
 		//! sets a render target
@@ -177,6 +201,8 @@ namespace video
 
 		virtual ITexture* createDeviceDependentTexture(const io::path& name, IImage* image) _IRR_OVERRIDE_;
 
+		virtual bool swapDeviceDependentTexture(ITexture* placeholder, ITexture* texture) _IRR_OVERRIDE_;
+
 		video::CImage* BackBuffer;
 		video::IImagePresenter* Presenter;
 
@@ -190,12 +216,55 @@ namespace video
 		//! selects the right triangle renderer based on the render states.
 		void setCurrentShader();
 
+		//! creates the triangle renderers for all EBurningFFShader types
+		void createShaders(IBurningShader** shader);
+
+		//! applies the current render states to a triangle renderer of type CurrentShaderType
+		void bindShader(IBurningShader* shader);
+
 		IBurningShader* CurrentShader;
 		IBurningShader* BurningShader[ETR2_COUNT];
+		EBurningFFShader CurrentShaderType;
+
+		// screen band rendering on worker threads
+		struct SBandTriangle
+		{
+			s4DVertex v[3];
+			sInternalTexture IT[BURNING_MATERIAL_MAX_TEXTURES];
+			s32 yStart;
+			s32 yEnd;
+		};
+
+		//! draws a triangle with the current shader or records it for the screen bands
+		void drawTriangle(const s4DVertex* a, const s4DVertex* b, const s4DVertex* c);
+
+		//! draws the recorded triangles in screen bands on all threads
+		void flushBands();
+
+		//! draws every band slot-th screen band, called from the job pool
+		static void drawBands(void* driver, u32 slot);
+
+		core::array<SBandTriangle> BandTriangles;
+		//! indices of the recorded triangles overlapping each screen band, in draw order
+		core::array<core::array<u32> > BandBins;
+		//! one set of triangle renderers per band slot
+		core::array<IBurningShader*> BandShader;
+		u32 BandSlots;
+		bool RecordBands;
+
+		//! returns true if the box is behind the depth buffer content, current transformation
+		bool isHiddenBox(const core::aabbox3df& box) const;
+
+		// hierarchical depth test of whole triangles
+		bool DepthReject;
+		u32 DepthRejectedTriangles;
+		u32 DepthRejectedPixels;
 
 		IDepthBuffer* DepthBuffer;
 		IStencilBuffer* StencilBuffer;
 
+		io::path MipMapCachePath;
+
 
 		/*
 			extend Matrix Stack
@@ -239,7 +308,8 @@ namespace video
 		void VertexCache_get ( const s4DVertex ** face );
 		void VertexCache_getbypass ( s4DVertex ** face );
 
-		void VertexCache_fill ( const u32 sourceIndex,const u32 destIndex );
+		void VertexCache_fill ( const u32 *sourceIndex, const u32 *destIndex, const u32 count );
+		void VertexCache_fillAttributes ( const S3DVertex *base, s4DVertex *dest );
 		s4DVertex * VertexCache_getVertex ( const u32 sourceIndex );
 
 
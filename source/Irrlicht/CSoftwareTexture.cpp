@@ -113,6 +113,15 @@ void CSoftwareTexture::regenerateMipMapLevels(void* data, u32 layer)
 }
 
 
+//! swaps the surfaces and properties with another texture, keeps the name
+void CSoftwareTexture::swap(CSoftwareTexture* other)
+{
+	swapProperties(*other);
+	core::swap(Image, other->Image);
+	core::swap(Texture, other->Texture);
+}
+
+
 /* Software Render Target */
 
 CSoftwareRenderTarget::CSoftwareRenderTarget(CSoftwareDriver* driver) : Driver(driver)
@@ -43,6 +43,9 @@ public:
 
 	virtual void regenerateMipMapLevels(void* data = 0, u32 layer = 0) _IRR_OVERRIDE_;
 
+	//! swaps the surfaces and properties with another texture, keeps the name
+	void swap(CSoftwareTexture* other);
+
 private:
 	CImage* Image;
 	CImage* Texture;
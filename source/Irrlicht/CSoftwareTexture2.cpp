@@ -9,16 +9,260 @@
 #include "SoftwareDriver2_helper.h"
 #include "CSoftwareTexture2.h"
 #include "CSoftwareDriver2.h"
+#include "CJobPool.h"
+#include "IReadFile.h"
+#include "IWriteFile.h"
 #include "os.h"
 
+#if defined ( SOFTWARE_DRIVER_2_32BIT ) && defined ( SOFTWARE_DRIVER_2_SSE2 )
+	#include <emmintrin.h>
+#endif
+
 namespace irr
 {
 namespace video
 {
 
+#ifdef SOFTWARE_DRIVER_2_32BIT
+
+// the levels are the block sums of level 0 divided by the block size, like
+// copyToScalingBoxFilter computes them. each level keeps four channel sums
+// per pixel, the next level adds them up 2x2.
+struct SMipMapSums
+{
+	const CImage* Source;
+	//! channel sums of the source, 0 if the source is level 0
+	const u32* SourceSums;
+	CImage* Target;
+	u32* TargetSums;
+	//! log2 of the number of level 0 pixels summed per target pixel
+	u32 Shift;
+	u32 BandHeight;
+};
+
+//! sums up the rows [yStart, yEnd) of the target level from the source level
+/** Each source dimension is halved, or it's 1 and stays. */
+static void sumMipMapRows(const SMipMapSums* s, u32 yStart, u32 yEnd)
+{
+	const core::dimension2d<u32>& sourceSize = s->Source->getDimension();
+	const u32 width = s->Target->getDimension().Width;
+	const u32 sourcePitch = s->Source->getPitch();
+	const u32 nextColumn = sourceSize.Width > 1 ? 1 : 0;
+	const u32 nextRow = sourceSize.Height > 1 ? 1 : 0;
+	const u32 shift = s->Shift;
+
+	for (u32 y = yStart; y < yEnd; ++y)
+	{
+		const u32 sy = y << nextRow;
+		u32* dst = (u32*) ((u8*) s->Target->getData() + y * s->Target->getPitch());
+		u32* sum = s->TargetSums + 4 * y * width;
+
+		u32 x = 0;
+#ifdef SOFTWARE_DRIVER_2_SSE2
+		if (nextColumn && nextRow)
+		{
+			const __m128i zero = _mm_setzero_si128();
+			const __m128i count = _mm_cvtsi32_si128(shift);
+			if (!s->SourceSums)
+			{
+				const u32* row0 = (const u32*) ((const u8*) s->Source->getData() + sy * sourcePitch);
+				const u32* row1 = (const u32*) ((const u8*) row0 + sourcePitch);
+				for (; x + 2 <= width; x += 2)
+				{
+					const __m128i a = _mm_loadu_si128((const __m128i*) (row0 + 2 * x));
+					const __m128i b = _mm_loadu_si128((const __m128i*) (row1 + 2 * x));
+
+					// vertical sums of source pixels 0,1 | 2,3 as 16 bit
+					const __m128i s01 = _mm_add_epi16(_mm_unpacklo_epi8(a, zero), _mm_unpacklo_epi8(b, zero));
+					const __m128i s23 = _mm_add_epi16(_mm_unpackhi_epi8(a, zero), _mm_unpackhi_epi8(b, zero));
+
+					// horizontal sums give target pixels 0 and 1
+					const __m128i t = _mm_add_epi16(_mm_unpacklo_epi64(s01, s23), _mm_unpackhi_epi64(s01, s23));
+					_mm_storeu_si128((__m128i*) (sum + 4 * x), _mm_unpacklo_epi16(t, zero));
+					_mm_storeu_si128((__m128i*) (sum + 4 * x + 4), _mm_unpackhi_epi16(t, zero));
+
+					const __m128i p = _mm_srl_epi16(t, count);
+					_mm_storel_epi64((__m128i*) (dst + x), _mm_packus_epi16(p, p));
+				}
+			}
+			else
+			{
+				const u32* row0 = s->SourceSums + 4 * sy * sourceSize.Width;
+				const u32* row1 = row0 + 4 * sourceSize.Width;
+				for (; x < width; ++x)
+				{
+					const __m128i t = _mm_add_epi32(
+						_mm_add_epi32(_mm_loadu_si128((const __m128i*) (row0 + 8 * x)), _mm_loadu_si128((const __m128i*) (row0 + 8 * x + 4))),
+						_mm_add_epi32(_mm_loadu_si128((const __m128i*) (row1 + 8 * x)), _mm_loadu_si128((const __m128i*) (row1 + 8 * x + 4))));
+					_mm_storeu_si128((__m128i*) (sum + 4 * x), t);
+
+					// the channels fit into 8 bit after the shift
+					__m128i p = _mm_srl_epi32(t, count);
+					p = _mm_packs_epi32(p, p);
+					dst[x] = (u32) _mm_cvtsi128_si32(_mm_packus_epi16(p, p));
+				}
+			}
+		}
+#endif
+		for (; x < width; ++x)
+		{
+			const u32 sx = x << nextColumn;
+			u32 block[4] = { 0, 0, 0, 0 };
+			for (u32 dy = 0; dy <= nextRow; ++dy)
+			{
+				for (u32 dx = 0; dx <= nextColumn; ++dx)
+				{
+					if (s->SourceSums)
+					{
+						const u32* p = s->SourceSums + 4 * ((sy + dy) * sourceSize.Width + sx + dx);
+						for (u32 c = 0; c != 4; ++c)
+							block[c] += p[c];
+					}
+					else
+					{
+						const u32 p = ((const u32*) ((const u8*) s->Source->getData() + (sy + dy) * sourcePitch))[sx + dx];
+						for (u32 c = 0; c != 4; ++c)
+							block[c] += (p >> (8 * c)) & 0xFF;
+					}
+				}
+			}
+
+			u32 pixel = 0;
+			for (u32 c = 0; c != 4; ++c)
+			{
+				sum[4 * x + c] = block[c];
+				pixel |= (block[c] >> shift) << (8 * c);
+			}
+			dst[x] = pixel;
+		}
+	}
+}
+
+//! job pool function, sums up one band of rows
+static void sumMipMapBand(void* data, u32 index)
+{
+	const SMipMapSums* s = (const SMipMapSums*) data;
+	const u32 height = s->Target->getDimension().Height;
+	const u32 yStart = index * s->BandHeight;
+	sumMipMapRows(s, yStart, core::min_(yStart + s->BandHeight, height));
+}
+
+#endif // SOFTWARE_DRIVER_2_32BIT
+
+
+//! builds the mipmap levels 1 to SOFTWARE_DRIVER_2_MIPMAPPING_MAX-1 from level 0
+/** The levels are the same as box filtering level 0 for each of them. As long
+as each level halves the previous one, they are summed up from the previous
+level in row bands on the job pool. Other reductions, and the levels after
+them, go through the generic box filter. */
+static void generateMipMapLevels(CImage* const* mipMap, CJobPool* pool)
+{
+	s32 i = 1;
+
+#ifdef SOFTWARE_DRIVER_2_32BIT
+	core::array<u32> sums[2];
+
+	SMipMapSums s;
+	s.SourceSums = 0;
+	s.Shift = 0;
+
+	for (; i < SOFTWARE_DRIVER_2_MIPMAPPING_MAX; ++i)
+	{
+		const core::dimension2d<u32>& sourceSize = mipMap[i-1]->getDimension();
+		const core::dimension2d<u32>& targetSize = mipMap[i]->getDimension();
+		const bool halfWidth = targetSize.Width * 2 == sourceSize.Width;
+		const bool halfHeight = targetSize.Height * 2 == sourceSize.Height;
+		if ((!halfWidth && sourceSize.Width != 1) || (!halfHeight && sourceSize.Height != 1))
+			break;
+
+		// the sums of 8 bit channels have to fit into 32 bit
+		const u32 shift = s.Shift + (halfWidth ? 1 : 0) + (halfHeight ? 1 : 0);
+		if (shift > 24)
+			break;
+
+		sums[i & 1].set_used(4 * targetSize.getArea());
+
+		s.Source = mipMap[i-1];
+		s.Target = mipMap[i];
+		s.TargetSums = sums[i & 1].pointer();
+		s.Shift = shift;
+		s.BandHeight = core::max_(16384u / targetSize.Width, 1u);
+
+		const u32 count = (targetSize.Height + s.BandHeight - 1) / s.BandHeight;
+		if (pool && count > 1)
+			pool->parallelFor(sumMipMapBand, &s, count);
+		else
+			sumMipMapRows(&s, 0, targetSize.Height);
+
+		s.SourceSums = s.TargetSums;
+	}
+#endif
+
+	for (; i < SOFTWARE_DRIVER_2_MIPMAPPING_MAX; ++i)
+	{
+		mipMap[i]->fill(0);
+		mipMap[0]->copyToScalingBoxFilter(mipMap[i], 0, false);
+	}
+}
+
+
+//! 64 bit FNV-1a style hash of the image content
+/** Works on 64 bit words in four interleaved lanes, so the multiplications
+don't wait for each other. */
+static u64 getImageHash(const CImage* image)
+{
+	const u64 prime = 1099511628211ULL;
+	u64 lane[4];
+	for (u32 l = 0; l != 4; ++l)
+		lane[l] = 14695981039346656037ULL + l;
+
+	const u8* data = (const u8*) image->getData();
+	const u32 bytes = image->getImageDataSizeInBytes();
+
+	u32 i = 0;
+	for (; i + 32 <= bytes; i += 32)
+	{
+		u64 word[4];
+		memcpy(word, data + i, 32);
+		lane[0] = (lane[0] ^ word[0]) * prime;
+		lane[1] = (lane[1] ^ word[1]) * prime;
+		lane[2] = (lane[2] ^ word[2]) * prime;
+		lane[3] = (lane[3] ^ word[3]) * prime;
+	}
+
+	u64 hash = lane[0];
+	for (u32 l = 1; l != 4; ++l)
+		hash = (hash ^ lane[l]) * prime;
+	for (; i != bytes; ++i)
+		hash = (hash ^ data[i]) * prime;
+
+	const core::dimension2d<u32>& size = image->getDimension();
+	hash = (hash ^ size.Width) * prime;
+	hash = (hash ^ size.Height) * prime;
+	hash = (hash ^ (u32) image->getColorFormat()) * prime;
+
+	return hash;
+}
+
+
+// header of a mipmap cache file, the levels 1 to Levels-1 follow
+struct SMipMapCacheHeader
+{
+	u32 Magic;
+	u32 Format;
+	u32 Width;
+	u32 Height;
+	u32 Levels;
+	u32 HashLow;
+	u32 HashHigh;
+};
+
+static const u32 MIPMAP_CACHE_MAGIC = 0x3250494D; // "MIP2"
+
+
 //! constructor
-CSoftwareTexture2::CSoftwareTexture2(IImage* image, const io::path& name, u32 flags)
-	: ITexture(name, ETT_2D), MipMapLOD(0), Flags ( flags ), OriginalFormat(video::ECF_UNKNOWN)
+CSoftwareTexture2::CSoftwareTexture2(IImage* image, const io::path& name, u32 flags, CBurningVideoDriver* driver)
+	: ITexture(name, ETT_2D), Driver(driver), MipMapLOD(0), Flags ( flags ), OriginalFormat(video::ECF_UNKNOWN)
 {
 	#ifdef _DEBUG
 	setDebugName("CSoftwareTexture2");
@@ -84,7 +328,24 @@ CSoftwareTexture2::CSoftwareTexture2(IImage* image, const io::path& name, u32 fl
 
 		HasMipMaps = (Flags & GEN_MIPMAP) != 0;
 
+		// generated levels can come from the cache
+		const bool useCache = HasMipMaps && !IsCompressed && !image->getMipMapsData() &&
+			Driver && Driver->getMipMapCachePath().size();
+
+		u64 hash = 0;
+		io::path cacheName;
+		if (useCache)
+		{
+			hash = getImageHash(MipMap[0]);
+			cacheName = getMipMapCacheName(hash);
+			if (readMipMapCache(cacheName, hash))
+				return;
+		}
+
 		regenerateMipMapLevels(image->getMipMapsData());
+
+		if (useCache)
+			writeMipMapCache(cacheName, hash);
 	}
 }
 
@@ -116,6 +377,9 @@ void CSoftwareTexture2::regenerateMipMapLevels(void* data, u32 layer)
 			MipMap[i]->drop();
 	}
 
+	CJobPool* pool = Driver ? Driver->getJobPool() : 0;
+	const bool generate = 0 == data;
+
 	core::dimension2d<u32> newSize;
 	core::dimension2d<u32> origSize = Size;
 
@@ -154,14 +418,116 @@ void CSoftwareTexture2::regenerateMipMapLevels(void* data, u32 layer)
 			data = (u8*)data +origSize.getArea()*IImage::getBitsPerPixelFromFormat(OriginalFormat)/8;
 		}
 		else
-		{
 			MipMap[i] = new CImage(BURNINGSHADER_COLOR_FORMAT, newSize);
+	}
+
+	if (generate)
+		generateMipMapLevels(MipMap, pool);
+}
+
 
-			//static u32 color[] = { 0, 0xFFFF0000, 0xFF00FF00,0xFF0000FF,0xFFFFFF00,0xFFFF00FF,0xFF00FFFF,0xFF0F0F0F };
-			MipMap[i]->fill ( 0 );
-			MipMap[0]->copyToScalingBoxFilter( MipMap[i], 0, false );
+//! swaps the mipmap levels and properties with another texture, keeps the name
+void CSoftwareTexture2::swap(CSoftwareTexture2* other)
+{
+	swapProperties(*other);
+
+	for ( s32 i = 0; i != SOFTWARE_DRIVER_2_MIPMAPPING_MAX; ++i )
+		core::swap(MipMap[i], other->MipMap[i]);
+
+	core::swap(OrigImageDataSizeInPixels, other->OrigImageDataSizeInPixels);
+	core::swap(MipMapLOD, other->MipMapLOD);
+	core::swap(Flags, other->Flags);
+	core::swap(OriginalFormat, other->OriginalFormat);
+}
+
+
+//! returns the name of the mipmap cache file for a content hash
+io::path CSoftwareTexture2::getMipMapCacheName(u64 hash) const
+{
+	c8 buf[32];
+	snprintf_irr(buf, 32, "%08x%08x.mip", (u32) (hash >> 32), (u32) hash);
+
+	io::path name = Driver->getMipMapCachePath();
+	if (name.lastChar() != '/' && name.lastChar() != '\\')
+		name += '/';
+	name += buf;
+	return name;
+}
+
+
+//! reads the mipmap levels from the cache file, returns false if it doesn't fit
+bool CSoftwareTexture2::readMipMapCache(const io::path& filename, u64 hash)
+{
+	io::IFileSystem* fileSystem = Driver->getFileSystem();
+	if (!fileSystem->existFile(filename))
+		return false;
+
+	io::IReadFile* file = fileSystem->createAndOpenFile(filename);
+	if (!file)
+		return false;
+
+	const core::dimension2d<u32>& size = MipMap[0]->getDimension();
+
+	SMipMapCacheHeader header;
+	bool valid = file->read(&header, sizeof(header)) == sizeof(header) &&
+		header.Magic == MIPMAP_CACHE_MAGIC &&
+		header.Format == (u32) BURNINGSHADER_COLOR_FORMAT &&
+		header.Width == size.Width && header.Height == size.Height &&
+		header.Levels == SOFTWARE_DRIVER_2_MIPMAPPING_MAX &&
+		header.HashLow == (u32) hash && header.HashHigh == (u32) (hash >> 32);
+
+	s32 i;
+	core::dimension2d<u32> newSize = size;
+	for (i = 1; valid && i < SOFTWARE_DRIVER_2_MIPMAPPING_MAX; ++i)
+	{
+		newSize.Width = core::s32_max ( 1, newSize.Width >> SOFTWARE_DRIVER_2_MIPMAPPING_SCALE );
+		newSize.Height = core::s32_max ( 1, newSize.Height >> SOFTWARE_DRIVER_2_MIPMAPPING_SCALE );
+
+		MipMap[i] = new CImage(BURNINGSHADER_COLOR_FORMAT, newSize);
+		const size_t bytes = MipMap[i]->getImageDataSizeInBytes();
+		valid = file->read(MipMap[i]->getData(), bytes) == bytes;
+	}
+	file->drop();
+
+	if (!valid)
+	{
+		for (i = 1; i < SOFTWARE_DRIVER_2_MIPMAPPING_MAX; ++i)
+		{
+			if (MipMap[i])
+				MipMap[i]->drop();
+			MipMap[i] = 0;
 		}
+		os::Printer::log("Ignoring outdated mipmap cache file", filename, ELL_INFORMATION);
+	}
+
+	return valid;
+}
+
+
+//! writes the mipmap levels to the cache file
+void CSoftwareTexture2::writeMipMapCache(const io::path& filename, u64 hash) const
+{
+	io::IWriteFile* file = Driver->getFileSystem()->createAndWriteFile(filename);
+	if (!file)
+	{
+		os::Printer::log("Could not write mipmap cache file", filename, ELL_WARNING);
+		return;
 	}
+
+	SMipMapCacheHeader header;
+	header.Magic = MIPMAP_CACHE_MAGIC;
+	header.Format = (u32) BURNINGSHADER_COLOR_FORMAT;
+	header.Width = MipMap[0]->getDimension().Width;
+	header.Height = MipMap[0]->getDimension().Height;
+	header.Levels = SOFTWARE_DRIVER_2_MIPMAPPING_MAX;
+	header.HashLow = (u32) hash;
+	header.HashHigh = (u32) (hash >> 32);
+
+	file->write(&header, sizeof(header));
+	for (s32 i = 1; i < SOFTWARE_DRIVER_2_MIPMAPPING_MAX; ++i)
+		file->write(MipMap[i]->getData(), MipMap[i]->getImageDataSizeInBytes());
+
+	file->drop();
 }
 
 
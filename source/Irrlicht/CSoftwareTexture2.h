@@ -32,7 +32,7 @@ public:
 		IS_RENDERTARGET	= 2,
 		NP2_SIZE	= 4,
 	};
-	CSoftwareTexture2(IImage* surface, const io::path& name, u32 flags);
+	CSoftwareTexture2(IImage* surface, const io::path& name, u32 flags, CBurningVideoDriver* driver = 0);
 
 	//! destructor
 	virtual ~CSoftwareTexture2();
@@ -82,7 +82,22 @@ public:
 
 	virtual void regenerateMipMapLevels(void* data = 0, u32 layer = 0) _IRR_OVERRIDE_;
 
+	//! swaps the mipmap levels and properties with another texture, keeps the name
+	void swap(CSoftwareTexture2* other);
+
 private:
+
+	//! returns the name of the mipmap cache file for a content hash
+	io::path getMipMapCacheName(u64 hash) const;
+
+	//! reads the mipmap levels from the cache file, returns false if it doesn't fit
+	bool readMipMapCache(const io::path& filename, u64 hash);
+
+	//! writes the mipmap levels to the cache file
+	void writeMipMapCache(const io::path& filename, u64 hash) const;
+
+	CBurningVideoDriver* Driver;
+
 	f32 OrigImageDataSizeInPixels;
 
 	CImage * MipMap[SOFTWARE_DRIVER_2_MIPMAPPING_MAX];
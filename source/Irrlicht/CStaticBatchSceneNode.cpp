@@ -0,0 +1,472 @@
+// Copyright (C) 2002-2012 Nikolaus Gebhardt
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#include "CStaticBatchSceneNode.h"
+#include "CDynamicMeshBuffer.h"
+#include "ISceneManager.h"
+#include "ICameraSceneNode.h"
+#include "IVideoDriver.h"
+#include "IMaterialRenderer.h"
+#include "SViewFrustum.h"
+
+namespace irr
+{
+namespace scene
+{
+
+//! constructor
+CStaticBatchSceneNode::CStaticBatchSceneNode(ISceneNode* parent, ISceneManager* mgr, s32 id,
+		const core::vector3df& position)
+	: IStaticBatchSceneNode(parent, mgr, id, position), Mesh(0), Dirty(true)
+{
+	#ifdef _DEBUG
+	setDebugName("CStaticBatchSceneNode");
+	#endif
+}
+
+
+//! destructor
+CStaticBatchSceneNode::~CStaticBatchSceneNode()
+{
+	clearBatches();
+
+	for (u32 i=0; i<Members.size(); ++i)
+	{
+		if (Members[i].Mesh)
+			Members[i].Mesh->drop();
+		Members[i].Node->drop();
+	}
+}
+
+
+//! Adds a mesh scene node to the batch.
+bool CStaticBatchSceneNode::addNode(IMeshSceneNode* node)
+{
+	if (!node)
+		return false;
+
+	for (u32 i=0; i<Members.size(); ++i)
+	{
+		if (Members[i].Node == node)
+			return false;
+	}
+
+	IMesh* mesh = node->getMesh();
+	for (u32 i=0; mesh && i<mesh->getMeshBufferCount(); ++i)
+	{
+		if (mesh->getMeshBuffer(i)->getPrimitiveType() != EPT_TRIANGLES)
+			return false;
+	}
+
+	SMember member;
+	member.Node = node;
+	member.Mesh = 0;
+	member.WasVisible = node->isVisible();
+	Members.push_back(member);
+
+	node->grab();
+	node->setVisible(false);
+	Dirty = true;
+	return true;
+}
+
+
+//! Removes a mesh scene node from the batch.
+bool CStaticBatchSceneNode::removeNode(IMeshSceneNode* node)
+{
+	for (u32 i=0; i<Members.size(); ++i)
+	{
+		if (Members[i].Node == node)
+		{
+			releaseMember(Members[i]);
+			Members.erase(i);
+			Dirty = true;
+			return true;
+		}
+	}
+
+	return false;
+}
+
+
+//! Removes all mesh scene nodes from the batch.
+void CStaticBatchSceneNode::removeAllNodes()
+{
+	for (u32 i=0; i<Members.size(); ++i)
+		releaseMember(Members[i]);
+
+	Members.clear();
+	Dirty = true;
+}
+
+
+//! Restores the visibility of a member and drops its node and mesh
+void CStaticBatchSceneNode::releaseMember(SMember& member)
+{
+	member.Node->setVisible(member.WasVisible);
+	member.Node->drop();
+	if (member.Mesh)
+		member.Mesh->drop();
+}
+
+
+//! Get a mesh scene node of the batch.
+IMeshSceneNode* CStaticBatchSceneNode::getNode(u32 index) const
+{
+	return index < Members.size() ? Members[index].Node : 0;
+}
+
+
+//! Get the merged mesh.
+IMesh* CStaticBatchSceneNode::getMesh()
+{
+	update();
+	return Mesh;
+}
+
+
+//! returns the material of a merged mesh buffer
+video::SMaterial& CStaticBatchSceneNode::getMaterial(u32 i)
+{
+	if (i >= Batches.size())
+		return ISceneNode::getMaterial(i);
+
+	return Batches[i].Buffer->getMaterial();
+}
+
+
+//! Get the material a member uses for one of its mesh buffers
+const video::SMaterial& CStaticBatchSceneNode::getMemberMaterial(IMeshSceneNode* node, u32 i)
+{
+	// same choice of materials as CMeshSceneNode::render()
+	return node->isReadOnlyMaterials() ? node->getMesh()->getMeshBuffer(i)->getMaterial() : node->getMaterial(i);
+}
+
+
+//! Returns true if a member or this node changed since the last build
+bool CStaticBatchSceneNode::needsBuild()
+{
+	bool changed = Dirty || AbsoluteTransformation != BuildTransformation;
+
+	u32 i = 0;
+	while (i < Members.size())
+	{
+		IMeshSceneNode* node = Members[i].Node;
+
+		// removed from the scene
+		if (!node->getParent())
+		{
+			node->drop();
+			Members.erase(i);
+			changed = true;
+			continue;
+		}
+
+		// the node is invisible, so its absolute transformation is not updated by OnAnimate()
+		node->updateAbsolutePositionIfChanged();
+		if (node->getMesh() != Members[i].Mesh ||
+			node->getAbsoluteTransformation() != Members[i].Transformation)
+			changed = true;
+
+		++i;
+	}
+
+	return changed;
+}
+
+
+//! Builds the merged mesh buffers if a member changed
+void CStaticBatchSceneNode::update()
+{
+	if (needsBuild())
+		build();
+}
+
+
+//! Drops the merged mesh buffers
+void CStaticBatchSceneNode::clearBatches()
+{
+	video::IVideoDriver* driver = SceneManager->getVideoDriver();
+	for (u32 i=0; i<Batches.size(); ++i)
+	{
+		if (driver)
+			driver->removeHardwareBuffer(Batches[i].Buffer);
+	}
+	Batches.clear();
+
+	if (Mesh)
+		Mesh->drop();
+	Mesh = 0;
+}
+
+
+//! Merges the mesh buffers of the members
+void CStaticBatchSceneNode::build()
+{
+	clearBatches();
+	Mesh = new SMesh();
+	Box.reset(0.f, 0.f, 0.f);
+
+	// find the merged mesh buffer of each source mesh buffer and their sizes
+	core::array<u32> batchOfBuffer;
+	core::array<u32> vertexCounts;
+	core::array<u32> indexCounts;
+	for (u32 m=0; m<Members.size(); ++m)
+	{
+		IMeshSceneNode* node = Members[m].Node;
+		IMesh* mesh = node->getMesh();
+		for (u32 i=0; mesh && i<mesh->getMeshBufferCount(); ++i)
+		{
+			const IMeshBuffer* mb = mesh->getMeshBuffer(i);
+			const video::SMaterial& material = getMemberMaterial(node, i);
+
+			u32 b = 0;
+			for (; b<Batches.size(); ++b)
+			{
+				const IMeshBuffer* batch = Batches[b].Buffer;
+				if (batch->getVertexType() == mb->getVertexType() && batch->getMaterial() == material)
+					break;
+			}
+
+			if (b == Batches.size())
+			{
+				SBatch batch;
+				// the index type is chosen when the size is known
+				batch.Buffer = new CDynamicMeshBuffer(mb->getVertexType(), video::EIT_16BIT);
+				batch.Buffer->getMaterial() = material;
+				Batches.push_back(batch);
+				vertexCounts.push_back(0);
+				indexCounts.push_back(0);
+			}
+
+			batchOfBuffer.push_back(b);
+			vertexCounts[b] += mb->getVertexCount();
+			indexCounts[b] += mb->getIndexCount();
+		}
+	}
+
+	for (u32 b=0; b<Batches.size(); ++b)
+	{
+		CDynamicMeshBuffer* buffer = Batches[b].Buffer;
+		if (vertexCounts[b] > 65535)
+			buffer->getIndexBuffer().setType(video::EIT_32BIT);
+		buffer->getVertexBuffer().reallocate(vertexCounts[b]);
+		buffer->getIndexBuffer().reallocate(indexCounts[b]);
+		buffer->setHardwareMappingHint(EHM_STATIC);
+	}
+
+	// copy the vertices relative to this node
+	const core::matrix4 toNode(AbsoluteTransformation, core::matrix4::EM4CONST_INVERSE);
+	u32 source = 0;
+	for (u32 m=0; m<Members.size(); ++m)
+	{
+		IMeshSceneNode* node = Members[m].Node;
+		IMesh* mesh = node->getMesh();
+		if (mesh)
+			mesh->grab();
+		if (Members[m].Mesh)
+			Members[m].Mesh->drop();
+		Members[m].Mesh = mesh;
+		Members[m].Transformation = node->getAbsoluteTransformation();
+		const core::matrix4 transformation = toNode * Members[m].Transformation;
+
+		// normals stay perpendicular to the surface with the inverse transposed matrix
+		core::matrix4 normalTransformation;
+		if (transformation.getInverse(normalTransformation))
+			normalTransformation = normalTransformation.getTransposed();
+		else
+			normalTransformation = transformation;
+
+		for (u32 i=0; mesh && i<mesh->getMeshBufferCount(); ++i, ++source)
+		{
+			const IMeshBuffer* mb = mesh->getMeshBuffer(i);
+			SBatch& batch = Batches[batchOfBuffer[source]];
+			IVertexBuffer& vertices = batch.Buffer->getVertexBuffer();
+			IIndexBuffer& indices = batch.Buffer->getIndexBuffer();
+
+			const u32 firstVertex = vertices.size();
+			const u32 vertexCount = mb->getVertexCount();
+			const u32 stride = vertices.stride();
+			vertices.set_used(firstVertex + vertexCount);
+			u8* v = (u8*)vertices.getData() + firstVertex * stride;
+			memcpy(v, mb->getVertices(), vertexCount * stride);
+
+			for (u32 k=0; k<vertexCount; ++k, v+=stride)
+			{
+				video::S3DVertex* vertex = (video::S3DVertex*)v;
+				transformation.transformVect(vertex->Pos);
+				normalTransformation.rotateVect(vertex->Normal);
+				vertex->Normal.normalize();
+
+				if (mb->getVertexType() == video::EVT_TANGENTS)
+				{
+					// tangent and binormal lie in the surface, so they use the transformation itself
+					video::S3DVertexTangents* tangents = (video::S3DVertexTangents*)v;
+					transformation.rotateVect(tangents->Tangent);
+					tangents->Tangent.normalize();
+					transformation.rotateVect(tangents->Binormal);
+					tangents->Binormal.normalize();
+				}
+			}
+
+			SRange range;
+			range.IndexStart = indices.size();
+			range.IndexCount = mb->getIndexCount();
+			range.Box = mb->getBoundingBox();
+			transformation.transformBoxEx(range.Box);
+			batch.Ranges.push_back(range);
+
+			if (source == 0)
+				Box = range.Box;
+			else
+				Box.addInternalBox(range.Box);
+
+			const u16* indices16 = mb->getIndices();
+			const u32* indices32 = (const u32*)mb->getIndices();
+			const bool is32Bit = mb->getIndexType() == video::EIT_32BIT;
+			for (u32 k=0; k<range.IndexCount; ++k)
+				indices.push_back(firstVertex + (is32Bit ? indices32[k] : indices16[k]));
+		}
+	}
+
+	for (u32 b=0; b<Batches.size(); ++b)
+	{
+		Batches[b].Buffer->recalculateBoundingBox();
+		Mesh->addMeshBuffer(Batches[b].Buffer);
+		Batches[b].Buffer->drop();
+	}
+	Mesh->recalculateBoundingBox();
+
+	BuildTransformation = AbsoluteTransformation;
+	Dirty = false;
+}
+
+
+//! frame
+void CStaticBatchSceneNode::OnRegisterSceneNode()
+{
+	if (IsVisible)
+	{
+		update();
+
+		video::IVideoDriver* driver = SceneManager->getVideoDriver();
+		bool solid = false;
+		bool transparent = false;
+		for (u32 b=0; b<Batches.size(); ++b)
+		{
+			video::IMaterialRenderer* rnd = driver->getMaterialRenderer(Batches[b].Buffer->getMaterial().MaterialType);
+			if (rnd && rnd->isTransparent())
+				transparent = true;
+			else
+				solid = true;
+		}
+
+		if (solid)
+			SceneManager->registerNodeForRendering(this, ESNRP_SOLID);
+		if (transparent)
+			SceneManager->registerNodeForRendering(this, ESNRP_TRANSPARENT);
+
+		ISceneNode::OnRegisterSceneNode();
+	}
+}
+
+
+//! renders the node.
+void CStaticBatchSceneNode::render()
+{
+	video::IVideoDriver* driver = SceneManager->getVideoDriver();
+	if (!driver)
+		return;
+
+	const bool isTransparentPass =
+		SceneManager->getSceneNodeRenderPass() == ESNRP_TRANSPARENT;
+
+	driver->setTransform(video::ETS_WORLD, AbsoluteTransformation);
+
+	// the view frustum relative to this node
+	const ICameraSceneNode* camera = SceneManager->getActiveCamera();
+	SViewFrustum frustum;
+	if (camera)
+	{
+		frustum = *camera->getViewFrustum();
+		frustum.transform(core::matrix4(AbsoluteTransformation, core::matrix4::EM4CONST_INVERSE));
+	}
+
+	for (u32 b=0; b<Batches.size(); ++b)
+	{
+		CDynamicMeshBuffer* buffer = Batches[b].Buffer;
+		video::IMaterialRenderer* rnd = driver->getMaterialRenderer(buffer->getMaterial().MaterialType);
+		if ((rnd && rnd->isTransparent()) != isTransparentPass)
+			continue;
+
+		const core::array<SRange>& ranges = Batches[b].Ranges;
+		bool materialSet = false;
+		u32 runStart = 0;
+		u32 runCount = 0;
+		for (u32 r=0; r<=ranges.size(); ++r)
+		{
+			bool visible = r < ranges.size();
+			for (u32 p=0; camera && visible && p<SViewFrustum::VF_PLANE_COUNT; ++p)
+			{
+				if (ranges[r].Box.classifyPlaneRelation(frustum.planes[p]) == core::ISREL3D_FRONT)
+					visible = false;
+			}
+
+			if (visible)
+			{
+				if (!runCount)
+					runStart = ranges[r].IndexStart;
+				runCount += ranges[r].IndexCount;
+				continue;
+			}
+
+			if (!runCount)
+				continue;
+
+			if (!materialSet)
+			{
+				driver->setMaterial(buffer->getMaterial());
+				materialSet = true;
+			}
+
+			// all visible, the mesh buffer may be in a hardware buffer
+			if (runCount == buffer->getIndexCount())
+			{
+				driver->drawMeshBuffer(buffer);
+			}
+			else
+			{
+				const IIndexBuffer& indices = buffer->getIndexBuffer();
+				driver->drawVertexPrimitiveList(buffer->getVertices(), buffer->getVertexCount(),
+					(const u8*)buffer->getIndices() + runStart * indices.stride(), runCount / 3,
+					buffer->getVertexType(), EPT_TRIANGLES, buffer->getIndexType());
+			}
+			runCount = 0;
+		}
+	}
+
+	// for debug purposes only:
+	if (DebugDataVisible && !isTransparentPass)
+	{
+		video::SMaterial m;
+		m.Lighting = false;
+		driver->setMaterial(m);
+
+		if (DebugDataVisible & EDS_BBOX)
+			driver->draw3DBox(Box, video::SColor(255,255,255,255));
+
+		if (DebugDataVisible & EDS_BBOX_BUFFERS)
+		{
+			for (u32 b=0; b<Batches.size(); ++b)
+			{
+				for (u32 r=0; r<Batches[b].Ranges.size(); ++r)
+					driver->draw3DBox(Batches[b].Ranges[r].Box, video::SColor(255,190,128,128));
+			}
+		}
+	}
+}
+
+} // end namespace scene
+} // end namespace irr
+
@@ -0,0 +1,133 @@
+// Copyright (C) 2002-2012 Nikolaus Gebhardt
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#ifndef __C_STATIC_BATCH_SCENE_NODE_H_INCLUDED__
+#define __C_STATIC_BATCH_SCENE_NODE_H_INCLUDED__
+
+#include "IStaticBatchSceneNode.h"
+#include "IMeshSceneNode.h"
+#include "SMesh.h"
+#include "CDynamicMeshBuffer.h"
+#include "irrArray.h"
+
+namespace irr
+{
+namespace scene
+{
+
+	class CStaticBatchSceneNode : public IStaticBatchSceneNode
+	{
+	public:
+
+		//! constructor
+		CStaticBatchSceneNode(ISceneNode* parent, ISceneManager* mgr, s32 id,
+			const core::vector3df& position = core::vector3df(0,0,0));
+
+		//! destructor
+		virtual ~CStaticBatchSceneNode();
+
+		//! frame
+		virtual void OnRegisterSceneNode() _IRR_OVERRIDE_;
+
+		//! renders the node.
+		virtual void render() _IRR_OVERRIDE_;
+
+		//! returns the axis aligned bounding box of this node
+		virtual const core::aabbox3d<f32>& getBoundingBox() const _IRR_OVERRIDE_ { return Box; }
+
+		//! returns the material of a merged mesh buffer, which is replaced when the batch is built again
+		virtual video::SMaterial& getMaterial(u32 i) _IRR_OVERRIDE_;
+
+		//! returns amount of merged mesh buffers
+		virtual u32 getMaterialCount() const _IRR_OVERRIDE_ { return Batches.size(); }
+
+		//! Returns type of the scene node
+		virtual ESCENE_NODE_TYPE getType() const _IRR_OVERRIDE_ { return ESNT_STATIC_BATCH; }
+
+		//! The batch is built again in OnRegisterSceneNode, not while animating
+		virtual bool isAnimationThreadSafe() const _IRR_OVERRIDE_ { return true; }
+
+		//! The batch node itself uses the default transformation
+		virtual bool hasDefaultTransformation() const _IRR_OVERRIDE_ { return true; }
+
+		//! Adds a mesh scene node to the batch.
+		virtual bool addNode(IMeshSceneNode* node) _IRR_OVERRIDE_;
+
+		//! Removes a mesh scene node from the batch.
+		virtual bool removeNode(IMeshSceneNode* node) _IRR_OVERRIDE_;
+
+		//! Removes all mesh scene nodes from the batch.
+		virtual void removeAllNodes() _IRR_OVERRIDE_;
+
+		//! Get the number of mesh scene nodes in the batch.
+		virtual u32 getNodeCount() const _IRR_OVERRIDE_ { return Members.size(); }
+
+		//! Get a mesh scene node of the batch.
+		virtual IMeshSceneNode* getNode(u32 index) const _IRR_OVERRIDE_;
+
+		//! Build the merged mesh buffers again before they are used next time.
+		virtual void setDirty() _IRR_OVERRIDE_ { Dirty = true; }
+
+		//! Get the merged mesh.
+		virtual IMesh* getMesh() _IRR_OVERRIDE_;
+
+	private:
+
+		//! Builds the merged mesh buffers if a member changed
+		void update();
+
+		//! Returns true if a member or this node changed since the last build
+		bool needsBuild();
+
+		//! Merges the mesh buffers of the members
+		void build();
+
+		//! Drops the merged mesh buffers
+		void clearBatches();
+
+		//! Get the material a member uses for one of its mesh buffers
+		static const video::SMaterial& getMemberMaterial(IMeshSceneNode* node, u32 i);
+
+		struct SMember
+		{
+			IMeshSceneNode* Node;
+			//! Mesh and absolute transformation of the last build, the mesh is grabbed
+			IMesh* Mesh;
+			core::matrix4 Transformation;
+			//! Visibility of the node before it was added
+			bool WasVisible;
+		};
+
+		//! Restores the visibility of a member and drops its node and mesh
+		static void releaseMember(SMember& member);
+
+		//! Indices of one source mesh buffer in a merged one
+		struct SRange
+		{
+			u32 IndexStart;
+			u32 IndexCount;
+			core::aabbox3df Box;
+		};
+
+		struct SBatch
+		{
+			CDynamicMeshBuffer* Buffer;
+			core::array<SRange> Ranges;
+		};
+
+		core::array<SMember> Members;
+		core::array<SBatch> Batches;
+		SMesh* Mesh;
+		core::aabbox3df Box;
+
+		//! Absolute transformation of this node at the last build
+		core::matrix4 BuildTransformation;
+		bool Dirty;
+	};
+
+} // end namespace scene
+} // end namespace irr
+
+#endif
+
@@ -141,6 +141,11 @@ void CTRTextureWire2::renderLine ( const s4DVertex *a,const s4DVertex *b ) const
 	int xInc1 = 4;
 	int yInc1 = pitch1;
 
+	// scanline of the current pixel, for the scanline clip
+	int y = aposy;
+	int yStep0 = 0;
+	int yStep1 = 1;
+
 	tVideoSample color;
 
 #ifdef SOFTWARE_DRIVER_2_USE_VERTEX_COLOR
@@ -163,6 +168,7 @@ void CTRTextureWire2::renderLine ( const s4DVertex *a,const s4DVertex *b ) const
 		swap_xor ( dx, dy );
 		swap_xor ( xInc0, yInc0 );
 		swap_xor ( xInc1, yInc1 );
+		swap_xor ( yStep0, yStep1 );
 	}
 
 	if ( 0 == dx )
@@ -189,6 +195,7 @@ void CTRTextureWire2::renderLine ( const s4DVertex *a,const s4DVertex *b ) const
 	run = dx;
 	while ( run )
 	{
+		if ( y >= ScanlineClipStart && y < ScanlineClipEnd )
 #ifdef CMP_Z
 		if ( *z >= dataZ )
 #endif
@@ -208,6 +215,7 @@ void CTRTextureWire2::renderLine ( const s4DVertex *a,const s4DVertex *b ) const
 		}
 
 		dst = (tVideoSample*) ( (u8*) dst + xInc0 );	// x += xInc
+		y += yStep0;
 #ifdef IPOL_Z
 		z = (fp24*) ( (u8*) z + xInc1 );
 #endif
@@ -219,6 +227,7 @@ void CTRTextureWire2::renderLine ( const s4DVertex *a,const s4DVertex *b ) const
 		if ( d > dx )
 		{
 			dst = (tVideoSample*) ( (u8*) dst + yInc0 );	// y += yInc
+			y += yStep1;
 #ifdef IPOL_Z
 			z = (fp24*) ( (u8*) z + yInc1 );
 #endif
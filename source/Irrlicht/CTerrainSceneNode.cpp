@@ -235,6 +235,18 @@ namespace scene
 	}
 
 
+	//! Returns the width of a square RAW heightmap, 0 if the file is too small
+	static s32 getHeightMapRAWSize(io::IReadFile* file, s32 bitsPerPixel, s32 width)
+	{
+		const size_t bytesPerPixel = (size_t)bitsPerPixel / 8;
+		if (!width)
+			return core::floor32(sqrtf((f32)(file->getSize() / bytesPerPixel)));
+		if ((file->getSize()-file->getPos())/bytesPerPixel < (size_t)(width*width))
+			return 0;
+		return width;
+	}
+
+
 	//! Initializes the terrain data. Loads the vertices from the heightMapFile
 	bool CTerrainSceneNode::loadHeightMapRAW(io::IReadFile* file,
 			s32 bitsPerPixel, bool signedData, bool floatVals,
@@ -242,29 +254,61 @@ namespace scene
 	{
 		if (!file)
 			return false;
-		if (floatVals && bitsPerPixel != 32)
+
+		const s32 size = getHeightMapRAWSize(file, bitsPerPixel, width);
+		if (!size)
+		{
+			os::Printer::log("Error reading heightmap RAW file", "File is too small.", ELL_ERROR);
+			return false;
+		}
+		if ((size - 1) % TerrainData.CalcPatchSize)
+		{
+			// the patches cover the terrain, the rest of the heightmap would be lost
+			os::Printer::log("Error reading heightmap RAW file",
+				"Width minus one is not a multiple of the patch size minus one.", ELL_ERROR);
 			return false;
+		}
 
 		// start reading
 		const u32 startTime = os::Timer::getTime();
 
-		Mesh->MeshBuffers.clear();
+		if (!createTerrainFromRAW(file, bitsPerPixel, signedData, floatVals, width, vertexColor, smoothFactor))
+		{
+			os::Printer::log("Error reading heightmap RAW file.");
+			return false;
+		}
+
+		const u32 endTime = os::Timer::getTime();
+
+		c8 tmp[255];
+		snprintf_irr(tmp, 255, "Generated terrain data (%dx%d) in %.4f seconds",
+			TerrainData.Size, TerrainData.Size, (endTime - startTime) / 1000.0f);
+		os::Printer::log(tmp);
+
+		return true;
+	}
+
+
+	//! Loads the vertices from a RAW heightmap and creates the patches
+	bool CTerrainSceneNode::createTerrainFromRAW(io::IReadFile* file,
+			s32 bitsPerPixel, bool signedData, bool floatVals,
+			s32 width, video::SColor vertexColor, s32 smoothFactor)
+	{
+		if (!file)
+			return false;
+		if (floatVals && bitsPerPixel != 32)
+			return false;
 
-		const size_t bytesPerPixel = (size_t)bitsPerPixel / 8;
 
 		// Get the dimension of the heightmap data
-		const long filesize = file->getSize();
-		if (!width)
-			TerrainData.Size = core::floor32(sqrtf((f32)(filesize / bytesPerPixel)));
-		else
-		{
-			if ((filesize-file->getPos())/bytesPerPixel>(size_t)(width*width))
-			{
-				os::Printer::log("Error reading heightmap RAW file", "File is too small.");
-				return false;
-			}
-			TerrainData.Size = width;
-		}
+		const s32 size = getHeightMapRAWSize(file, bitsPerPixel, width);
+		if (!size || (size - 1) % TerrainData.CalcPatchSize)
+			return false;
+
+		Mesh->MeshBuffers.clear();
+
+		const size_t bytesPerPixel = (size_t)bitsPerPixel / 8;
+		TerrainData.Size = size;
 
 		switch (TerrainData.PatchSize)
 		{
@@ -403,7 +447,6 @@ namespace scene
 				}
 				if (failure)
 				{
-					os::Printer::log("Error reading heightmap RAW file.");
 					mb->drop();
 					return false;
 				}
@@ -460,13 +503,6 @@ namespace scene
 				TerrainData.PatchCount*TerrainData.PatchCount*
 				TerrainData.CalcPatchSize*TerrainData.CalcPatchSize*6);
 
-		const u32 endTime = os::Timer::getTime();
-
-		c8 tmp[255];
-		snprintf_irr(tmp, 255, "Generated terrain data (%dx%d) in %.4f seconds",
-			TerrainData.Size, TerrainData.Size, (endTime - startTime) / 1000.0f);
-		os::Printer::log(tmp);
-
 		return true;
 	}
 
@@ -631,14 +667,29 @@ namespace scene
 
 		const SViewFrustum* frustum = camera->getViewFrustum();
 
+		// Determine the distance of all patches to the camera first, this loop
+		// only reads the patch centers.
+		const s32 count = TerrainData.PatchCount * TerrainData.PatchCount;
+		const f32* centerX = TerrainData.PatchCenterX.const_pointer();
+		const f32* centerY = TerrainData.PatchCenterY.const_pointer();
+		const f32* centerZ = TerrainData.PatchCenterZ.const_pointer();
+		PatchDistances.set_used(count);
+		f32* distances = PatchDistances.pointer();
+		for (s32 j = 0; j < count; ++j)
+		{
+			const f32 dx = cameraPosition.X - centerX[j];
+			const f32 dy = cameraPosition.Y - centerY[j];
+			const f32 dz = cameraPosition.Z - centerZ[j];
+			distances[j] = dx*dx + dy*dy + dz*dz;
+		}
+
 		// Determine each patches LOD based on distance from camera (and whether or not they are in
 		// the view frustum).
-		const s32 count = TerrainData.PatchCount * TerrainData.PatchCount;
 		for (s32 j = 0; j < count; ++j)
 		{
 			if (frustum->getBoundingBox().intersectsWithBox(TerrainData.Patches[j].BoundingBox))
 			{
-				const f32 distance = cameraPosition.getDistanceFromSQ(TerrainData.Patches[j].Center);
+				const f32 distance = distances[j];
 
 				TerrainData.Patches[j].CurrentLOD = 0;
 				for (s32 i = TerrainData.MaxLOD - 1; i>0; --i)
@@ -661,55 +712,71 @@ namespace scene
 	void CTerrainSceneNode::preRenderIndicesCalculations()
 	{
 		scene::IIndexBuffer& indexBuffer = RenderBuffer->getIndexBuffer();
-		IndicesToRender = 0;
-		indexBuffer.set_used(0);
+		const s32 count = TerrainData.PatchCount * TerrainData.PatchCount;
+
+		// room for all patches at the highest LOD
+		const u32 maxIndices = count * TerrainData.CalcPatchSize * TerrainData.CalcPatchSize * 6;
+		if (indexBuffer.size() < maxIndices)
+			indexBuffer.set_used(maxIndices);
+		const bool indices16Bit = indexBuffer.getType() == video::EIT_16BIT;
 
+		const u32 maxLOD = TerrainData.MaxLOD;
+		u32 indices = 0;
+		bool changed = false;
+		s32 borderLODs[4];
+
+		// Then copy the indices of all patches that are visible from their
+		// templates. Patches with the same template at the same position as
+		// last time are still in the buffer.
 		s32 index = 0;
-		// Then generate the indices for all patches that are visible.
 		for (s32 i = 0; i < TerrainData.PatchCount; ++i)
 		{
 			for (s32 j = 0; j < TerrainData.PatchCount; ++j)
 			{
-				if (TerrainData.Patches[index].CurrentLOD >= 0)
+				SPatch& patch = TerrainData.Patches[index];
+				if (patch.CurrentLOD >= 0)
 				{
-					s32 x = 0;
-					s32 z = 0;
+					getBorderLODs(index, borderLODs);
+					const u32 key = (((patch.CurrentLOD * maxLOD + borderLODs[0]) * maxLOD +
+						borderLODs[1]) * maxLOD + borderLODs[2]) * maxLOD + borderLODs[3];
+					const SIndexTemplate& indexTemplate = getIndexTemplate(key, patch.CurrentLOD, borderLODs);
 
-					// calculate the step we take this patch, based on the patches current LOD
-					const s32 step = 1 << TerrainData.Patches[index].CurrentLOD;
-
-					// Loop through patch and generate indices
-					while (z < TerrainData.CalcPatchSize)
+					if (patch.IndexTemplate != key || patch.IndexOffset != indices)
 					{
-						const s32 index11 = getIndex(j, i, index, x, z);
-						const s32 index21 = getIndex(j, i, index, x + step, z);
-						const s32 index12 = getIndex(j, i, index, x, z + step);
-						const s32 index22 = getIndex(j, i, index, x + step, z + step);
-
-						indexBuffer.push_back(index12);
-						indexBuffer.push_back(index11);
-						indexBuffer.push_back(index22);
-						indexBuffer.push_back(index22);
-						indexBuffer.push_back(index11);
-						indexBuffer.push_back(index21);
-						IndicesToRender+=6;
-
-						// increment index position horizontally
-						x += step;
-
-						// we've hit an edge
-						if (x >= TerrainData.CalcPatchSize)
+						const u32 first = TerrainData.CalcPatchSize * (i * TerrainData.Size + j);
+						const u32* source = IndexTemplates.const_pointer() + indexTemplate.Start;
+
+						if (indices16Bit)
+						{
+							u16* target = (u16*)indexBuffer.pointer() + indices;
+							for (u32 n = 0; n < indexTemplate.Count; ++n)
+								target[n] = (u16)(first + source[n]);
+						}
+						else
 						{
-							x = 0;
-							z += step;
+							u32* target = (u32*)indexBuffer.pointer() + indices;
+							for (u32 n = 0; n < indexTemplate.Count; ++n)
+								target[n] = first + source[n];
 						}
+
+						patch.IndexTemplate = key;
+						patch.IndexOffset = indices;
+						changed = true;
 					}
+					indices += indexTemplate.Count;
+				}
+				else
+				{
+					patch.IndexOffset = 0xffffffff;
 				}
 				++index;
 			}
 		}
 
-		RenderBuffer->setDirty(EBT_INDEX);
+		// the hardware buffer is only updated when indices changed
+		if (changed || indices != IndicesToRender)
+			RenderBuffer->setDirty(EBT_INDEX);
+		IndicesToRender = indices;
 
 		if (DynamicSelectorUpdate && TriangleSelector)
 		{
@@ -1030,48 +1097,43 @@ namespace scene
 	//! used to get the indices when generating index data for patches at varying levels of detail.
 	u32 CTerrainSceneNode::getIndex(const s32 PatchX, const s32 PatchZ,
 					const s32 PatchIndex, u32 vX, u32 vZ) const
+	{
+		s32 borderLODs[4];
+		getBorderLODs(PatchIndex, borderLODs);
+
+		return getPatchIndex(borderLODs, vX, vZ) +
+			TerrainData.CalcPatchSize * (PatchZ * TerrainData.Size + PatchX);
+	}
+
+
+	//! get the LODs of the top, bottom, left and right neighbours which are coarser than the patch, 0 for the others
+	void CTerrainSceneNode::getBorderLODs(const s32 PatchIndex, s32* borderLODs) const
+	{
+		const SPatch& patch = TerrainData.Patches[PatchIndex];
+
+		borderLODs[0] = (patch.Top && patch.CurrentLOD < patch.Top->CurrentLOD) ? patch.Top->CurrentLOD : 0;
+		borderLODs[1] = (patch.Bottom && patch.CurrentLOD < patch.Bottom->CurrentLOD) ? patch.Bottom->CurrentLOD : 0;
+		borderLODs[2] = (patch.Left && patch.CurrentLOD < patch.Left->CurrentLOD) ? patch.Left->CurrentLOD : 0;
+		borderLODs[3] = (patch.Right && patch.CurrentLOD < patch.Right->CurrentLOD) ? patch.Right->CurrentLOD : 0;
+	}
+
+
+	//! get the index of a vertex relative to the first vertex of its patch, snapped to the border LODs
+	u32 CTerrainSceneNode::getPatchIndex(const s32* borderLODs, u32 vX, u32 vZ) const
 	{
 		// top border
 		if (vZ == 0)
-		{
-			if (TerrainData.Patches[PatchIndex].Top &&
-				TerrainData.Patches[PatchIndex].CurrentLOD < TerrainData.Patches[PatchIndex].Top->CurrentLOD &&
-				(vX % (1 << TerrainData.Patches[PatchIndex].Top->CurrentLOD)) != 0 )
-			{
-				vX -= vX % (1 << TerrainData.Patches[PatchIndex].Top->CurrentLOD);
-			}
-		}
+			vX -= vX % (1 << borderLODs[0]);
 		else
 		if (vZ == (u32)TerrainData.CalcPatchSize) // bottom border
-		{
-			if (TerrainData.Patches[PatchIndex].Bottom &&
-				TerrainData.Patches[PatchIndex].CurrentLOD < TerrainData.Patches[PatchIndex].Bottom->CurrentLOD &&
-				(vX % (1 << TerrainData.Patches[PatchIndex].Bottom->CurrentLOD)) != 0)
-			{
-				vX -= vX % (1 << TerrainData.Patches[PatchIndex].Bottom->CurrentLOD);
-			}
-		}
+			vX -= vX % (1 << borderLODs[1]);
 
 		// left border
 		if (vX == 0)
-		{
-			if (TerrainData.Patches[PatchIndex].Left &&
-				TerrainData.Patches[PatchIndex].CurrentLOD < TerrainData.Patches[PatchIndex].Left->CurrentLOD &&
-				(vZ % (1 << TerrainData.Patches[PatchIndex].Left->CurrentLOD)) != 0)
-			{
-				vZ -= vZ % (1 << TerrainData.Patches[PatchIndex].Left->CurrentLOD);
-			}
-		}
+			vZ -= vZ % (1 << borderLODs[2]);
 		else
 		if (vX == (u32)TerrainData.CalcPatchSize) // right border
-		{
-			if (TerrainData.Patches[PatchIndex].Right &&
-				TerrainData.Patches[PatchIndex].CurrentLOD < TerrainData.Patches[PatchIndex].Right->CurrentLOD &&
-				(vZ % (1 << TerrainData.Patches[PatchIndex].Right->CurrentLOD)) != 0)
-			{
-				vZ -= vZ % (1 << TerrainData.Patches[PatchIndex].Right->CurrentLOD);
-			}
-		}
+			vZ -= vZ % (1 << borderLODs[3]);
 
 		if (vZ >= (u32)TerrainData.PatchSize)
 			vZ = TerrainData.CalcPatchSize;
@@ -1079,8 +1141,52 @@ namespace scene
 		if (vX >= (u32)TerrainData.PatchSize)
 			vX = TerrainData.CalcPatchSize;
 
-		return (vZ + ((TerrainData.CalcPatchSize) * PatchZ)) * TerrainData.Size +
-			(vX + ((TerrainData.CalcPatchSize) * PatchX));
+		return vZ * TerrainData.Size + vX;
+	}
+
+
+	//! get the index template of a patch at the specified LOD, creates it if needed
+	const CTerrainSceneNode::SIndexTemplate& CTerrainSceneNode::getIndexTemplate(u32 key, s32 LOD, const s32* borderLODs)
+	{
+		SIndexTemplate& indexTemplate = IndexTemplateList[key];
+		if (indexTemplate.Count)
+			return indexTemplate;
+
+		indexTemplate.Start = IndexTemplates.size();
+
+		// calculate the step we take this patch, based on the LOD
+		const s32 step = 1 << LOD;
+		s32 x = 0;
+		s32 z = 0;
+
+		// Loop through patch and generate indices
+		while (z < TerrainData.CalcPatchSize)
+		{
+			const u32 index11 = getPatchIndex(borderLODs, x, z);
+			const u32 index21 = getPatchIndex(borderLODs, x + step, z);
+			const u32 index12 = getPatchIndex(borderLODs, x, z + step);
+			const u32 index22 = getPatchIndex(borderLODs, x + step, z + step);
+
+			IndexTemplates.push_back(index12);
+			IndexTemplates.push_back(index11);
+			IndexTemplates.push_back(index22);
+			IndexTemplates.push_back(index22);
+			IndexTemplates.push_back(index11);
+			IndexTemplates.push_back(index21);
+
+			// increment index position horizontally
+			x += step;
+
+			// we've hit an edge
+			if (x >= TerrainData.CalcPatchSize)
+			{
+				x = 0;
+				z += step;
+			}
+		}
+
+		indexTemplate.Count = IndexTemplates.size() - indexTemplate.Start;
+		return indexTemplate;
 	}
 
 
@@ -1239,6 +1345,14 @@ namespace scene
 			delete [] TerrainData.Patches;
 
 		TerrainData.Patches = new SPatch[TerrainData.PatchCount * TerrainData.PatchCount];
+
+		// the index templates depend on the terrain size, create them again when they are used
+		const u32 maxLOD = TerrainData.MaxLOD;
+		IndexTemplateList.clear();
+		IndexTemplateList.reallocate(maxLOD * maxLOD * maxLOD * maxLOD * maxLOD);
+		for (u32 i=0; i<IndexTemplateList.allocated_size(); ++i)
+			IndexTemplateList.push_back(SIndexTemplate());
+		IndexTemplates.clear();
 	}
 
 
@@ -1248,6 +1362,11 @@ namespace scene
 		// Reset the Terrains Bounding Box for re-calculation
 		TerrainData.BoundingBox.reset(RenderBuffer->getPosition(0));
 
+		const u32 count = TerrainData.PatchCount * TerrainData.PatchCount;
+		TerrainData.PatchCenterX.set_used(count);
+		TerrainData.PatchCenterY.set_used(count);
+		TerrainData.PatchCenterZ.set_used(count);
+
 		for (s32 x = 0; x < TerrainData.PatchCount; ++x)
 		{
 			for (s32 z = 0; z < TerrainData.PatchCount; ++z)
@@ -1272,6 +1391,9 @@ namespace scene
 
 				// get center of Patch
 				patch.Center = patch.BoundingBox.getCenter();
+				TerrainData.PatchCenterX[index] = patch.Center.X;
+				TerrainData.PatchCenterY[index] = patch.Center.Y;
+				TerrainData.PatchCenterZ[index] = patch.Center.Z;
 
 				// Assign Neighbours
 				// Top
@@ -58,6 +58,13 @@ namespace scene
 		virtual bool loadHeightMapRAW(io::IReadFile* file, s32 bitsPerPixel = 16,
 			bool signedData=true, bool floatVals=false, s32 width=0,
 			video::SColor vertexColor = video::SColor ( 255, 255, 255, 255 ), s32 smoothFactor = 0 ) _IRR_OVERRIDE_;
+		//! Loads the vertices from a RAW heightmap like loadHeightMapRAW, but without logging.
+		/** Returns false for the same heightmaps as loadHeightMapRAW, so a
+		node which is not in the scene yet can be created on a worker thread. */
+		bool createTerrainFromRAW(io::IReadFile* file, s32 bitsPerPixel,
+			bool signedData, bool floatVals, s32 width,
+			video::SColor vertexColor, s32 smoothFactor);
+
 
 		//! Returns the material based on the zero based index i. This scene node only uses
 		//! 1 material.
@@ -205,6 +212,12 @@ namespace scene
 		//! Returns type of the scene node
 		virtual ESCENE_NODE_TYPE getType() const _IRR_OVERRIDE_ {return ESNT_TERRAIN;}
 
+		//! The LOD is updated in OnRegisterSceneNode, OnAnimate is the default one
+		virtual bool isAnimationThreadSafe() const _IRR_OVERRIDE_ { return true; }
+
+		//! The terrain uses the default transformation, the LOD has its own checks
+		virtual bool hasDefaultTransformation() const _IRR_OVERRIDE_ { return true; }
+
 		//! Writes attributes of the scene node.
 		virtual void serializeAttributes(io::IAttributes* out,
 				io::SAttributeReadWriteOptions* options=0) const _IRR_OVERRIDE_;
@@ -223,7 +236,8 @@ namespace scene
 		struct SPatch
 		{
 			SPatch()
-			: Top(0), Bottom(0), Right(0), Left(0), CurrentLOD(-1)
+			: Top(0), Bottom(0), Right(0), Left(0), CurrentLOD(-1),
+				IndexTemplate(0), IndexOffset(0xffffffff)
 			{
 			}
 
@@ -234,6 +248,22 @@ namespace scene
 			s32 CurrentLOD;
 			core::aabbox3df BoundingBox;
 			core::vector3df Center;
+
+			//! index template and position of the indices of the patch in the RenderBuffer
+			u32 IndexTemplate;
+			u32 IndexOffset;
+		};
+
+		//! Indices of a patch at one LOD with its borders snapped to the LODs of the neighbours
+		struct SIndexTemplate
+		{
+			SIndexTemplate() : Start(0), Count(0) {}
+
+			//! first index in IndexTemplates
+			u32 Start;
+
+			//! number of indices, 0 if the template was not created yet
+			u32 Count;
 		};
 
 		struct STerrainData
@@ -258,6 +288,11 @@ namespace scene
 			s32		MaxLOD;
 			core::aabbox3df	BoundingBox;
 			core::array<f64> LODDistanceThreshold;
+
+			//! centers of the patches, one array per coordinate
+			core::array<f32> PatchCenterX;
+			core::array<f32> PatchCenterY;
+			core::array<f32> PatchCenterZ;
 		};
 
 		void preRenderCalculationsIfNeeded();
@@ -267,6 +302,15 @@ namespace scene
 		//! get indices when generating index data for patches at varying levels of detail.
 		u32 getIndex(const s32 PatchX, const s32 PatchZ, const s32 PatchIndex, u32 vX, u32 vZ) const;
 
+		//! get the LODs of the top, bottom, left and right neighbours which are coarser than the patch, 0 for the others
+		void getBorderLODs(const s32 PatchIndex, s32* borderLODs) const;
+
+		//! get the index of a vertex relative to the first vertex of its patch, snapped to the border LODs
+		u32 getPatchIndex(const s32* borderLODs, u32 vX, u32 vZ) const;
+
+		//! get the index template of a patch at the specified LOD, creates it if needed
+		const SIndexTemplate& getIndexTemplate(u32 key, s32 LOD, const s32* borderLODs);
+
 		//! smooth the terrain
 		void smoothTerrain(IDynamicMeshBuffer* mb, s32 smoothFactor);
 
@@ -296,6 +340,13 @@ namespace scene
 
 		IDynamicMeshBuffer *RenderBuffer;
 
+		//! patch indices for each combination of patch LOD and border LODs
+		core::array<SIndexTemplate> IndexTemplateList;
+		core::array<u32> IndexTemplates;
+
+		//! squared distances of the patches to the camera
+		core::array<f32> PatchDistances;
+
 		u32 VerticesToRender;
 		u32 IndicesToRender;
 
@@ -61,6 +61,12 @@ namespace scene
 		//! Returns type of the scene node
 		virtual ESCENE_NODE_TYPE getType() const _IRR_OVERRIDE_ { return ESNT_TEXT; }
 
+		//! Text scene nodes are projected to the screen when rendered
+		virtual bool isAnimationThreadSafe() const _IRR_OVERRIDE_ { return true; }
+
+		//! Text scene nodes use the default transformation
+		virtual bool hasDefaultTransformation() const _IRR_OVERRIDE_ { return true; }
+
 	private:
 
 		core::stringw Text;
@@ -85,6 +91,12 @@ namespace scene
 		//! sets the vertex positions etc
 		virtual void OnAnimate(u32 timeMs) _IRR_OVERRIDE_;
 
+		//! OnAnimate uses the active camera, so it stays on the main thread
+		virtual bool isAnimationThreadSafe() const _IRR_OVERRIDE_ { return false; }
+
+		//! The billboard is turned to the camera in OnAnimate, not in the transformation
+		virtual bool hasDefaultTransformation() const _IRR_OVERRIDE_ { return true; }
+
 		//! registers the node into the transparent pass
 		virtual void OnRegisterSceneNode() _IRR_OVERRIDE_;
 
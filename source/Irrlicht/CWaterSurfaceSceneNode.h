@@ -32,6 +32,9 @@ namespace scene
 		//! animated update
 		virtual void OnAnimate(u32 timeMs) _IRR_OVERRIDE_;
 
+		//! OnAnimate changes the mesh, so it stays on the main thread
+		virtual bool isAnimationThreadSafe() const _IRR_OVERRIDE_ { return false; }
+
 		//! Update mesh
 		virtual void setMesh(IMesh* mesh) _IRR_OVERRIDE_;
 
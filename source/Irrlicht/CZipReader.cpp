@@ -16,7 +16,12 @@ extern "C" void bz_internal_error(int errorCode)
 
 #include "CFileList.h"
 #include "CReadFile.h"
+#include "CWriteFile.h"
+#include "CZipStreamReadFile.h"
+#include "CPathHashMap.h"
 #include "coreutil.h"
+#include <sys/types.h>
+#include <sys/stat.h>
 
 #include "IrrCompileConfig.h"
 #ifdef _IRR_COMPILE_WITH_ZLIB_
@@ -138,7 +143,7 @@ bool CArchiveLoaderZIP::isALoadableFileFormat(io::IReadFile* file) const
 // -----------------------------------------------------------------------------
 
 CZipReader::CZipReader(IFileSystem* fs, IReadFile* file, bool ignoreCase, bool ignorePaths, bool isGZip)
- : CFileList((file ? file->getFileName() : io::path("")), ignoreCase, ignorePaths), FileSystem(fs), File(file), IsGZip(isGZip)
+ : CFileList((file ? file->getFileName() : io::path("")), ignoreCase, ignorePaths), FileSystem(fs), File(file), StreamingThreshold(0x100000), IsGZip(isGZip)
 {
 	#ifdef _DEBUG
 	setDebugName("CZipReader");
@@ -148,13 +153,21 @@ CZipReader::CZipReader(IFileSystem* fs, IReadFile* file, bool ignoreCase, bool i
 	{
 		File->grab();
 
-		// load file entries
-		if (IsGZip)
-			while (scanGZipHeader()) { }
-		else
-			while (scanZipHeader()) { }
+		// load file entries, from the cache when the archive didn't change
+		s64 archiveTime = 0;
+		const io::path cacheName = getIndexCacheName(archiveTime);
+		if (cacheName.empty() || !readIndexCache(cacheName, archiveTime))
+		{
+			if (IsGZip)
+				while (scanGZipHeader()) { }
+			else
+				while (scanZipHeader()) { }
 
-		sort();
+			sort();
+
+			if (!cacheName.empty())
+				writeIndexCache(cacheName, archiveTime);
+		}
 	}
 }
 
@@ -165,6 +178,191 @@ CZipReader::~CZipReader()
 }
 
 
+// Cache of the file list of a zip archive. The header is followed by FileInfo,
+// an SZipIndexCacheFile for each entry of Files, the path of the archive and
+// the full names of the entries, so all parts are aligned.
+namespace
+{
+	const u32 ZIP_INDEX_CACHE_MAGIC = 0x31584449; // IDX1
+
+	struct SZipIndexCacheHeader
+	{
+		u32 Magic;
+		u32 Flags;
+		s64 ArchiveSize;
+		s64 ArchiveTime;
+		u32 PathLength;
+		u32 FileInfoCount;
+		u32 FileCount;
+		u32 NameLength;
+	};
+
+	struct SZipIndexCacheFile
+	{
+		u32 Size;
+		u32 ID;
+		u32 Offset;
+		u32 NameLength;
+		u32 IsDirectory;
+	};
+
+	//! gets size and modification time of a file on disk
+	bool getFileSizeAndTime(const io::path& filename, s64& size, s64& time)
+	{
+#if defined(_IRR_WCHAR_FILESYSTEM)
+		struct _stat64 st;
+		if (_wstat64(filename.c_str(), &st))
+			return false;
+#elif defined(_MSC_VER)
+		struct _stat64 st;
+		if (_stat64(filename.c_str(), &st))
+			return false;
+#else
+		struct stat st;
+		if (stat(filename.c_str(), &st))
+			return false;
+#endif
+		size = st.st_size;
+		time = st.st_mtime;
+		return true;
+	}
+}
+
+
+//! flags which have to match between the cache and the archive
+u32 CZipReader::getIndexCacheFlags() const
+{
+	return (IgnoreCase ? 1 : 0) | (IgnorePaths ? 2 : 0) | (IsGZip ? 4 : 0) | (sizeof(fschar_t) << 8);
+}
+
+
+//! returns the cache file of the file list and the modification time of the archive
+io::path CZipReader::getIndexCacheName(s64& archiveTime) const
+{
+	if (!FileSystem || FileSystem->getArchiveCacheDirectory().empty())
+		return io::path();
+
+	// only archives on disk are cached
+	s64 size = 0;
+	if (!getFileSizeAndTime(Path, size, archiveTime) || size != File->getSize())
+		return io::path();
+
+	// the archive name and a hash of its path and flags
+	io::path name(Path);
+	core::deletePathFromFilename(name);
+	const u32 hash = CPathHashMap<u32>::getHash(Path + io::path(getIndexCacheFlags()));
+	return FileSystem->getArchiveCacheDirectory() + name + "." + io::path(hash) + ".zidx";
+}
+
+
+//! reads the file list from the cache, returns false if the cache doesn't match the archive
+bool CZipReader::readIndexCache(const io::path& cacheName, s64 archiveTime)
+{
+	IReadFile* cache = CReadFile::createReadFile(cacheName);
+	if (!cache)
+		return false;
+
+	// the cache is read at once
+	const long size = cache->getSize();
+	core::array<u8> data;
+	data.set_used(size > 0 ? (u32)size : 0);
+	const bool read = size > (long)sizeof(SZipIndexCacheHeader) &&
+		cache->read(data.pointer(), size) == (size_t)size;
+	cache->drop();
+	if (!read)
+		return false;
+
+	SZipIndexCacheHeader header;
+	memcpy(&header, data.const_pointer(), sizeof(header));
+	if (header.Magic != ZIP_INDEX_CACHE_MAGIC || header.Flags != getIndexCacheFlags() ||
+		header.ArchiveSize != File->getSize() || header.ArchiveTime != archiveTime)
+		return false;
+
+	const u64 infoSize = (u64)header.FileInfoCount * sizeof(SZipFileEntry);
+	const u64 filesSize = (u64)header.FileCount * sizeof(SZipIndexCacheFile);
+	const u64 namesSize = ((u64)header.PathLength + header.NameLength) * sizeof(fschar_t);
+	if (sizeof(header) + infoSize + filesSize + namesSize != (u64)size)
+		return false;
+
+	const u8* info = data.const_pointer() + sizeof(header);
+	const SZipIndexCacheFile* files = (const SZipIndexCacheFile*)(info + infoSize);
+	const fschar_t* names = (const fschar_t*)(info + infoSize + filesSize);
+
+	// names of different archives can have the same hash
+	if (io::path(names, header.PathLength) != Path)
+		return false;
+	names += header.PathLength;
+
+	u32 nameLength = 0;
+	for (u32 i=0; i < header.FileCount; ++i)
+	{
+		if (files[i].ID >= header.FileInfoCount || files[i].NameLength > header.NameLength - nameLength)
+			return false;
+		nameLength += files[i].NameLength;
+	}
+
+	FileInfo.set_used(header.FileInfoCount);
+	memcpy(FileInfo.pointer(), info, (size_t)infoSize);
+
+	// the entries were sorted when the cache was written
+	Files.reallocate(header.FileCount);
+	SFileListEntry entry;
+	for (u32 i=0; i < header.FileCount; ++i)
+	{
+		entry.FullName = io::path(names, files[i].NameLength);
+		names += files[i].NameLength;
+		entry.Name = entry.FullName;
+		core::deletePathFromFilename(entry.Name);
+		entry.Size = files[i].Size;
+		entry.ID = files[i].ID;
+		entry.Offset = files[i].Offset;
+		entry.IsDirectory = files[i].IsDirectory != 0;
+		Files.push_back(entry);
+	}
+
+	return true;
+}
+
+
+//! writes the file list to the cache
+void CZipReader::writeIndexCache(const io::path& cacheName, s64 archiveTime) const
+{
+	IWriteFile* cache = CWriteFile::createWriteFile(cacheName, false);
+	if (!cache)
+		return;
+
+	SZipIndexCacheHeader header;
+	header.Magic = ZIP_INDEX_CACHE_MAGIC;
+	header.Flags = getIndexCacheFlags();
+	header.ArchiveSize = File->getSize();
+	header.ArchiveTime = archiveTime;
+	header.PathLength = Path.size();
+	header.FileInfoCount = FileInfo.size();
+	header.FileCount = Files.size();
+	header.NameLength = 0;
+	for (u32 i=0; i < Files.size(); ++i)
+		header.NameLength += Files[i].FullName.size();
+
+	cache->write(&header, sizeof(header));
+	cache->write(FileInfo.const_pointer(), FileInfo.size() * sizeof(SZipFileEntry));
+	for (u32 i=0; i < Files.size(); ++i)
+	{
+		SZipIndexCacheFile file;
+		file.Size = Files[i].Size;
+		file.ID = Files[i].ID;
+		file.Offset = Files[i].Offset;
+		file.NameLength = Files[i].FullName.size();
+		file.IsDirectory = Files[i].IsDirectory ? 1 : 0;
+		cache->write(&file, sizeof(file));
+	}
+	cache->write(Path.c_str(), Path.size() * sizeof(fschar_t));
+	for (u32 i=0; i < Files.size(); ++i)
+		cache->write(Files[i].FullName.c_str(), Files[i].FullName.size() * sizeof(fschar_t));
+
+	cache->drop();
+}
+
+
 //! get the archive type
 E_FILE_ARCHIVE_TYPE CZipReader::getType() const
 {
@@ -488,6 +686,34 @@ IReadFile* CZipReader::createAndOpenFile(const io::path& filename)
 	return 0;
 }
 
+//! opens a compressed file which is decompressed while reading
+IReadFile* CZipReader::createStreamReadFile(u32 index, IReadFile* decrypted, s16 compressionMethod)
+{
+	const SZipFileEntry &e = FileInfo[Files[index].ID];
+
+	CZipStreamReadFile* file = 0;
+	if (decrypted)
+	{
+		file = new CZipStreamReadFile(decrypted, 0, decrypted->getSize(),
+			e.header.DataDescriptor.UncompressedSize, compressionMethod, Files[index].FullName);
+		decrypted->drop();
+	}
+	else
+	{
+		file = new CZipStreamReadFile(File, e.Offset, e.header.DataDescriptor.CompressedSize,
+			e.header.DataDescriptor.UncompressedSize, compressionMethod, Files[index].FullName);
+	}
+
+	if (!file->isValid())
+	{
+		os::Printer::log("Error decompressing", Files[index].FullName, ELL_ERROR);
+		file->drop();
+		return 0;
+	}
+
+	return file;
+}
+
 #ifdef _IRR_COMPILE_WITH_LZMA_
 //! Used for LZMA decompression. The lib has no default memory management
 namespace
@@ -611,6 +837,11 @@ IReadFile* CZipReader::createAndOpenFile(u32 index)
 #endif
 	}
 #endif
+	// large files are decompressed while reading
+	if ((actualCompressionMethod == 8 || actualCompressionMethod == 12 || actualCompressionMethod == 14) &&
+		e.header.DataDescriptor.UncompressedSize >= StreamingThreshold)
+		return createStreamReadFile(index, decrypted, actualCompressionMethod);
+
 	switch(actualCompressionMethod)
 	{
 	case 0: // no compression
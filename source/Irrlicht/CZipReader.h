@@ -200,6 +200,12 @@ namespace io
 		//! return the id of the file Archive
 		virtual const io::path& getArchiveName() const _IRR_OVERRIDE_ {return Path;}
 
+		//! Set the size from which compressed files are decompressed while reading
+		virtual void setStreamingThreshold(u32 size) _IRR_OVERRIDE_ {StreamingThreshold = size;}
+
+		//! Get the size from which compressed files are decompressed while reading
+		virtual u32 getStreamingThreshold() const _IRR_OVERRIDE_ {return StreamingThreshold;}
+
 	protected:
 
 		//! reads the next file header from a ZIP file, returns false if there are no more headers.
@@ -213,12 +219,29 @@ namespace io
 
 		bool scanCentralDirectoryHeader();
 
+		//! opens a compressed file which is decompressed while reading
+		IReadFile* createStreamReadFile(u32 index, IReadFile* decrypted, s16 compressionMethod);
+
+		//! returns the cache file of the file list and the modification time of the archive
+		//! returns an empty name if the file list is not cached
+		io::path getIndexCacheName(s64& archiveTime) const;
+
+		//! reads the file list from the cache, returns false if the cache doesn't match the archive
+		bool readIndexCache(const io::path& cacheName, s64 archiveTime);
+
+		//! writes the file list to the cache
+		void writeIndexCache(const io::path& cacheName, s64 archiveTime) const;
+
+		//! flags which have to match between the cache and the archive
+		u32 getIndexCacheFlags() const;
+
 		io::IFileSystem* FileSystem;
 		IReadFile* File;
 
 		// holds extended info about files
 		core::array<SZipFileEntry> FileInfo;
 
+		u32 StreamingThreshold;
 		bool IsGZip;
 	};
 
@@ -0,0 +1,466 @@
+// Copyright (C) 2002-2012 Nikolaus Gebhardt
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#include "CZipStreamReadFile.h"
+
+#ifdef __IRR_COMPILE_WITH_ZIP_ARCHIVE_LOADER_
+
+#include "os.h"
+
+#ifdef _IRR_COMPILE_WITH_ZLIB_
+	#ifndef _IRR_USE_NON_SYSTEM_ZLIB_
+	#include <zlib.h> // use system lib
+	#else
+	#include "zlib/zlib.h"
+	#endif
+
+	#ifdef _IRR_COMPILE_WITH_BZIP2_
+	#ifndef _IRR_USE_NON_SYSTEM_BZLIB_
+	#include <bzlib.h>
+	#else
+	#include "bzip2/bzlib.h"
+	#endif
+	#endif
+	#ifdef _IRR_COMPILE_WITH_LZMA_
+	#include "lzma/LzmaDec.h"
+	#endif
+#endif
+
+namespace irr
+{
+namespace io
+{
+
+namespace
+{
+	// size of the compressed data read from the archive at once
+	const u32 ZIP_STREAM_INPUT_SIZE = 16384;
+	// size of the decompressed data kept in memory
+	const u32 ZIP_STREAM_WINDOW_SIZE = 65536;
+	// distance of the deflate checkpoints in the decompressed data
+	const u32 ZIP_STREAM_CHECKPOINT_DISTANCE = 0x100000;
+
+#if defined(_IRR_COMPILE_WITH_ZLIB_) && defined(_IRR_COMPILE_WITH_LZMA_)
+	//! Used for LZMA decompression. The lib has no default memory management
+	void *SzAlloc(void *p, size_t size)
+	{
+		(void)p; // disable unused variable warnings
+		return malloc(size);
+	}
+	void SzFree(void *p, void *address)
+	{
+		(void)p; // disable unused variable warnings
+		free(address);
+	}
+	ISzAlloc lzmaAlloc = { SzAlloc, SzFree };
+#endif
+}
+
+
+//! State of the decompression
+struct CZipStreamReadFile::SDecoder
+{
+	SDecoder() : OutPos(0), InPos(0) {}
+
+	// position of a checkpoint in the decompressed data
+	long OutPos;
+	// position of a checkpoint in the compressed data, relative to the data start
+	u32 InPos;
+
+#ifdef _IRR_COMPILE_WITH_ZLIB_
+	z_stream Inflate;
+#ifdef _IRR_COMPILE_WITH_BZIP2_
+	bz_stream BZip;
+#endif
+#ifdef _IRR_COMPILE_WITH_LZMA_
+	CLzmaDec Lzma;
+#endif
+#endif
+};
+
+
+CZipStreamReadFile::CZipStreamReadFile(IReadFile* alreadyOpenedFile, long pos, u32 compressedSize,
+		u32 uncompressedSize, s16 compressionMethod, const io::path& name)
+	: Filename(name), File(alreadyOpenedFile), DataStart(pos), CompressedSize(compressedSize),
+	UncompressedSize(uncompressedSize), CompressionMethod(compressionMethod), Pos(0),
+	Input(0), InputBegin(0), InputEnd(0), InputPos(0),
+	Window(0), WindowStart(0), WindowFill(0), Decoder(0), Finished(false)
+{
+	#ifdef _DEBUG
+	setDebugName("CZipStreamReadFile");
+	#endif
+
+	if (File)
+	{
+		File->grab();
+		Input = new u8[ZIP_STREAM_INPUT_SIZE];
+		Window = new u8[ZIP_STREAM_WINDOW_SIZE];
+		restart();
+	}
+}
+
+
+CZipStreamReadFile::~CZipStreamReadFile()
+{
+#ifdef _IRR_COMPILE_WITH_ZLIB_
+	for (u32 i=0; i<Checkpoints.size(); ++i)
+	{
+		inflateEnd(&Checkpoints[i]->Inflate);
+		delete Checkpoints[i];
+	}
+#endif
+
+	if (Decoder)
+	{
+		switch (CompressionMethod)
+		{
+#ifdef _IRR_COMPILE_WITH_ZLIB_
+		case 8:
+			inflateEnd(&Decoder->Inflate);
+			break;
+#ifdef _IRR_COMPILE_WITH_BZIP2_
+		case 12:
+			BZ2_bzDecompressEnd(&Decoder->BZip);
+			break;
+#endif
+#ifdef _IRR_COMPILE_WITH_LZMA_
+		case 14:
+			LzmaDec_Free(&Decoder->Lzma, &lzmaAlloc);
+			break;
+#endif
+#endif
+		default:
+			break;
+		}
+		delete Decoder;
+	}
+
+	delete [] Input;
+	delete [] Window;
+
+	if (File)
+		File->drop();
+}
+
+
+//! starts the decompression at the begin of the data
+bool CZipStreamReadFile::restart()
+{
+	InputBegin = 0;
+	InputEnd = 0;
+	InputPos = 0;
+	WindowStart = 0;
+	WindowFill = 0;
+	Finished = false;
+
+	const bool created = (Decoder == 0);
+	if (created)
+		Decoder = new SDecoder();
+
+	bool success = false;
+	switch (CompressionMethod)
+	{
+#ifdef _IRR_COMPILE_WITH_ZLIB_
+	case 8:
+		if (created)
+		{
+			memset(&Decoder->Inflate, 0, sizeof(z_stream));
+			// wbits < 0 indicates no zlib header inside the data.
+			success = (inflateInit2(&Decoder->Inflate, -MAX_WBITS) == Z_OK);
+		}
+		else
+			success = (inflateReset(&Decoder->Inflate) == Z_OK);
+		break;
+#ifdef _IRR_COMPILE_WITH_BZIP2_
+	case 12:
+		if (!created)
+			BZ2_bzDecompressEnd(&Decoder->BZip);
+		memset(&Decoder->BZip, 0, sizeof(bz_stream));
+		success = (BZ2_bzDecompressInit(&Decoder->BZip, 0, 0) == BZ_OK);
+		break;
+#endif
+#ifdef _IRR_COMPILE_WITH_LZMA_
+	case 14:
+		{
+			// the lzma data starts with a version, the size of the properties and the properties
+			u8 header[4+LZMA_PROPS_SIZE];
+			File->seek(DataStart);
+			if (File->read(header, 4) != 4)
+				break;
+			const u32 propSize = (header[3]<<8) + header[2];
+			if (propSize != LZMA_PROPS_SIZE || File->read(header+4, propSize) != propSize)
+				break;
+			InputPos = 4 + propSize;
+
+			if (created)
+			{
+				LzmaDec_Construct(&Decoder->Lzma);
+				if (LzmaDec_Allocate(&Decoder->Lzma, header+4, propSize, &lzmaAlloc) != SZ_OK)
+					break;
+			}
+			LzmaDec_Init(&Decoder->Lzma);
+			success = true;
+		}
+		break;
+#endif
+#endif
+	default:
+		os::Printer::log("Decompression method not supported. File cannot be read.", Filename, ELL_ERROR);
+		break;
+	}
+
+	if (!success)
+	{
+		if (!created)
+			os::Printer::log("Could not restart decompression", Filename, ELL_ERROR);
+		delete Decoder;
+		Decoder = 0;
+	}
+
+	return success;
+}
+
+
+//! continues the decompression at the closest checkpoint before pos, if it is after the decoder
+void CZipStreamReadFile::skipToCheckpoint(long pos)
+{
+#ifdef _IRR_COMPILE_WITH_ZLIB_
+	SDecoder* checkpoint = 0;
+	for (u32 i=0; i<Checkpoints.size() && Checkpoints[i]->OutPos <= pos; ++i)
+		checkpoint = Checkpoints[i];
+
+	if (!checkpoint || checkpoint->OutPos <= WindowStart + (long)WindowFill)
+		return;
+
+	// the copied state refers to its own stream, so the decoder is replaced
+	SDecoder* decoder = new SDecoder();
+	if (inflateCopy(&decoder->Inflate, &checkpoint->Inflate) != Z_OK)
+	{
+		// continue without the checkpoint
+		delete decoder;
+		return;
+	}
+	inflateEnd(&Decoder->Inflate);
+	delete Decoder;
+	Decoder = decoder;
+
+	InputBegin = 0;
+	InputEnd = 0;
+	InputPos = checkpoint->InPos;
+	WindowStart = checkpoint->OutPos;
+	WindowFill = 0;
+	Finished = false;
+#else
+	(void)pos; // disable unused variable warnings
+#endif
+}
+
+
+//! remembers the decoder state for backward seeks
+void CZipStreamReadFile::addCheckpoint()
+{
+#ifdef _IRR_COMPILE_WITH_ZLIB_
+	// only inflate can copy its state
+	const long outPos = WindowStart + WindowFill;
+	if (CompressionMethod != 8 || Finished ||
+		outPos < (long)((Checkpoints.size()+1) * ZIP_STREAM_CHECKPOINT_DISTANCE))
+		return;
+
+	SDecoder* checkpoint = new SDecoder();
+	if (inflateCopy(&checkpoint->Inflate, &Decoder->Inflate) != Z_OK)
+	{
+		delete checkpoint;
+		return;
+	}
+	checkpoint->OutPos = outPos;
+	checkpoint->InPos = InputPos - (InputEnd - InputBegin);
+	Checkpoints.push_back(checkpoint);
+#endif
+}
+
+
+//! reads the next compressed bytes into the input buffer
+bool CZipStreamReadFile::fillInput()
+{
+	const u32 size = core::min_(ZIP_STREAM_INPUT_SIZE, CompressedSize - InputPos);
+	if (!size)
+		return false;
+
+	// the archive file is shared by all files opened from it
+	File->seek(DataStart + InputPos);
+	InputBegin = 0;
+	InputEnd = (u32)File->read(Input, size);
+	InputPos += InputEnd;
+	return InputEnd != 0;
+}
+
+
+//! decompresses the window following the current one
+bool CZipStreamReadFile::decodeWindow()
+{
+	WindowStart += WindowFill;
+	WindowFill = 0;
+
+	const u32 windowSize = (u32)core::min_((long)ZIP_STREAM_WINDOW_SIZE, (long)UncompressedSize - WindowStart);
+	while (WindowFill < windowSize && !Finished)
+	{
+		if (InputBegin == InputEnd)
+			fillInput();
+
+		const u32 inSize = InputEnd - InputBegin;
+		const u32 outSize = windowSize - WindowFill;
+		u32 consumed = 0;
+		u32 produced = 0;
+		bool error = false;
+
+		switch (CompressionMethod)
+		{
+#ifdef _IRR_COMPILE_WITH_ZLIB_
+		case 8:
+			{
+				z_stream& stream = Decoder->Inflate;
+				stream.next_in = (Bytef*)Input + InputBegin;
+				stream.avail_in = inSize;
+				stream.next_out = (Bytef*)Window + WindowFill;
+				stream.avail_out = outSize;
+				const int err = inflate(&stream, Z_NO_FLUSH);
+				consumed = inSize - stream.avail_in;
+				produced = outSize - stream.avail_out;
+				Finished = (err == Z_STREAM_END);
+				error = (err != Z_OK && err != Z_STREAM_END && err != Z_BUF_ERROR);
+			}
+			break;
+#ifdef _IRR_COMPILE_WITH_BZIP2_
+		case 12:
+			{
+				bz_stream& stream = Decoder->BZip;
+				stream.next_in = (char*)Input + InputBegin;
+				stream.avail_in = inSize;
+				stream.next_out = (char*)Window + WindowFill;
+				stream.avail_out = outSize;
+				const int err = BZ2_bzDecompress(&stream);
+				consumed = inSize - stream.avail_in;
+				produced = outSize - stream.avail_out;
+				Finished = (err == BZ_STREAM_END);
+				error = (err != BZ_OK && err != BZ_STREAM_END);
+			}
+			break;
+#endif
+#ifdef _IRR_COMPILE_WITH_LZMA_
+		case 14:
+			{
+				SizeT inLength = inSize;
+				SizeT outLength = outSize;
+				ELzmaStatus status;
+				const SRes err = LzmaDec_DecodeToBuf(&Decoder->Lzma, Window + WindowFill, &outLength,
+						Input + InputBegin, &inLength, LZMA_FINISH_ANY, &status);
+				consumed = (u32)inLength;
+				produced = (u32)outLength;
+				Finished = (status == LZMA_STATUS_FINISHED_WITH_MARK);
+				error = (err != SZ_OK);
+			}
+			break;
+#endif
+#endif
+		default:
+			error = true;
+			break;
+		}
+
+		InputBegin += consumed;
+		WindowFill += produced;
+
+		if (error)
+		{
+			os::Printer::log("Error decompressing", Filename, ELL_ERROR);
+			Finished = true;
+		}
+		else if (!consumed && !produced)
+		{
+			// the compressed data ended early
+			break;
+		}
+	}
+
+	addCheckpoint();
+	return WindowFill != 0;
+}
+
+
+//! returns how much was read
+size_t CZipStreamReadFile::read(void* buffer, size_t sizeToRead)
+{
+	if (!Decoder || Pos >= (long)UncompressedSize)
+		return 0;
+
+	const size_t size = core::min_(sizeToRead, (size_t)(UncompressedSize - Pos));
+	u8* out = (u8*)buffer;
+	size_t done = 0;
+	while (done < size)
+	{
+		if (Pos < WindowStart)
+		{
+			// behind the window, decompress again
+			if (!restart())
+				break;
+			skipToCheckpoint(Pos);
+		}
+		else if (Pos >= WindowStart + (long)WindowFill)
+		{
+			skipToCheckpoint(Pos);
+			if (!decodeWindow())
+				break;
+		}
+		else
+		{
+			const size_t count = core::min_(size - done, (size_t)(WindowStart + WindowFill - Pos));
+			memcpy(out + done, Window + (Pos - WindowStart), count);
+			done += count;
+			Pos += (long)count;
+		}
+	}
+
+	return done;
+}
+
+
+//! changes position in file, returns true if successful
+bool CZipStreamReadFile::seek(long finalPos, bool relativeMovement)
+{
+	const long pos = finalPos + (relativeMovement ? Pos : 0);
+	if (pos < 0 || pos > (long)UncompressedSize)
+		return false;
+
+	// the data is decompressed when reading
+	Pos = pos;
+	return true;
+}
+
+
+//! returns size of file
+long CZipStreamReadFile::getSize() const
+{
+	return UncompressedSize;
+}
+
+
+//! returns where in the file we are.
+long CZipStreamReadFile::getPos() const
+{
+	return Pos;
+}
+
+
+//! returns name of file
+const io::path& CZipStreamReadFile::getFileName() const
+{
+	return Filename;
+}
+
+
+} // end namespace io
+} // end namespace irr
+
+#endif // __IRR_COMPILE_WITH_ZIP_ARCHIVE_LOADER_
+
@@ -0,0 +1,113 @@
+// Copyright (C) 2002-2012 Nikolaus Gebhardt
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#ifndef __C_ZIP_STREAM_READ_FILE_H_INCLUDED__
+#define __C_ZIP_STREAM_READ_FILE_H_INCLUDED__
+
+#include "IrrCompileConfig.h"
+
+#ifdef __IRR_COMPILE_WITH_ZIP_ARCHIVE_LOADER_
+
+#include "IReadFile.h"
+#include "irrArray.h"
+#include "irrString.h"
+
+namespace irr
+{
+namespace io
+{
+
+	/*! A read file decompressing a compressed file of an archive while reading.
+		Only a small window of the uncompressed data is kept in memory.
+		Reads and forward seeks decompress up to the requested position,
+		backward seeks behind the window start again from the closest
+		checkpoint (deflate) or from the begin of the data (bzip2, lzma).
+	!*/
+	class CZipStreamReadFile : public IReadFile
+	{
+	public:
+
+		//! Constructor
+		/** \param alreadyOpenedFile File containing the compressed data.
+		\param pos Position of the compressed data in the file.
+		\param compressedSize Size of the compressed data.
+		\param uncompressedSize Size of the decompressed data.
+		\param compressionMethod 8 for deflate, 12 for bzip2, 14 for lzma.
+		\param name Name of the file. */
+		CZipStreamReadFile(IReadFile* alreadyOpenedFile, long pos, u32 compressedSize,
+				u32 uncompressedSize, s16 compressionMethod, const io::path& name);
+
+		virtual ~CZipStreamReadFile();
+
+		//! returns true if the decompression could be started
+		bool isValid() const { return Decoder != 0; }
+
+		//! returns how much was read
+		virtual size_t read(void* buffer, size_t sizeToRead) _IRR_OVERRIDE_;
+
+		//! changes position in file, returns true if successful
+		//! if relativeMovement==true, the pos is changed relative to current pos,
+		//! otherwise from begin of file
+		virtual bool seek(long finalPos, bool relativeMovement = false) _IRR_OVERRIDE_;
+
+		//! returns size of file
+		virtual long getSize() const _IRR_OVERRIDE_;
+
+		//! returns where in the file we are.
+		virtual long getPos() const _IRR_OVERRIDE_;
+
+		//! returns name of file
+		virtual const io::path& getFileName() const _IRR_OVERRIDE_;
+
+	private:
+
+		struct SDecoder;
+
+		//! starts the decompression at the begin of the data
+		bool restart();
+
+		//! continues the decompression at the closest checkpoint before pos, if it is after the decoder
+		void skipToCheckpoint(long pos);
+
+		//! remembers the decoder state for backward seeks
+		void addCheckpoint();
+
+		//! decompresses the window following the current one
+		bool decodeWindow();
+
+		//! reads the next compressed bytes into the input buffer
+		bool fillInput();
+
+		io::path Filename;
+		IReadFile* File;
+		long DataStart;
+		u32 CompressedSize;
+		u32 UncompressedSize;
+		s16 CompressionMethod;
+
+		long Pos;
+
+		// compressed data read from the file
+		u8* Input;
+		u32 InputBegin;
+		u32 InputEnd;
+		// position of the next compressed byte read from the file, relative to DataStart
+		u32 InputPos;
+
+		// decompressed data
+		u8* Window;
+		long WindowStart;
+		u32 WindowFill;
+
+		SDecoder* Decoder;
+		core::array<SDecoder*> Checkpoints;
+		bool Finished;
+	};
+
+} // end namespace io
+} // end namespace irr
+
+#endif // __IRR_COMPILE_WITH_ZIP_ARCHIVE_LOADER_
+#endif // __C_ZIP_STREAM_READ_FILE_H_INCLUDED__
+
@@ -27,6 +27,12 @@ namespace irr
 		EPID_SM_RENDER_EFFECT,
 		EPID_SM_REGISTER,
 
+		//! render queue of the scenemanager
+		EPID_RQ_SORT_AND_DRAW,
+		EPID_RQ_ITEMS,
+		EPID_RQ_MATERIAL_CHANGES,
+		EPID_RQ_TEXTURE_CHANGES,
+
 		//! octrees
 		EPID_OC_RENDER,
 		EPID_OC_CALCPOLYS,
@@ -36,6 +36,8 @@ namespace video
 		Driver = driver;
 		RenderTarget = 0;
 		ColorMask = COLOR_BRIGHT_WHITE;
+		ScanlineClipStart = 0;
+		ScanlineClipEnd = 0x7FFFFFFF;
 		DepthBuffer = (CDepthBuffer*) driver->getDepthBuffer ();
 		if ( DepthBuffer )
 			DepthBuffer->grab();
@@ -113,6 +115,25 @@ namespace video
 	}
 
 
+	//! restricts rasterization to the scanlines [start, end)
+	void IBurningShader::setScanlineClip ( s32 start, s32 end )
+	{
+		ScanlineClipStart = start;
+		ScanlineClipEnd = end;
+	}
+
+
+	//! uses the texture stages of another shader, without a reference to the textures
+	void IBurningShader::copyTextureParam ( const sInternalTexture* it )
+	{
+		for ( u32 i = 0; i != BURNING_MATERIAL_MAX_TEXTURES; ++i )
+		{
+			IT[i] = it[i];
+			IT[i].Texture = 0;
+		}
+	}
+
+
 } // end namespace video
 } // end namespace irr
 
@@ -115,6 +115,7 @@ namespace video
 		ETR_STENCIL_SHADOW,
 
 		ETR_TEXTURE_BLEND,
+		ETR_OCCLUSION_QUERY,
 		ETR_REFERENCE,
 		ETR_INVALID,
 
@@ -144,6 +145,20 @@ namespace video
 
 		virtual void setMaterial ( const SBurningShaderMaterial &material ) {};
 
+		//! adds the number of pixels passing the depth test to counter, for occlusion queries
+		virtual void setSampleCounter ( u32* counter ) {};
+
+		//! restricts rasterization to the scanlines [start, end)
+		void setScanlineClip ( s32 start, s32 end );
+
+		//! returns the texture stages set by setTextureParam
+		const sInternalTexture* getTextureParam () const { return IT; }
+
+		//! uses the texture stages of another shader, without a reference to the textures
+		/** Used when drawing screen bands on several threads. The caller
+		has to keep the textures alive. Don't mix with setTextureParam. */
+		void copyTextureParam ( const sInternalTexture* it );
+
 	protected:
 
 		CBurningVideoDriver *Driver;
@@ -155,6 +170,9 @@ namespace video
 
 		sInternalTexture IT[ BURNING_MATERIAL_MAX_TEXTURES ];
 
+		s32 ScanlineClipStart;
+		s32 ScanlineClipEnd;
+
 		static const tFixPointu dithermask[ 4 * 4];
 	};
 
@@ -189,6 +207,7 @@ namespace video
 
 	IBurningShader* createTRNormalMap(CBurningVideoDriver* driver);
 	IBurningShader* createTRStencilShadow(CBurningVideoDriver* driver);
+	IBurningShader* createTROcclusionQuery(CBurningVideoDriver* driver);
 
 	IBurningShader* createTriangleRendererReference(CBurningVideoDriver* driver);
 
@@ -0,0 +1,73 @@
+// Copyright (C) 2002-2012 Nikolaus Gebhardt
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#ifndef __IRR_PARTICLE_SIMD_H_INCLUDED__
+#define __IRR_PARTICLE_SIMD_H_INCLUDED__
+
+#include "irrTypes.h"
+
+// The particle system and the built in affectors work on four particles at
+// once with SSE2. Define NO_IRR_PARTICLES_SSE2_ to use the plain C++ loops.
+#if !defined(NO_IRR_PARTICLES_SSE2_) && \
+	(defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+	#define _IRR_PARTICLES_SSE2_
+	#include <emmintrin.h>
+#endif
+
+namespace irr
+{
+namespace scene
+{
+
+#if defined(_IRR_PARTICLES_SSE2_)
+
+	//! loads four values of a particle array
+	inline __m128 loadParticles(const f32* values)
+	{
+		return _mm_loadu_ps(values);
+	}
+
+	//! loads four times of a particle array
+	inline __m128i loadParticles(const u32* values)
+	{
+		return _mm_loadu_si128((const __m128i*)values);
+	}
+
+	//! stores four values of a particle array
+	inline void storeParticles(f32* values, __m128 v)
+	{
+		_mm_storeu_ps(values, v);
+	}
+
+	//! converts four unsigned times to floats, like a (f32) cast of each
+	inline __m128 timeToFloat(__m128i v)
+	{
+		// the conversion is signed, values from 2^31 on come out negative
+		const __m128 f = _mm_cvtepi32_ps(v);
+		return _mm_add_ps(f, _mm_and_ps(_mm_cmplt_ps(f, _mm_setzero_ps()), _mm_set1_ps(4294967296.f)));
+	}
+
+	//! returns the smallest of four values
+	inline f32 minParticles(__m128 v)
+	{
+		v = _mm_min_ps(v, _mm_shuffle_ps(v, v, _MM_SHUFFLE(2,3,0,1)));
+		v = _mm_min_ps(v, _mm_shuffle_ps(v, v, _MM_SHUFFLE(1,0,3,2)));
+		return _mm_cvtss_f32(v);
+	}
+
+	//! returns the largest of four values
+	inline f32 maxParticles(__m128 v)
+	{
+		v = _mm_max_ps(v, _mm_shuffle_ps(v, v, _MM_SHUFFLE(2,3,0,1)));
+		v = _mm_max_ps(v, _mm_shuffle_ps(v, v, _MM_SHUFFLE(1,0,3,2)));
+		return _mm_cvtss_f32(v);
+	}
+
+#endif
+
+} // end namespace scene
+} // end namespace irr
+
+#endif
+
@@ -93,6 +93,36 @@
 
 #define SOFTWARE_DRIVER_2_MIPMAPPING_SCALE (16/SOFTWARE_DRIVER_2_MIPMAPPING_MAX)
 
+// batched vertex transform with SSE2, bit identical to the scalar code.
+// not combined with IRRLICHT_FAST_MATH, which uses approximations there.
+#if !defined ( IRRLICHT_FAST_MATH ) && !defined ( NO_SOFTWARE_DRIVER_2_SSE2 ) && \
+	( defined ( __SSE2__ ) || defined ( _M_X64 ) || ( defined ( _M_IX86_FP ) && _M_IX86_FP >= 2 ) )
+	#define SOFTWARE_DRIVER_2_SSE2
+#endif
+
+// 2D blitter kernels for 32 bit images with SSE2. AVX2 versions are compiled
+// as well and used when the cpu supports them. bit identical to the scalar code.
+#if !defined ( NO_SOFTWARE_DRIVER_2_SSE2 ) && \
+	( defined ( __SSE2__ ) || defined ( _M_X64 ) || ( defined ( _M_IX86_FP ) && _M_IX86_FP >= 2 ) )
+	#define SOFTWARE_DRIVER_2_BLIT_SSE2
+	#if !defined ( NO_SOFTWARE_DRIVER_2_AVX2 ) && ( defined ( __clang__ ) || \
+		( defined ( __GNUC__ ) && ( __GNUC__ > 4 || ( __GNUC__ == 4 && __GNUC_MINOR__ >= 9 ) ) ) || \
+		( defined ( _MSC_VER ) && _MSC_VER >= 1700 ) )
+		#define SOFTWARE_DRIVER_2_BLIT_AVX2
+	#endif
+#endif
+
+// hierarchical depth test, depth range of 8x8 pixel blocks. needs the w-buffer
+#define SOFTWARE_DRIVER_2_DEPTH_BLOCK_LOG2	3
+#define SOFTWARE_DRIVER_2_DEPTH_BLOCK		( 1 << SOFTWARE_DRIVER_2_DEPTH_BLOCK_LOG2 )
+#if defined ( SOFTWARE_DRIVER_2_USE_WBUFFER ) && !defined ( NO_SOFTWARE_DRIVER_2_HIERARCHICAL_Z )
+	#define SOFTWARE_DRIVER_2_HIERARCHICAL_Z
+#endif
+
+// multithreaded rendering, screen band height and minimal primitive count per draw call
+#define SOFTWARE_DRIVER_2_BAND_HEIGHT			32
+#define SOFTWARE_DRIVER_2_BAND_MIN_PRIMITIVES	64
+
 #ifndef REALINLINE
 	#ifdef _MSC_VER
 		#define REALINLINE __forceinline
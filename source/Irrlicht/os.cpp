@@ -310,35 +310,80 @@ namespace os
 
 #endif // end linux / emscripten / android / windows
 
+#if defined(_IRR_COMPILE_WITH_THREADS_) && defined(_MSC_VER)
+	#define _IRR_THREAD_LOCAL_ __declspec(thread)
+#elif defined(_IRR_COMPILE_WITH_THREADS_)
+	#define _IRR_THREAD_LOCAL_ __thread
+#else
+	#define _IRR_THREAD_LOCAL_
+#endif
+
 namespace os
 {
 	// The platform independent implementation of the printer
 	ILogger* Printer::Logger = 0;
 
+	// messages of the current thread are collected here when set
+	static _IRR_THREAD_LOCAL_ core::array<Printer::SMessage>* ThreadQueue = 0;
+
 	void Printer::log(const c8* message, ELOG_LEVEL ll)
 	{
-		if (Logger)
+		if (ThreadQueue)
+			queueMessage(message, 0, ll);
+		else if (Logger)
 			Logger->log(message, ll);
 	}
 
 	void Printer::log(const wchar_t* message, ELOG_LEVEL ll)
 	{
-		if (Logger)
+		if (ThreadQueue)
+			queueMessage(core::stringc(message).c_str(), 0, ll);
+		else if (Logger)
 			Logger->log(message, ll);
 	}
 
 	void Printer::log(const c8* message, const c8* hint, ELOG_LEVEL ll)
 	{
-		if (Logger)
+		if (ThreadQueue)
+			queueMessage(message, hint, ll);
+		else if (Logger)
 			Logger->log(message, hint, ll);
 	}
 
 	void Printer::log(const c8* message, const io::path& hint, ELOG_LEVEL ll)
 	{
-		if (Logger)
+		if (ThreadQueue)
+			queueMessage(message, hint.c_str(), ll);
+		else if (Logger)
 			Logger->log(message, hint.c_str(), ll);
 	}
 
+	void Printer::setThreadQueue(core::array<SMessage>* queue)
+	{
+		ThreadQueue = queue;
+	}
+
+	void Printer::log(const core::array<SMessage>& queue)
+	{
+		for (u32 i=0; i<queue.size(); ++i)
+		{
+			if (queue[i].Hint.size())
+				log(queue[i].Text.c_str(), queue[i].Hint.c_str(), queue[i].Level);
+			else
+				log(queue[i].Text.c_str(), queue[i].Level);
+		}
+	}
+
+	void Printer::queueMessage(const c8* message, const c8* hint, ELOG_LEVEL ll)
+	{
+		SMessage entry;
+		entry.Text = message;
+		if (hint)
+			entry.Hint = hint;
+		entry.Level = ll;
+		ThreadQueue->push_back(entry);
+	}
+
 	// our Randomizer is not really os specific, so we
 	// code one for all, which should work on every platform the same,
 	// which is desirable.
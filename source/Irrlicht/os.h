@@ -8,6 +8,7 @@
 #include "IrrCompileConfig.h" // for endian check
 #include "irrTypes.h"
 #include "irrString.h"
+#include "irrArray.h"
 #include "path.h"
 #include "ILogger.h"
 #include "ITimer.h"
@@ -42,6 +43,25 @@ namespace os
 		static void log(const c8* message, const c8* hint, ELOG_LEVEL ll = ELL_INFORMATION);
 		static void log(const c8* message, const io::path& hint, ELOG_LEVEL ll = ELL_INFORMATION);
 		static ILogger* Logger;
+
+		//! message held back by setThreadQueue
+		struct SMessage
+		{
+			core::stringc Text;
+			core::stringc Hint;
+			ELOG_LEVEL Level;
+		};
+
+		//! Collects the log messages of the calling thread in queue instead of logging them.
+		/** Used by jobs on worker threads, as the log receivers expect the
+		main thread. 0 logs directly again. */
+		static void setThreadQueue(core::array<SMessage>* queue);
+
+		//! Logs messages collected on another thread
+		static void log(const core::array<SMessage>& queue);
+
+	private:
+		static void queueMessage(const c8* message, const c8* hint, ELOG_LEVEL ll);
 	};
 
 
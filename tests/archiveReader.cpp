@@ -353,6 +353,316 @@ bool testSpecialZip(IFileSystem* fs, const char* archiveName, const char* filena
 	return true;
 }
 
+//! Compares a file decompressed while reading with the completely decompressed file
+bool testStreamingFile(IFileSystem* fs, IFileArchive* archive, const char* filename)
+{
+	archive->setStreamingThreshold(0xffffffff);
+	IReadFile* memoryFile = fs->createAndOpenFile(filename);
+	archive->setStreamingThreshold(0);
+	IReadFile* streamFile = fs->createAndOpenFile(filename);
+	if (!memoryFile || !streamFile || memoryFile->getSize() != streamFile->getSize())
+	{
+		logTestString("Opening %s failed\n", filename);
+		if (memoryFile)
+			memoryFile->drop();
+		if (streamFile)
+			streamFile->drop();
+		return false;
+	}
+
+	const long size = memoryFile->getSize();
+	u8* expected = new u8[size];
+	u8* data = new u8[size];
+	bool result = (memoryFile->read(expected, size) == (size_t)size);
+	memoryFile->drop();
+
+	// read all in odd blocks
+	long pos = 0;
+	while (result && pos < size)
+	{
+		const size_t count = streamFile->read(data + pos, 1234);
+		result &= (count != 0);
+		pos += (long)count;
+	}
+	result &= (pos == size) && !memcmp(expected, data, size);
+	result &= (streamFile->getPos() == size);
+	result &= (streamFile->read(data, 10) == 0);
+
+	// seeking back and forth, over checkpoints and to the end
+	const long positions[] = { 10, size - 1000, 1500000, 100000, 2200000, 0, size / 2, size / 2 - 70000 };
+	for (u32 i=0; i<sizeof(positions)/sizeof(positions[0]); ++i)
+	{
+		const long start = core::min_(positions[i], size);
+		result &= streamFile->seek(start);
+		const size_t count = core::min_((long)100000, size - start);
+		result &= (streamFile->read(data, 100000) == count);
+		result &= !memcmp(expected + start, data, count);
+		result &= (streamFile->getPos() == start + (long)count);
+	}
+
+	result &= streamFile->seek(0);
+	result &= streamFile->seek(500, true);
+	result &= (streamFile->read(data, 8) == 8) && !memcmp(expected + 500, data, 8);
+	result &= !streamFile->seek(size + 1);
+	result &= !streamFile->seek(-10);
+
+	streamFile->drop();
+	delete [] expected;
+	delete [] data;
+
+	if (!result)
+		logTestString("Reading %s while decompressing failed\n", filename);
+
+	return result;
+}
+
+bool testStreamingZip(IFileSystem* fs)
+{
+	IFileArchive* archive = 0;
+	if (!fs->addFileArchive("media/streaming.zip", true, false, EFAT_UNKNOWN, "", &archive) || !archive)
+	{
+		logTestString("Mounting archive failed\n");
+		return false;
+	}
+
+	bool result = (archive->getStreamingThreshold() == 0x100000);
+	result &= testStreamingFile(fs, archive, "deflate.txt");
+#ifdef _IRR_COMPILE_WITH_BZIP2_
+	result &= testStreamingFile(fs, archive, "bzip2.txt");
+#endif
+#ifdef _IRR_COMPILE_WITH_LZMA_
+	result &= testStreamingFile(fs, archive, "lzma.txt");
+#endif
+
+	result &= fs->removeFileArchive(archive);
+	return result;
+}
+
+//! Checks that files from disk and uncompressed files in archives give access to their contents
+bool testFileData(IFileSystem* fs)
+{
+	bool result = true;
+	// files are read by default
+	IReadFile* file = fs->createAndOpenFile("media/file_with_path.zip");
+	if (!file)
+		return false;
+	result &= (file->getData() == 0);
+	file->drop();
+
+	fs->setFileMapping(true);
+	file = fs->createAndOpenFile("media/file_with_path.zip");
+	fs->setFileMapping(false);
+	if (!file)
+		return false;
+#ifdef _IRR_COMPILE_WITH_MAPPED_READ_FILE_
+	result &= (file->getData() != 0);
+	result &= file->getData() && !memcmp(file->getData(), "PK\x03\x04", 4);
+#endif
+
+	// the contents don't depend on the position
+	char tmp[14] = {'\0'};
+	result &= file->seek(10) && file->read(tmp, 4) == 4;
+	result &= (file->getPos() == 14);
+	result &= !file->getData() || !memcmp((const c8*)file->getData() + 10, tmp, 4);
+	result &= !file->seek(file->getSize() + 1);
+
+	IFileArchive* archive = 0;
+	result &= fs->addFileArchive(file, true, false, EFAT_UNKNOWN, "", &archive);
+	file->drop();
+	if (!archive)
+		return false;
+
+	// stored files are views into the archive
+	IReadFile* stored = fs->createAndOpenFile("test/test.txt");
+	result &= (stored != 0);
+	if (stored)
+	{
+		result &= (stored->read(tmp, 13) == 13) && !strncmp(tmp, "Hello world!", 12);
+#ifdef _IRR_COMPILE_WITH_MAPPED_READ_FILE_
+		result &= stored->getData() && !memcmp(stored->getData(), tmp, 13);
+#endif
+		stored->drop();
+	}
+	result &= fs->removeFileArchive(archive);
+
+	// memory files
+	const c8 memory[] = "memory";
+	file = fs->createMemoryReadFile(memory, 6, "memory.txt");
+	result &= (file->getData() == memory);
+	file->drop();
+
+	if (!result)
+		logTestString("Access to the contents of files failed\n");
+
+	return result;
+}
+
+//! returns the size of a file found in the archives, or -1
+static long getOverlaySize(IFileSystem* fs, const io::path& filename)
+{
+	IReadFile* file = fs->createAndOpenFile(filename);
+	if (!file)
+		return -1;
+	const long size = file->getSize();
+	file->drop();
+	return size;
+}
+
+//! Checks that files are found in the first archive containing them
+bool testArchiveOverlay(IFileSystem* fs)
+{
+	bool result = true;
+	result &= fs->addFileArchive("media/file_with_path.zip", true, false);
+	result &= fs->addFileArchive("media/overlay.zip", false, false);
+	if (!result || fs->getFileArchiveCount() != 2)
+		return false;
+
+	// mypath/myfile.txt has 5 bytes in file_with_path.zip and 12 in overlay.zip
+	result &= (getOverlaySize(fs, "mypath/myfile.txt") == 5);
+	result &= (getOverlaySize(fs, "mypath/overlay.txt") == 12);
+	result &= fs->existFile("mypath/");
+	result &= !fs->existFile("mypath/missing.txt");
+
+	// overlay.zip comes first now. it keeps the case of its names, but
+	// like in the file list the case is ignored when searching them
+	result &= fs->moveFileArchive(1, -1);
+	result &= (getOverlaySize(fs, "mypath/myfile.txt") == 12);
+	result &= (getOverlaySize(fs, "MyPath\\MyFile.txt") == 12);
+	result &= fs->existFile("MyPath/Overlay.txt");
+
+	result &= fs->removeFileArchive((u32)0);
+	result &= (getOverlaySize(fs, "mypath/myfile.txt") == 5);
+	result &= !fs->existFile("mypath/overlay.txt");
+
+	// archives not created by the file system keep their priority
+	IFileArchive* archive = 0;
+	for (u32 i=0; i<fs->getArchiveLoaderCount() && !archive; ++i)
+	{
+		if (fs->getArchiveLoader(i)->isALoadableFileFormat("media/overlay.zip"))
+			archive = fs->getArchiveLoader(i)->createArchive("media/overlay.zip", false, false);
+	}
+	result &= (archive != 0);
+	if (archive)
+	{
+		result &= fs->addFileArchive(archive);
+		archive->drop();
+		result &= (getOverlaySize(fs, "mypath/myfile.txt") == 5);
+		result &= fs->moveFileArchive(1, -1);
+		result &= (getOverlaySize(fs, "mypath/myfile.txt") == 12);
+		result &= fs->existFile("mypath/overlay.txt");
+	}
+
+	while (fs->getFileArchiveCount())
+		result &= fs->removeFileArchive(fs->getFileArchiveCount()-1);
+
+	result &= fs->addFileArchive("media/file_with_path.zip", false, false);
+	result &= (getOverlaySize(fs, "MyPath/MyFile.TXT") == 5);
+	result &= (getOverlaySize(fs, "TEST/TEST.TXT") == 13);
+	result &= fs->existFile("Test/");
+	result &= fs->removeFileArchive(fs->getFileArchiveCount()-1);
+
+	if (!result)
+		logTestString("Files not found in the first archive containing them\n");
+
+	return result;
+}
+
+//! Checks that archives read on worker threads are added in the order of the calls
+bool testAsyncArchives()
+{
+	SIrrlichtCreationParameters params;
+	params.DriverType = video::EDT_NULL;
+	params.WindowSize = core::dimension2du(1, 1);
+	params.WorkerThreads = 2;
+	IrrlichtDevice* device = createDeviceEx(params);
+	if (!device)
+		return false;
+	IFileSystem* fs = device->getFileSystem();
+
+	bool result = true;
+	result &= fs->addFileArchiveAsync("media/file_with_path.zip", true, false);
+	result &= fs->addFileArchiveAsync("media/overlay.zip", false, false);
+	result &= fs->addFileArchiveAsync("media/sample_pakfile.pak", true, false);
+	// already read
+	result &= fs->addFileArchiveAsync("media/overlay.zip", false, false);
+	// folders are added at once, after the archives read before
+	result &= fs->addFileArchiveAsync("media/file_with_path", true, false);
+
+	result &= (fs->getFileArchiveCount() == 4);
+	result &= !fs->isFileArchiveLoading();
+	if (fs->getFileArchiveCount() == 4)
+	{
+		result &= (fs->getFileArchive(0)->getType() == EFAT_ZIP);
+		result &= core::hasFileExtension(fs->getFileArchive(0)->getFileList()->getPath(), "zip");
+		result &= (fs->getFileArchive(1)->getType() == EFAT_ZIP);
+		result &= (fs->getFileArchive(1)->getFileList()->getFileCount() == 2);
+		result &= (fs->getFileArchive(2)->getType() == EFAT_PAK);
+		result &= (fs->getFileArchive(3)->getType() == EFAT_FOLDER);
+	}
+	result &= (getOverlaySize(fs, "mypath/myfile.txt") == 5);
+	result &= (getOverlaySize(fs, "mypath/overlay.txt") == 12);
+
+	device->closeDevice();
+	device->run();
+	device->drop();
+
+	if (!result)
+		logTestString("Archives read on worker threads not added correctly\n");
+
+	return result;
+}
+
+//! Checks that file lists of zip archives read from the cache are the same as read from the archive
+bool testArchiveCache(IFileSystem* fs)
+{
+	bool result = true;
+	core::array<io::path> names;
+	core::array<u32> sizes;
+
+	// read without cache, then the cache is written (or read if it exists) and read
+	for (u32 pass=0; pass<3; ++pass)
+	{
+		fs->setArchiveCacheDirectory(pass ? "results" : "");
+		result &= (fs->getArchiveCacheDirectory().empty() == (pass == 0));
+
+		IFileArchive* archive = 0;
+		result &= fs->addFileArchive("media/file_with_path.zip", true, false, EFAT_UNKNOWN, "", &archive);
+		if (!archive)
+			break;
+
+		const IFileList* list = archive->getFileList();
+		for (u32 i=0; i<list->getFileCount(); ++i)
+		{
+			io::path name = list->getFullFileName(i);
+			if (list->isDirectory(i))
+				name.append('/');
+			if (pass == 0)
+			{
+				names.push_back(name);
+				sizes.push_back(list->getFileSize(i));
+			}
+			else
+				result &= (i < names.size()) && (names[i] == name) && (sizes[i] == list->getFileSize(i));
+		}
+		result &= (list->getFileCount() == names.size());
+		result &= (getOverlaySize(fs, "test/test.txt") == 13);
+		result &= fs->existFile("mypath/mypath/");
+		result &= fs->removeFileArchive(archive);
+	}
+
+	// the flags are part of the cache
+	result &= fs->addFileArchive("media/file_with_path.zip", true, true);
+	result &= fs->existFile("test.txt");
+	result &= fs->removeFileArchive(fs->getFileArchiveCount()-1);
+
+	fs->setArchiveCacheDirectory("");
+
+	if (!result)
+		logTestString("File list of zip archive not read from the cache correctly\n");
+
+	return result;
+}
+
 static bool testMountFile(IFileSystem* fs)
 {
 	bool result = true;
@@ -457,6 +767,16 @@ bool archiveReader()
 	ret &= testSpecialZip(fs, "media/lzmadata.zip", "tahoma10_.xml", buf);
 //	logTestString("Testing complex mount file.\n");
 //	ret &= testMountFile(fs);
+	logTestString("Testing zip files decompressed while reading.\n");
+	ret &= testStreamingZip(fs);
+	logTestString("Testing file contents in memory.\n");
+	ret &= testFileData(fs);
+	logTestString("Testing the order of archives.\n");
+	ret &= testArchiveOverlay(fs);
+	logTestString("Testing archives read on worker threads.\n");
+	ret &= testAsyncArchives();
+	logTestString("Testing cached file lists of zip archives.\n");
+	ret &= testArchiveCache(fs);
 	logTestString("Testing add/remove with filenames.\n");
 	ret &= testAddRemove(fs, "media/file_with_path.zip");
 
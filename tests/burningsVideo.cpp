@@ -2,11 +2,281 @@
 // No rights reserved: this software is in the public domain.
 
 #include "testUtils.h"
+#include <stdio.h>
+#if defined(_IRR_WINDOWS_API_)
+#include <direct.h>
+#else
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
 
 using namespace irr;
 using namespace scene;
 using namespace video;
 
+//! Renders a textured and a wireframe sphere and returns the screenshot
+static IImage* renderSpheres(u32 workerThreads, const io::path& mipMapCachePath = io::path())
+{
+	SIrrlichtCreationParameters params;
+	params.DriverType = video::EDT_BURNINGSVIDEO;
+	params.WindowSize = core::dimension2du(160,120);
+	params.WorkerThreads = workerThreads;
+	params.MipMapCachePath = mipMapCachePath;
+
+	IrrlichtDevice *device = createDeviceEx(params);
+	if (!device)
+		return 0;
+
+	IVideoDriver* driver = device->getVideoDriver();
+	ISceneManager* smgr = device->getSceneManager();
+
+	ISceneNode* node = smgr->addSphereSceneNode(10.f, 64, 0, -1, core::vector3df(-6.f, 0.f, 25.f));
+	node->setMaterialTexture(0, driver->getTexture("../media/wall.bmp"));
+	node->setMaterialFlag(video::EMF_LIGHTING, false);
+	node = smgr->addSphereSceneNode(8.f, 32, 0, -1, core::vector3df(8.f, 2.f, 20.f));
+	node->setMaterialFlag(video::EMF_WIREFRAME, true);
+	node->setMaterialFlag(video::EMF_LIGHTING, false);
+	smgr->addCameraSceneNode();
+
+	IImage* screenshot = 0;
+	device->run();
+	if (driver->beginScene(video::ECBF_COLOR | video::ECBF_DEPTH, video::SColor(0, 80, 80, 80)))
+	{
+		smgr->drawAll();
+		screenshot = driver->createScreenShot();
+		driver->endScene();
+	}
+
+	device->closeDevice();
+	device->run();
+	device->drop();
+
+	return screenshot;
+}
+
+//! Rendering in screen bands on worker threads has to give the same pixels
+static bool multiThreadedRendering()
+{
+	IImage* single = renderSpheres(0);
+	IImage* multi = renderSpheres(3);
+
+	bool result = single && multi &&
+		single->getDimension() == multi->getDimension() &&
+		single->getColorFormat() == multi->getColorFormat() &&
+		0 == memcmp(single->getData(), multi->getData(), single->getImageDataSizeInBytes());
+
+	if (!result)
+		logTestString("Multithreaded rendering differs from single threaded rendering.\n");
+
+	if (single)
+		single->drop();
+	if (multi)
+		multi->drop();
+
+	return result;
+}
+
+//! Directory of the mipmap cache test, created and emptied by the test
+static const char* const MipMapCacheDir = "results/mipmapcache";
+
+//! Removes the cache files of the mipmap cache test, returns how many there were
+static u32 clearMipMapCache()
+{
+	IrrlichtDevice* device = createDevice(video::EDT_NULL);
+	if (!device)
+		return 0;
+
+	io::IFileSystem* fs = device->getFileSystem();
+	const io::path workingDirectory = fs->getWorkingDirectory();
+	u32 removed = 0;
+	if (fs->changeWorkingDirectoryTo(MipMapCacheDir))
+	{
+		io::IFileList* files = fs->createFileList();
+		for (u32 i = 0; i < files->getFileCount(); ++i)
+		{
+			if (!files->isDirectory(i) && core::hasFileExtension(files->getFileName(i), "mip") &&
+				0 == remove(files->getFullFileName(i).c_str()))
+				++removed;
+		}
+		files->drop();
+		fs->changeWorkingDirectoryTo(workingDirectory);
+	}
+
+	device->closeDevice();
+	device->run();
+	device->drop();
+
+	return removed;
+}
+
+//! Mipmaps read from the cache have to give the same pixels as generated ones
+static bool mipMapCache()
+{
+	// start with an empty cache, the second rendering writes it
+#if defined(_IRR_WINDOWS_API_)
+	_mkdir("results");
+	_mkdir(MipMapCacheDir);
+#else
+	mkdir("results", 0777);
+	mkdir(MipMapCacheDir, 0777);
+#endif
+	clearMipMapCache();
+
+	IImage* generated = renderSpheres(0);
+	IImage* written = renderSpheres(0, MipMapCacheDir);
+	IImage* cached = renderSpheres(0, MipMapCacheDir);
+
+	const u32 cacheFiles = clearMipMapCache();
+#if defined(_IRR_WINDOWS_API_)
+	_rmdir(MipMapCacheDir);
+#else
+	rmdir(MipMapCacheDir);
+#endif
+
+	bool result = generated && written && cached &&
+		0 == memcmp(generated->getData(), written->getData(), generated->getImageDataSizeInBytes()) &&
+		0 == memcmp(generated->getData(), cached->getData(), generated->getImageDataSizeInBytes());
+
+	if (!result)
+		logTestString("Rendering with cached mipmaps differs from generated mipmaps.\n");
+
+	if (0 == cacheFiles)
+	{
+		logTestString("No mipmap cache files were written.\n");
+		result = false;
+	}
+
+	if (generated)
+		generated->drop();
+	if (written)
+		written->drop();
+	if (cached)
+		cached->drop();
+
+	return result;
+}
+
+//! A quad completely behind another quad is skipped by the hierarchical depth test
+static bool hierarchicalDepthTest()
+{
+	IrrlichtDevice *device = createDevice(video::EDT_BURNINGSVIDEO, core::dimension2du(160,120), 32);
+	if (!device)
+		return false;
+
+	IVideoDriver* driver = device->getVideoDriver();
+
+	const u16 indices[] = { 0,1,2, 0,2,3 };
+	S3DVertex nearQuad[4];
+	nearQuad[0] = S3DVertex(-10.f,-10.f,10.f, 0,0,-1, SColor(255,255,0,0), 0,1);
+	nearQuad[1] = S3DVertex(-10.f, 10.f,10.f, 0,0,-1, SColor(255,255,0,0), 0,0);
+	nearQuad[2] = S3DVertex( 10.f, 10.f,10.f, 0,0,-1, SColor(255,255,0,0), 1,0);
+	nearQuad[3] = S3DVertex( 10.f,-10.f,10.f, 0,0,-1, SColor(255,255,0,0), 1,1);
+	S3DVertex farQuad[4];
+	for (u32 i=0; i<4; ++i)
+	{
+		farQuad[i] = nearQuad[i];
+		farQuad[i].Pos *= 0.5f;
+		farQuad[i].Pos.Z = 20.f;
+		farQuad[i].Color = SColor(255,0,255,0);
+	}
+
+	SMaterial material;
+	material.Lighting = false;
+
+	core::matrix4 projection;
+	projection.buildProjectionMatrixPerspectiveFovLH(core::PI / 2.f, 4.f / 3.f, 1.f, 100.f);
+
+	device->run();
+	driver->beginScene(video::ECBF_COLOR | video::ECBF_DEPTH, video::SColor(0, 80, 80, 80));
+	driver->setTransform(ETS_PROJECTION, projection);
+	driver->setTransform(ETS_VIEW, core::IdentityMatrix);
+	driver->setTransform(ETS_WORLD, core::IdentityMatrix);
+	driver->setMaterial(material);
+	driver->drawIndexedTriangleList(nearQuad, 4, indices, 2);
+	driver->drawIndexedTriangleList(farQuad, 4, indices, 2);
+	IImage* screenshot = driver->createScreenShot();
+	driver->endScene();
+
+	bool result = 2 == driver->getDriverAttributes().getAttributeAsInt("DepthRejectedTriangles");
+	if (!result)
+		logTestString("Hidden triangles were not rejected.\n");
+
+	if (screenshot)
+	{
+		if (screenshot->getPixel(80, 60).getGreen() != 0)
+		{
+			logTestString("Hidden quad is visible.\n");
+			result = false;
+		}
+		screenshot->drop();
+	}
+
+	device->closeDevice();
+	device->run();
+	device->drop();
+
+	return result;
+}
+
+//! A sphere behind a wall has no visible pixels, a sphere beside it has
+static bool occlusionQuery()
+{
+	IrrlichtDevice *device = createDevice(video::EDT_BURNINGSVIDEO, core::dimension2du(160,120), 32);
+	if (!device)
+		return false;
+
+	IVideoDriver* driver = device->getVideoDriver();
+	ISceneManager* smgr = device->getSceneManager();
+
+	bool result = driver->queryFeature(video::EVDF_OCCLUSION_QUERY);
+	if (!result)
+	{
+		logTestString("Occlusion queries not supported.\n");
+		device->closeDevice();
+		device->run();
+		device->drop();
+		return false;
+	}
+
+	ISceneNode* wall = smgr->addCubeSceneNode(10.f, 0, -1, core::vector3df(0.f, 0.f, 20.f),
+		core::vector3df(0.f, 0.f, 0.f), core::vector3df(1.5f, 1.5f, 0.1f));
+	wall->setMaterialFlag(video::EMF_LIGHTING, false);
+	IMeshSceneNode* hidden = smgr->addSphereSceneNode(3.f, 16, 0, -1, core::vector3df(0.f, 0.f, 40.f));
+	IMeshSceneNode* visible = smgr->addSphereSceneNode(3.f, 16, 0, -1, core::vector3df(30.f, 0.f, 40.f));
+	hidden->setVisible(false);
+	visible->setVisible(false);
+	driver->addOcclusionQuery(hidden, hidden->getMesh());
+	driver->addOcclusionQuery(visible, visible->getMesh());
+	smgr->addCameraSceneNode(0, core::vector3df(0.f, 0.f, 0.f), core::vector3df(0.f, 0.f, 40.f));
+
+	device->run();
+	if (driver->beginScene(video::ECBF_COLOR | video::ECBF_DEPTH, video::SColor(0, 80, 80, 80)))
+	{
+		smgr->drawAll();
+		driver->runAllOcclusionQueries(false);
+		driver->updateAllOcclusionQueries();
+		driver->endScene();
+	}
+
+	if (driver->getOcclusionQueryResult(hidden) != 0)
+	{
+		logTestString("Hidden sphere has visible pixels.\n");
+		result = false;
+	}
+	const u32 pixels = driver->getOcclusionQueryResult(visible);
+	if (pixels == 0 || pixels == ~0u)
+	{
+		logTestString("Visible sphere has no visible pixels.\n");
+		result = false;
+	}
+
+	device->closeDevice();
+	device->run();
+	device->drop();
+
+	return result;
+}
+
 /** Tests the Burning Video driver */
 bool burningsVideo(void)
 {
@@ -36,5 +306,10 @@ bool burningsVideo(void)
 	device->run();
     device->drop();
 
+	result &= multiThreadedRendering();
+	result &= hierarchicalDepthTest();
+	result &= occlusionQuery();
+	result &= mipMapCache();
+
     return result;
 }
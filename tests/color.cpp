@@ -10,12 +10,146 @@ bool rounding()
     return col.getRed() == 1 && col.getGreen() == 2 && col.getBlue() == 3;
 }
 
+namespace
+{
+
+u32 randomColor()
+{
+	return ((u32)rand() << 16) ^ (u32)rand();
+}
+
+//! Pixel by pixel conversion from A8R8G8B8, as done by the scalar converters
+void referenceFromA8R8G8B8(const u32* in, s32 count, void* out, video::ECOLOR_FORMAT format)
+{
+	for (s32 i = 0; i != count; ++i)
+	{
+		switch (format)
+		{
+		case video::ECF_A1R5G5B5:
+			((u16*)out)[i] = video::A8R8G8B8toA1R5G5B5(in[i]);
+			break;
+		case video::ECF_R5G6B5:
+			((u16*)out)[i] = video::A8R8G8B8toR5G6B5(in[i]);
+			break;
+		case video::ECF_R8G8B8:
+			((u8*)out)[i*3] = (u8)(in[i] >> 16);
+			((u8*)out)[i*3+1] = (u8)(in[i] >> 8);
+			((u8*)out)[i*3+2] = (u8)in[i];
+			break;
+		default:
+			break;
+		}
+	}
+}
+
+//! Pixel by pixel conversion to A8R8G8B8, as done by the scalar converters
+void referenceToA8R8G8B8(const void* in, s32 count, u32* out, video::ECOLOR_FORMAT format)
+{
+	for (s32 i = 0; i != count; ++i)
+	{
+		switch (format)
+		{
+		case video::ECF_A1R5G5B5:
+			out[i] = video::A1R5G5B5toA8R8G8B8(((const u16*)in)[i]);
+			break;
+		case video::ECF_R5G6B5:
+			out[i] = video::R5G6B5toA8R8G8B8(((const u16*)in)[i]);
+			break;
+		case video::ECF_R8G8B8:
+			out[i] = 0xFF000000 | ((const u8*)in)[i*3] << 16 | ((const u8*)in)[i*3+1] << 8 | ((const u8*)in)[i*3+2];
+			break;
+		default:
+			break;
+		}
+	}
+}
+
+//! Compares IVideoDriver::convertColor, which uses the SIMD converters, with the reference loops
+bool convertColor(video::IVideoDriver* driver, video::ECOLOR_FORMAT format, s32 count)
+{
+	const u32 bytes = video::IImage::getBitsPerPixelFromFormat(format) / 8;
+
+	core::array<u32> argb;
+	for (s32 i = 0; i != count; ++i)
+		argb.push_back(randomColor());
+
+	core::array<u8> expected;
+	core::array<u8> converted;
+	expected.set_used(count * bytes);
+	converted.set_used(count * bytes);
+	referenceFromA8R8G8B8(argb.const_pointer(), count, expected.pointer(), format);
+	driver->convertColor(argb.const_pointer(), video::ECF_A8R8G8B8, count, converted.pointer(), format);
+	if (memcmp(expected.const_pointer(), converted.const_pointer(), count * bytes))
+	{
+		logTestString("A8R8G8B8 to format %d differs for %d pixels\n", (int)format, count);
+		return false;
+	}
+
+	// in place, the smaller pixels are written over the source
+	core::array<u32> inPlace(argb);
+	driver->convertColor(inPlace.const_pointer(), video::ECF_A8R8G8B8, count, inPlace.pointer(), format);
+	if (memcmp(expected.const_pointer(), inPlace.const_pointer(), count * bytes))
+	{
+		logTestString("A8R8G8B8 to format %d in place differs for %d pixels\n", (int)format, count);
+		return false;
+	}
+
+	for (u32 i = 0; i != expected.size(); ++i)
+		expected[i] = (u8)rand();
+
+	core::array<u32> expectedArgb;
+	core::array<u32> convertedArgb;
+	expectedArgb.set_used(count);
+	convertedArgb.set_used(count);
+	referenceToA8R8G8B8(expected.const_pointer(), count, expectedArgb.pointer(), format);
+	driver->convertColor(expected.const_pointer(), format, count, convertedArgb.pointer(), video::ECF_A8R8G8B8);
+	if (memcmp(expectedArgb.const_pointer(), convertedArgb.const_pointer(), count * 4))
+	{
+		logTestString("Format %d to A8R8G8B8 differs for %d pixels\n", (int)format, count);
+		return false;
+	}
+
+	return true;
+}
+
+//! Runs the converters on short runs, for the SIMD tails, and on runs long enough for the worker threads
+bool convertColors()
+{
+	SIrrlichtCreationParameters params;
+	params.DriverType = video::EDT_NULL;
+	params.WorkerThreads = 2;
+
+	IrrlichtDevice* device = createDeviceEx(params);
+	if (!device)
+		return true;
+
+	srand(1234);
+
+	const video::ECOLOR_FORMAT formats[] = { video::ECF_A1R5G5B5, video::ECF_R5G6B5, video::ECF_R8G8B8 };
+	bool ok = true;
+	for (u32 f = 0; f != sizeof(formats) / sizeof(formats[0]); ++f)
+	{
+		for (s32 count = 1; count <= 37; ++count)
+			ok &= convertColor(device->getVideoDriver(), formats[f], count);
+		ok &= convertColor(device->getVideoDriver(), formats[f], 64 * 4096 + 5);
+	}
+
+	device->closeDevice();
+	device->run();
+	device->drop();
+
+	return ok;
+}
+
+} // end anonymous namespace
+
 //! Test SColor and SColorf
 bool color(void)
 {
 	bool ok = true;
 
     ok &= rounding();
+	ok &= convertColors();
 
 	return ok;
 }
@@ -0,0 +1,157 @@
+// Copyright (C) 2008-2012 Colin MacDonald
+// No rights reserved: this software is in the public domain.
+
+#include "testUtils.h"
+
+using namespace irr;
+using namespace core;
+using namespace scene;
+
+namespace
+{
+
+//! Draws the scene and returns the number of drawn primitives
+u32 drawScene(IrrlichtDevice* device)
+{
+	video::IVideoDriver* driver = device->getVideoDriver();
+	driver->beginScene(video::ECBF_COLOR | video::ECBF_DEPTH, video::SColor(255,0,0,0));
+	device->getSceneManager()->drawAll();
+	driver->endScene();
+	return driver->getPrimitiveCountDrawn(0);
+}
+
+//! Adding, culling and removing instances of a cube
+bool cullInstances(IrrlichtDevice* device)
+{
+	ISceneManager* smgr = device->getSceneManager();
+	smgr->addCameraSceneNode(0, vector3df(0.f, 0.f, -20.f), vector3df(0.f, 0.f, 0.f));
+
+	IMesh* cube = smgr->getGeometryCreator()->createCubeMesh(vector3df(1.f, 1.f, 1.f));
+	const u32 cubeTriangles = cube->getMeshBuffer(0)->getIndexCount() / 3;
+	IInstancedMeshSceneNode* node = smgr->addInstancedMeshSceneNode(cube);
+	cube->drop();
+
+	bool result = node && node->getType() == ESNT_INSTANCED_MESH;
+	if (!result)
+		return false;
+	node->setMaterialFlag(video::EMF_LIGHTING, false);
+
+	// nothing to draw without instances
+	result &= (drawScene(device) == 0);
+
+	// 4 cubes in front of the camera and 4 far away at the side
+	for (u32 i=0; i<8; ++i)
+	{
+		matrix4 m;
+		m.setTranslation(vector3df((i < 4 ? 0.f : 1000.f) + i * 2.f, 0.f, 0.f));
+		result &= (node->addInstance(m, video::SColor(255, i * 30, 0, 0)) == i);
+	}
+	result &= (node->getInstanceCount() == 8);
+	result &= (node->getInstanceColor(3) == video::SColor(255, 90, 0, 0));
+	result &= node->getBoundingBox().MinEdge.equals(vector3df(-0.5f, -0.5f, -0.5f));
+	result &= node->getBoundingBox().MaxEdge.equals(vector3df(1014.5f, 0.5f, 0.5f));
+
+	// only the cubes in front of the camera are drawn
+	result &= (drawScene(device) == 4 * cubeTriangles);
+	result &= (node->getVisibleInstanceCount() == 4);
+
+	// without culling all cubes are drawn
+	node->setAutomaticCulling(EAC_OFF);
+	result &= (drawScene(device) == 8 * cubeTriangles);
+	result &= (node->getVisibleInstanceCount() == 8);
+	node->setAutomaticCulling(EAC_BOX);
+
+	// the instances are relative to the node
+	node->setPosition(vector3df(-1000.f, 0.f, 0.f));
+	result &= (drawScene(device) == 4 * cubeTriangles);
+	node->setPosition(vector3df(0.f, 0.f, 0.f));
+
+	// moving an instance into the view
+	matrix4 m;
+	m.setTranslation(vector3df(0.f, 2.f, 0.f));
+	node->setInstanceTransformation(7, m);
+	result &= node->getInstanceTransformation(7).getTranslation().equals(vector3df(0.f, 2.f, 0.f));
+	result &= (drawScene(device) == 5 * cubeTriangles);
+	result &= node->getBoundingBox().MaxEdge.equals(vector3df(1012.5f, 2.5f, 0.5f));
+
+	// the last instance takes the index of the removed one
+	node->removeInstance(4);
+	result &= (node->getInstanceCount() == 7);
+	result &= node->getInstanceTransformation(4).getTranslation().equals(vector3df(0.f, 2.f, 0.f));
+	result &= (node->getInstanceColor(4) == video::SColor(255, 210, 0, 0));
+	result &= (drawScene(device) == 5 * cubeTriangles);
+
+	// invalid indices are ignored
+	node->setInstanceTransformation(7, m);
+	node->setInstanceColor(7, video::SColor(255, 0, 0, 0));
+	node->removeInstance(7);
+	result &= (node->getInstanceCount() == 7);
+
+	node->removeAllInstances();
+	result &= (node->getInstanceCount() == 0);
+	result &= (drawScene(device) == 0);
+	node->removeInstance(0);
+	result &= (node->getInstanceCount() == 0);
+
+	smgr->clear();
+
+	if (!result)
+		logTestString("Culling of mesh instances failed\n");
+
+	return result;
+}
+
+//! Drawing instances directly with the driver
+bool drawInstances(IrrlichtDevice* device)
+{
+	video::IVideoDriver* driver = device->getVideoDriver();
+	ISceneManager* smgr = device->getSceneManager();
+
+	IMesh* cube = smgr->getGeometryCreator()->createCubeMesh(vector3df(1.f, 1.f, 1.f));
+	const IMeshBuffer* mb = cube->getMeshBuffer(0);
+
+	array<matrix4> transformations;
+	array<video::SColor> colors;
+	for (u32 i=0; i<10; ++i)
+	{
+		matrix4 m;
+		m.setTranslation(vector3df((f32)i, 0.f, 0.f));
+		transformations.push_back(m);
+		colors.push_back(video::SColor(255, 255, i * 20, 0));
+	}
+
+	driver->beginScene(video::ECBF_COLOR | video::ECBF_DEPTH, video::SColor(255,0,0,0));
+	driver->setMaterial(mb->getMaterial());
+	driver->drawMeshBufferInstances(mb, transformations.const_pointer(), colors.const_pointer(), transformations.size());
+	driver->drawMeshBufferInstances(mb, transformations.const_pointer(), 0, 1);
+	driver->drawMeshBufferInstances(mb, transformations.const_pointer(), 0, 0);
+	driver->endScene();
+
+	const u32 primitives = driver->getPrimitiveCountDrawn(0);
+	const bool result = (primitives == 11 * mb->getIndexCount() / 3);
+	cube->drop();
+
+	if (!result)
+		logTestString("Drawing of mesh buffer instances gave %d primitives\n", primitives);
+
+	return result;
+}
+
+} // end anonymous namespace
+
+/** Test that the instanced mesh scene node culls and draws its instances. */
+bool instancedMesh(void)
+{
+	IrrlichtDevice* device = createDevice(video::EDT_NULL, dimension2du(160, 120));
+	if (!device)
+		return false;
+
+	bool result = cullInstances(device);
+	result &= drawInstances(device);
+
+	device->closeDevice();
+	device->run();
+	device->drop();
+
+	return result;
+}
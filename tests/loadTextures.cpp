@@ -2,6 +2,13 @@
 // No rights reserved: this software is in the public domain.
 
 #include "testUtils.h"
+#include <stdio.h>
+#include <string.h>
+#if defined(_IRR_WINDOWS_API_)
+#include <direct.h>
+#else
+#include <sys/stat.h>
+#endif
 
 using namespace irr;
 using namespace core;
@@ -88,10 +95,224 @@ bool loadFromFileFolder(void)
 	return ((tex1 == tex2) && (tex1 == tex3) && (tex1 == tex4));
 }
 
+/** Removes and renames textures in the texture cache, also with several
+	textures of the same name, and checks that all of them are still found. */
+static bool textureCacheIndex()
+{
+	IrrlichtDevice *device =
+		createDevice( video::EDT_NULL, dimension2du(160, 120));
+
+	if (!device)
+	{
+		logTestString("Unable to create EDT_NULL device\n");
+		return false;
+	}
+
+	IVideoDriver * driver = device->getVideoDriver();
+	const u32 numTexs = driver->getTextureCount();
+
+	array<ITexture*> textures;
+	for (u32 i=0; i<100; ++i)
+		textures.push_back(driver->addTexture(dimension2du(1, 1), io::path("tex") + io::path(i)));
+
+	// same name, different case
+	ITexture* duplicate = driver->addTexture(dimension2du(1, 1), "TEX5");
+
+	bool result = driver->getTextureCount() == numTexs + 101;
+
+	for (u32 i=0; i<100; i+=3)
+		driver->removeTexture(textures[i]);
+	driver->renameTexture(textures[10], "renamed");
+
+	result &= driver->getTextureCount() == numTexs + 101 - 34;
+	result &= driver->findTexture("renamed") == textures[10];
+	result &= driver->findTexture("tex10") == 0;
+	for (u32 i=0; i<100; ++i)
+	{
+		if (i % 3 == 0)
+			result &= driver->findTexture(io::path("tex") + io::path(i)) == 0;
+		else if (i != 10 && i != 5)
+			result &= driver->findTexture(io::path("tex") + io::path(i)) == textures[i];
+	}
+
+	// removing the first texture of a name finds the other one
+	result &= driver->findTexture("tex5") == textures[5];
+	driver->removeTexture(textures[5]);
+	result &= driver->findTexture("tex5") == duplicate;
+	driver->removeTexture(duplicate);
+	result &= driver->findTexture("tex5") == 0;
+
+	if (!result)
+		logTestString("Texture cache index failed\n");
+
+	device->closeDevice();
+	device->run();
+	device->drop();
+	return result;
+}
+
+class CTextureLoadCallBack : public ITextureLoadCallBack
+{
+public:
+	CTextureLoadCallBack() : Calls(0), Placeholder(0), Texture(0) {}
+
+	virtual void OnTextureLoaded(ITexture* placeholder, ITexture* texture)
+	{
+		++Calls;
+		Placeholder = placeholder;
+		Texture = texture;
+	}
+
+	u32 Calls;
+	ITexture* Placeholder;
+	ITexture* Texture;
+};
+
+/** Loads a texture in the background and waits in beginScene until it's
+	swapped in. Burning's Video swaps the data into the placeholder, the null
+	driver replaces the placeholder in the texture cache. */
+static bool loadAsync(video::E_DRIVER_TYPE driverType)
+{
+	SIrrlichtCreationParameters params;
+	params.DriverType = driverType;
+	params.WindowSize = dimension2du(160, 120);
+	params.WorkerThreads = 2;
+
+	IrrlichtDevice *device = createDeviceEx(params);
+	if (!device)
+		return true; // in case the driver type does not exist
+
+	IVideoDriver * driver = device->getVideoDriver();
+	CTextureLoadCallBack* callBack = new CTextureLoadCallBack();
+
+	ITexture* placeholder = driver->getTextureAsync("../media/tools.png", callBack);
+	bool result = placeholder && driver->getTexture("../media/tools.png") == placeholder;
+
+	for (u32 i=0; i<1000 && driver->isTextureLoading(placeholder); ++i)
+	{
+		device->sleep(10);
+		driver->beginScene();
+		driver->endScene();
+	}
+
+	ITexture* texture = driver->getTexture("../media/tools.png");
+	result &= !driver->isTextureLoading(placeholder) && 1 == callBack->Calls &&
+		callBack->Placeholder == placeholder && callBack->Texture && callBack->Texture == texture;
+
+	if (result && driverType == EDT_BURNINGSVIDEO)
+	{
+		IImage* image = driver->createImageFromFile("../media/tools.png");
+		result &= image && texture == placeholder && texture->getOriginalSize() == image->getDimension();
+		if (image)
+			image->drop();
+	}
+	else if (result && texture != placeholder)
+	{
+		// the replaced placeholder stays valid, removing it removes the loaded texture
+		const u32 count = driver->getTextureCount();
+		const io::path name = texture->getName().getPath();
+		result &= placeholder->getReferenceCount() == 1 && placeholder->getName().getPath() == name;
+		driver->removeTexture(placeholder);
+		result &= driver->getTextureCount() == count - 1 && driver->findTexture(name) == 0;
+	}
+
+	if (!result)
+		logTestString("Background texture loading failed with %ls\n", driver->getName());
+
+	callBack->drop();
+
+	device->closeDevice();
+	device->run();
+	device->drop();
+	return result;
+}
+
+//! Counts log messages of the jpeg loader
+class CJpegLogReceiver : public IEventReceiver
+{
+public:
+	CJpegLogReceiver() : Messages(0), FileNames(0) {}
+
+	virtual bool OnEvent(const SEvent& event)
+	{
+		if (event.EventType == EET_LOG_TEXT_EVENT && strstr(event.LogEvent.Text, "JPEG FATAL ERROR"))
+		{
+			++Messages;
+			if (strstr(event.LogEvent.Text, "brokenAsync.jpg"))
+				++FileNames;
+		}
+		return false;
+	}
+
+	u32 Messages;
+	u32 FileNames;
+};
+
+/** Loader messages of a texture loaded in the background reach the event
+	receiver from beginScene on the main thread, not from the worker thread. */
+static bool loadAsyncLog()
+{
+	SIrrlichtCreationParameters params;
+	params.DriverType = EDT_NULL;
+	params.WorkerThreads = 2;
+
+	IrrlichtDevice *device = createDeviceEx(params);
+	if (!device)
+		return false;
+
+	CJpegLogReceiver receiver;
+	device->setEventReceiver(&receiver);
+	IVideoDriver * driver = device->getVideoDriver();
+	IFileSystem* fs = device->getFileSystem();
+
+	// a jpeg header followed by garbage
+#if defined(_IRR_WINDOWS_API_)
+	_mkdir("results");
+#else
+	mkdir("results", 0777);
+#endif
+	IWriteFile* file = fs->createAndWriteFile("results/brokenAsync.jpg");
+	if (!file)
+	{
+		device->drop();
+		return false;
+	}
+	const u8 data[] = { 0xFF, 0xD8, 0xFF, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09 };
+	file->write(data, sizeof(data));
+	file->drop();
+
+	ITexture* placeholder = driver->getTextureAsync("results/brokenAsync.jpg");
+	device->sleep(200);
+	bool result = placeholder && 0 == receiver.Messages;
+
+	for (u32 i=0; i<1000 && driver->isTextureLoading(placeholder); ++i)
+	{
+		device->sleep(10);
+		driver->beginScene();
+		driver->endScene();
+	}
+	result &= receiver.Messages > 0 && receiver.Messages == receiver.FileNames;
+
+	if (!result)
+		logTestString("Loader messages of background texture loading not logged by beginScene\n");
+
+	remove("results/brokenAsync.jpg");
+
+	device->setEventReceiver(0);
+	device->closeDevice();
+	device->run();
+	device->drop();
+	return result;
+}
+
 bool loadTextures()
 {
 	bool result = true;
 	result &= loadFromFileFolder();
+	result &= textureCacheIndex();
+	result &= loadAsync(EDT_NULL);
+	result &= loadAsyncLog();
+	result &= loadAsync(EDT_BURNINGSVIDEO);
 	return result;
 }
 
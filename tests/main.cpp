@@ -67,6 +67,7 @@ int main(int argumentCount, char * arguments[])
 	TEST(testS3DVertex);
 	TEST(testaabbox3d);
     TEST(color);
+	TEST(softwareBlitters);
 	TEST(testTriangle3d);
 	TEST(vectorPositionDimension2d);
 	// file system checks (with null driver)
@@ -98,6 +99,10 @@ int main(int argumentCount, char * arguments[])
 	TEST(md2Animation);
 	TEST(meshTransform);
 	TEST(skinnedMesh);
+	TEST(particleSystem);
+	TEST(renderQueue);
+	TEST(staticBatch);
+	TEST(instancedMesh);
 	TEST(testGeometryCreator);
 	TEST(writeImageToFile);
 	TEST(ioScene);
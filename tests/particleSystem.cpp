@@ -0,0 +1,330 @@
+// Copyright (C) 2008-2012 Colin MacDonald
+// No rights reserved: this software is in the public domain.
+
+#include "testUtils.h"
+
+using namespace irr;
+using namespace core;
+using namespace scene;
+
+namespace
+{
+
+//! Sets all particles to a fixed color, to check the default affectStreams.
+class CColorAffector : public IParticleAffector
+{
+public:
+	virtual void affect(u32 now, SParticle* particlearray, u32 count) _IRR_OVERRIDE_
+	{
+		for (u32 i=0; i<count; ++i)
+			particlearray[i].color = video::SColor(now & 0xff, 1, 2, 3);
+	}
+
+	virtual E_PARTICLE_AFFECTOR_TYPE getType() const _IRR_OVERRIDE_ { return EPAT_NONE; }
+};
+
+f32 randomValue(f32 range)
+{
+	return ((f32)rand() / RAND_MAX - 0.5f) * 2.f * range;
+}
+
+// Odd count, so the scalar loops after the SIMD loops are used as well
+void createParticles(array<SParticle>& particles, SParticleStreams& streams, u32 now)
+{
+	const u32 count = 1003;
+	particles.clear();
+	streams.clear();
+
+	for (u32 i=0; i<count; ++i)
+	{
+		SParticle p;
+		p.pos.set(randomValue(100.f), randomValue(100.f), randomValue(100.f));
+		p.vector.set(randomValue(1.f), randomValue(1.f), randomValue(1.f));
+		p.startVector.set(randomValue(1.f), randomValue(1.f), randomValue(1.f));
+		p.startTime = now - rand() % 3000;
+		p.endTime = p.startTime + 1 + rand() % 4000;
+		p.startColor.color = (u32)rand() * 7919u;
+		p.color = p.startColor;
+		p.startSize.set(1.f + (f32)rand() / RAND_MAX * 10.f, 1.f + (f32)rand() / RAND_MAX * 10.f);
+		p.size = p.startSize;
+
+		// one particle exactly at the attraction point
+		if (i == 17)
+			p.pos.set(10.f, 20.f, 30.f);
+
+		particles.push_back(p);
+		streams.push_back(p);
+	}
+}
+
+bool equalColors(video::SColor a, video::SColor b)
+{
+	return abs_((s32)a.getAlpha() - (s32)b.getAlpha()) <= 1 &&
+		abs_((s32)a.getRed() - (s32)b.getRed()) <= 1 &&
+		abs_((s32)a.getGreen() - (s32)b.getGreen()) <= 1 &&
+		abs_((s32)a.getBlue() - (s32)b.getBlue()) <= 1;
+}
+
+bool compareParticles(const array<SParticle>& particles, const SParticleStreams& streams, const c8* name)
+{
+	if (particles.size() != streams.size())
+	{
+		logTestString("%s: %u particles instead of %u\n", name, streams.size(), particles.size());
+		return false;
+	}
+
+	for (u32 i=0; i<particles.size(); ++i)
+	{
+		SParticle p;
+		streams.getParticle(i, p);
+		const SParticle& r = particles[i];
+
+		if (!p.pos.equals(r.pos, 0.001f) || !p.vector.equals(r.vector, 0.0001f) ||
+			!equals(p.size.Width, r.size.Width, 0.001f) || !equals(p.size.Height, r.size.Height, 0.001f) ||
+			!equalColors(p.color, r.color))
+		{
+			logTestString("%s: particle %u differs, pos %f %f %f instead of %f %f %f, color %08x instead of %08x\n",
+				name, i, p.pos.X, p.pos.Y, p.pos.Z, r.pos.X, r.pos.Y, r.pos.Z, p.color.color, r.color.color);
+			return false;
+		}
+	}
+
+	return true;
+}
+
+//! Runs two affectors with the same settings, one on each particle layout.
+bool compareAffector(IParticleAffector* onArray, IParticleAffector* onStreams, const c8* name)
+{
+	array<SParticle> particles;
+	SParticleStreams streams;
+	const u32 now = 100000;
+	createParticles(particles, streams, now);
+
+	// the first call of some affectors only remembers the time
+	for (u32 t=0; t<3; ++t)
+	{
+		onArray->affect(now + t*16, particles.pointer(), particles.size());
+		onStreams->affectStreams(now + t*16, streams);
+	}
+
+	onArray->drop();
+	onStreams->drop();
+
+	return compareParticles(particles, streams, name);
+}
+
+bool particleAffectors(IParticleSystemSceneNode* ps)
+{
+	bool result = true;
+
+	result &= compareAffector(ps->createGravityAffector(vector3df(0.f, -0.05f, 0.01f), 1500),
+		ps->createGravityAffector(vector3df(0.f, -0.05f, 0.01f), 1500), "Gravity");
+	result &= compareAffector(ps->createFadeOutParticleAffector(video::SColor(0, 10, 200, 30), 1200),
+		ps->createFadeOutParticleAffector(video::SColor(0, 10, 200, 30), 1200), "FadeOut");
+	result &= compareAffector(ps->createAttractionAffector(vector3df(10.f, 20.f, 30.f), 15.f, true, true, false, true),
+		ps->createAttractionAffector(vector3df(10.f, 20.f, 30.f), 15.f, true, true, false, true), "Attraction");
+	result &= compareAffector(ps->createAttractionAffector(vector3df(10.f, 20.f, 30.f), 5.f, false),
+		ps->createAttractionAffector(vector3df(10.f, 20.f, 30.f), 5.f, false), "Repulsion");
+	result &= compareAffector(ps->createScaleParticleAffector(dimension2df(3.f, 0.5f)),
+		ps->createScaleParticleAffector(dimension2df(3.f, 0.5f)), "Scale");
+	result &= compareAffector(ps->createRotationAffector(vector3df(20.f, 45.f, -90.f), vector3df(1.f, 2.f, 3.f)),
+		ps->createRotationAffector(vector3df(20.f, 45.f, -90.f), vector3df(1.f, 2.f, 3.f)), "Rotation");
+	result &= compareAffector(new CColorAffector(), new CColorAffector(), "Default affectStreams");
+
+	return result;
+}
+
+//! The SIMD loop and the scalar loop after it have to move equal particles the same.
+bool equalRotation(IParticleSystemSceneNode* ps)
+{
+	SParticleStreams streams;
+	SParticle p;
+	p.pos.set(12.3f, -45.6f, 78.9f);
+	for (u32 i=0; i<5; ++i)
+		streams.push_back(p);
+
+	IParticleAffector* affector = ps->createRotationAffector(vector3df(20.f, 45.f, -90.f), vector3df(1.f, 2.f, 3.f));
+	affector->affectStreams(1000, streams);
+	affector->affectStreams(1016, streams);
+	affector->drop();
+
+	SParticle first, last;
+	streams.getParticle(0, first);
+	streams.getParticle(4, last);
+	if (first.pos.X != last.pos.X || first.pos.Y != last.pos.Y || first.pos.Z != last.pos.Z)
+	{
+		logTestString("Rotation: last particle at %f %f %f instead of %f %f %f\n",
+			last.pos.X, last.pos.Y, last.pos.Z, first.pos.X, first.pos.Y, first.pos.Z);
+		return false;
+	}
+
+	return true;
+}
+
+//! More particles than 16 bit indices can address are drawn in several parts.
+bool manyParticles(IrrlichtDevice* device)
+{
+	ISceneManager* smgr = device->getSceneManager();
+	video::IVideoDriver* driver = device->getVideoDriver();
+
+	IParticleSystemSceneNode* ps = smgr->addParticleSystemSceneNode(false);
+	IParticleEmitter* em = ps->createBoxEmitter(aabbox3df(-10, -10, -10, 10, 10, 10),
+		vector3df(0.f, 0.01f, 0.f), 100000, 100000, video::SColor(255, 255, 255, 255),
+		video::SColor(255, 255, 255, 255), 5000, 5000);
+	ps->setEmitter(em);
+	em->drop();
+
+	IParticleAffector* paf = ps->createFadeOutParticleAffector();
+	ps->addAffector(paf);
+	paf->drop();
+
+	smgr->addCameraSceneNode(0, vector3df(0, 0, -100));
+	ps->updateAbsolutePosition();
+
+	for (u32 t=1; t<=1000; t+=100)
+		ps->doParticleSystem(t);
+
+	driver->beginScene();
+	ps->render();
+	driver->endScene();
+
+	const u32 primitives = driver->getPrimitiveCountDrawn();
+	if (primitives <= 2*16384)
+	{
+		logTestString("Only %u primitives drawn for the particles\n", primitives);
+		return false;
+	}
+
+	// all particles die
+	ps->setEmitter(0);
+	ps->doParticleSystem(10000);
+	driver->beginScene();
+	ps->render();
+	driver->endScene();
+
+	if (driver->getPrimitiveCountDrawn() != 0)
+	{
+		logTestString("%u primitives drawn for dead particles\n", driver->getPrimitiveCountDrawn());
+		return false;
+	}
+
+	return true;
+}
+
+IParticleSystemSceneNode* addPointParticles(ISceneManager* smgr)
+{
+	// emits from a point without random values, so all nodes emit the same particles
+	IParticleSystemSceneNode* ps = smgr->addParticleSystemSceneNode(false);
+	IParticleEmitter* em = ps->createBoxEmitter(aabbox3df(0, 0, 0, 0, 0, 0), vector3df(0.01f, 0.02f, 0.f), 30000, 30000,
+		video::SColor(255, 255, 255, 255), video::SColor(255, 255, 255, 255), 1000, 1000);
+	ps->setEmitter(em);
+	em->drop();
+
+	IParticleAffector* paf = ps->createGravityAffector(vector3df(0.f, -0.01f, 0.f), 500);
+	ps->addAffector(paf);
+	paf->drop();
+
+	return ps;
+}
+
+u32 renderParticles(video::IVideoDriver* driver, IParticleSystemSceneNode* ps)
+{
+	driver->beginScene();
+	ps->render();
+	driver->endScene();
+	return driver->getPrimitiveCountDrawn();
+}
+
+//! Updates one node in OnAnimate on the worker threads and one with doParticleSystem.
+bool jobParticles()
+{
+	SIrrlichtCreationParameters params;
+	params.DriverType = video::EDT_NULL;
+	params.WorkerThreads = 2;
+
+	IrrlichtDevice* device = createDeviceEx(params);
+	if (!device)
+		return false;
+
+	ISceneManager* smgr = device->getSceneManager();
+	video::IVideoDriver* driver = device->getVideoDriver();
+	smgr->addCameraSceneNode(0, vector3df(0, 0, -100));
+
+	IParticleSystemSceneNode* animated = addPointParticles(smgr);
+	IParticleSystemSceneNode* reference = addPointParticles(smgr);
+	animated->updateAbsolutePosition();
+	reference->updateAbsolutePosition();
+
+	bool result = true;
+	for (u32 t=1; t<=3000 && result; t+=100)
+	{
+		animated->OnAnimate(t);
+		animated->OnRegisterSceneNode();
+		reference->doParticleSystem(t);
+
+		if (animated->getBoundingBox().MinEdge != reference->getBoundingBox().MinEdge ||
+			animated->getBoundingBox().MaxEdge != reference->getBoundingBox().MaxEdge)
+		{
+			logTestString("Bounding box of the particles differs at %u\n", t);
+			result = false;
+		}
+
+		const u32 primitives = renderParticles(driver, animated);
+		const u32 referencePrimitives = renderParticles(driver, reference);
+		if (primitives != referencePrimitives)
+		{
+			logTestString("%u primitives drawn instead of %u at %u\n", primitives, referencePrimitives, t);
+			result = false;
+		}
+	}
+
+	// more than 16 bit indices can address
+	if (renderParticles(driver, animated) <= 2*16384)
+	{
+		logTestString("Only %u primitives drawn for the particles\n", driver->getPrimitiveCountDrawn());
+		result = false;
+	}
+
+	// the box must not keep the removed particles of a running update
+	animated->OnAnimate(3100);
+	animated->clearParticles();
+	renderParticles(driver, animated);
+	if (animated->getBoundingBox().getExtent() != vector3df(0.f))
+	{
+		logTestString("Bounding box of the cleared particles is not empty\n");
+		result = false;
+	}
+
+	device->closeDevice();
+	device->run();
+	device->drop();
+
+	return result;
+}
+
+} // end anonymous namespace
+
+/** Compare the structure of arrays versions of the built in particle
+affectors with their SParticle versions, check large particle systems and
+the update on worker threads. */
+bool particleSystem(void)
+{
+	IrrlichtDevice * device = irr::createDevice(video::EDT_NULL, dimension2d<u32>(160, 120));
+	assert_log(device);
+	if(!device)
+		return false;
+
+	IParticleSystemSceneNode* ps = device->getSceneManager()->addParticleSystemSceneNode(false);
+
+	bool result = particleAffectors(ps);
+	result &= equalRotation(ps);
+	result &= manyParticles(device);
+	result &= jobParticles();
+
+	device->closeDevice();
+	device->run();
+	device->drop();
+
+	return result;
+}
+
@@ -0,0 +1,134 @@
+// Copyright (C) 2008-2012 Colin MacDonald
+// No rights reserved: this software is in the public domain.
+
+#include "testUtils.h"
+
+using namespace irr;
+using namespace core;
+using namespace scene;
+
+namespace
+{
+
+//! Mesh buffers in the order in which they were drawn
+array<const IMeshBuffer*> DrawnBuffers;
+
+//! Remembers when the driver draws it
+class CLoggingMeshBuffer : public SMeshBuffer
+{
+public:
+	virtual const void* getVertices() const _IRR_OVERRIDE_
+	{
+		DrawnBuffers.push_back(this);
+		return SMeshBuffer::getVertices();
+	}
+};
+
+//! Adds a node with one mesh buffer per texture
+IMeshSceneNode* addNode(ISceneManager* smgr, video::ITexture** textures, u32 textureCount, const vector3df& position)
+{
+	SMesh* mesh = new SMesh();
+	for (u32 i=0; i<textureCount; ++i)
+	{
+		CLoggingMeshBuffer* mb = new CLoggingMeshBuffer();
+		mb->Vertices.push_back(video::S3DVertex(0,0,0, 0,0,-1, video::SColor(255,255,255,255), 0,0));
+		mb->Vertices.push_back(video::S3DVertex(1,0,0, 0,0,-1, video::SColor(255,255,255,255), 1,0));
+		mb->Vertices.push_back(video::S3DVertex(0,1,0, 0,0,-1, video::SColor(255,255,255,255), 0,1));
+		mb->Indices.push_back(0);
+		mb->Indices.push_back(1);
+		mb->Indices.push_back(2);
+		mb->Material.setTexture(0, textures[i]);
+		if (!textures[i])
+			mb->Material.MaterialType = video::EMT_TRANSPARENT_ADD_COLOR;
+		mb->recalculateBoundingBox();
+		mesh->addMeshBuffer(mb);
+		mb->drop();
+	}
+	mesh->recalculateBoundingBox();
+
+	IMeshSceneNode* node = smgr->addMeshSceneNode(mesh, 0, -1, position);
+	mesh->drop();
+	return node;
+}
+
+//! Counts the texture changes between the drawn solid mesh buffers
+u32 countTextureChanges()
+{
+	u32 changes = 0;
+	video::ITexture* last = 0;
+	for (u32 i=0; i<DrawnBuffers.size(); ++i)
+	{
+		const video::SMaterial& material = DrawnBuffers[i]->getMaterial();
+		if (material.MaterialType != video::EMT_SOLID)
+			continue;
+		if (!changes || material.getTexture(0) != last)
+			++changes;
+		last = material.getTexture(0);
+	}
+	return changes;
+}
+
+} // end anonymous namespace
+
+/** Test that the render queue draws the same mesh buffers as the scene
+nodes, with fewer texture changes. */
+bool renderQueue(void)
+{
+	IrrlichtDevice* device = createDevice(video::EDT_NULL, dimension2du(160, 120));
+	if (!device)
+		return false;
+
+	video::IVideoDriver* driver = device->getVideoDriver();
+	ISceneManager* smgr = device->getSceneManager();
+	smgr->addCameraSceneNode(0, vector3df(0.f, 0.f, -10.f), vector3df(0.f, 0.f, 0.f));
+
+	video::ITexture* textures[3];
+	textures[0] = driver->addTexture(dimension2du(4, 4), "first");
+	textures[1] = driver->addTexture(dimension2du(4, 4), "second");
+	textures[2] = 0;
+
+	// each node uses both textures, one node with a transparent mesh buffer
+	for (u32 i=0; i<8; ++i)
+		addNode(smgr, textures, i ? 2 : 3, vector3df((f32)i, 0.f, 0.f));
+
+	// a node which can't be queued
+	IMeshSceneNode* debugNode = addNode(smgr, textures, 2, vector3df(0.f, 2.f, 0.f));
+	debugNode->setDebugDataVisible(EDS_BBOX);
+
+	bool result = !smgr->getRenderQueue();
+
+	DrawnBuffers.clear();
+	driver->beginScene(video::ECBF_COLOR | video::ECBF_DEPTH, video::SColor(255,0,0,0));
+	smgr->drawAll();
+	driver->endScene();
+	const u32 drawnWithoutQueue = DrawnBuffers.size();
+	const u32 changesWithoutQueue = countTextureChanges();
+
+	smgr->setRenderQueue(true);
+	result &= smgr->getRenderQueue();
+
+	DrawnBuffers.clear();
+	driver->beginScene(video::ECBF_COLOR | video::ECBF_DEPTH, video::SColor(255,0,0,0));
+	smgr->drawAll();
+	driver->endScene();
+
+	// 9 nodes with 2 solid mesh buffers and one transparent mesh buffer
+	result &= (drawnWithoutQueue == 19);
+	result &= (DrawnBuffers.size() == drawnWithoutQueue);
+	// the queued buffers, then the debug node and the transparent buffer
+	result &= (countTextureChanges() == 4);
+	result &= (changesWithoutQueue == 18);
+
+	smgr->setRenderQueue(false);
+	result &= !smgr->getRenderQueue();
+
+	device->closeDevice();
+	device->run();
+	device->drop();
+
+	if (!result)
+		logTestString("Render queue drew %d mesh buffers with %d texture changes, before %d with %d changes\n",
+			DrawnBuffers.size(), countTextureChanges(), drawnWithoutQueue, changesWithoutQueue);
+
+	return result;
+}
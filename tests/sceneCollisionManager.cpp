@@ -439,6 +439,179 @@ static bool compareGetSceneNodeFromRayBBWithBBIntersectsWithLine(IrrlichtDevice
 }
 
 
+// Adds some cubes and a sphere and returns a selector for all of them
+static IMetaTriangleSelector* createBatchScene(ISceneManager * smgr)
+{
+	IMetaTriangleSelector * meta = smgr->createMetaTriangleSelector();
+
+	for (s32 i=0; i<4; ++i)
+	{
+		ISceneNode * cube = smgr->addCubeSceneNode(10.f + i*5.f, 0, -1,
+			vector3df(i*20.f - 30.f, i*3.f - 5.f, i*7.f - 10.f), vector3df(0, i*15.f, 0));
+		ITriangleSelector * selector = smgr->createTriangleSelectorFromBoundingBox(cube);
+		meta->addTriangleSelector(selector);
+		selector->drop();
+	}
+
+	IMeshSceneNode * sphere = smgr->addSphereSceneNode(8.f, 16, 0, -1, vector3df(3.f, 12.f, 25.f));
+	ITriangleSelector * selector = smgr->createTriangleSelector(sphere->getMesh(), sphere);
+	meta->addTriangleSelector(selector);
+	selector->drop();
+
+	// the cubes only get their absolute transformation here
+	smgr->getRootSceneNode()->OnAnimate(0);
+
+	return meta;
+}
+
+
+// Test that getCollisionPoints() gives the same results as getCollisionPoint() for each ray
+static bool testBatchCollisionPoints(ISceneManager * smgr, ISceneCollisionManager * collMgr)
+{
+	IMetaTriangleSelector * meta = createBatchScene(smgr);
+
+	array<line3df> rays;
+	for (s32 y=0; y<16; ++y)
+	{
+		for (s32 x=0; x<16; ++x)
+		{
+			const vector3df start(x*4.13f - 33.f, y*2.71f - 20.f, -60.f + x);
+			const vector3df end(x*3.17f - 24.f, y*1.93f - 10.f, 60.f - y*2.f);
+			rays.push_back(line3df(start, end));
+			rays.push_back(line3df(end, start));
+		}
+	}
+
+	array<SCollisionHit> hits;
+	hits.set_used(rays.size());
+	array<bool> hitFlags;
+	hitFlags.set_used(rays.size());
+	const u32 hitCount = collMgr->getCollisionPoints(hits.pointer(), hitFlags.pointer(),
+		rays.const_pointer(), rays.size(), meta);
+
+	bool result = true;
+	u32 expectedHitCount = 0;
+	for (u32 i=0; i<rays.size(); ++i)
+	{
+		SCollisionHit hit;
+		const bool collision = collMgr->getCollisionPoint(hit, rays[i], meta);
+		if (collision)
+			++expectedHitCount;
+
+		if (collision != hitFlags[i])
+		{
+			logTestString("testBatchCollisionPoints: ray %d hit is %d instead of %d.\n", i, hitFlags[i], collision);
+			result = false;
+		}
+		else if (collision && (!hits[i].Intersection.equals(hit.Intersection, 0.01f) ||
+			hits[i].Node != hit.Node || hits[i].TriangleSelector != hit.TriangleSelector))
+		{
+			logTestString("testBatchCollisionPoints: ray %d hit %f %f %f instead of %f %f %f.\n", i,
+				hits[i].Intersection.X, hits[i].Intersection.Y, hits[i].Intersection.Z,
+				hit.Intersection.X, hit.Intersection.Y, hit.Intersection.Z);
+			result = false;
+		}
+	}
+
+	if (hitCount != expectedHitCount || hitCount == 0 || hitCount == rays.size())
+	{
+		logTestString("testBatchCollisionPoints: %d of %d rays hit, expected %d.\n", hitCount, rays.size(), expectedHitCount);
+		result = false;
+	}
+
+	meta->drop();
+	smgr->clear();
+
+	assert_log(result);
+	return result;
+}
+
+
+// Test that getCollisionResultPositions() gives the same results as getCollisionResultPosition() for each ellipsoid
+static bool testBatchCollisionResultPositions(ISceneManager * smgr, ISceneCollisionManager * collMgr)
+{
+	IMetaTriangleSelector * meta = createBatchScene(smgr);
+
+	const vector3df gravity(0, -10.f, 0);
+	array<SEllipsoidSweep> sweeps;
+	for (s32 i=0; i<80; ++i)
+	{
+		SEllipsoidSweep sweep;
+		sweep.Position.set((i%10)*7.f - 35.f, 20.f + (i%3)*5.f, (i/10)*6.f - 20.f);
+		sweep.Radius.set(2.f + (i%4), 3.f + (i%5), 2.f + (i%3));
+		sweep.DirectionAndSpeed.set((i%7)*3.f - 9.f, -(f32)(i%11), (i%5)*4.f - 8.f);
+		sweeps.push_back(sweep);
+	}
+	// not moved
+	sweeps[5].Radius.Y = 0.f;
+
+	collMgr->getCollisionResultPositions(meta, sweeps.pointer(), sweeps.size(), 0.0005f, gravity);
+
+	bool result = true;
+	u32 hitCount = 0;
+	for (u32 i=0; i<sweeps.size(); ++i)
+	{
+		const SEllipsoidSweep& sweep = sweeps[i];
+
+		triangle3df triOut;
+		vector3df hitPosition;
+		bool falling = false;
+		ISceneNode* hitNode = 0;
+		const vector3df resultPosition = collMgr->getCollisionResultPosition(meta,
+			sweep.Position, sweep.Radius, sweep.DirectionAndSpeed,
+			triOut, hitPosition, falling, hitNode, 0.0005f, gravity);
+		if (hitNode)
+			++hitCount;
+
+		if (!sweep.ResultPosition.equals(resultPosition, 0.01f) ||
+			sweep.Falling != falling || sweep.Node != hitNode)
+		{
+			logTestString("testBatchCollisionResultPositions: ellipsoid %d moved to %f %f %f instead of %f %f %f.\n", i,
+				sweep.ResultPosition.X, sweep.ResultPosition.Y, sweep.ResultPosition.Z,
+				resultPosition.X, resultPosition.Y, resultPosition.Z);
+			result = false;
+		}
+	}
+
+	if (hitCount == 0 || hitCount == sweeps.size())
+	{
+		logTestString("testBatchCollisionResultPositions: %d of %d ellipsoids collided.\n", hitCount, sweeps.size());
+		result = false;
+	}
+
+	meta->drop();
+	smgr->clear();
+
+	assert_log(result);
+	return result;
+}
+
+
+// Test the batches with the jobs spread over worker threads
+static bool testBatchesWithWorkerThreads()
+{
+	SIrrlichtCreationParameters params;
+	params.DriverType = video::EDT_NULL;
+	params.WindowSize = dimension2du(160, 120);
+	params.WorkerThreads = 2;
+	IrrlichtDevice * device = createDeviceEx(params);
+	assert_log(device);
+	if (!device)
+		return false;
+
+	ISceneManager * smgr = device->getSceneManager();
+	ISceneCollisionManager * collMgr = smgr->getSceneCollisionManager();
+
+	bool result = testBatchCollisionPoints(smgr, collMgr);
+	result &= testBatchCollisionResultPositions(smgr, collMgr);
+
+	device->closeDevice();
+	device->run();
+	device->drop();
+	return result;
+}
+
+
 /** Test functionality of the sceneCollisionManager */
 bool sceneCollisionManager(void)
 {
@@ -464,8 +637,15 @@ bool sceneCollisionManager(void)
 
 	result &= compareGetSceneNodeFromRayBBWithBBIntersectsWithLine(device, smgr, collMgr);
 
+	result &= testBatchCollisionPoints(smgr, collMgr);
+
+	result &= testBatchCollisionResultPositions(smgr, collMgr);
+
 	device->closeDevice();
 	device->run();
 	device->drop();
+
+	result &= testBatchesWithWorkerThreads();
+
 	return result;
 }
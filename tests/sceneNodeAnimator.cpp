@@ -7,7 +7,423 @@ using namespace irr;
 using namespace core;
 using namespace scene;
 
-/** Test functionality of the ISceneNodeAnimator implementations. */
+namespace
+{
+
+//! Moves a node to another node, which is not thread safe.
+class CFollowAnimator : public ISceneNodeAnimator
+{
+public:
+	//! The target is found by its id, as it may be removed from the scene
+	CFollowAnimator(s32 targetId) : TargetId(targetId) {}
+
+	virtual void animateNode(ISceneNode* node, u32 timeMs) _IRR_OVERRIDE_
+	{
+		ISceneNode* target = TargetId >= 0 ? node->getSceneManager()->getSceneNodeFromId(TargetId) : 0;
+		if (target)
+			node->setPosition(target->getAbsolutePosition() + vector3df(0.f, 1.f, 0.f));
+		else
+			node->setPosition(vector3df(0.f, (f32)(timeMs % 100), 0.f));
+	}
+
+	virtual ISceneNodeAnimator* createClone(ISceneNode* node, ISceneManager* newManager=0) _IRR_OVERRIDE_
+	{
+		return 0;
+	}
+
+private:
+	s32 TargetId;
+};
+
+//! A user node with an own OnAnimate(), which counts the calls
+class CCountingSceneNode : public ISceneNode
+{
+public:
+	CCountingSceneNode(ISceneNode* parent, ISceneManager* mgr)
+		: ISceneNode(parent, mgr), Calls(0) {}
+
+	virtual void OnAnimate(u32 timeMs) _IRR_OVERRIDE_
+	{
+		++Calls;
+		ISceneNode::OnAnimate(timeMs);
+	}
+
+	virtual void render() _IRR_OVERRIDE_ {}
+
+	virtual const aabbox3df& getBoundingBox() const _IRR_OVERRIDE_
+	{
+		return Box;
+	}
+
+	u32 Calls;
+
+private:
+	aabbox3df Box;
+};
+
+//! A user node with its own transformation, which doesn't call ISceneNode::updateAbsolutePosition()
+class CMatrixSceneNode : public ISceneNode
+{
+public:
+	CMatrixSceneNode(ISceneNode* parent, ISceneManager* mgr)
+		: ISceneNode(parent, mgr), Box(-1.f, -1.f, -1.f, 1.f, 1.f, 1.f) {}
+
+	virtual matrix4 getRelativeTransformation() const _IRR_OVERRIDE_
+	{
+		return Matrix;
+	}
+
+	virtual void updateAbsolutePosition() _IRR_OVERRIDE_
+	{
+		AbsoluteTransformation = Matrix;
+	}
+
+	virtual void render() _IRR_OVERRIDE_ {}
+
+	virtual const aabbox3df& getBoundingBox() const _IRR_OVERRIDE_
+	{
+		return Box;
+	}
+
+	matrix4 Matrix;
+
+private:
+	aabbox3df Box;
+};
+
+//! A node with the default transformation, which counts its updates
+class CUpdateCountingSceneNode : public ISceneNode
+{
+public:
+	CUpdateCountingSceneNode(ISceneNode* parent, ISceneManager* mgr)
+		: ISceneNode(parent, mgr), Updates(0) {}
+
+	virtual bool hasDefaultTransformation() const _IRR_OVERRIDE_ { return true; }
+
+	virtual void updateAbsolutePosition() _IRR_OVERRIDE_
+	{
+		++Updates;
+		ISceneNode::updateAbsolutePosition();
+	}
+
+	virtual void render() _IRR_OVERRIDE_ {}
+
+	virtual const aabbox3df& getBoundingBox() const _IRR_OVERRIDE_
+	{
+		return Box;
+	}
+
+	u32 Updates;
+
+private:
+	aabbox3df Box;
+};
+
+//! Adds the same tree of animated nodes to a scene manager
+/** With follow, some nodes depend on the positions of other nodes in the
+same frame, so the result depends on the order in which they are animated. */
+void addAnimatedTree(ISceneManager* smgr, u32 seed, bool follow)
+{
+	srand(seed);
+	array<ISceneNode*> nodes;
+	for (u32 i=0; i<2000; ++i)
+	{
+		// about three levels below the root, with some deep chains
+		ISceneNode* parent = nodes.size() && (i % 7) ? nodes[rand() % nodes.size()] : 0;
+		ISceneNode* node = smgr->addEmptySceneNode(parent, i);
+		node->setPosition(vector3df((f32)(rand() % 100), (f32)(rand() % 100), (f32)(rand() % 100)));
+
+		ISceneNodeAnimator* anim = 0;
+		switch (rand() % 5)
+		{
+		case 0:
+			anim = smgr->createRotationAnimator(vector3df(0.f, (f32)(rand() % 10) * 0.1f, 0.3f));
+			break;
+		case 1:
+			anim = smgr->createFlyCircleAnimator(vector3df(0.f, 0.f, 0.f), (f32)(rand() % 20));
+			break;
+		case 2:
+			if (nodes.size())
+				anim = new CFollowAnimator(follow ? (s32)(rand() % nodes.size()) : -1);
+			break;
+		case 3:
+			if (i % 50 == 0)
+				anim = smgr->createDeleteAnimator(200);
+			break;
+		default:
+			break;
+		}
+		if (anim)
+		{
+			node->addAnimator(anim);
+			anim->drop();
+		}
+		nodes.push_back(node);
+	}
+}
+
+bool equalTrees(ISceneNode* a, ISceneNode* b)
+{
+	if (a->getID() != b->getID() || a->getChildren().size() != b->getChildren().size())
+	{
+		logTestString("Node %d differs from node %d\n", a->getID(), b->getID());
+		return false;
+	}
+
+	if (!a->getAbsolutePosition().equals(b->getAbsolutePosition()) ||
+		!a->getAbsoluteTransformation().equals(b->getAbsoluteTransformation()))
+	{
+		logTestString("Node %d is at %f %f %f instead of %f %f %f\n", a->getID(),
+			a->getAbsolutePosition().X, a->getAbsolutePosition().Y, a->getAbsolutePosition().Z,
+			b->getAbsolutePosition().X, b->getAbsolutePosition().Y, b->getAbsolutePosition().Z);
+		return false;
+	}
+
+	ISceneNodeList::ConstIterator ita = a->getChildren().begin();
+	ISceneNodeList::ConstIterator itb = b->getChildren().begin();
+	for (; ita != a->getChildren().end(); ++ita, ++itb)
+	{
+		if (!equalTrees(*ita, *itb))
+			return false;
+	}
+
+	return true;
+}
+
+IrrlichtDevice* createJobDevice(u32 workerThreads)
+{
+	SIrrlichtCreationParameters params;
+	params.DriverType = video::EDT_NULL;
+	params.WorkerThreads = workerThreads;
+	return createDeviceEx(params);
+}
+
+//! Animates both scene managers in the same frames and compares their nodes.
+bool compareAnimation(ITimer* timer, ISceneManager* smgr1, ISceneManager* smgr2)
+{
+	bool result = true;
+	timer->stop();
+	for (u32 t=1000; t<1500 && result; t+=50)
+	{
+		timer->setTime(t);
+		smgr1->drawAll();
+		smgr2->drawAll();
+		result &= equalTrees(smgr1->getRootSceneNode(), smgr2->getRootSceneNode());
+	}
+	timer->start();
+
+	return result;
+}
+
+//! Animates the same scene on the worker threads and on the main thread.
+bool parallelAnimation()
+{
+	IrrlichtDevice* device = createJobDevice(2);
+	IrrlichtDevice* device1 = createJobDevice(1);
+	if (!device || !device1)
+		return false;
+
+	// nodes which only depend on their parents have the same
+	// result as with ISceneNode::OnAnimate()
+	ISceneManager* parallel = device->getSceneManager();
+	ISceneManager* serial = parallel->createNewSceneManager();
+	addAnimatedTree(parallel, 42, false);
+	addAnimatedTree(serial, 42, false);
+	parallel->setParallelAnimation(true);
+
+	bool result = parallel->getParallelAnimation() && !serial->getParallelAnimation();
+	result &= compareAnimation(device->getTimer(), parallel, serial);
+	serial->drop();
+
+	// the others are always animated in the same order, with any number of threads
+	parallel->clear();
+	addAnimatedTree(parallel, 7, true);
+	ISceneManager* parallel1 = device1->getSceneManager();
+	addAnimatedTree(parallel1, 7, true);
+	parallel1->setParallelAnimation(true);
+	result &= compareAnimation(device->getTimer(), parallel, parallel1);
+
+	// nodes which override OnAnimate() don't lose it
+	parallel->clear();
+	CCountingSceneNode* counting = new CCountingSceneNode(parallel->addEmptySceneNode(), parallel);
+	parallel->drawAll();
+	parallel->drawAll();
+	result &= counting->Calls == 2;
+	counting->drop();
+
+	device->closeDevice();
+	device->run();
+	device->drop();
+	device1->closeDevice();
+	device1->run();
+	device1->drop();
+
+	if (!result)
+		logTestString("Parallel animation differs\n");
+
+	return result;
+}
+
+//! Changes the scene graph between the frames of transformStore()
+void changeScene(ISceneManager* smgr, u32 frame)
+{
+	ISceneNode* node = 0;
+	switch (frame)
+	{
+	case 3:
+		smgr->getSceneNodeFromId(10)->setVisible(false);
+		smgr->getSceneNodeFromId(3)->setPosition(vector3df(5.f, 6.f, 7.f));
+		break;
+	case 5:
+		smgr->getSceneNodeFromId(10)->setVisible(true);
+		// descendants have larger ids
+		smgr->getSceneNodeFromId(31)->setParent(smgr->getSceneNodeFromId(21));
+		break;
+	case 6:
+		smgr->getSceneNodeFromId(41)->remove();
+		node = smgr->addEmptySceneNode(smgr->getSceneNodeFromId(53), 6000);
+		node->setPosition(vector3df(1.f, 2.f, 3.f));
+		break;
+	case 7:
+		smgr->getSceneNodeFromId(1)->setScale(vector3df(2.f, 1.f, 1.f));
+		break;
+	default:
+		break;
+	}
+
+	IDummyTransformationSceneNode* dummy = (IDummyTransformationSceneNode*)smgr->getSceneNodeFromId(5000);
+	dummy->getRelativeTransformationMatrix().setTranslation(vector3df((f32)frame, 0.f, 0.f));
+}
+
+//! Animates the same scene with and without the transform store.
+bool transformStore()
+{
+	IrrlichtDevice* device = createJobDevice(0);
+	if (!device)
+		return false;
+
+	ISceneManager* stored = device->getSceneManager();
+	ISceneManager* plain = stored->createNewSceneManager();
+	ISceneManager* smgrs[] = { stored, plain };
+	for (u32 i=0; i<2; ++i)
+	{
+		addAnimatedTree(smgrs[i], 3, true);
+		smgrs[i]->addLightSceneNode(smgrs[i]->getSceneNodeFromId(5), vector3df(0.f, 10.f, 0.f));
+		ISceneNode* dummy = smgrs[i]->addDummyTransformationSceneNode(smgrs[i]->getSceneNodeFromId(9), 5000);
+		smgrs[i]->addEmptySceneNode(dummy, 5001)->setPosition(vector3df(1.f, 2.f, 3.f));
+	}
+	stored->setTransformStore(true);
+
+	bool result = stored->getTransformStore() && !plain->getTransformStore();
+
+	ITimer* timer = device->getTimer();
+	timer->stop();
+	for (u32 f=0; f<12 && result; ++f)
+	{
+		timer->setTime(1000 + f*50);
+		for (u32 i=0; i<2; ++i)
+		{
+			changeScene(smgrs[i], f);
+			smgrs[i]->drawAll();
+		}
+		result &= equalTrees(stored->getRootSceneNode(), plain->getRootSceneNode());
+	}
+	timer->start();
+
+	plain->drop();
+	stored->clear();
+	device->closeDevice();
+	device->run();
+	device->drop();
+
+	if (!result)
+		logTestString("Animation with the transform store differs\n");
+
+	return result;
+}
+
+//! Nodes which didn't move skip the update of their absolute transformation.
+bool skipUnchangedTransformations()
+{
+	IrrlichtDevice* device = createDevice(video::EDT_NULL, dimension2du(160, 120));
+	if (!device)
+		return false;
+
+	ISceneManager* smgr = device->getSceneManager();
+	ISceneNode* parent = smgr->addEmptySceneNode();
+	ISceneNode* other = smgr->addEmptySceneNode();
+	other->setPosition(vector3df(0.f, 0.f, 100.f));
+	ISceneNode* cube = smgr->addCubeSceneNode(2.f, parent, -1, vector3df(1.f, 2.f, 3.f));
+
+	smgr->getRootSceneNode()->OnAnimate(0);
+	bool result = cube->getAbsolutePosition().equals(vector3df(1.f, 2.f, 3.f));
+	result &= cube->getTransformedBoundingBox().MinEdge.equals(vector3df(0.f, 1.f, 2.f));
+
+	// nothing changed
+	result &= !parent->updateAbsolutePositionIfChanged();
+	result &= !cube->updateAbsolutePositionIfChanged();
+
+	// the parent moved
+	parent->setPosition(vector3df(10.f, 0.f, 0.f));
+	smgr->getRootSceneNode()->OnAnimate(10);
+	result &= cube->getAbsolutePosition().equals(vector3df(11.f, 2.f, 3.f));
+	result &= cube->getTransformedBoundingBox().MinEdge.equals(vector3df(10.f, 1.f, 2.f));
+	result &= !cube->updateAbsolutePositionIfChanged();
+
+	// a small movement of the node itself
+	cube->setPosition(vector3df(1.f, 2.f, 3.0001f));
+	result &= cube->updateAbsolutePositionIfChanged();
+	result &= cube->getAbsolutePosition().equals(vector3df(11.f, 2.f, 3.0001f), 0.00001f);
+
+	// another parent
+	cube->setParent(other);
+	smgr->getRootSceneNode()->OnAnimate(20);
+	result &= cube->getAbsolutePosition().equals(vector3df(1.f, 2.f, 103.0001f), 0.00001f);
+	result &= cube->getTransformedBoundingBox().MaxEdge.equals(vector3df(2.f, 3.f, 104.0001f), 0.00001f);
+
+	// only the frames after a movement update the transformation
+	CUpdateCountingSceneNode* counting = new CUpdateCountingSceneNode(parent, smgr);
+	for (u32 t=0; t<4; ++t)
+		smgr->getRootSceneNode()->OnAnimate(30 + t);
+	result &= (counting->Updates == 0);
+	parent->setPosition(vector3df(20.f, 0.f, 0.f));
+	for (u32 t=0; t<4; ++t)
+		smgr->getRootSceneNode()->OnAnimate(40 + t);
+	result &= (counting->Updates == 1);
+	result &= counting->getAbsolutePosition().equals(vector3df(20.f, 0.f, 0.f));
+	counting->drop();
+
+	// user nodes don't know about the skipped updates, their children follow them
+	CMatrixSceneNode* user = new CMatrixSceneNode(smgr->getRootSceneNode(), smgr);
+	ISceneNode* child = smgr->addEmptySceneNode(user);
+	child->setPosition(vector3df(1.f, 0.f, 0.f));
+	smgr->getRootSceneNode()->OnAnimate(50);
+	user->Matrix.setTranslation(vector3df(4.f, 5.f, 6.f));
+	smgr->getRootSceneNode()->OnAnimate(60);
+	result &= user->getAbsolutePosition().equals(vector3df(4.f, 5.f, 6.f));
+	result &= user->getTransformedBoundingBox().MinEdge.equals(vector3df(3.f, 4.f, 5.f));
+	result &= child->getAbsolutePosition().equals(vector3df(5.f, 5.f, 6.f));
+	user->Matrix.setTranslation(vector3df(7.f, 5.f, 6.f));
+	smgr->getRootSceneNode()->OnAnimate(70);
+	result &= user->getTransformedBoundingBox().MinEdge.equals(vector3df(6.f, 4.f, 5.f));
+	result &= child->getAbsolutePosition().equals(vector3df(8.f, 5.f, 6.f));
+	user->drop();
+
+	device->closeDevice();
+	device->run();
+	device->drop();
+
+	if (!result)
+		logTestString("Skipping unchanged transformations failed\n");
+
+	return result;
+}
+
+} // end anonymous namespace
+
+/** Test functionality of the ISceneNodeAnimator implementations, the
+animation on the worker threads and with the transform store, and the
+skipped updates of unchanged transformations. */
 bool sceneNodeAnimator(void)
 {
 	IrrlichtDevice * device = irr::createDevice(video::EDT_NULL, dimension2d<u32>(160, 120));
@@ -111,6 +527,10 @@ bool sceneNodeAnimator(void)
 		assert_log(false);
 	}
 
+	result &= parallelAnimation();
+	result &= transformStore();
+	result &= skipUnchangedTransformations();
+
 	return result;
 }
 
@@ -5,9 +5,253 @@
 
 using namespace irr;
 
+// Compares the skinned vertices with the weighted sum of the joint transformations.
+static bool compareWithReference(scene::ISkinnedMesh* mesh, const core::array<video::S3DVertex>& staticVertices)
+{
+	core::array<core::vector3df> positions;
+	core::array<core::vector3df> normals;
+	core::array<bool> moved;
+	positions.set_used(staticVertices.size());
+	normals.set_used(staticVertices.size());
+	moved.set_used(staticVertices.size());
+	for (u32 i=0; i<moved.size(); ++i)
+		moved[i] = false;
+
+	core::array<u32> firstVertex;
+	u32 count = 0;
+	for (u32 b=0; b<mesh->getMeshBufferCount(); ++b)
+	{
+		firstVertex.push_back(count);
+		count += mesh->getMeshBuffer(b)->getVertexCount();
+	}
+
+	const core::array<scene::ISkinnedMesh::SJoint*>& joints = mesh->getAllJoints();
+	for (u32 j=0; j<joints.size(); ++j)
+	{
+		core::matrix4 pull;
+		pull.setbyproduct(joints[j]->GlobalAnimatedMatrix, joints[j]->GlobalInversedMatrix);
+
+		for (u32 w=0; w<joints[j]->Weights.size(); ++w)
+		{
+			const scene::ISkinnedMesh::SWeight& weight = joints[j]->Weights[w];
+			const u32 v = firstVertex[weight.buffer_id] + weight.vertex_id;
+
+			core::vector3df pos, normal;
+			pull.transformVect(pos, staticVertices[v].Pos);
+			pull.rotateVect(normal, staticVertices[v].Normal);
+
+			positions[v] = (moved[v] ? positions[v] : core::vector3df()) + pos * weight.strength;
+			normals[v] = (moved[v] ? normals[v] : core::vector3df()) + normal * weight.strength;
+			moved[v] = true;
+		}
+	}
+
+	u32 skinned = 0;
+	for (u32 b=0; b<mesh->getMeshBufferCount(); ++b)
+	{
+		scene::IMeshBuffer* buffer = mesh->getMeshBuffer(b);
+		for (u32 i=0; i<buffer->getVertexCount(); ++i)
+		{
+			const u32 v = firstVertex[b] + i;
+			const core::vector3df& pos = buffer->getPosition(i);
+			const core::vector3df& normal = buffer->getNormal(i);
+
+			if (!moved[v])
+			{
+				if (pos != staticVertices[v].Pos)
+					return false;
+				continue;
+			}
+
+			const f32 tolerance = 0.0001f * (1.f + positions[v].getLength());
+			if (!pos.equals(positions[v], tolerance) || !normal.equals(normals[v], 0.0001f))
+			{
+				logTestString("Skinned vertex %u of buffer %u differs from reference.\n", i, b);
+				return false;
+			}
+			++skinned;
+		}
+	}
+
+	return skinned > 0;
+}
+
+// Skins meshes directly and through an animated scene node with worker threads.
+static bool skinningReference(const io::path& filename)
+{
+	SIrrlichtCreationParameters params;
+	params.DriverType = video::EDT_NULL;
+	params.WorkerThreads = 2;
+
+	IrrlichtDevice *device = createDeviceEx(params);
+	if (!device)
+		return false;
+
+	scene::ISceneManager * smgr = device->getSceneManager();
+	scene::ISkinnedMesh* mesh = (scene::ISkinnedMesh*)smgr->getMesh(filename);
+	if (!mesh)
+	{
+		logTestString("Could not load %s.\n", filename.c_str());
+		device->closeDevice();
+		device->run();
+		device->drop();
+		return false;
+	}
+
+	core::array<video::S3DVertex> staticVertices;
+	for (u32 b=0; b<mesh->getMeshBufferCount(); ++b)
+	{
+		scene::IMeshBuffer* buffer = mesh->getMeshBuffer(b);
+		for (u32 i=0; i<buffer->getVertexCount(); ++i)
+			staticVertices.push_back(video::S3DVertex(buffer->getPosition(i), buffer->getNormal(i), video::SColor(0), core::vector2df()));
+	}
+
+	mesh->animateMesh(mesh->getFrameCount() / 3.f, 1.f);
+	mesh->skinMesh();
+	bool result = compareWithReference(mesh, staticVertices);
+
+	scene::IAnimatedMeshSceneNode* node = smgr->addAnimatedMeshSceneNode(mesh);
+	node->setCurrentFrame(mesh->getFrameCount() / 2.f);
+	node->OnAnimate(device->getTimer()->getTime());
+	result &= compareWithReference(mesh, staticVertices);
+
+	if (!result)
+		logTestString("Skinning %s differs from reference.\n", filename.c_str());
+
+	device->closeDevice();
+	device->run();
+	device->drop();
+
+	return result;
+}
+
+// Builds a grid bent by two joints, with more vertices than are skinned on
+// the calling thread. The vertices of the middle columns have two weights.
+static scene::ISkinnedMesh* createBentGrid(scene::ISceneManager* smgr)
+{
+	const u32 size = 100;
+
+	scene::ISkinnedMesh* mesh = smgr->createSkinnedMesh();
+	scene::SSkinMeshBuffer* buffer = mesh->addMeshBuffer();
+	for (u32 y=0; y<size; ++y)
+	{
+		for (u32 x=0; x<size; ++x)
+			buffer->Vertices_Standard.push_back(video::S3DVertex((f32)x, 0.f, (f32)y, 0.f, 1.f, 0.f,
+				video::SColor(255, 255, 255, 255), x / (f32)size, y / (f32)size));
+	}
+	for (u32 y=0; y+1<size; ++y)
+	{
+		for (u32 x=0; x+1<size; ++x)
+		{
+			const u16 i = (u16) (y * size + x);
+			buffer->Indices.push_back(i);
+			buffer->Indices.push_back((u16) (i + size));
+			buffer->Indices.push_back((u16) (i + 1));
+			buffer->Indices.push_back((u16) (i + 1));
+			buffer->Indices.push_back((u16) (i + size));
+			buffer->Indices.push_back((u16) (i + size + 1));
+		}
+	}
+
+	scene::ISkinnedMesh::SJoint* root = mesh->addJoint();
+	root->Name = "root";
+	scene::ISkinnedMesh::SJoint* tip = mesh->addJoint(root);
+	tip->Name = "tip";
+	tip->LocalMatrix.setTranslation(core::vector3df(size * 0.5f, 0.f, 0.f));
+
+	for (u32 k=0; k<2; ++k)
+	{
+		scene::ISkinnedMesh::SRotationKey* key = mesh->addRotationKey(root);
+		key->frame = k * 10.f;
+		key->rotation.fromAngleAxis(k * 0.5f, core::vector3df(0.f, 0.f, 1.f));
+		key = mesh->addRotationKey(tip);
+		key->frame = k * 10.f;
+		key->rotation.fromAngleAxis(k * 1.2f, core::vector3df(1.f, 0.f, 1.f).normalize());
+		scene::ISkinnedMesh::SPositionKey* position = mesh->addPositionKey(tip);
+		position->frame = k * 10.f;
+		position->position.set(size * 0.5f, k * 3.f, 0.f);
+	}
+
+	for (u32 i=0; i<buffer->Vertices_Standard.size(); ++i)
+	{
+		const f32 t = core::clamp((buffer->Vertices_Standard[i].Pos.X - size * 0.3f) / (size * 0.4f), 0.f, 1.f);
+		if (t < 1.f)
+		{
+			scene::ISkinnedMesh::SWeight* weight = mesh->addWeight(root);
+			weight->buffer_id = 0;
+			weight->vertex_id = i;
+			weight->strength = 1.f - t;
+		}
+		if (t > 0.f)
+		{
+			scene::ISkinnedMesh::SWeight* weight = mesh->addWeight(tip);
+			weight->buffer_id = 0;
+			weight->vertex_id = i;
+			weight->strength = t;
+		}
+	}
+
+	mesh->finalize();
+	return mesh;
+}
+
+// Skinning on the worker threads has to give the same vertices as on the calling thread.
+static bool skinningThreads()
+{
+	SIrrlichtCreationParameters params;
+	params.DriverType = video::EDT_NULL;
+	params.WorkerThreads = 3;
+
+	IrrlichtDevice *device = createDeviceEx(params);
+	if (!device)
+		return false;
+
+	scene::ISceneManager * smgr = device->getSceneManager();
+	scene::ISkinnedMesh* mesh = createBentGrid(smgr);
+	scene::IMeshBuffer* buffer = mesh->getMeshBuffer(0);
+
+	core::array<video::S3DVertex> staticVertices;
+	for (u32 i=0; i<buffer->getVertexCount(); ++i)
+		staticVertices.push_back(video::S3DVertex(buffer->getPosition(i), buffer->getNormal(i), video::SColor(0), core::vector2df()));
+
+	// skinMesh without a job pool runs on the calling thread
+	const f32 frame = 6.5f;
+	mesh->animateMesh(frame, 1.f);
+	mesh->skinMesh();
+	bool result = compareWithReference(mesh, staticVertices);
+
+	core::array<video::S3DVertex> single;
+	for (u32 i=0; i<buffer->getVertexCount(); ++i)
+		single.push_back(video::S3DVertex(buffer->getPosition(i), buffer->getNormal(i), video::SColor(0), core::vector2df()));
+
+	// the scene node skins with the job pool of the driver
+	mesh->animateMesh(0.f, 1.f);
+	scene::IAnimatedMeshSceneNode* node = smgr->addAnimatedMeshSceneNode(mesh);
+	node->setAnimationSpeed(0.f);
+	node->setCurrentFrame(frame);
+	node->OnAnimate(device->getTimer()->getTime());
+	result &= compareWithReference(mesh, staticVertices);
+
+	for (u32 i=0; result && i<buffer->getVertexCount(); ++i)
+		result = buffer->getPosition(i) == single[i].Pos && buffer->getNormal(i) == single[i].Normal;
+
+	if (!result)
+		logTestString("Skinning on worker threads differs from skinning on the calling thread.\n");
+
+	mesh->drop();
+	device->closeDevice();
+	device->run();
+	device->drop();
+
+	return result;
+}
+
 // Tests skinned meshes.
 bool skinnedMesh(void)
 {
+	if (!skinningReference("../media/dwarf.x") || !skinningReference("../media/ninja.b3d") || !skinningThreads())
+		return false;
+
 	// Use EDT_BURNINGSVIDEO since it is not dependent on (e.g.) OpenGL driver versions.
 	IrrlichtDevice *device = createDevice(video::EDT_BURNINGSVIDEO, core::dimension2d<u32>(160, 120), 32);
 	if (!device)
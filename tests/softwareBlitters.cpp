@@ -0,0 +1,166 @@
+// Copyright (C) 2008-2012 Colin MacDonald
+// No rights reserved: this software is in the public domain.
+
+#include "testUtils.h"
+
+using namespace irr;
+using namespace core;
+
+/*
+	The simd blitters of the software drivers work on whole groups of pixels
+	and use the scalar code for the remaining pixels of a row. Blitting whole
+	rows and blitting each pixel on its own has to give the same results.
+*/
+
+namespace
+{
+
+//! random pixel, with many fully transparent and opaque ones to hit the shortcuts
+u32 randomPixel()
+{
+	const u32 c = ((u32)rand() << 16) ^ (u32)rand();
+	switch (rand() % 4)
+	{
+	case 0:
+		return c & 0x00FFFFFF;
+	case 1:
+		return c | 0xFF000000;
+	default:
+		return c;
+	}
+}
+
+video::IImage* createRandomImage(video::IVideoDriver* driver, const dimension2du& size)
+{
+	video::IImage* image = driver->createImage(video::ECF_A8R8G8B8, size);
+	u32* data = (u32*)image->getData();
+	for (u32 i = 0; i != size.Width * size.Height; ++i)
+		data[i] = randomPixel();
+	return image;
+}
+
+//! Compares copyToWithAlpha of rows with the one of single pixels
+bool compareCopyToWithAlpha(video::IVideoDriver* driver, bool combineAlpha, const char* name)
+{
+	// the borders right of the blitted rows must stay untouched
+	const dimension2du size(40, 3);
+
+	for (s32 width = 1; width <= 37; ++width)
+	{
+		const video::SColor color = combineAlpha || rand() % 2 ? randomPixel() : 0xFFFFFFFF;
+		video::IImage* src = createRandomImage(driver, size);
+		video::IImage* rows = createRandomImage(driver, size);
+		video::IImage* pixels = driver->createImage(video::ECF_A8R8G8B8, size);
+		rows->copyTo(pixels);
+
+		src->copyToWithAlpha(rows, position2di(0, 0), recti(0, 0, width, size.Height), color, 0, combineAlpha);
+		for (s32 y = 0; y != (s32)size.Height; ++y)
+			for (s32 x = 0; x != width; ++x)
+				src->copyToWithAlpha(pixels, position2di(x, y), recti(x, y, x+1, y+1), color, 0, combineAlpha);
+
+		const u32* a = (const u32*)rows->getData();
+		const u32* b = (const u32*)pixels->getData();
+		bool result = true;
+		for (u32 i = 0; result && i != size.Width * size.Height; ++i)
+		{
+			if (a[i] != b[i])
+			{
+				logTestString("%s differs at width %d, pixel %u: %08x != %08x\n",
+					name, width, i, a[i], b[i]);
+				result = false;
+			}
+		}
+
+		src->drop();
+		rows->drop();
+		pixels->drop();
+		if (!result)
+			return false;
+	}
+
+	return true;
+}
+
+//! Compares draw2DRectangle of rows with the one of single pixels on the same background
+bool compareRectangles(video::IVideoDriver* driver, bool alpha)
+{
+	// rows are drawn from x=0, single pixels from x=offset
+	const s32 offset = 80;
+	const s32 border = 3;
+
+	driver->beginScene(video::ECBF_COLOR, video::SColor(0));
+	for (s32 width = 1; width <= 37; ++width)
+	{
+		const s32 y = width;
+		for (s32 x = 0; x != width + border; ++x)
+		{
+			const video::SColor background = randomPixel() | 0xFF000000;
+			driver->drawPixel(x, y, background);
+			driver->drawPixel(offset + x, y, background);
+		}
+
+		const video::SColor color = alpha ? (randomPixel() & 0x7FFFFFFF) | 0x01000000 : randomPixel() | 0xFF000000;
+		driver->draw2DRectangle(color, recti(0, y, width, y+1));
+		for (s32 x = 0; x != width; ++x)
+			driver->draw2DRectangle(color, recti(offset + x, y, offset + x + 1, y+1));
+	}
+	video::IImage* screenshot = driver->createScreenShot();
+	driver->endScene();
+
+	if (!screenshot)
+		return false;
+
+	bool result = true;
+	for (s32 width = 1; result && width <= 37; ++width)
+	{
+		for (s32 x = 0; result && x != width + border; ++x)
+		{
+			const video::SColor a = screenshot->getPixel(x, width);
+			const video::SColor b = screenshot->getPixel(offset + x, width);
+			if (a != b)
+			{
+				logTestString("%s rectangle differs at width %d, pixel %d: %08x != %08x\n",
+					alpha ? "Alpha" : "Opaque", width, x, a.color, b.color);
+				result = false;
+			}
+		}
+	}
+
+	screenshot->drop();
+	return result;
+}
+
+} // end anonymous namespace
+
+//! Compares the simd blitters of the software drivers with the scalar ones
+bool softwareBlitters(void)
+{
+	srand(1234);
+
+	IrrlichtDevice* device = createDevice(video::EDT_NULL);
+	if (!device)
+		return false;
+
+	video::IVideoDriver* driver = device->getVideoDriver();
+	bool result = compareCopyToWithAlpha(driver, false, "Alpha blend");
+	result &= compareCopyToWithAlpha(driver, true, "Combine alpha");
+
+	device->closeDevice();
+	device->run();
+	device->drop();
+
+	// the fills are only used to draw rectangles into the back buffer
+	device = createDevice(video::EDT_BURNINGSVIDEO, dimension2du(160, 120), 32);
+	if (!device)
+		return false;
+
+	driver = device->getVideoDriver();
+	result &= compareRectangles(driver, false);
+	result &= compareRectangles(driver, true);
+
+	device->closeDevice();
+	device->run();
+	device->drop();
+
+	return result;
+}
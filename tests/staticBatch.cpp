@@ -0,0 +1,231 @@
+// Copyright (C) 2008-2012 Colin MacDonald
+// No rights reserved: this software is in the public domain.
+
+#include "testUtils.h"
+
+using namespace irr;
+using namespace core;
+using namespace scene;
+
+namespace
+{
+
+//! Draws the scene and returns the number of drawn primitives
+u32 drawScene(IrrlichtDevice* device)
+{
+	video::IVideoDriver* driver = device->getVideoDriver();
+	driver->beginScene(video::ECBF_COLOR | video::ECBF_DEPTH, video::SColor(255,0,0,0));
+	device->getSceneManager()->drawAll();
+	driver->endScene();
+	return driver->getPrimitiveCountDrawn(0);
+}
+
+//! Merging, culling and rebuilding of a few cubes
+bool mergeAndCull(IrrlichtDevice* device)
+{
+	video::IVideoDriver* driver = device->getVideoDriver();
+	ISceneManager* smgr = device->getSceneManager();
+	smgr->addCameraSceneNode(0, vector3df(0.f, 0.f, -20.f), vector3df(0.f, 0.f, 0.f));
+
+	video::ITexture* textures[2];
+	textures[0] = driver->addTexture(dimension2du(4, 4), "first");
+	textures[1] = driver->addTexture(dimension2du(4, 4), "second");
+
+	IStaticBatchSceneNode* batch = smgr->addStaticBatchSceneNode();
+	bool result = batch && batch->getType() == ESNT_STATIC_BATCH;
+	if (!result)
+		return false;
+
+	// 4 cubes in front of the camera and 4 far away at the side, alternating textures
+	IMesh* cube = smgr->getGeometryCreator()->createCubeMesh(vector3df(1.f, 1.f, 1.f));
+	IMeshSceneNode* nodes[8];
+	for (u32 i=0; i<8; ++i)
+	{
+		nodes[i] = smgr->addMeshSceneNode(cube, 0, -1, vector3df((i < 4 ? 0.f : 1000.f) + i * 2.f, 0.f, 0.f));
+		nodes[i]->setMaterialTexture(0, textures[i % 2]);
+		nodes[i]->setMaterialFlag(video::EMF_LIGHTING, false);
+		result &= batch->addNode(nodes[i]);
+		result &= !nodes[i]->isVisible();
+	}
+	const u32 cubeVertices = cube->getMeshBuffer(0)->getVertexCount();
+	const u32 cubeTriangles = cube->getMeshBuffer(0)->getIndexCount() / 3;
+	cube->drop();
+
+	result &= !batch->addNode(nodes[0]);
+	result &= (batch->getNodeCount() == 8);
+	result &= (batch->getNode(3) == nodes[3]);
+
+	// one merged mesh buffer per texture
+	IMesh* mesh = batch->getMesh();
+	result &= (mesh->getMeshBufferCount() == 2);
+	result &= (batch->getMaterialCount() == 2);
+	for (u32 i=0; i<mesh->getMeshBufferCount(); ++i)
+	{
+		const IMeshBuffer* mb = mesh->getMeshBuffer(i);
+		result &= (mb->getVertexCount() == 4 * cubeVertices);
+		result &= (mb->getIndexCount() == 4 * cubeTriangles * 3);
+		result &= (mb->getIndexType() == video::EIT_16BIT);
+		result &= (mb->getMaterial().getTexture(0) == textures[i]);
+	}
+	result &= batch->getBoundingBox().MinEdge.equals(vector3df(-0.5f, -0.5f, -0.5f));
+	result &= batch->getBoundingBox().MaxEdge.equals(vector3df(1014.5f, 0.5f, 0.5f));
+
+	// only the cubes in front of the camera are drawn
+	result &= (drawScene(device) == 4 * cubeTriangles);
+
+	// all cubes in front of the camera
+	for (u32 i=4; i<8; ++i)
+		nodes[i]->setPosition(vector3df(i * 2.f - 8.f, 2.f, 0.f));
+	result &= (drawScene(device) == 8 * cubeTriangles);
+	result &= batch->getBoundingBox().MinEdge.equals(vector3df(-0.5f, -0.5f, -0.5f));
+	result &= batch->getBoundingBox().MaxEdge.equals(vector3df(6.5f, 2.5f, 0.5f));
+
+	// the vertices are relative to the batch node
+	batch->setPosition(vector3df(0.f, 0.f, 3.f));
+	result &= (drawScene(device) == 8 * cubeTriangles);
+	result &= batch->getBoundingBox().MinEdge.equals(vector3df(-0.5f, -0.5f, -3.5f));
+
+	// removed nodes are drawn by themselves again
+	result &= batch->removeNode(nodes[7]);
+	result &= !batch->removeNode(nodes[7]);
+	result &= nodes[7]->isVisible();
+	nodes[6]->remove();
+	result &= (drawScene(device) == 7 * cubeTriangles);
+	result &= (batch->getNodeCount() == 6);
+	result &= (batch->getMesh()->getMeshBuffer(0)->getVertexCount() == 3 * cubeVertices);
+	result &= (batch->getMesh()->getMeshBuffer(1)->getVertexCount() == 3 * cubeVertices);
+
+	batch->removeAllNodes();
+	result &= (batch->getNodeCount() == 0);
+	result &= (batch->getMesh()->getMeshBufferCount() == 0);
+	result &= nodes[0]->isVisible();
+	result &= (drawScene(device) == 7 * cubeTriangles);
+
+	smgr->clear();
+
+	if (!result)
+		logTestString("Merging and culling of a static batch failed\n");
+
+	return result;
+}
+
+//! Mesh buffers with more than 65535 vertices need 32 bit indices
+bool largeBatch(IrrlichtDevice* device)
+{
+	ISceneManager* smgr = device->getSceneManager();
+	IStaticBatchSceneNode* batch = smgr->addStaticBatchSceneNode();
+
+	IMesh* cube = smgr->getGeometryCreator()->createCubeMesh(vector3df(1.f, 1.f, 1.f));
+	const u32 count = 65536 / cube->getMeshBuffer(0)->getVertexCount() + 1;
+	for (u32 i=0; i<count; ++i)
+		batch->addNode(smgr->addMeshSceneNode(cube, 0, -1, vector3df((f32)(i % 100), 0.f, (f32)(i / 100))));
+	const u32 cubeIndices = cube->getMeshBuffer(0)->getIndexCount();
+	cube->drop();
+
+	IMesh* mesh = batch->getMesh();
+	bool result = (mesh->getMeshBufferCount() == 1);
+	const IMeshBuffer* mb = mesh->getMeshBuffer(0);
+	const u32 vertexCount = mb->getVertexCount();
+	result &= (vertexCount > 65535);
+	result &= (mb->getIndexType() == video::EIT_32BIT);
+
+	// the indices of the last cube point to its own vertices
+	const u32* indices = (const u32*)mb->getIndices();
+	for (u32 i=mb->getIndexCount()-cubeIndices; i<mb->getIndexCount(); ++i)
+		result &= (indices[i] >= vertexCount - vertexCount / count && indices[i] < vertexCount);
+
+	smgr->clear();
+
+	if (!result)
+		logTestString("Static batch with %d vertices failed\n", vertexCount);
+
+	return result;
+}
+
+//! Normals stay perpendicular to the surface with a non uniform scale
+bool scaledNormals(IrrlichtDevice* device)
+{
+	ISceneManager* smgr = device->getSceneManager();
+	IStaticBatchSceneNode* batch = smgr->addStaticBatchSceneNode();
+
+	// a plane at 45 degrees, stretched along x by its parent
+	ISceneNode* parent = smgr->addEmptySceneNode();
+	parent->setScale(vector3df(2.f, 1.f, 1.f));
+	parent->updateAbsolutePosition();
+	IMesh* plane = smgr->getGeometryCreator()->createPlaneMesh(dimension2df(1.f, 1.f));
+	bool result = batch->addNode(smgr->addMeshSceneNode(plane, parent, -1,
+		vector3df(0.f, 0.f, 0.f), vector3df(0.f, 0.f, 45.f)));
+	plane->drop();
+
+	const vector3df normal = vector3df(-1.f, 2.f, 0.f).normalize();
+	const IMeshBuffer* mb = batch->getMesh()->getMeshBuffer(0);
+	for (u32 i=0; i<mb->getVertexCount(); ++i)
+		result &= mb->getNormal(i).equals(normal, 0.0001f);
+
+	smgr->clear();
+
+	if (!result)
+		logTestString("Normals of a scaled static batch are wrong\n");
+
+	return result;
+}
+
+//! Removed nodes get back their visibility, the meshes of the last build stay alive
+bool memberLifetime(IrrlichtDevice* device)
+{
+	ISceneManager* smgr = device->getSceneManager();
+	IStaticBatchSceneNode* batch = smgr->addStaticBatchSceneNode();
+
+	IMesh* cube = smgr->getGeometryCreator()->createCubeMesh(vector3df(1.f, 1.f, 1.f));
+	IMeshSceneNode* shown = smgr->addMeshSceneNode(cube);
+	IMeshSceneNode* hidden = smgr->addMeshSceneNode(cube, 0, -1, vector3df(2.f, 0.f, 0.f));
+	hidden->setVisible(false);
+	bool result = batch->addNode(shown);
+	result &= batch->addNode(hidden);
+
+	// built with the cube, which is grabbed until the next build
+	result &= (batch->getMesh()->getMeshBufferCount() == 1);
+	const s32 referenceCount = cube->getReferenceCount();
+	IMesh* sphere = smgr->getGeometryCreator()->createSphereMesh(1.f);
+	shown->setMesh(sphere);
+	hidden->setMesh(sphere);
+	sphere->drop();
+	result &= (cube->getReferenceCount() == referenceCount - 2);
+	result &= (batch->getMesh()->getMeshBufferCount() == 1);
+	result &= (cube->getReferenceCount() == 1);
+	cube->drop();
+
+	result &= batch->removeNode(hidden);
+	result &= !hidden->isVisible();
+	batch->removeAllNodes();
+	result &= shown->isVisible();
+
+	smgr->clear();
+
+	if (!result)
+		logTestString("Members of a static batch are not released correctly\n");
+
+	return result;
+}
+
+} // end anonymous namespace
+
+/** Test that the static batch scene node merges and culls the mesh buffers
+of its nodes. */
+bool staticBatch(void)
+{
+	IrrlichtDevice* device = createDevice(video::EDT_NULL, dimension2du(160, 120));
+	if (!device)
+		return false;
+
+	bool result = mergeAndCull(device);
+	result &= largeBatch(device);
+	result &= scaledNormals(device);
+	result &= memberLifetime(device);
+
+	device->closeDevice();
+	device->run();
+	device->drop();
+
+	return result;
+}
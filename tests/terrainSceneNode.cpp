@@ -117,11 +117,221 @@ bool terrainGaps()
 	return result;
 }
 
+// compare the indices of the visible patches with the indices in the render buffer
+bool compareTerrainIndices(scene::ITerrainSceneNode* terrain, u32 step)
+{
+	core::array<s32> lods;
+	const s32 patchCount = (s32)sqrtf((f32)terrain->getCurrentLODOfPatches(lods));
+
+	core::array<u32> expected;
+	core::array<u32> patchIndices;
+	for (s32 x=0; x<patchCount; ++x)
+	{
+		for (s32 z=0; z<patchCount; ++z)
+		{
+			const s32 count = terrain->getIndicesForPatch(patchIndices, x, z, -1);
+			for (s32 i=0; i<count; ++i)
+				expected.push_back(patchIndices[i]);
+		}
+	}
+
+	scene::IMeshBuffer* buffer = terrain->getRenderBuffer();
+	if (expected.size() != terrain->getIndexCount())
+	{
+		logTestString("Step %u: %u terrain indices instead of %u\n", step, terrain->getIndexCount(), expected.size());
+		return false;
+	}
+
+	for (u32 i=0; i<expected.size(); ++i)
+	{
+		const u32 index = buffer->getIndexType() == video::EIT_16BIT ?
+			buffer->getIndices()[i] : ((const u32*)buffer->getIndices())[i];
+		if (index != expected[i])
+		{
+			logTestString("Step %u: terrain index %u is %u instead of %u\n", step, i, index, expected[i]);
+			return false;
+		}
+	}
+
+	return true;
+}
+
+// the indices are only copied for patches which changed, check them while the camera moves
+bool terrainIndices()
+{
+	IrrlichtDevice* device = createDevice(video::EDT_NULL, dimension2d<u32>(160, 120));
+	if (!device)
+		return false;
+
+	scene::ISceneManager* smgr = device->getSceneManager();
+	scene::ITerrainSceneNode* terrain = smgr->addTerrainSceneNode("../media/terrain-heightmap.bmp",
+		0, -1, vector3df(0.f, 0.f, 0.f), vector3df(0.f, 0.f, 0.f), vector3df(40.f, 4.4f, 40.f));
+	scene::ICameraSceneNode* camera = smgr->addCameraSceneNode();
+	camera->setFarValue(20000.f);
+
+	bool result = terrain != 0;
+	for (u32 step=0; step<40 && result; ++step)
+	{
+		const f32 angle = step * 0.3f;
+		camera->setPosition(vector3df(5000.f + cosf(angle) * (500.f + step * 80.f), 300.f, 5000.f + sinf(angle) * 3000.f));
+		camera->setTarget(vector3df(5000.f + step * 100.f, 0.f, 5000.f));
+
+		device->getVideoDriver()->beginScene();
+		smgr->drawAll();
+		device->getVideoDriver()->endScene();
+
+		result &= compareTerrainIndices(terrain, step);
+	}
+
+	device->closeDevice();
+	device->run();
+	device->drop();
+	return result;
+}
+
+// height of the generated heightmap of pagedTerrain at a world position
+f32 pagedHeight(f32 x, f32 z)
+{
+	return ((x - 100.f) / 10.f * 16.f + (z + 200.f) / 10.f * 32.f) / 256.f + 5.f;
+}
+
+bool checkPagedHeight(IrrlichtDevice* device, scene::IPagedTerrainSceneNode* terrain, f32 x, f32 z)
+{
+	const f32 expected = pagedHeight(x, z);
+	const f32 height = terrain->getHeight(x, z);
+	if (!core::equals(height, expected, 0.01f))
+	{
+		logTestString("Paged terrain height at %f %f is %f instead of %f\n", x, z, height, expected);
+		return false;
+	}
+
+	// the triangle selector contains the resident tiles
+	core::vector3df point;
+	core::triangle3df triangle;
+	scene::ISceneNode* node = 0;
+	if (!device->getSceneManager()->getSceneCollisionManager()->getCollisionPoint(
+		core::line3df(x, 1000.f, z, x, -1000.f, z), terrain->getTriangleSelector(), point, triangle, node) ||
+		!core::equals(point.Y, expected, 0.01f))
+	{
+		logTestString("No collision with the paged terrain at %f %f\n", x, z);
+		return false;
+	}
+
+	return true;
+}
+
+// fly over a terrain which is loaded in tiles, within the tile budget
+bool pagedTerrain()
+{
+	SIrrlichtCreationParameters params;
+	params.DriverType = video::EDT_NULL;
+	params.WorkerThreads = 2;
+	IrrlichtDevice* device = createDeviceEx(params);
+	if (!device)
+		return false;
+
+	// 16 bit heightmap with a header, the height grows linearly in both directions
+	const u32 size = 1025;
+	const u32 header = 4;
+	u16* data = new u16[header/2 + size*size];
+	for (u32 x=0; x<size; ++x)
+		for (u32 z=0; z<size; ++z)
+			data[header/2 + x*size + z] = (u16)(x*16 + z*32);
+
+	io::IReadFile* file = device->getFileSystem()->createMemoryReadFile(data, (header/2 + size*size)*2, "paged.raw", true);
+	file->seek(header);
+
+	scene::ISceneManager* smgr = device->getSceneManager();
+	scene::IPagedTerrainSceneNode* terrain = smgr->addPagedTerrainSceneNode(file, core::dimension2du(size, size),
+		0, -1, vector3df(100.f, 5.f, -200.f), vector3df(10.f, 1.f, 10.f), video::SColor(255, 255, 255, 255),
+		5, scene::ETPS_17, 64, 12, 16, false, 0);
+	file->drop();
+
+	bool result = terrain && terrain->getTileCount() == core::dimension2du(16, 16);
+	if (!result)
+	{
+		logTestString("Paged terrain not created\n");
+		device->drop();
+		return false;
+	}
+
+	terrain->setLoadDistance(700.f);
+	scene::ICameraSceneNode* camera = smgr->addCameraSceneNode();
+
+	for (u32 step=0; step<60 && result; ++step)
+	{
+		const f32 x = 300.f + step * 160.f;
+		const f32 z = -100.f + step * 150.f;
+		camera->setPosition(vector3df(x, 200.f, z));
+		camera->setTarget(vector3df(x + 100.f, 0.f, z + 100.f));
+
+		device->getVideoDriver()->beginScene();
+		smgr->drawAll();
+		device->getVideoDriver()->endScene();
+
+		if (terrain->getResidentTileCount() > terrain->getMaxResidentTiles())
+		{
+			logTestString("Step %u: %u resident tiles\n", step, terrain->getResidentTileCount());
+			result = false;
+		}
+
+		if (step % 10 == 0)
+		{
+			terrain->waitForTiles();
+			result &= checkPagedHeight(device, terrain, x, z);
+			result &= checkPagedHeight(device, terrain, x + 333.f, z + 211.f);
+		}
+	}
+
+	// the tiles at the start were removed
+	if (terrain->getTile(0, 0) || terrain->getHeight(150.f, -150.f) != -FLT_MAX)
+	{
+		logTestString("First tile of the paged terrain is still resident\n");
+		result = false;
+	}
+
+	terrain->setMaxResidentTiles(4);
+	smgr->drawAll();
+	if (terrain->getResidentTileCount() > 4)
+	{
+		logTestString("%u resident tiles after lowering the budget\n", terrain->getResidentTileCount());
+		result = false;
+	}
+
+	// the tiles have to cover the whole heightmap
+	data = new u16[size*size];
+	memset(data, 0, size*size*2);
+	file = device->getFileSystem()->createMemoryReadFile(data, size*size*2, "paged.raw", true);
+	terrain = smgr->addPagedTerrainSceneNode(file, core::dimension2du(size, size),
+		0, -1, vector3df(0.f), vector3df(1.f), video::SColor(255, 255, 255, 255),
+		5, scene::ETPS_17, 200);
+	if (!terrain || terrain->getTileCount() != core::dimension2du(8, 8))
+	{
+		logTestString("Tiles don't cover the paged terrain\n");
+		result = false;
+	}
+
+	// sizes which are no multiple of the patches are rejected
+	if (smgr->addPagedTerrainSceneNode(file, core::dimension2du(1000, 1000)))
+	{
+		logTestString("Paged terrain with partial patches created\n");
+		result = false;
+	}
+	file->drop();
+
+	device->closeDevice();
+	device->run();
+	device->drop();
+	return result;
+}
+
 }
 
 bool terrainSceneNode()
 {
-	bool result = terrainRecalc();
+	bool result = terrainIndices();
+	result &= pagedTerrain();
+	result &= terrainRecalc();
 	result &= terrainGaps();
 	return result;
 }
@@ -0,0 +1,126 @@
+// Copyright (C) 2002-2012 Nikolaus Gebhardt
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+/*
+Micro benchmark for finding files in many mounted archives. Mounts the same
+archive several times and reports the time for looking up a file which is in
+the last archive only and a file which is in none of them. Archives mounted by
+the file system are found in its path index, archives created by an archive
+loader and mounted afterwards are searched one by one.
+
+Usage: ArchiveLookup [archive] [archive count] [lookups]
+*/
+
+#include <irrlicht.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+using namespace irr;
+
+// Times the lookups of a file in the last archive and of a missing file
+static void lookupFiles(IrrlichtDevice* device, u32 lookups, u32& foundTime, u32& missingTime)
+{
+	io::IFileSystem* fs = device->getFileSystem();
+	ITimer* timer = device->getTimer();
+
+	u32 found = 0;
+	foundTime = timer->getRealTime();
+	for (u32 i=0; i<lookups; ++i)
+		found += fs->existFile("mypath/overlay.txt") ? 1 : 0;
+	foundTime = timer->getRealTime() - foundTime;
+
+	missingTime = timer->getRealTime();
+	for (u32 i=0; i<lookups; ++i)
+		found += fs->existFile("Missing/File.txt") ? 1 : 0;
+	missingTime = timer->getRealTime() - missingTime;
+
+	if (found != lookups)
+		printf("Unexpected number of files found: %u\n", found);
+}
+
+// Mounts the archive count times, plus an archive with a file only it contains
+static bool mountArchives(IrrlichtDevice* device, const c8* data, long size, u32 count, bool external)
+{
+	io::IFileSystem* fs = device->getFileSystem();
+	io::IArchiveLoader* loader = 0;
+	for (u32 i=0; i<fs->getArchiveLoaderCount() && !loader; ++i)
+		if (fs->getArchiveLoader(i)->isALoadableFileFormat(io::EFAT_ZIP))
+			loader = fs->getArchiveLoader(i);
+
+	for (u32 i=0; i<=count; ++i)
+	{
+		io::IReadFile* file;
+		if (i < count)
+			file = fs->createMemoryReadFile(data, size, io::path("archive") + io::path(i) + ".zip");
+		else
+			file = fs->createAndOpenFile("../../tests/media/overlay.zip");
+		if (!file)
+			return false;
+
+		bool ret;
+		if (external)
+		{
+			io::IFileArchive* archive = loader ? loader->createArchive(file, true, false) : 0;
+			ret = fs->addFileArchive(archive);
+			if (archive)
+				archive->drop();
+		}
+		else
+			ret = fs->addFileArchive(file, true, false);
+		file->drop();
+		if (!ret)
+			return false;
+	}
+	return true;
+}
+
+int main(int argc, char* argv[])
+{
+	const char* archiveName = argc > 1 ? argv[1] : "../../tests/media/file_with_path.zip";
+	const u32 count = argc > 2 ? (u32)atoi(argv[2]) : 40;
+	const u32 lookups = argc > 3 ? (u32)atoi(argv[3]) : 100000;
+
+	IrrlichtDevice* device = createDevice(video::EDT_NULL);
+	if (!device)
+		return 1;
+	io::IFileSystem* fs = device->getFileSystem();
+
+	io::IReadFile* file = fs->createAndOpenFile(archiveName);
+	if (!file)
+	{
+		printf("Could not open %s\n", archiveName);
+		device->drop();
+		return 1;
+	}
+	const long size = file->getSize();
+	c8* data = new c8[size];
+	file->read(data, size);
+	file->drop();
+
+	u32 indexedFound = 0, indexedMissing = 0, externalFound = 0, externalMissing = 0;
+	bool ret = mountArchives(device, data, size, count, false);
+	if (ret)
+		lookupFiles(device, lookups, indexedFound, indexedMissing);
+	while (fs->getFileArchiveCount())
+		fs->removeFileArchive(fs->getFileArchiveCount()-1);
+	ret = ret && mountArchives(device, data, size, count, true);
+	if (ret)
+		lookupFiles(device, lookups, externalFound, externalMissing);
+
+	if (ret)
+	{
+		printf("%u archives, %u lookups\n", count+1, lookups);
+		printf("indexed archives: file in last archive %.3f us, missing file %.3f us\n",
+			indexedFound * 1000.f / lookups, indexedMissing * 1000.f / lookups);
+		printf("archives searched in order: file in last archive %.3f us, missing file %.3f us\n",
+			externalFound * 1000.f / lookups, externalMissing * 1000.f / lookups);
+	}
+	else
+		printf("Could not mount the archives\n");
+
+	// the archives still use the data
+	device->drop();
+	delete [] data;
+	return ret ? 0 : 1;
+}
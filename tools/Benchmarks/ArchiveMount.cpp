@@ -0,0 +1,94 @@
+// Copyright (C) 2002-2012 Nikolaus Gebhardt
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+/*
+Micro benchmark for adding archives to the file system. Reports the time to
+add the archives one after another, with addFileArchiveAsync on the worker
+threads, and with the file lists of zip archives read from the cache
+directory. The cache files are written to the cache directory.
+
+Usage: ArchiveMount [worker threads] [repeats] [cache directory] [archives...]
+*/
+
+#include <irrlicht.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+using namespace irr;
+
+enum EMountMode
+{
+	EMM_SERIAL = 0,
+	EMM_ASYNC,
+	EMM_CACHED
+};
+
+// Times adding and removing all archives
+static u32 mountArchives(IrrlichtDevice* device, const core::array<io::path>& archives,
+	u32 repeats, EMountMode mode)
+{
+	io::IFileSystem* fs = device->getFileSystem();
+	ITimer* timer = device->getTimer();
+
+	u32 time = timer->getRealTime();
+	for (u32 r=0; r<repeats; ++r)
+	{
+		for (u32 i=0; i<archives.size(); ++i)
+		{
+			if (mode == EMM_ASYNC)
+				fs->addFileArchiveAsync(archives[i]);
+			else
+				fs->addFileArchive(archives[i]);
+		}
+
+		// waits for the archives read on the worker threads
+		if (fs->getFileArchiveCount() != archives.size())
+			printf("Not all archives added\n");
+
+		while (fs->getFileArchiveCount())
+			fs->removeFileArchive(fs->getFileArchiveCount()-1);
+	}
+	return timer->getRealTime() - time;
+}
+
+int main(int argc, char* argv[])
+{
+	SIrrlichtCreationParameters params;
+	params.DriverType = video::EDT_NULL;
+	params.WorkerThreads = argc > 1 ? (u32)atoi(argv[1]) : 4;
+	const u32 repeats = argc > 2 ? (u32)atoi(argv[2]) : 100;
+	const char* cacheDirectory = argc > 3 ? argv[3] : ".";
+
+	core::array<io::path> archives;
+	for (int i=4; i<argc; ++i)
+		archives.push_back(argv[i]);
+	if (archives.empty())
+	{
+		archives.push_back("../../tests/media/file_with_path.zip");
+		archives.push_back("../../tests/media/Monty.zip");
+		archives.push_back("../../tests/media/lzmadata.zip");
+		archives.push_back("../../tests/media/streaming.zip");
+		archives.push_back("../../tests/media/sample_pakfile.pak");
+	}
+
+	IrrlichtDevice* device = createDeviceEx(params);
+	if (!device)
+		return 1;
+
+	const u32 serialTime = mountArchives(device, archives, repeats, EMM_SERIAL);
+	const u32 asyncTime = mountArchives(device, archives, repeats, EMM_ASYNC);
+
+	// the first time fills the cache
+	device->getFileSystem()->setArchiveCacheDirectory(cacheDirectory);
+	mountArchives(device, archives, 1, EMM_CACHED);
+	const u32 cachedTime = mountArchives(device, archives, repeats, EMM_CACHED);
+
+	printf("%u archives, %u worker threads, %u repeats\n", archives.size(), params.WorkerThreads, repeats);
+	printf("one after another: %.3f ms\n", (f32)serialTime / repeats);
+	printf("on worker threads: %.3f ms\n", (f32)asyncTime / repeats);
+	printf("file lists from the cache: %.3f ms\n", (f32)cachedTime / repeats);
+
+	device->drop();
+	return 0;
+}
@@ -0,0 +1,124 @@
+// Copyright (C) 2002-2012 Nikolaus Gebhardt
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+/*
+Micro benchmark for line of sight rays and moving ellipsoids on a hilly
+terrain. Reports the time of testing the rays one by one with
+ISceneCollisionManager::getCollisionPoint and as one batch with
+getCollisionPoints, then the time of moving the ellipsoids one by one with
+getCollisionResultPosition and as one batch with getCollisionResultPositions.
+The rays and ellipsoids are spread over an area of the terrain, like the
+agents of one region of a server.
+
+Usage: CollisionRays [ray count] [iterations] [worker threads] [area size]
+*/
+
+#include <irrlicht.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+using namespace irr;
+
+static f32 randomValue(f32 range)
+{
+	return (rand() / (f32)RAND_MAX - 0.5f) * range;
+}
+
+int main(int argc, char* argv[])
+{
+	const u32 count = argc > 1 ? (u32)atoi(argv[1]) : 4096;
+	const u32 iterations = argc > 2 ? (u32)atoi(argv[2]) : 10;
+	const u32 workerThreads = argc > 3 ? (u32)atoi(argv[3]) : 0;
+	const f32 area = argc > 4 ? (f32)atof(argv[4]) : 128.f;
+
+	SIrrlichtCreationParameters params;
+	params.DriverType = video::EDT_NULL;
+	params.WorkerThreads = workerThreads;
+	IrrlichtDevice* device = createDeviceEx(params);
+	if (!device)
+		return 1;
+
+	scene::ISceneManager* smgr = device->getSceneManager();
+	scene::ISceneCollisionManager* collMgr = smgr->getSceneCollisionManager();
+	ITimer* timer = device->getTimer();
+
+	scene::IMesh* mesh = smgr->getGeometryCreator()->createHillPlaneMesh(
+		core::dimension2df(8.f, 8.f), core::dimension2du(64, 64), 0, 10.f,
+		core::dimension2df(4.f, 4.f), core::dimension2df(1.f, 1.f));
+	scene::IMeshSceneNode* node = smgr->addMeshSceneNode(mesh);
+	scene::ITriangleSelector* selector = smgr->createOctreeTriangleSelector(mesh, node, 128);
+	mesh->drop();
+	node->updateAbsolutePosition();
+
+	core::array<core::line3df> rays;
+	core::array<scene::SEllipsoidSweep> sweeps;
+	srand(1);
+	for (u32 i=0; i<count; ++i)
+	{
+		const core::vector3df start(randomValue(area), 6.f + randomValue(6.f), randomValue(area));
+		const core::vector3df end(start.X + randomValue(64.f), 6.f + randomValue(6.f), start.Z + randomValue(64.f));
+		rays.push_back(core::line3df(start, end));
+
+		scene::SEllipsoidSweep sweep;
+		sweep.Position = start + core::vector3df(0.f, 5.f, 0.f);
+		sweep.Radius.set(1.f, 2.f, 1.f);
+		sweep.DirectionAndSpeed.set(randomValue(2.f), 0.f, randomValue(2.f));
+		sweeps.push_back(sweep);
+	}
+
+	core::array<scene::SCollisionHit> hits;
+	hits.set_used(count);
+	core::array<bool> hitFlags;
+	hitFlags.set_used(count);
+	const core::vector3df gravity(0.f, -1.f, 0.f);
+
+	// rays one by one
+	u32 singleHits = 0;
+	u32 singleTime = timer->getRealTime();
+	for (u32 it=0; it<iterations; ++it)
+	{
+		for (u32 i=0; i<count; ++i)
+			singleHits += collMgr->getCollisionPoint(hits[i], rays[i], selector) ? 1 : 0;
+	}
+	singleTime = timer->getRealTime() - singleTime;
+
+	// rays as batch
+	u32 batchHits = 0;
+	u32 batchTime = timer->getRealTime();
+	for (u32 it=0; it<iterations; ++it)
+		batchHits += collMgr->getCollisionPoints(hits.pointer(), hitFlags.pointer(), rays.const_pointer(), count, selector);
+	batchTime = timer->getRealTime() - batchTime;
+
+	// ellipsoids one by one
+	u32 singleSweepTime = timer->getRealTime();
+	for (u32 it=0; it<iterations; ++it)
+	{
+		for (u32 i=0; i<count; ++i)
+		{
+			scene::SEllipsoidSweep& sweep = sweeps[i];
+			scene::ISceneNode* hitNode = 0;
+			sweep.ResultPosition = collMgr->getCollisionResultPosition(selector,
+				sweep.Position, sweep.Radius, sweep.DirectionAndSpeed,
+				sweep.Triangle, sweep.HitPosition, sweep.Falling, hitNode, 0.0005f, gravity);
+		}
+	}
+	singleSweepTime = timer->getRealTime() - singleSweepTime;
+
+	// ellipsoids as batch
+	u32 batchSweepTime = timer->getRealTime();
+	for (u32 it=0; it<iterations; ++it)
+		collMgr->getCollisionResultPositions(selector, sweeps.pointer(), count, 0.0005f, gravity);
+	batchSweepTime = timer->getRealTime() - batchSweepTime;
+
+	printf("%u rays and ellipsoids in an area of %.0f, %u iterations, %u worker threads, %d triangles\n",
+		count, area, iterations, workerThreads, selector->getTriangleCount());
+	printf("rays one by one: %.3f ms per iteration, %u hits\n", singleTime / (f32)iterations, singleHits / iterations);
+	printf("rays as batch: %.3f ms per iteration, %u hits\n", batchTime / (f32)iterations, batchHits / iterations);
+	printf("ellipsoids one by one: %.3f ms per iteration\n", singleSweepTime / (f32)iterations);
+	printf("ellipsoids as batch: %.3f ms per iteration\n", batchSweepTime / (f32)iterations);
+
+	selector->drop();
+	device->drop();
+	return 0;
+}
@@ -0,0 +1,79 @@
+// Copyright (C) 2002-2012 Nikolaus Gebhardt
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+/*
+Micro benchmark for the color conversions of IVideoDriver::convertColor.
+Reports the MPixels/s for each pair of source and destination format.
+
+Usage: ColorConverter [worker threads]
+*/
+
+#include <irrlicht.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+using namespace irr;
+
+static const video::ECOLOR_FORMAT Formats[] =
+{
+	video::ECF_A1R5G5B5, video::ECF_R5G6B5, video::ECF_R8G8B8, video::ECF_A8R8G8B8
+};
+
+static const char* const FormatNames[] =
+{
+	"A1R5G5B5", "R5G6B5", "R8G8B8", "A8R8G8B8"
+};
+
+int main(int argc, char* argv[])
+{
+	SIrrlichtCreationParameters params;
+	params.DriverType = video::EDT_NULL;
+	params.WorkerThreads = argc > 1 ? (u32)atoi(argv[1]) : 0;
+
+	IrrlichtDevice* device = createDeviceEx(params);
+	if (!device)
+		return 1;
+
+	video::IVideoDriver* driver = device->getVideoDriver();
+	ITimer* timer = device->getTimer();
+
+	// one 1024x1024 image, converted as a whole
+	const s32 pixels = 1024*1024;
+	u8* source = new u8[pixels*4];
+	u8* dest = new u8[pixels*4];
+	for (s32 i=0; i<pixels*4; ++i)
+		source[i] = (u8)rand();
+
+	printf("%u worker threads, %d pixels per conversion\n", params.WorkerThreads, pixels);
+	printf("%-10s %-10s %10s\n", "source", "dest", "MPixels/s");
+
+	const u32 count = sizeof(Formats) / sizeof(Formats[0]);
+	for (u32 s=0; s<count; ++s)
+	{
+		for (u32 d=0; d<count; ++d)
+		{
+			// run for at least 200ms
+			u32 runs = 0;
+			const u32 start = timer->getRealTime();
+			u32 elapsed = 0;
+			do
+			{
+				driver->convertColor(source, Formats[s], pixels, dest, Formats[d]);
+				++runs;
+				elapsed = timer->getRealTime() - start;
+			} while (elapsed < 200);
+
+			const f64 mpixels = (f64)pixels * runs / (elapsed * 1000.0);
+			printf("%-10s %-10s %10.1f\n", FormatNames[s], FormatNames[d], mpixels);
+		}
+	}
+
+	delete [] source;
+	delete [] dest;
+	device->drop();
+
+	return 0;
+}
+
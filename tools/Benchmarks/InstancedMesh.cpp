@@ -0,0 +1,81 @@
+// Copyright (C) 2002-2012 Nikolaus Gebhardt
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+/*
+Micro benchmark for IInstancedMeshSceneNode.
+Builds a grid of cubes and reports the time per frame of drawAll with one
+mesh scene node per cube and with all cubes added as instances of one
+instanced mesh scene node.
+
+Usage: InstancedMesh [instance count] [frames] [driver: n=null, b=burnings video, o=OpenGL]
+*/
+
+#include <irrlicht.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+using namespace irr;
+
+// Times frames of a scene with count cubes
+static u32 renderScene(u32 count, u32 frames, video::E_DRIVER_TYPE driverType, bool instanced)
+{
+	IrrlichtDevice* device = createDevice(driverType, core::dimension2du(640, 480));
+	if (!device)
+		return 0;
+
+	video::IVideoDriver* driver = device->getVideoDriver();
+	scene::ISceneManager* smgr = device->getSceneManager();
+	ITimer* timer = device->getTimer();
+	smgr->addCameraSceneNode(0, core::vector3df(0, 200, -200), core::vector3df(0, 0, 0));
+
+	scene::IMesh* cube = smgr->getGeometryCreator()->createCubeMesh(core::vector3df(4.f, 4.f, 4.f));
+	scene::IInstancedMeshSceneNode* node = instanced ? smgr->addInstancedMeshSceneNode(cube) : 0;
+	if (node)
+		node->setMaterialFlag(video::EMF_LIGHTING, false);
+	const u32 side = core::max_((u32)core::squareroot((f32)count), (u32)1);
+	for (u32 i=0; i<count; ++i)
+	{
+		const core::vector3df position((f32)(i % side) * 6.f - side * 3.f, 0.f, (f32)(i / side) * 6.f - side * 3.f);
+		if (node)
+		{
+			core::matrix4 m;
+			m.setTranslation(position);
+			node->addInstance(m);
+		}
+		else
+			smgr->addMeshSceneNode(cube, 0, -1, position)->setMaterialFlag(video::EMF_LIGHTING, false);
+	}
+	cube->drop();
+
+	const u32 start = timer->getRealTime();
+	for (u32 f=0; f<frames && device->run(); ++f)
+	{
+		driver->beginScene(video::ECBF_COLOR | video::ECBF_DEPTH, video::SColor(255,0,0,0));
+		smgr->drawAll();
+		driver->endScene();
+	}
+	const u32 elapsed = timer->getRealTime() - start;
+
+	device->drop();
+	return elapsed;
+}
+
+int main(int argc, char* argv[])
+{
+	const u32 count = argc > 1 ? (u32)atoi(argv[1]) : 5000;
+	const u32 frames = argc > 2 ? (u32)atoi(argv[2]) : 100;
+	video::E_DRIVER_TYPE driverType = video::EDT_BURNINGSVIDEO;
+	if (argc > 3 && argv[3][0] == 'n')
+		driverType = video::EDT_NULL;
+	else if (argc > 3 && argv[3][0] == 'o')
+		driverType = video::EDT_OPENGL;
+
+	printf("%u cubes, %u frames\n", count, frames);
+	const f32 nodes = (f32)renderScene(count, frames, driverType, false) / frames;
+	const f32 instanced = (f32)renderScene(count, frames, driverType, true) / frames;
+	printf("mesh scene nodes: %.2f ms per frame, instanced mesh scene node: %.2f ms per frame\n",
+		nodes, instanced);
+
+	return 0;
+}
@@ -0,0 +1,173 @@
+// Copyright (C) 2002-2012 Nikolaus Gebhardt
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+/*
+Micro benchmark for the particle affectors and the particle system scene node.
+Runs the gravity, fade out, attraction, scale and rotation affectors on an array
+of SParticle (IParticleAffector::affect) and on SParticleStreams
+(IParticleAffector::affectStreams) and reports the time of each. Then reports
+the time per frame of a particle system scene node with all affectors, which
+emits and removes particles while updating them. At last reports the time
+per frame of several particle system nodes which are animated, registered
+and rendered like in ISceneManager::drawAll, without and with worker threads.
+
+Usage: ParticleSystem [particle count] [frames] [worker threads]
+*/
+
+#include <irrlicht.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+using namespace irr;
+
+// Times frames of nodes which each have count/nodeCount particles.
+static u32 drawParticleNodes(u32 count, u32 frames, u32 workerThreads)
+{
+	SIrrlichtCreationParameters params;
+	params.DriverType = video::EDT_NULL;
+	params.WorkerThreads = workerThreads;
+	IrrlichtDevice* device = createDeviceEx(params);
+	if (!device)
+		return 0;
+
+	scene::ISceneManager* smgr = device->getSceneManager();
+	video::IVideoDriver* driver = device->getVideoDriver();
+	ITimer* timer = device->getTimer();
+	smgr->addCameraSceneNode(0, core::vector3df(0, 100, -300), core::vector3df(0, 50, 0));
+
+	const u32 nodeCount = 8;
+	core::array<scene::IParticleSystemSceneNode*> nodes;
+	for (u32 n=0; n<nodeCount; ++n)
+	{
+		scene::IParticleSystemSceneNode* ps = smgr->addParticleSystemSceneNode(false, 0, -1,
+			core::vector3df((f32)n * 20.f - 80.f, 0.f, 0.f));
+		scene::IParticleEmitter* em = ps->createBoxEmitter(core::aabbox3df(-10, 0, -10, 10, 10, 10),
+			core::vector3df(0.f, 0.03f, 0.f), count / nodeCount / 3, count / nodeCount / 3,
+			video::SColor(255, 255, 255, 255), video::SColor(255, 255, 255, 255), 2000, 4000);
+		ps->setEmitter(em);
+		em->drop();
+
+		scene::IParticleAffector* paf = ps->createGravityAffector();
+		ps->addAffector(paf);
+		paf->drop();
+		paf = ps->createFadeOutParticleAffector();
+		ps->addAffector(paf);
+		paf->drop();
+		nodes.push_back(ps);
+	}
+
+	u32 time = 1;
+	u32 elapsed = 0;
+	for (u32 f=0; f<300+frames; ++f, time+=16)
+	{
+		// the first frames fill the particle systems
+		const u32 start = timer->getRealTime();
+		smgr->getRootSceneNode()->OnAnimate(time);
+		for (u32 n=0; n<nodeCount; ++n)
+			nodes[n]->OnRegisterSceneNode();
+		driver->beginScene();
+		for (u32 n=0; n<nodeCount; ++n)
+			nodes[n]->render();
+		driver->endScene();
+		if (f >= 300)
+			elapsed += timer->getRealTime() - start;
+	}
+
+	device->drop();
+	return elapsed;
+}
+
+int main(int argc, char* argv[])
+{
+	const u32 count = argc > 1 ? (u32)atoi(argv[1]) : 100000;
+	const u32 frames = argc > 2 ? (u32)atoi(argv[2]) : 100;
+	const u32 workerThreads = argc > 3 ? (u32)atoi(argv[3]) : 3;
+
+	IrrlichtDevice* device = createDevice(video::EDT_NULL);
+	if (!device)
+		return 1;
+
+	scene::ISceneManager* smgr = device->getSceneManager();
+	ITimer* timer = device->getTimer();
+	scene::IParticleSystemSceneNode* ps = smgr->addParticleSystemSceneNode(false);
+
+	scene::IParticleAffector* affectors[] =
+	{
+		ps->createGravityAffector(),
+		ps->createFadeOutParticleAffector(),
+		ps->createAttractionAffector(core::vector3df(0.f, 50.f, 0.f), 10.f),
+		ps->createScaleParticleAffector(core::dimension2df(2.f, 2.f)),
+		ps->createRotationAffector()
+	};
+	const char* const names[] = { "Gravity", "FadeOut", "Attraction", "Scale", "Rotation" };
+	const u32 affectorCount = sizeof(affectors) / sizeof(affectors[0]);
+
+	core::array<scene::SParticle> particles;
+	scene::SParticleStreams streams;
+	const u32 now = 100000;
+	for (u32 i=0; i<count; ++i)
+	{
+		scene::SParticle p;
+		p.pos.set((f32)(rand() % 200) - 100.f, (f32)(rand() % 200), (f32)(rand() % 200) - 100.f);
+		p.vector.set(0.f, 0.03f, 0.f);
+		p.startVector = p.vector;
+		p.startTime = now - rand() % 2000;
+		p.endTime = p.startTime + 2000 + rand() % 2000;
+		p.startColor.set(255, 255, 128, 0);
+		p.color = p.startColor;
+		p.startSize.set(5.f, 5.f);
+		p.size = p.startSize;
+		particles.push_back(p);
+		streams.push_back(p);
+	}
+
+	printf("%u particles, %u frames\n", count, frames);
+
+	for (u32 a=0; a<affectorCount; ++a)
+	{
+		u32 start = timer->getRealTime();
+		for (u32 f=0; f<frames; ++f)
+			affectors[a]->affect(now + f*16, particles.pointer(), particles.size());
+		const u32 elapsedArray = timer->getRealTime() - start;
+
+		start = timer->getRealTime();
+		for (u32 f=0; f<frames; ++f)
+			affectors[a]->affectStreams(now + f*16, streams);
+		const u32 elapsedStreams = timer->getRealTime() - start;
+
+		printf("%-10s affect: %5u ms  affectStreams: %5u ms\n", names[a], elapsedArray, elapsedStreams);
+	}
+
+	// a node which emits about as many particles as die each frame
+	scene::IParticleEmitter* em = ps->createBoxEmitter(core::aabbox3df(-100, 0, -100, 100, 10, 100),
+		core::vector3df(0.f, 0.03f, 0.f), count / 3, count / 3,
+		video::SColor(255, 255, 255, 255), video::SColor(255, 255, 255, 255), 2000, 4000);
+	ps->setEmitter(em);
+	em->drop();
+	for (u32 a=0; a<affectorCount; ++a)
+		ps->addAffector(affectors[a]);
+
+	u32 time = 1;
+	for (; time<5000; time+=16)
+		ps->doParticleSystem(time);
+
+	const u32 start = timer->getRealTime();
+	for (u32 f=0; f<frames; ++f, time+=16)
+		ps->doParticleSystem(time);
+	const u32 elapsed = timer->getRealTime() - start;
+
+	printf("doParticleSystem: %.2f ms per frame\n", (f32)elapsed / frames);
+
+	for (u32 a=0; a<affectorCount; ++a)
+		affectors[a]->drop();
+
+	device->drop();
+
+	printf("8 nodes: %.2f ms per frame, with %u worker threads: %.2f ms per frame\n",
+		(f32)drawParticleNodes(count, frames, 0) / frames, workerThreads,
+		(f32)drawParticleNodes(count, frames, workerThreads) / frames);
+
+	return 0;
+}
+
@@ -0,0 +1,99 @@
+// Copyright (C) 2002-2012 Nikolaus Gebhardt
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+/*
+Micro benchmark for ISceneManager::setRenderQueue.
+Builds a grid of mesh scene nodes, each with several mesh buffers using
+different textures, and reports the time per frame of drawAll with the
+solid scene nodes rendered one by one and with the render queue.
+With _IRR_COMPILE_WITH_PROFILING_ the material and texture changes of the
+render queue are counted in the "Irrlicht render queue" profiler group.
+
+Usage: RenderQueue [node count] [frames] [driver: n=null, b=burnings video, o=OpenGL]
+*/
+
+#include <irrlicht.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+using namespace irr;
+
+// Times frames of a scene with count nodes using 8 textures
+static u32 renderScene(u32 count, u32 frames, video::E_DRIVER_TYPE driverType, bool renderQueue)
+{
+	IrrlichtDevice* device = createDevice(driverType, core::dimension2du(640, 480));
+	if (!device)
+		return 0;
+
+	video::IVideoDriver* driver = device->getVideoDriver();
+	scene::ISceneManager* smgr = device->getSceneManager();
+	ITimer* timer = device->getTimer();
+	smgr->addCameraSceneNode(0, core::vector3df(0, 200, -200), core::vector3df(0, 0, 0));
+	smgr->setRenderQueue(renderQueue);
+
+	const u32 textureCount = 8;
+	video::ITexture* textures[textureCount];
+	for (u32 t=0; t<textureCount; ++t)
+	{
+		video::IImage* image = driver->createImage(video::ECF_A8R8G8B8, core::dimension2du(16, 16));
+		image->fill(video::SColor(255, t*32, 255-t*32, 128));
+		core::stringc name("texture");
+		name += t;
+		textures[t] = driver->addTexture(name, image);
+		image->drop();
+	}
+
+	// the same cube mesh with 3 textures per node, in different combinations
+	scene::IMesh* cube = smgr->getGeometryCreator()->createCubeMesh(core::vector3df(4.f, 4.f, 4.f));
+	const u32 side = core::max_((u32)core::squareroot((f32)count), (u32)1);
+	for (u32 i=0; i<count; ++i)
+	{
+		scene::SMesh* mesh = new scene::SMesh();
+		for (u32 b=0; b<3; ++b)
+		{
+			mesh->addMeshBuffer(cube->getMeshBuffer(0));
+		}
+		mesh->recalculateBoundingBox();
+
+		const core::vector3df position((f32)(i % side) * 6.f - side * 3.f, 0.f, (f32)(i / side) * 6.f - side * 3.f);
+		scene::IMeshSceneNode* node = smgr->addMeshSceneNode(mesh, 0, -1, position);
+		for (u32 b=0; b<3; ++b)
+		{
+			node->getMaterial(b).setTexture(0, textures[(i + b * 3) % textureCount]);
+			node->getMaterial(b).Lighting = false;
+		}
+		mesh->drop();
+	}
+	cube->drop();
+
+	const u32 start = timer->getRealTime();
+	for (u32 f=0; f<frames && device->run(); ++f)
+	{
+		driver->beginScene(video::ECBF_COLOR | video::ECBF_DEPTH, video::SColor(255,0,0,0));
+		smgr->drawAll();
+		driver->endScene();
+	}
+	const u32 elapsed = timer->getRealTime() - start;
+
+	device->drop();
+	return elapsed;
+}
+
+int main(int argc, char* argv[])
+{
+	const u32 count = argc > 1 ? (u32)atoi(argv[1]) : 2000;
+	const u32 frames = argc > 2 ? (u32)atoi(argv[2]) : 100;
+	video::E_DRIVER_TYPE driverType = video::EDT_BURNINGSVIDEO;
+	if (argc > 3 && argv[3][0] == 'n')
+		driverType = video::EDT_NULL;
+	else if (argc > 3 && argv[3][0] == 'o')
+		driverType = video::EDT_OPENGL;
+
+	printf("%u nodes with 3 mesh buffers, %u frames\n", count, frames);
+	printf("node by node: %.2f ms per frame, render queue: %.2f ms per frame\n",
+		(f32)renderScene(count, frames, driverType, false) / frames,
+		(f32)renderScene(count, frames, driverType, true) / frames);
+
+	return 0;
+}
@@ -0,0 +1,99 @@
+// Copyright (C) 2002-2012 Nikolaus Gebhardt
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+/*
+Micro benchmark for the animation of the scene graph in ISceneManager::drawAll.
+Builds a scene of empty scene nodes in groups, each with a rotation or fly
+circle animator, and reports the time per frame of drawAll on the main thread,
+with ISceneManager::setTransformStore and with ISceneManager::setParallelAnimation
+on the worker threads. Then the same for a scene in which only every 16th group
+is animated.
+
+Usage: SceneAnimation [node count] [frames] [worker threads]
+*/
+
+#include <irrlicht.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+using namespace irr;
+
+enum E_ANIMATION_MODE
+{
+	EAM_MAIN_THREAD,
+	EAM_TRANSFORM_STORE,
+	EAM_PARALLEL
+};
+
+// Times frames of a scene with count nodes, of which every animatedGroups'th group is animated.
+static u32 animateScene(u32 count, u32 frames, u32 animatedGroups, u32 workerThreads, E_ANIMATION_MODE mode)
+{
+	SIrrlichtCreationParameters params;
+	params.DriverType = video::EDT_NULL;
+	params.WorkerThreads = workerThreads;
+	IrrlichtDevice* device = createDeviceEx(params);
+	if (!device)
+		return 0;
+
+	scene::ISceneManager* smgr = device->getSceneManager();
+	ITimer* timer = device->getTimer();
+	smgr->addCameraSceneNode(0, core::vector3df(0, 100, -300), core::vector3df(0, 50, 0));
+	smgr->setTransformStore(mode == EAM_TRANSFORM_STORE);
+	smgr->setParallelAnimation(mode == EAM_PARALLEL);
+
+	// groups of 16 nodes, 4 levels deep
+	scene::ISceneNode* parent = 0;
+	for (u32 i=0; i<count; ++i)
+	{
+		if (i % 4 == 0)
+			parent = 0;
+		if (i % 16 == 0)
+			parent = smgr->addEmptySceneNode();
+
+		scene::ISceneNode* node = smgr->addEmptySceneNode(parent);
+		node->setPosition(core::vector3df((f32)(rand() % 100), 0.f, (f32)(rand() % 100)));
+		if ((i / 16) % animatedGroups == 0)
+		{
+			scene::ISceneNodeAnimator* anim = (i & 1) ?
+				smgr->createRotationAnimator(core::vector3df(0.f, 0.5f, 0.1f)) :
+				smgr->createFlyCircleAnimator(core::vector3df(0.f, 0.f, 0.f), 10.f);
+			node->addAnimator(anim);
+			anim->drop();
+		}
+		if (i % 4 == 0)
+			parent = node;
+	}
+
+	const u32 start = timer->getRealTime();
+	for (u32 f=0; f<frames; ++f)
+	{
+		device->run();
+		smgr->drawAll();
+	}
+	const u32 elapsed = timer->getRealTime() - start;
+
+	device->drop();
+	return elapsed;
+}
+
+int main(int argc, char* argv[])
+{
+	const u32 count = argc > 1 ? (u32)atoi(argv[1]) : 50000;
+	const u32 frames = argc > 2 ? (u32)atoi(argv[2]) : 100;
+	const u32 workerThreads = argc > 3 ? (u32)atoi(argv[3]) : 3;
+
+	printf("%u nodes, %u frames\n", count, frames);
+	const u32 animatedGroups[] = { 1, 16 };
+	for (u32 i=0; i<2; ++i)
+	{
+		printf("every %u. group animated\n", animatedGroups[i]);
+		printf("main thread: %.2f ms per frame, transform store: %.2f ms per frame, with %u worker threads: %.2f ms per frame\n",
+			(f32)animateScene(count, frames, animatedGroups[i], 0, EAM_MAIN_THREAD) / frames,
+			(f32)animateScene(count, frames, animatedGroups[i], 0, EAM_TRANSFORM_STORE) / frames, workerThreads,
+			(f32)animateScene(count, frames, animatedGroups[i], workerThreads, EAM_PARALLEL) / frames);
+	}
+
+	return 0;
+}
+
@@ -0,0 +1,95 @@
+// Copyright (C) 2002-2012 Nikolaus Gebhardt
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+/*
+Micro benchmark for IStaticBatchSceneNode.
+Builds a grid of small mesh scene nodes using a few textures and reports
+the time per frame of drawAll with the nodes drawn one by one and with
+the nodes added to a static batch scene node, and the time to build the
+batch.
+
+Usage: StaticBatch [node count] [frames] [driver: n=null, b=burnings video, o=OpenGL]
+*/
+
+#include <irrlicht.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+using namespace irr;
+
+// Times frames of a scene with count nodes using 4 textures
+static u32 renderScene(u32 count, u32 frames, video::E_DRIVER_TYPE driverType, bool batched, u32& buildTime)
+{
+	IrrlichtDevice* device = createDevice(driverType, core::dimension2du(640, 480));
+	if (!device)
+		return 0;
+
+	video::IVideoDriver* driver = device->getVideoDriver();
+	scene::ISceneManager* smgr = device->getSceneManager();
+	ITimer* timer = device->getTimer();
+	smgr->addCameraSceneNode(0, core::vector3df(0, 200, -200), core::vector3df(0, 0, 0));
+
+	const u32 textureCount = 4;
+	video::ITexture* textures[textureCount];
+	for (u32 t=0; t<textureCount; ++t)
+	{
+		video::IImage* image = driver->createImage(video::ECF_A8R8G8B8, core::dimension2du(16, 16));
+		image->fill(video::SColor(255, t*64, 255-t*64, 128));
+		core::stringc name("texture");
+		name += t;
+		textures[t] = driver->addTexture(name, image);
+		image->drop();
+	}
+
+	scene::IStaticBatchSceneNode* batch = batched ? smgr->addStaticBatchSceneNode() : 0;
+	scene::IMesh* cube = smgr->getGeometryCreator()->createCubeMesh(core::vector3df(4.f, 4.f, 4.f));
+	const u32 side = core::max_((u32)core::squareroot((f32)count), (u32)1);
+	for (u32 i=0; i<count; ++i)
+	{
+		const core::vector3df position((f32)(i % side) * 6.f - side * 3.f, 0.f, (f32)(i / side) * 6.f - side * 3.f);
+		scene::IMeshSceneNode* node = smgr->addMeshSceneNode(cube, 0, -1, position);
+		node->setMaterialTexture(0, textures[i % textureCount]);
+		node->setMaterialFlag(video::EMF_LIGHTING, false);
+		if (batch)
+			batch->addNode(node);
+	}
+	cube->drop();
+
+	buildTime = timer->getRealTime();
+	if (batch)
+		batch->getMesh();
+	buildTime = timer->getRealTime() - buildTime;
+
+	const u32 start = timer->getRealTime();
+	for (u32 f=0; f<frames && device->run(); ++f)
+	{
+		driver->beginScene(video::ECBF_COLOR | video::ECBF_DEPTH, video::SColor(255,0,0,0));
+		smgr->drawAll();
+		driver->endScene();
+	}
+	const u32 elapsed = timer->getRealTime() - start;
+
+	device->drop();
+	return elapsed;
+}
+
+int main(int argc, char* argv[])
+{
+	const u32 count = argc > 1 ? (u32)atoi(argv[1]) : 5000;
+	const u32 frames = argc > 2 ? (u32)atoi(argv[2]) : 100;
+	video::E_DRIVER_TYPE driverType = video::EDT_BURNINGSVIDEO;
+	if (argc > 3 && argv[3][0] == 'n')
+		driverType = video::EDT_NULL;
+	else if (argc > 3 && argv[3][0] == 'o')
+		driverType = video::EDT_OPENGL;
+
+	u32 buildTime = 0;
+	printf("%u nodes with 4 textures, %u frames\n", count, frames);
+	const f32 nodes = (f32)renderScene(count, frames, driverType, false, buildTime) / frames;
+	const f32 batched = (f32)renderScene(count, frames, driverType, true, buildTime) / frames;
+	printf("node by node: %.2f ms per frame, static batch: %.2f ms per frame, built in %u ms\n",
+		nodes, batched, buildTime);
+
+	return 0;
+}
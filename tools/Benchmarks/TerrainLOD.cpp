@@ -0,0 +1,76 @@
+// Copyright (C) 2002-2012 Nikolaus Gebhardt
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+/*
+Micro benchmark for the LOD and index calculations of the terrain scene node.
+Loads a generated 16 bit RAW heightmap and flies the camera over it, far
+enough each frame that the terrain recalculates the LOD of its patches and
+its indices. Reports the time per frame.
+
+Usage: TerrainLOD [heightmap size] [frames]
+*/
+
+#include <irrlicht.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+
+using namespace irr;
+
+int main(int argc, char* argv[])
+{
+	const u32 size = argc > 1 ? (u32)atoi(argv[1]) : 2049;
+	const u32 frames = argc > 2 ? (u32)atoi(argv[2]) : 200;
+
+	IrrlichtDevice* device = createDevice(video::EDT_NULL);
+	if (!device)
+		return 1;
+
+	scene::ISceneManager* smgr = device->getSceneManager();
+	video::IVideoDriver* driver = device->getVideoDriver();
+	ITimer* timer = device->getTimer();
+
+	// rolling hills
+	u16* heights = new u16[size*size];
+	for (u32 z=0; z<size; ++z)
+		for (u32 x=0; x<size; ++x)
+			heights[z*size+x] = (u16)(20000.f + 10000.f * sinf(x * 0.01f) * cosf(z * 0.013f));
+	io::IReadFile* file = device->getFileSystem()->createMemoryReadFile(heights,
+		size*size*sizeof(u16), "heightmap.raw", true);
+
+	scene::ITerrainSceneNode* terrain = smgr->addTerrainSceneNode((io::IReadFile*)0, 0, -1,
+		core::vector3df(0.f, 0.f, 0.f), core::vector3df(0.f, 0.f, 0.f), core::vector3df(1.f, 0.01f, 1.f),
+		video::SColor(255, 255, 255, 255), 5, scene::ETPS_17, 0, true);
+	u32 start = timer->getRealTime();
+	terrain->loadHeightMapRAW(file, 16, false, false, size);
+	printf("%ux%u heightmap loaded in %u ms\n", size, size, timer->getRealTime() - start);
+	file->drop();
+
+	scene::ICameraSceneNode* camera = smgr->addCameraSceneNode();
+	camera->setFarValue((f32)size);
+
+	const f32 center = size * 0.5f;
+	start = timer->getRealTime();
+	u32 indices = 0;
+	for (u32 f=0; f<frames; ++f)
+	{
+		// 11 units per frame, more than the camera movement delta
+		const f32 angle = f * 11.f / (size * 0.25f);
+		const core::vector3df position(center + cosf(angle) * size * 0.25f, 500.f, center + sinf(angle) * size * 0.25f);
+		camera->setPosition(position);
+		camera->setTarget(position + core::vector3df(-sinf(angle), -0.3f, cosf(angle)));
+
+		driver->beginScene();
+		smgr->drawAll();
+		driver->endScene();
+		indices += terrain->getIndexCount();
+	}
+	const u32 elapsed = timer->getRealTime() - start;
+
+	printf("%u frames: %.2f ms per frame, %u indices per frame\n", frames, (f32)elapsed / frames, indices / frames);
+
+	device->drop();
+
+	return 0;
+}
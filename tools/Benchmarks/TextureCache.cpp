@@ -0,0 +1,94 @@
+// Copyright (C) 2002-2012 Nikolaus Gebhardt
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+/*
+Micro benchmark for the texture cache of the video driver.
+Fills the cache with generated textures and loads the images of the media
+folder. Then reports the time of 50000 IVideoDriver::getTexture calls with
+the relative filenames of the images, which all hit the cache, and the
+time to remove all textures one by one.
+
+Usage: TextureCache [generated texture count] [media folder]
+*/
+
+#include <irrlicht.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+using namespace irr;
+
+int main(int argc, char* argv[])
+{
+	const u32 generated = argc > 1 ? (u32)atoi(argv[1]) : 5000;
+	const io::path media = argc > 2 ? argv[2] : "../../media";
+	const u32 lookups = 50000;
+
+	IrrlichtDevice* device = createDevice(video::EDT_NULL);
+	if (!device)
+		return 1;
+
+	device->getLogger()->setLogLevel(ELL_WARNING);
+	video::IVideoDriver* driver = device->getVideoDriver();
+	io::IFileSystem* fs = device->getFileSystem();
+	ITimer* timer = device->getTimer();
+
+	for (u32 i=0; i<generated; ++i)
+		driver->addTexture(core::dimension2du(1, 1), io::path("generated/tex") + io::path(i) + ".png");
+
+	// the images of the media folder, by relative filename
+	core::array<io::path> names;
+	const io::path workingDirectory = fs->getWorkingDirectory();
+	fs->changeWorkingDirectoryTo(media);
+	io::IFileList* files = fs->createFileList();
+	fs->changeWorkingDirectoryTo(workingDirectory);
+	for (u32 i=0; i<files->getFileCount(); ++i)
+	{
+		io::path extension;
+		core::getFileNameExtension(extension, files->getFileName(i));
+		extension.make_lower();
+		if (extension == ".png" || extension == ".jpg" || extension == ".bmp" || extension == ".tga")
+		{
+			const io::path name = media + "/" + files->getFileName(i);
+			if (driver->getTexture(name))
+				names.push_back(name);
+		}
+	}
+	files->drop();
+
+	if (names.empty())
+	{
+		printf("No images in %s\n", core::stringc(media).c_str());
+		device->drop();
+		return 1;
+	}
+
+	printf("%u textures, %u loaded from files\n", driver->getTextureCount(), names.size());
+
+	u32 start = timer->getRealTime();
+	u32 hits = 0;
+	for (u32 i=0; i<lookups; ++i)
+	{
+		if (driver->getTexture(names[i % names.size()]))
+			++hits;
+	}
+	u32 elapsed = timer->getRealTime() - start;
+
+	printf("%u getTexture calls: %u ms, %u hits\n", lookups, elapsed, hits);
+
+	const u32 count = driver->getTextureCount();
+	start = timer->getRealTime();
+	while (driver->getTextureCount())
+	{
+		// remove from the middle of the cache
+		driver->removeTexture(driver->getTextureByIndex(driver->getTextureCount() / 2));
+	}
+	elapsed = timer->getRealTime() - start;
+
+	printf("%u removeTexture calls: %u ms\n", count, elapsed);
+
+	device->drop();
+
+	return 0;
+}
+
@@ -0,0 +1,83 @@
+// Copyright (C) 2002-2012 Nikolaus Gebhardt
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+/*
+Micro benchmark for compressed files of zip archives which are decompressed
+while reading. Reports the time to open a file and read its first 4 KB and
+the time to read it completely, with the file decompressed completely when
+opened and decompressed while reading.
+
+Usage: ZipStreaming [archive] [file in archive] [repeats]
+*/
+
+#include <irrlicht.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+using namespace irr;
+
+// Times opening the file and reading its first 4 KB, and reading all of it
+static void readFile(IrrlichtDevice* device, io::IFileArchive* archive, const char* filename,
+	u32 repeats, u32 threshold, u32& headTime, u32& fullTime)
+{
+	io::IFileSystem* fs = device->getFileSystem();
+	ITimer* timer = device->getTimer();
+	archive->setStreamingThreshold(threshold);
+
+	c8 buffer[4096];
+	headTime = timer->getRealTime();
+	for (u32 r=0; r<repeats; ++r)
+	{
+		io::IReadFile* file = fs->createAndOpenFile(filename);
+		if (!file)
+			return;
+		file->read(buffer, sizeof(buffer));
+		file->drop();
+	}
+	headTime = timer->getRealTime() - headTime;
+
+	fullTime = timer->getRealTime();
+	for (u32 r=0; r<repeats; ++r)
+	{
+		io::IReadFile* file = fs->createAndOpenFile(filename);
+		if (!file)
+			return;
+		while (file->read(buffer, sizeof(buffer)))
+			;
+		file->drop();
+	}
+	fullTime = timer->getRealTime() - fullTime;
+}
+
+int main(int argc, char* argv[])
+{
+	const char* archiveName = argc > 1 ? argv[1] : "../../tests/media/streaming.zip";
+	const char* filename = argc > 2 ? argv[2] : "deflate.txt";
+	const u32 repeats = argc > 3 ? (u32)atoi(argv[3]) : 20;
+
+	IrrlichtDevice* device = createDevice(video::EDT_NULL);
+	if (!device)
+		return 1;
+
+	io::IFileArchive* archive = 0;
+	if (!device->getFileSystem()->addFileArchive(archiveName, true, false, io::EFAT_UNKNOWN, "", &archive))
+	{
+		printf("Could not open %s\n", archiveName);
+		device->drop();
+		return 1;
+	}
+
+	u32 memoryHead = 0, memoryFull = 0, streamHead = 0, streamFull = 0;
+	readFile(device, archive, filename, repeats, 0xffffffff, memoryHead, memoryFull);
+	readFile(device, archive, filename, repeats, 0, streamHead, streamFull);
+
+	printf("%s, %u repeats\n", filename, repeats);
+	printf("decompressed when opened: first 4 KB %.2f ms, complete %.2f ms\n",
+		(f32)memoryHead / repeats, (f32)memoryFull / repeats);
+	printf("decompressed while reading: first 4 KB %.2f ms, complete %.2f ms\n",
+		(f32)streamHead / repeats, (f32)streamFull / repeats);
+
+	device->drop();
+	return 0;
+}